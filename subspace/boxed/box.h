@@ -0,0 +1,375 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <new>
+#include <source_location>
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/convert/subclass.h"
+#include "subspace/mem/alloc.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/clone.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/never_value.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/mem/size_of.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/ops/eq.h"
+
+// Box is used by the iterator machinery, which is in turn included by Slice
+// and Vec. So Slice and Vec can only be forward declared here, and the methods
+// of `Box<T[]>` which use them require their headers to be included by the
+// caller.
+namespace sus::containers {
+template <class T>
+class Slice;
+template <class T>
+class Vec;
+}  // namespace sus::containers
+
+namespace sus::boxed {
+
+/// A pointer type that uniquely owns a heap allocation of type `T`.
+///
+/// A `Box` is never null. When the `Box` is destroyed, the `T` is destroyed
+/// and the heap allocation is freed.
+///
+/// `Box` is trivially relocatable, and it has a never-value field, so an
+/// `Option<Box<T>>` is the same size as a pointer.
+///
+/// A `Box<T[]>` owns a heap allocated array of `T` whose length is decided at
+/// runtime, and is viewed through a `Slice`.
+template <class T>
+class [[sus_trivial_abi]] Box final {
+  static_assert(!std::is_reference_v<T>, "Box<T&> is not a valid type.");
+  static_assert(!std::is_const_v<T>,
+                "`Box<const T>` should be written `const Box<T>`, as const "
+                "applies transitively.");
+
+ public:
+  /// Constructs a `Box<T>` by moving `t` into a new heap allocation.
+  static Box with(T t, const std::source_location location =
+                           std::source_location::current()) noexcept
+    requires(::sus::mem::Move<T>)
+  {
+    return Box(new (::sus::mem::allocate(sizeof(T), alignof(T), location))
+                   T(::sus::move(t)));
+  }
+
+  /// sus::construct::From<Box<T>, T> trait.
+  ///
+  /// #[doc.overloads=0]
+  static Box from(T t, const std::source_location location =
+                           std::source_location::current()) noexcept
+    requires(::sus::mem::Move<T>)
+  {
+    return with(::sus::move(t), location);
+  }
+
+  /// Converts a `Box<U>` into a `Box<T>` where `U` is a subclass of `T`.
+  ///
+  /// The object is destroyed through a `T*`, so `T` must have a virtual
+  /// destructor. The allocation is freed with the alignment of `T`, so `U` may
+  /// not be aligned to more than `alignof(max_align_t)`.
+  ///
+  /// sus::construct::From<Box<T>, Box<U>> trait.
+  ///
+  /// #[doc.overloads=1]
+  template <class U>
+    requires(!std::same_as<T, U> &&
+             ::sus::convert::SameOrSubclassOf<U*, T*> &&
+             std::has_virtual_destructor_v<T> &&
+             alignof(U) <= alignof(max_align_t))
+  static Box from(Box<U>&& box) noexcept {
+    return Box(static_cast<T*>(::sus::move(box).into_raw()));
+  }
+
+  /// Constructs a `Box<T>` from a pointer that was previously returned from
+  /// `into_raw()`.
+  ///
+  /// # Safety
+  /// The pointer must have come from `Box<T>::into_raw()`, and it must not be
+  /// given to `from_raw()` more than once, or Undefined Behaviour results.
+  static Box from_raw(::sus::marker::UnsafeFnMarker, T* raw) noexcept {
+    return Box(raw);
+  }
+
+  ~Box() {
+    // The `ptr_` is null when being destroyed from the never-value state.
+    if (ptr_ != nullptr && !is_moved_from()) destroy();
+  }
+
+  Box(Box&& o) noexcept
+      : ptr_(::sus::mem::replace_ptr(mref(o.ptr_), moved_from_value())) {
+    check(!is_moved_from());
+  }
+  Box& operator=(Box&& o) noexcept {
+    if (&o == this) return *this;
+    check(!o.is_moved_from());
+    if (!is_moved_from()) destroy();
+    ptr_ = ::sus::mem::replace_ptr(mref(o.ptr_), moved_from_value());
+    return *this;
+  }
+
+  /// sus::mem::Clone trait.
+  Box clone(const std::source_location location =
+                std::source_location::current()) const& noexcept
+    requires(::sus::mem::Clone<T>)
+  {
+    return Box::with(::sus::clone(as_ref()), location);
+  }
+
+  /// Returns a const reference to the owned `T`.
+  const T& as_ref() const& noexcept {
+    check(!is_moved_from());
+    return *ptr_;
+  }
+  const T& as_ref() && = delete;
+
+  /// Returns a mutable reference to the owned `T`.
+  T& as_mut() & noexcept {
+    check(!is_moved_from());
+    return *ptr_;
+  }
+
+  const T& operator*() const& noexcept { return as_ref(); }
+  const T& operator*() && = delete;
+  T& operator*() & noexcept { return as_mut(); }
+
+  const T* operator->() const& noexcept { return &as_ref(); }
+  const T* operator->() && = delete;
+  T* operator->() & noexcept { return &as_mut(); }
+
+  /// Consumes the `Box`, returning the pointer to the heap allocation without
+  /// freeing it.
+  ///
+  /// The caller becomes responsible for the memory. It can be freed by giving
+  /// the pointer back to `Box<T>::from_raw()`.
+  T* into_raw() && noexcept {
+    check(!is_moved_from());
+    return ::sus::mem::replace_ptr(mref(ptr_), moved_from_value());
+  }
+
+  /// sus::ops::Eq<Box<T>, Box<U>> trait.
+  template <class U>
+    requires(::sus::ops::Eq<T, U>)
+  friend bool operator==(const Box& l, const Box<U>& r) noexcept {
+    return l.as_ref() == r.as_ref();
+  }
+
+ private:
+  template <class U>
+  friend class Box;
+
+  explicit Box(T* ptr) noexcept : ptr_(ptr) {}
+
+  void destroy() noexcept {
+    ptr_->~T();
+    ::sus::mem::deallocate(ptr_, alignof(T));
+  }
+
+  constexpr inline bool is_moved_from() const noexcept {
+    return ptr_ == moved_from_value();
+  }
+  // The value used in `ptr_` to indicate moved-from. It is not null, so that
+  // a moved-from Box is not mistaken for the never-value.
+  static T* moved_from_value() noexcept {
+    return reinterpret_cast<T*>(uintptr_t{alignof(T)});
+  }
+
+  T* ptr_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(ptr_));
+  // The `ptr_` is never null in public usage.
+  sus_class_never_value_field(::sus::marker::unsafe_fn, Box, ptr_, nullptr,
+                              nullptr);
+  constexpr Box() : ptr_(nullptr) {}  // For the NeverValueField.
+};
+
+/// A `Box<T[]>` owns a heap allocation of `len()` objects of type `T`.
+///
+/// The array is viewed through a `Slice`, with `as_ref()` and `as_mut()`. The
+/// `Box<T[]>` is typically created from a `Vec<T>` that is done growing.
+template <class T>
+class [[sus_trivial_abi]] Box<T[]> final {
+  static_assert(!std::is_reference_v<T>, "Box<T&[]> is not a valid type.");
+  static_assert(!std::is_const_v<T>,
+                "`Box<const T[]>` should be written `const Box<T[]>`, as "
+                "const applies transitively.");
+
+ public:
+  /// Constructs an empty `Box<T[]>` which does not allocate.
+  ///
+  /// sus::construct::Default trait.
+  Box() noexcept : ptr_(nullptr), len_(0_usize) {}
+
+  /// Constructs a `Box<T[]>` holding `len` default-constructed objects.
+  static Box with_default(usize len,
+                          const std::source_location location =
+                              std::source_location::current()) noexcept
+    requires(std::is_default_constructible_v<T>)
+  {
+    auto b = Box(allocate(len, location), len);
+    for (size_t i = 0u; i < len.primitive_value; ++i) new (b.ptr_ + i) T();
+    return b;
+  }
+
+  /// Constructs a `Box<T[]>` by taking over the heap allocation of the
+  /// `Vec<T>`, without moving its elements.
+  ///
+  /// The `Vec` is first shrunk to fit its elements, as with
+  /// `Vec::shrink_to_fit()`, so any excess capacity is released.
+  ///
+  /// sus::construct::From<Box<T[]>, Vec<T>> trait.
+  static Box from(::sus::containers::Vec<T>&& vec,
+                  const std::source_location location =
+                      std::source_location::current()) noexcept {
+    vec.shrink_to_fit(location);
+    const usize len = vec.len_;
+    T* const ptr = reinterpret_cast<T*>(::sus::mem::replace_ptr(
+        mref(vec.storage_), nullptr));
+    vec.len_ = 0_usize;
+    vec.capacity_ = 0_usize;
+    return Box(len > 0u ? ptr : nullptr, len);
+  }
+
+  ~Box() {
+    if (is_moved_from()) return;
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (size_t i = 0u; i < len_.primitive_value; ++i) ptr_[i].~T();
+    }
+    free_storage();
+  }
+
+  Box(Box&& o) noexcept
+      : ptr_(::sus::mem::replace_ptr(mref(o.ptr_), moved_from_value())),
+        len_(::sus::mem::replace(mref(o.len_), 0_usize)) {
+    check(!is_moved_from());
+  }
+  Box& operator=(Box&& o) noexcept {
+    if (&o == this) return *this;
+    check(!o.is_moved_from());
+    if (!is_moved_from()) {
+      if constexpr (!std::is_trivially_destructible_v<T>) {
+        for (size_t i = 0u; i < len_.primitive_value; ++i) ptr_[i].~T();
+      }
+      free_storage();
+    }
+    ptr_ = ::sus::mem::replace_ptr(mref(o.ptr_), moved_from_value());
+    len_ = ::sus::mem::replace(mref(o.len_), 0_usize);
+    return *this;
+  }
+
+  /// sus::mem::Clone trait.
+  Box clone(const std::source_location location =
+                std::source_location::current()) const& noexcept
+    requires(::sus::mem::Clone<T>)
+  {
+    check(!is_moved_from());
+    auto b = Box(allocate(len_, location), len_);
+    for (size_t i = 0u; i < len_.primitive_value; ++i)
+      new (b.ptr_ + i) T(::sus::clone(ptr_[i]));
+    return b;
+  }
+
+  /// Returns the number of elements in the array.
+  usize len() const& noexcept {
+    check(!is_moved_from());
+    return len_;
+  }
+
+  /// Returns a const reference to the element at index `i`.
+  ///
+  /// # Panics
+  /// If the index `i` is beyond the end of the array, the function will panic.
+  const T& operator[](usize i) const& noexcept {
+    check(!is_moved_from());
+    check(i < len_);
+    return ptr_[i.primitive_value];
+  }
+  const T& operator[](usize i) && = delete;
+
+  /// Returns a mutable reference to the element at index `i`.
+  ///
+  /// # Panics
+  /// If the index `i` is beyond the end of the array, the function will panic.
+  T& operator[](usize i) & noexcept {
+    check(!is_moved_from());
+    check(i < len_);
+    return ptr_[i.primitive_value];
+  }
+
+  /// Returns a `Slice` that references all the elements of the array as const
+  /// references.
+  ::sus::containers::Slice<const T> as_ref() const& noexcept {
+    check(!is_moved_from());
+    return ::sus::containers::Slice<const T>::from_raw_parts(
+        ::sus::marker::unsafe_fn, ptr_, len_);
+  }
+  ::sus::containers::Slice<const T> as_ref() && = delete;
+
+  /// Returns a `Slice` that references all the elements of the array as
+  /// mutable references.
+  ::sus::containers::Slice<T> as_mut() & noexcept {
+    check(!is_moved_from());
+    return ::sus::containers::Slice<T>::from_raw_parts(::sus::marker::unsafe_fn,
+                                                       ptr_, len_);
+  }
+
+ private:
+  Box(T* ptr, usize len) noexcept : ptr_(ptr), len_(len) {}
+
+  static T* allocate(usize len,
+                     const std::source_location& location) noexcept {
+    if (len == 0u) return nullptr;
+    const usize bytes = ::sus::mem::size_of<T>() * len;
+    check(bytes <= usize(size_t{PTRDIFF_MAX}));
+    return static_cast<T*>(
+        ::sus::mem::allocate(bytes.primitive_value, alignof(T), location));
+  }
+  void free_storage() noexcept {
+    if (ptr_ != nullptr) ::sus::mem::deallocate(ptr_, alignof(T));
+  }
+
+  constexpr inline bool is_moved_from() const noexcept {
+    return ptr_ == moved_from_value();
+  }
+  // The value used in `ptr_` to indicate moved-from. An empty array holds a
+  // null pointer, so this is some other value that is never allocated.
+  static T* moved_from_value() noexcept {
+    return reinterpret_cast<T*>(uintptr_t{alignof(T)});
+  }
+
+  T* ptr_;
+  usize len_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(ptr_),
+                                  decltype(len_));
+};
+
+}  // namespace sus::boxed
+
+// Promote Box into the `sus` namespace.
+namespace sus {
+using ::sus::boxed::Box;
+}  // namespace sus
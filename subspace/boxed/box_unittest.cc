@@ -0,0 +1,190 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "subspace/boxed/box.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/slice.h"
+#include "subspace/containers/vec.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/size_of.h"
+#include "subspace/option/option.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::boxed::Box;
+
+static_assert(sus::mem::relocate_by_memcpy<Box<i32>>);
+static_assert(sus::mem::relocate_by_memcpy<Box<i32[]>>);
+static_assert(sus::mem::size_of<Box<i32>>() == sizeof(void*));
+// The never-value field makes Option<Box<T>> the same size as a pointer.
+static_assert(sus::mem::size_of<sus::Option<Box<i32>>>() == sizeof(void*));
+
+struct Base {
+  virtual ~Base() = default;
+  virtual i32 value() const = 0;
+};
+struct Sub : public Base {
+  Sub(i32 i, i32& destroyed) : i(i), destroyed(destroyed) {}
+  Sub(Sub&& o) : i(o.i), destroyed(o.destroyed) { o.i = 0; }
+  ~Sub() override {
+    if (i != 0) destroyed += 1;
+  }
+  i32 value() const override { return i; }
+
+  i32 i;
+  i32& destroyed;
+};
+
+TEST(Box, With) {
+  auto b = Box<i32>::with(3);
+  EXPECT_EQ(*b, 3);
+  *b = 4;
+  EXPECT_EQ(b.as_ref(), 4);
+  b.as_mut() += 1;
+  EXPECT_EQ(*b, 5);
+}
+
+TEST(Box, Destroy) {
+  i32 destroyed;
+  {
+    auto b = Box<Sub>::with(Sub(2, destroyed));
+    EXPECT_EQ(destroyed, 0);
+    EXPECT_EQ(b->value(), 2);
+  }
+  EXPECT_EQ(destroyed, 1);
+}
+
+TEST(Box, Move) {
+  i32 destroyed;
+  auto b = Box<Sub>::with(Sub(2, destroyed));
+  auto c = sus::move(b);
+  EXPECT_EQ(c->value(), 2);
+  b = sus::move(c);
+  EXPECT_EQ(b->value(), 2);
+  EXPECT_EQ(destroyed, 0);
+  c = Box<Sub>::with(Sub(3, destroyed));
+  b = sus::move(c);
+  EXPECT_EQ(destroyed, 1);
+  EXPECT_EQ(b->value(), 3);
+
+  // Moving into itself does nothing.
+  auto& self = b;
+  b = sus::move(self);
+  EXPECT_EQ(destroyed, 1);
+  EXPECT_EQ(b->value(), 3);
+}
+
+TEST(Box, FromSubclass) {
+  i32 destroyed;
+  {
+    Box<Base> b = Box<Base>::from(Box<Sub>::with(Sub(7, destroyed)));
+    EXPECT_EQ(b->value(), 7);
+  }
+  EXPECT_EQ(destroyed, 1);
+}
+
+TEST(Box, RawRoundTrip) {
+  auto b = Box<i32>::with(9);
+  i32* raw = sus::move(b).into_raw();
+  EXPECT_EQ(*raw, 9);
+  auto c = Box<i32>::from_raw(unsafe_fn, raw);
+  EXPECT_EQ(*c, 9);
+}
+
+TEST(Box, Clone) {
+  auto b = Box<i32>::with(3);
+  auto c = sus::clone(b);
+  *c = 4;
+  EXPECT_EQ(*b, 3);
+  EXPECT_EQ(*c, 4);
+  EXPECT_NE(b, c);
+  *c = 3;
+  EXPECT_EQ(b, c);
+}
+
+TEST(Box, Option) {
+  auto o = sus::Option<Box<i32>>::some(Box<i32>::with(3));
+  EXPECT_EQ(*o.as_ref().unwrap(), 3);
+  auto b = o.take().unwrap();
+  EXPECT_EQ(*b, 3);
+  EXPECT_TRUE(o.is_none());
+}
+
+TEST(BoxArray, Default) {
+  auto b = Box<i32[]>();
+  EXPECT_EQ(b.len(), 0u);
+  EXPECT_EQ(b.as_ref().len(), 0u);
+}
+
+TEST(BoxArray, WithDefault) {
+  auto b = Box<i32[]>::with_default(3u);
+  EXPECT_EQ(b.len(), 3u);
+  EXPECT_EQ(b[0u], 0);
+  EXPECT_EQ(b[2u], 0);
+  b[1u] = 5;
+  EXPECT_EQ(b.as_ref()[1u], 5);
+  auto s = b.as_mut();
+  s[2u] = 6;
+  EXPECT_EQ(b[2u], 6);
+}
+
+TEST(BoxArray, FromVec) {
+  auto v = Vec<i32>();
+  v.push(1);
+  v.push(2);
+  v.push(3);
+  EXPECT_EQ(v.capacity(), 3u);
+  const i32* const storage = v.as_ptr();
+  auto b = Box<i32[]>::from(sus::move(v));
+  // The Vec is full, so the Box takes its heap allocation as is.
+  EXPECT_EQ(b.as_ref().as_ptr(), storage);
+  EXPECT_EQ(b.len(), 3u);
+  EXPECT_EQ(b[0u], 1);
+  EXPECT_EQ(b[1u], 2);
+  EXPECT_EQ(b[2u], 3);
+
+  auto c = sus::clone(b);
+  c[0u] = 4;
+  EXPECT_EQ(b[0u], 1);
+  EXPECT_EQ(c[0u], 4);
+}
+
+TEST(BoxArray, FromVecExcessCapacity) {
+  auto v = Vec<i32>::with_capacity(8u);
+  v.push(1);
+  v.push(2);
+  auto b = Box<i32[]>::from(sus::move(v));
+  EXPECT_EQ(b.len(), 2u);
+  EXPECT_EQ(b[0u], 1);
+  EXPECT_EQ(b[1u], 2);
+
+  auto e = Box<i32[]>::from(Vec<i32>::with_capacity(8u));
+  EXPECT_EQ(e.len(), 0u);
+}
+
+TEST(BoxArray, FromVecNonTrivial) {
+  i32 destroyed;
+  {
+    auto v = Vec<Sub>();
+    v.push(Sub(1, destroyed));
+    v.push(Sub(2, destroyed));
+    auto b = Box<Sub[]>::from(sus::move(v));
+    EXPECT_EQ(destroyed, 0);
+    EXPECT_EQ(b[1u].value(), 2);
+  }
+  EXPECT_EQ(destroyed, 2);
+}
+
+}  // namespace
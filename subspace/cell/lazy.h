@@ -0,0 +1,74 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <type_traits>
+
+#include "subspace/cell/once_cell.h"
+#include "subspace/mem/move.h"
+
+namespace sus::cell {
+
+/// A value which is initialized on first use, for use from a single thread.
+///
+/// This is the single-threaded counterpart to `sus::sync::LazyLock`. The value
+/// is made by calling the initializer given to the constructor the first time
+/// it is accessed, through `force()`, `*` or `->`. It does no synchronization,
+/// so it must not be shared between threads.
+///
+/// The initializer is a function pointer by default, so that a `Lazy` can be
+/// constant-initialized. Any other callable type, such as
+/// `sus::fn::FnOnce<T()>`, can be given as `F`.
+template <class T, class F = T (*)()>
+class Lazy final {
+  static_assert(std::is_invocable_r_v<T, F&&>,
+                "The initializer must return a T when called.");
+
+ public:
+  /// Constructs a `Lazy` which will be initialized by calling `init`.
+  ///
+  /// This is a constructor, rather than a `with()` method, as a `Lazy`
+  /// holding a type with a non-trivial destructor is not a literal type, and
+  /// can only be constant-initialized by a constexpr constructor.
+  constexpr explicit Lazy(F init) noexcept : init_(::sus::move(init)) {}
+
+  Lazy(const Lazy&) = delete;
+  Lazy& operator=(const Lazy&) = delete;
+
+  /// Returns a reference to the value, initializing it first if this is the
+  /// first access.
+  ///
+  /// # Panics
+  /// Panics if the initializer accesses the `Lazy` itself.
+  const T& force() const& noexcept {
+    return cell_.get_or_init([this]() { return ::sus::move(init_)(); });
+  }
+  const T& force() && = delete;
+
+  const T& operator*() const& noexcept { return force(); }
+  const T& operator*() && = delete;
+
+  const T* operator->() const& noexcept { return &force(); }
+  const T* operator->() && = delete;
+
+  /// Returns whether the value has been initialized.
+  bool is_initialized() const& noexcept { return cell_.get().is_some(); }
+
+ private:
+  OnceCell<T> cell_;
+  mutable F init_;
+};
+
+}  // namespace sus::cell
@@ -0,0 +1,54 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/cell/lazy.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/fn/fn.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::cell::Lazy;
+
+int builds = 0;
+
+sus::Vec<i32> build() {
+  builds += 1;
+  auto v = sus::Vec<i32>();
+  v.push(1);
+  v.push(2);
+  return v;
+}
+
+constinit Lazy<sus::Vec<i32>> GLOBAL(&build);
+
+TEST(Lazy, Global) {
+  EXPECT_FALSE(GLOBAL.is_initialized());
+  EXPECT_EQ(GLOBAL->len(), 2u);
+  EXPECT_EQ((*GLOBAL)[1u], 2_i32);
+  EXPECT_EQ(GLOBAL.force()[0u], 1_i32);
+  EXPECT_TRUE(GLOBAL.is_initialized());
+  EXPECT_EQ(builds, 1);
+}
+
+TEST(Lazy, FnOnce) {
+  auto l = Lazy<i32, sus::fn::FnOnce<i32()>>(
+      sus::fn::FnOnce<i32()>::from([]() { return 5_i32; }));
+  EXPECT_EQ(*l, 5_i32);
+  EXPECT_EQ(l.force(), 5_i32);
+}
+
+}  // namespace
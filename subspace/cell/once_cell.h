@@ -0,0 +1,120 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <new>
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/mem/move.h"
+#include "subspace/option/option.h"
+
+namespace sus::cell {
+
+/// A value which is written at most once, for use from a single thread.
+///
+/// This is the single-threaded counterpart to `sus::sync::OnceLock`, with the
+/// same methods. It does no synchronization, so it must not be shared between
+/// threads. Checking whether the value is set is a single load.
+///
+/// The value is stored inline, and no allocation is made.
+template <class T>
+class OnceCell final {
+  static_assert(!std::is_reference_v<T>, "OnceCell<T&> is not a valid type.");
+
+ public:
+  /// Constructs an empty `OnceCell`.
+  ///
+  /// sus::construct::Default trait.
+  constexpr OnceCell() noexcept : no_value_() {}
+
+  ~OnceCell() noexcept {
+    if (is_set_) value_.~T();
+  }
+
+  OnceCell(const OnceCell&) = delete;
+  OnceCell& operator=(const OnceCell&) = delete;
+
+  /// Returns a reference to the value if it has been set, or None if it has
+  /// not.
+  ::sus::Option<const T&> get() const& noexcept {
+    if (is_set_) return ::sus::Option<const T&>::some(value_);
+    return ::sus::Option<const T&>::none();
+  }
+  ::sus::Option<const T&> get() && = delete;
+
+  /// Returns a mutable reference to the value if it has been set.
+  ::sus::Option<T&> get_mut() & noexcept {
+    if (is_set_) return ::sus::Option<T&>::some(value_);
+    return ::sus::Option<T&>::none();
+  }
+
+  /// Sets the value to `value` if it is not set yet, and returns None. If the
+  /// value was already set, `value` is returned back inside an Option.
+  ::sus::Option<T> set(T value) const& noexcept {
+    if (is_set_) return ::sus::Option<T>::some(::sus::move(value));
+    new (&value_) T(::sus::move(value));
+    is_set_ = true;
+    return ::sus::Option<T>::none();
+  }
+
+  /// Returns a reference to the value, setting it to the result of `f` first
+  /// if it is not set yet.
+  ///
+  /// The `f` may be any callable, including a `sus::fn::FnOnce<T()>`, and is
+  /// called at most once.
+  ///
+  /// # Panics
+  /// Panics if `f` sets the value of the `OnceCell` itself, through a
+  /// reentrant call.
+  template <class F>
+    requires(std::is_invocable_r_v<T, F &&>)
+  const T& get_or_init(F f) const& noexcept {
+    if (!is_set_) [[unlikely]] {
+      T value = ::sus::move(f)();
+      ::sus::check_with_message(!is_set_,
+                                *"reentrant initialization of OnceCell");
+      new (&value_) T(::sus::move(value));
+      is_set_ = true;
+    }
+    return value_;
+  }
+  template <class F>
+    requires(std::is_invocable_r_v<T, F &&>)
+  const T& get_or_init(F f) && = delete;
+
+  /// Takes the value out of the `OnceCell`, leaving it empty.
+  ::sus::Option<T> take() & noexcept {
+    if (!is_set_) return ::sus::Option<T>::none();
+    is_set_ = false;
+    auto o = ::sus::Option<T>::some(::sus::move(value_));
+    value_.~T();
+    return o;
+  }
+
+  /// Consumes the `OnceCell`, returning the value if it was set.
+  ::sus::Option<T> into_inner() && noexcept { return take(); }
+
+ private:
+  mutable bool is_set_ = false;
+  // Not held in an `Option`, as an `Option` can't be constant-initialized
+  // for every `T`, while a union with a trivial member active can.
+  union {
+    char no_value_;
+    mutable T value_;
+  };
+};
+
+}  // namespace sus::cell
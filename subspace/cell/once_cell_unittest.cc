@@ -0,0 +1,65 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/cell/once_cell.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/fn/fn.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::cell::OnceCell;
+
+TEST(OnceCell, GetOrInit) {
+  auto c = OnceCell<i32>();
+  EXPECT_TRUE(c.get().is_none());
+  EXPECT_EQ(c.get_or_init([]() { return 3_i32; }), 3_i32);
+  EXPECT_EQ(c.get_or_init([]() { return 4_i32; }), 3_i32);
+  EXPECT_EQ(c.get().unwrap(), 3_i32);
+
+  auto d = OnceCell<i32>();
+  EXPECT_EQ(d.get_or_init(sus::fn::FnOnce<i32()>::from([]() { return 5_i32; })),
+            5_i32);
+}
+
+TEST(OnceCell, Set) {
+  auto c = OnceCell<i32>();
+  EXPECT_TRUE(c.set(1).is_none());
+  EXPECT_EQ(c.set(2).unwrap(), 2_i32);
+  EXPECT_EQ(c.get().unwrap(), 1_i32);
+}
+
+TEST(OnceCell, TakeIntoInner) {
+  auto c = OnceCell<i32>();
+  (void)c.get_or_init([]() { return 3_i32; });
+  c.get_mut().unwrap() += 1;
+  EXPECT_EQ(c.take().unwrap(), 4_i32);
+  EXPECT_TRUE(c.get().is_none());
+  EXPECT_TRUE(c.set(5).is_none());
+  EXPECT_EQ(sus::move(c).into_inner().unwrap(), 5_i32);
+}
+
+TEST(OnceCellDeathTest, Reentrant) {
+#if GTEST_HAS_DEATH_TEST
+  auto c = OnceCell<i32>();
+  EXPECT_DEATH((void)c.get_or_init([&c]() {
+    (void)c.set(1);
+    return 2_i32;
+  }),
+               "");
+#endif
+}
+
+}  // namespace
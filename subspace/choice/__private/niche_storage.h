@@ -0,0 +1,212 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <compare>
+#include <new>
+#include <type_traits>
+
+#include "subspace/choice/__private/nothing.h"
+#include "subspace/choice/__private/storage.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/clone.h"
+#include "subspace/mem/forward.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/never_value.h"
+#include "subspace/option/__private/storage.h"
+#include "subspace/tuple/tuple.h"
+
+namespace sus::choice_type::__private {
+
+template <class T>
+struct NicheHeldHelper {
+  using type = T;
+};
+
+template <class T>
+struct NicheHeldHelper<T&> {
+  using type = ::sus::option::__private::StoragePointer<T&>;
+};
+
+/// The type held in a `NicheStorage` for a value of type `T`. References are
+/// held as a pointer which is never null.
+template <class T>
+using NicheHeld = NicheHeldHelper<T>::type;
+
+/// A value type whose never-value field can be used to hold the index of a
+/// `Choice`.
+template <class T>
+concept NicheValue = ::sus::mem::NeverValueField<NicheHeld<T>>;
+
+/// Storage for a `Choice` with exactly two members, where one member holds a
+/// single `NicheValue` and the other member is void.
+///
+/// There is no separate index. The void member is active when the never-value
+/// field of the `T` is set to its never-value, and the value member is active
+/// otherwise. This makes the `Choice` the same size as the `T`, the way
+/// `Option<T>` is.
+///
+/// The index-based methods mirror those of `Storage`, where `P` is the index of
+/// the value member, and any other index refers to the void member. Leaving
+/// the void member (through `destroy()`) destroys the never-value `T`, so
+/// moving into the void member must be done with `set_niche()`.
+template <size_t P, class T>
+union NicheStorage {
+  using Held = NicheHeld<T>;
+  using Access = ::sus::mem::__private::NeverValueAccess<Held>;
+
+  NicheStorage() {}
+  ~NicheStorage()
+    requires(std::is_trivially_destructible_v<Held>)
+  = default;
+  ~NicheStorage()
+    requires(!std::is_trivially_destructible_v<Held>)
+  {}
+
+  NicheStorage(const NicheStorage&)
+    requires(std::is_trivially_copy_constructible_v<Held>)
+  = default;
+  NicheStorage& operator=(const NicheStorage&)
+    requires(std::is_trivially_copy_assignable_v<Held>)
+  = default;
+  NicheStorage(NicheStorage&&)
+    requires(std::is_trivially_move_constructible_v<Held>)
+  = default;
+  NicheStorage& operator=(NicheStorage&&)
+    requires(std::is_trivially_move_assignable_v<Held>)
+  = default;
+
+  /// Whether the void member is active.
+  inline constexpr bool is_niche() const noexcept {
+    return !access_.is_constructed();
+  }
+  /// Makes the void member active. The value member must not be active.
+  inline void set_niche() noexcept {
+    new (&access_) Access();
+    access_.set_never_value(::sus::marker::unsafe_fn);
+  }
+
+  template <class U>
+  inline void construct(U&& value) {
+    new (&access_) Access(::sus::forward<U>(value));
+  }
+  inline constexpr void assign(T&& value) {
+    if constexpr (std::is_reference_v<T>)
+      access_.as_inner_mut() = Held(value);
+    else
+      access_.as_inner_mut() = ::sus::move(value);
+  }
+  inline void move_construct(size_t index, NicheStorage&& from) {
+    if (index == P)
+      new (&access_) Access(::sus::move(from.access_.as_inner_mut()));
+  }
+  inline constexpr void move_assign(size_t index, NicheStorage&& from) {
+    if (index == P)
+      access_.as_inner_mut() = ::sus::move(from.access_.as_inner_mut());
+  }
+  inline void copy_construct(size_t index, const NicheStorage& from) {
+    if (index == P) new (&access_) Access(from.access_.as_inner());
+  }
+  inline constexpr void copy_assign(size_t index, const NicheStorage& from) {
+    if (index == P) access_.as_inner_mut() = from.access_.as_inner();
+  }
+  inline void clone_construct(size_t index, const NicheStorage& from) {
+    if (index == P)
+      new (&access_) Access(::sus::clone(from.access_.as_inner()));
+  }
+  inline constexpr void destroy(size_t index) {
+    if (index != P) access_.set_destroy_value(::sus::marker::unsafe_fn);
+    access_.~Access();
+  }
+  inline constexpr bool eq(size_t index, const NicheStorage& other) const& {
+    if (index != P) return true;
+    return as() == other.as();
+  }
+  inline constexpr auto ord(size_t index, const NicheStorage& other) const& {
+    if (index != P) return std::strong_ordering::equivalent;
+    return std::strong_order(as(), other.as());
+  }
+  inline constexpr auto weak_ord(size_t index,
+                                 const NicheStorage& other) const& {
+    if (index != P) return std::weak_ordering::equivalent;
+    return std::weak_order(as(), other.as());
+  }
+  inline constexpr auto partial_ord(size_t index,
+                                    const NicheStorage& other) const& {
+    if (index != P) return std::partial_ordering::equivalent;
+    return std::partial_order(as(), other.as());
+  }
+
+  inline constexpr const std::remove_reference_t<T>& as() const& {
+    return access_.as_inner();
+  }
+  inline constexpr std::remove_reference_t<T>& as_mut() & {
+    return access_.as_inner_mut();
+  }
+  inline constexpr T&& into_inner() && {
+    return static_cast<T&&>(access_.as_inner_mut());
+  }
+
+  Access access_;
+};
+
+/// Chooses the storage for a `Choice` over the member storage types `Ts...`
+/// (each a `Tuple` or `Nothing`).
+///
+/// A `Choice` with one `NicheValue` member and one void member uses
+/// `NicheStorage`, and keeps its index in the niche of the value. Any other
+/// `Choice` uses `Storage` along with a separate index.
+template <class... Ts>
+struct ChoiceStorage {
+  static constexpr bool kIndexInNiche = false;
+  using type = Storage<0, Ts...>;
+};
+
+template <class T>
+  requires(NicheValue<T>)
+struct ChoiceStorage<::sus::Tuple<T>, Nothing> {
+  static constexpr bool kIndexInNiche = true;
+  static constexpr size_t kVoidIndex = 1u;
+  using type = NicheStorage<0u, T>;
+};
+
+template <class T>
+  requires(NicheValue<T>)
+struct ChoiceStorage<Nothing, ::sus::Tuple<T>> {
+  static constexpr bool kIndexInNiche = true;
+  static constexpr size_t kVoidIndex = 0u;
+  using type = NicheStorage<1u, T>;
+};
+
+/// The type of the `index_` field in a `Choice` which keeps its index in the
+/// niche of its value.
+struct IndexInNiche {};
+
+// The value in a `NicheStorage` is accessed directly, rather than by walking
+// through the union members as in `Storage`.
+template <auto I, size_t P, class T>
+static constexpr const auto& find_choice_storage(
+    const NicheStorage<P, T>& storage) {
+  static_assert(size_t{I} == P);
+  return storage;
+}
+
+template <auto I, size_t P, class T>
+static constexpr auto& find_choice_storage_mut(NicheStorage<P, T>& storage) {
+  static_assert(size_t{I} == P);
+  return storage;
+}
+
+}  // namespace sus::choice_type::__private
@@ -22,6 +22,7 @@
 #include "subspace/choice/__private/index_of_value.h"
 #include "subspace/choice/__private/index_type.h"
 #include "subspace/choice/__private/marker.h"
+#include "subspace/choice/__private/niche_storage.h"
 #include "subspace/choice/__private/ops_concepts.h"
 #include "subspace/choice/__private/pack_index.h"
 #include "subspace/choice/__private/storage.h"
@@ -54,7 +55,12 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
       "The number of types and values in the Choice don't match. Use "
       "`sus_choice_types()` to define the Choice's value-type pairings.");
 
-  using Storage = __private::Storage<0, Ts...>;
+  // A Choice with one member whose value has a never-value field, and one
+  // void member, stores its index in that never-value field. Otherwise, the
+  // index is stored separately beside the Storage.
+  using ChoiceStorage = __private::ChoiceStorage<Ts...>;
+  static constexpr bool kIndexInNiche = ChoiceStorage::kIndexInNiche;
+  using Storage = ChoiceStorage::type;
   using TagsType = __private::PackFirst<decltype(Tags)...>;
 
   static_assert((... && std::same_as<TagsType, decltype(Tags)>),
@@ -174,8 +180,8 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
     requires(!(std::is_trivially_destructible_v<TagsType> && ... &&
                std::is_trivially_destructible_v<Ts>))
   {
-    if (index_ != kUseAfterMove && index_ != kNeverValue)
-      storage_.destroy(size_t{index_});
+    const IndexType i = get_index();
+    if (i != kUseAfterMove && i != kNeverValue) storage_.destroy(size_t{i});
   }
 
   constexpr Choice(Choice&& o) noexcept
@@ -191,12 +197,13 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
     requires((... && ::sus::mem::Move<Ts>) &&
              !(std::is_trivially_move_constructible_v<TagsType> && ... &&
                std::is_trivially_move_constructible_v<Ts>))
-      : index_(::sus::mem::replace(::sus::mref(o.index_),
-                                   // Attempt to catch use-after-move by setting
-                                   // the tag to an unused value.
-                                   kUseAfterMove)) {
-    check(index_ != kUseAfterMove);
-    storage_.move_construct(size_t{index_}, ::sus::move(o.storage_));
+  {
+    const IndexType i = o.get_index();
+    // Attempt to catch use-after-move by setting the tag to an unused value.
+    o.set_index(kUseAfterMove);
+    check(i != kUseAfterMove);
+    set_index(i);
+    storage_.move_construct(size_t{i}, ::sus::move(o.storage_));
   }
 
   constexpr Choice& operator=(Choice&& o) noexcept
@@ -213,15 +220,16 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
              !(std::is_trivially_move_assignable_v<TagsType> && ... &&
                std::is_trivially_move_assignable_v<Ts>))
   {
-    check(o.index_ != kUseAfterMove);
-    if (index_ == o.index_) {
-      storage_.move_assign(size_t{index_}, ::sus::move(o.storage_));
+    const IndexType i = o.get_index();
+    check(i != kUseAfterMove);
+    if (get_index() == i) {
+      storage_.move_assign(size_t{i}, ::sus::move(o.storage_));
     } else {
-      if (index_ != kUseAfterMove) storage_.destroy(size_t{index_});
-      index_ = ::sus::move(o.index_);
-      storage_.move_construct(size_t{index_}, ::sus::move(o.storage_));
+      if (get_index() != kUseAfterMove) storage_.destroy(size_t{get_index()});
+      set_index(i);
+      storage_.move_construct(size_t{i}, ::sus::move(o.storage_));
     }
-    o.index_ = kUseAfterMove;
+    o.set_index(kUseAfterMove);
     return *this;
   }
 
@@ -238,9 +246,11 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
     requires((... && ::sus::mem::Copy<Ts>) &&
              !(std::is_trivially_copy_constructible_v<TagsType> && ... &&
                std::is_trivially_copy_constructible_v<Ts>))
-      : index_(o.index_) {
-    check(o.index_ != kUseAfterMove);
-    storage_.copy_construct(size_t{index_}, o.storage_);
+  {
+    const IndexType i = o.get_index();
+    check(i != kUseAfterMove);
+    set_index(i);
+    storage_.copy_construct(size_t{i}, o.storage_);
   }
 
   constexpr Choice& operator=(const Choice& o)
@@ -257,13 +267,14 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
              !(std::is_trivially_copy_assignable_v<TagsType> && ... &&
                std::is_trivially_copy_assignable_v<Ts>))
   {
-    check(o.index_ != kUseAfterMove);
-    if (index_ == o.index_) {
-      storage_.copy_assign(size_t{index_}, o.storage_);
+    const IndexType i = o.get_index();
+    check(i != kUseAfterMove);
+    if (get_index() == i) {
+      storage_.copy_assign(size_t{i}, o.storage_);
     } else {
-      if (index_ != kUseAfterMove) storage_.destroy(size_t{index_});
-      index_ = o.index_;
-      storage_.copy_construct(size_t{index_}, o.storage_);
+      if (get_index() != kUseAfterMove) storage_.destroy(size_t{get_index()});
+      set_index(i);
+      storage_.copy_construct(size_t{i}, o.storage_);
     }
     return *this;
   }
@@ -272,9 +283,10 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
   constexpr Choice clone() const& noexcept
     requires((... && ::sus::mem::Clone<Ts>) && !(... && ::sus::mem::Copy<Ts>))
   {
-    check(index_ != kUseAfterMove);
-    auto u = Choice(::sus::clone(index_));
-    u.storage_.clone_construct(size_t{index_}, storage_);
+    const IndexType i = get_index();
+    check(i != kUseAfterMove);
+    auto u = Choice(i);
+    u.storage_.clone_construct(size_t{i}, storage_);
     return u;
   }
 
@@ -332,9 +344,10 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
   ///                             ████
   /// ```
   constexpr inline TagsType which() const& noexcept {
-    check(index_ != kUseAfterMove);
+    const IndexType i = get_index();
+    check(i != kUseAfterMove);
     constexpr TagsType tags[] = {Tags...};
-    return tags[size_t{index_}];
+    return tags[size_t{i}];
   }
 
   /// Returns a const reference to the value(s) inside the Choice.
@@ -352,7 +365,7 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
   template <TagsType V>
     requires(__private::ValueIsNotVoid<StorageTypeOfTag<V>>)
   constexpr inline decltype(auto) as() const& noexcept {
-    ::sus::check(index_ == index<V>);
+    ::sus::check(get_index() == index<V>);
     return __private::find_choice_storage<index<V>>(storage_).as();
   }
   // If the storage is a value type, it can't be accessed by reference in an
@@ -376,7 +389,7 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
   template <TagsType V>
     requires(__private::ValueIsNotVoid<StorageTypeOfTag<V>>)
   constexpr inline decltype(auto) as_mut() & noexcept {
-    ::sus::check(index_ == index<V>);
+    ::sus::check(get_index() == index<V>);
     return __private::find_choice_storage_mut<index<V>>(storage_).as_mut();
   }
 
@@ -395,7 +408,7 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
   template <TagsType V>
     requires(__private::ValueIsNotVoid<StorageTypeOfTag<V>>)
   constexpr inline decltype(auto) into_inner() && noexcept {
-    ::sus::check(index_ == index<V>);
+    ::sus::check(get_index() == index<V>);
     auto& s = __private::find_choice_storage_mut<index<V>>(storage_);
     return ::sus::move(s).into_inner();
   }
@@ -411,7 +424,7 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
   template <TagsType V>
     requires(__private::ValueIsNotVoid<StorageTypeOfTag<V>>)
   constexpr inline Option<AccessTypeOfTagConst<V>> get() const& noexcept {
-    if (index_ != index<V>) return ::sus::none();
+    if (get_index() != index<V>) return ::sus::none();
     return ::sus::some(__private::find_choice_storage<index<V>>(storage_).as());
   }
   // If the storage is a value type, it can't be accessed by reference in an
@@ -431,7 +444,7 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
   template <TagsType V>
     requires(__private::ValueIsNotVoid<StorageTypeOfTag<V>>)
   constexpr inline Option<AccessTypeOfTagMut<V>> get_mut() & noexcept {
-    if (index_ != index<V>) return ::sus::none();
+    if (get_index() != index<V>) return ::sus::none();
     return ::sus::some(
         __private::find_choice_storage_mut<index<V>>(storage_).as_mut());
   }
@@ -440,12 +453,12 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
     requires(std::convertible_to<U &&, Arg> &&
              __private::ValueIsNotVoid<StorageTypeOfTag<V>>)
   void set(U&& values) & noexcept {
-    if (index_ == index<V>) {
+    if (get_index() == index<V>) {
       __private::find_choice_storage_mut<index<V>>(storage_).assign(
           ::sus::move(values));
     } else {
-      if (index_ != kUseAfterMove) storage_.destroy(size_t{index_});
-      index_ = index<V>;
+      if (get_index() != kUseAfterMove) storage_.destroy(size_t{get_index()});
+      set_index(index<V>);
       __private::find_choice_storage_mut<index<V>>(storage_).construct(
           ::sus::move(values));
     }
@@ -498,9 +511,9 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
   template <TagsType V, int&...,
             __private::ValueIsVoid Arg = StorageTypeOfTag<V>>
   void set() & noexcept {
-    if (index_ != index<V>) {
-      if (index_ != kUseAfterMove) storage_.destroy(size_t{index_});
-      index_ = index<V>;
+    if (get_index() != index<V>) {
+      if (get_index() != kUseAfterMove) storage_.destroy(size_t{get_index()});
+      set_index(index<V>);
     }
   }
 
@@ -511,8 +524,10 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
   friend inline constexpr bool operator==(
       const Choice& l,
       const Choice<__private::TypeList<Us...>, V, Vs...>& r) noexcept {
-    check(l.index_ != kUseAfterMove && r.index_ != kUseAfterMove);
-    return l.index_ == r.index_ && l.storage_.eq(size_t{l.index_}, r.storage_);
+    const auto li = l.get_index();
+    const auto ri = r.get_index();
+    check(li != kUseAfterMove && ri != kUseAfterMove);
+    return li == ri && l.storage_.eq(size_t{li}, r.storage_);
   }
 
   template <class... Us, auto V, auto... Vs>
@@ -531,12 +546,12 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
   friend inline constexpr auto operator<=>(
       const Choice& l,
       const Choice<__private::TypeList<Us...>, V, Vs...>& r) noexcept {
-    check(l.index_ != kUseAfterMove && r.index_ != kUseAfterMove);
+    check(l.get_index() != kUseAfterMove && r.get_index() != kUseAfterMove);
     const auto value_order = std::strong_order(l.which(), r.which());
     if (value_order != std::strong_ordering::equivalent) {
       return value_order;
     } else {
-      return l.storage_.ord(size_t{l.index_}, r.storage_);
+      return l.storage_.ord(size_t{l.get_index()}, r.storage_);
     }
   }
 
@@ -550,12 +565,12 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
   friend inline constexpr auto operator<=>(
       const Choice& l,
       const Choice<__private::TypeList<Us...>, V, Vs...>& r) noexcept {
-    check(l.index_ != kUseAfterMove && r.index_ != kUseAfterMove);
+    check(l.get_index() != kUseAfterMove && r.get_index() != kUseAfterMove);
     const auto value_order = std::weak_order(l.which(), r.which());
     if (value_order != std::weak_ordering::equivalent) {
       return value_order;
     } else {
-      return l.storage_.weak_ord(size_t{l.index_}, r.storage_);
+      return l.storage_.weak_ord(size_t{l.get_index()}, r.storage_);
     }
   }
 
@@ -569,12 +584,12 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
   friend inline constexpr auto operator<=>(
       const Choice& l,
       const Choice<__private::TypeList<Us...>, V, Vs...>& r) noexcept {
-    check(l.index_ != kUseAfterMove && r.index_ != kUseAfterMove);
+    check(l.get_index() != kUseAfterMove && r.get_index() != kUseAfterMove);
     const auto value_order = std::partial_order(l.which(), r.which());
     if (value_order != std::partial_ordering::equivalent) {
       return value_order;
     } else {
-      return l.storage_.partial_ord(size_t{l.index_}, r.storage_);
+      return l.storage_.partial_ord(size_t{l.get_index()}, r.storage_);
     }
   }
 
@@ -588,22 +603,69 @@ class Choice<__private::TypeList<Ts...>, Tags...> final {
       delete;
 
  private:
-  constexpr inline Choice(IndexType i) noexcept : index_(i) {}
+  constexpr inline Choice(IndexType i) noexcept { set_index(i); }
+
+  /// Returns the index of the active member.
+  constexpr inline IndexType get_index() const noexcept {
+    if constexpr (kIndexInNiche) {
+      return storage_.is_niche() ? IndexType{ChoiceStorage::kVoidIndex}
+                                 : IndexType{1u - ChoiceStorage::kVoidIndex};
+    } else {
+      return index_;
+    }
+  }
+  /// Sets the index of the active member, which must then be constructed in
+  /// the `storage_` if it has a value.
+  ///
+  /// When the index is kept in the niche, there is no moved-from state. The
+  /// moved-from value stays in the `storage_` to be destroyed, so setting
+  /// `kUseAfterMove` does nothing.
+  constexpr inline void set_index(IndexType i) noexcept {
+    if constexpr (kIndexInNiche) {
+      if (i == IndexType{ChoiceStorage::kVoidIndex}) storage_.set_niche();
+    } else {
+      index_ = i;
+    }
+  }
 
-  // TODO: We don't use `[[sus_no_unique_address]]` here as the compiler
-  // overwrites the `index_` when we move-construct into the Storage union.
+  // TODO: We don't use `[[sus_no_unique_address]]` on `storage_` here as the
+  // compiler overwrites the `index_` when we move-construct into the Storage
+  // union.
   // Clang: https://github.com/llvm/llvm-project/issues/60711
   // GCC: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=108775
   Storage storage_;
-  IndexType index_;
+  // The `index_` takes no space when it is kept in the niche of the value.
+  [[sus_no_unique_address]] std::conditional_t<
+      kIndexInNiche, __private::IndexInNiche, IndexType> index_;
 
   // Declare that this type can always be trivially relocated for library
   // optimizations.
   sus_class_trivially_relocatable_if_types(::sus::marker::unsafe_fn, IndexType,
                                            Ts...);
 
-  sus_class_never_value_field(::sus::marker::unsafe_fn, Choice, index_,
-                              kNeverValue, kNeverValue);
+  // The `index_` is a never-value field, as in
+  // `sus_class_never_value_field()`, unless the index is kept in the niche of
+  // the value. Then the niche is used up and there is no never-value.
+  template <class>
+  friend struct ::sus::mem::__private::NeverValueAccess;
+  constexpr bool _sus_Unsafe_NeverValueIsConstructed(
+      ::sus::marker::UnsafeFnMarker) const noexcept
+    requires(!kIndexInNiche)
+  {
+    return index_ != kNeverValue;
+  }
+  constexpr void _sus_Unsafe_NeverValueSetNeverValue(
+      ::sus::marker::UnsafeFnMarker) noexcept
+    requires(!kIndexInNiche)
+  {
+    index_ = kNeverValue;
+  }
+  constexpr void _sus_Unsafe_NeverValueSetDestroyValue(
+      ::sus::marker::UnsafeFnMarker) noexcept
+    requires(!kIndexInNiche)
+  {
+    index_ = kNeverValue;
+  }
   constexpr Choice() = default;  // For the NeverValueField.
 };
 
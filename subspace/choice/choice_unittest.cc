@@ -17,9 +17,12 @@
 #include <variant>
 
 #include "googletest/include/gtest/gtest.h"
+#include "subspace/boxed/box.h"
+#include "subspace/mem/nonnull.h"
 #include "subspace/num/types.h"
 #include "subspace/option/option.h"
 #include "subspace/prelude.h"
+#include "subspace/rc/rc.h"
 #include "subspace/test/no_copy_move.h"
 
 namespace {
@@ -74,6 +77,90 @@ TEST(Choice, NeverValue) {
   static_assert(sizeof(sus::Option<Two>) == sizeof(Two));
 }
 
+// A Choice with one never-value member and one void member keeps its index in
+// the never-value field, the same as a Rust enum of the same shape.
+static_assert(sizeof(Choice<sus_choice_types((Order::First, sus::Box<i32>),
+                                             (Order::Second, void))>) ==
+              sizeof(void*));
+static_assert(sizeof(Choice<sus_choice_types(
+                  (Order::First, void), (Order::Second, sus::Box<i32>))>) ==
+              sizeof(void*));
+static_assert(sizeof(Choice<sus_choice_types((Order::First, const i32&),
+                                             (Order::Second, void))>) ==
+              sizeof(void*));
+static_assert(sizeof(Choice<sus_choice_types((Order::First, sus::Rc<i32>),
+                                             (Order::Second, void))>) ==
+              sizeof(void*));
+static_assert(sizeof(Choice<sus_choice_types((Order::First,
+                                              sus::mem::NonNull<i32>),
+                                             (Order::Second, void))>) ==
+              sizeof(void*));
+// Other shapes need a separate index.
+static_assert(sizeof(Choice<sus_choice_types((Order::First, sus::Box<i32>),
+                                             (Order::Second, sus::Box<i32>))>) >
+              sizeof(void*));
+static_assert(sizeof(Choice<sus_choice_types((Order::First, sus::Box<i32>),
+                                             (Order::Second, void),
+                                             (Order::Third, void))>) >
+              sizeof(void*));
+static_assert(sizeof(Choice<sus_choice_types((Order::First, u64),
+                                             (Order::Second, void))>) >
+              sizeof(u64));
+
+TEST(Choice, NicheIndex) {
+  using C = Choice<sus_choice_types((Order::First, sus::Rc<i32>),
+                                    (Order::Second, void))>;
+  // The niche is used up by the index, so an Option needs its own flag.
+  static_assert(!sus::mem::NeverValueField<C>);
+  static_assert(sizeof(sus::Option<C>) > sizeof(C));
+
+  auto rc = sus::Rc<i32>::with(3);
+  {
+    auto c = C::with<Order::First>(rc.clone());
+    EXPECT_EQ(c.which(), Order::First);
+    EXPECT_EQ(*c.as<Order::First>(), 3);
+    EXPECT_EQ(rc.strong_count(), 2u);
+
+    c.set<Order::Second>();
+    EXPECT_EQ(c.which(), Order::Second);
+    EXPECT_EQ(c.get<Order::First>().is_none(), true);
+    EXPECT_EQ(rc.strong_count(), 1u);
+
+    c.set<Order::First>(rc.clone());
+    EXPECT_EQ(rc.strong_count(), 2u);
+
+    // Move construct and assign.
+    auto d = sus::move(c);
+    EXPECT_EQ(d.which(), Order::First);
+    EXPECT_EQ(rc.strong_count(), 2u);
+    auto e = C::with<Order::Second>();
+    e = sus::move(d);
+    EXPECT_EQ(e.which(), Order::First);
+    EXPECT_EQ(rc.strong_count(), 2u);
+    e = C::with<Order::Second>();
+    EXPECT_EQ(e.which(), Order::Second);
+    EXPECT_EQ(rc.strong_count(), 1u);
+
+    e.set<Order::First>(rc.clone());
+    sus::Rc<i32> inner = sus::move(e).into_inner<Order::First>();
+    EXPECT_EQ(rc.strong_count(), 2u);
+  }
+  EXPECT_EQ(rc.strong_count(), 1u);
+
+  // References are held as a pointer which is never null.
+  i32 i = 2;
+  using R = Choice<sus_choice_types((Order::First, void),
+                                    (Order::Second, const i32&))>;
+  auto r = R::with<Order::Second>(i);
+  EXPECT_EQ(&r.as<Order::Second>(), &i);
+  auto s = r;
+  EXPECT_EQ(s, r);
+  s = R::with<Order::First>();
+  EXPECT_EQ(s.which(), Order::First);
+  EXPECT_NE(s, r);
+  EXPECT_LT(s, r);
+}
+
 TEST(Choice, ConstructorFunctionNoValue) {
   using U =
       Choice<sus_choice_types((Order::First, u32), (Order::Second, void))>;
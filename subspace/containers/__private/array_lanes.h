@@ -0,0 +1,181 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include "subspace/assertions/check.h"
+#include "subspace/num/__private/intrinsics.h"
+#include "subspace/num/float_concepts.h"
+#include "subspace/num/integer_concepts.h"
+
+// Element-wise ("lane-wise") arithmetic over runs of `sus::num` numbers.
+//
+// Each function is a single loop over the primitive values with no branches
+// in its body, which the compiler can turn into vector instructions for the
+// target (SSE, AVX, NEON, etc.) when it is inlined with a constant `N`.
+// Integer overflow is accumulated across all lanes and checked once after the
+// loop, so that integer arithmetic keeps the same checked semantics as the
+// scalar operators without a branch per element.
+namespace sus::containers::__private {
+
+/// Numeric types which support element-wise arithmetic in an `Array`.
+template <class T>
+concept LaneNumber = ::sus::num::Integer<T> || ::sus::num::Float<T>;
+
+template <size_t N, class T>
+inline void lanes_add(T* out, const T* l, const T* r) noexcept {
+  if constexpr (::sus::num::Integer<T>) {
+    bool overflow = false;
+    for (size_t i = 0u; i < N; ++i) {
+      const auto o = ::sus::num::__private::add_with_overflow(
+          l[i].primitive_value, r[i].primitive_value);
+      out[i].primitive_value = o.value;
+      overflow |= o.overflow;
+    }
+    ::sus::check(!overflow);
+  } else {
+    for (size_t i = 0u; i < N; ++i)
+      out[i].primitive_value = l[i].primitive_value + r[i].primitive_value;
+  }
+}
+
+template <size_t N, class T>
+inline void lanes_sub(T* out, const T* l, const T* r) noexcept {
+  if constexpr (::sus::num::Integer<T>) {
+    bool overflow = false;
+    for (size_t i = 0u; i < N; ++i) {
+      const auto o = ::sus::num::__private::sub_with_overflow(
+          l[i].primitive_value, r[i].primitive_value);
+      out[i].primitive_value = o.value;
+      overflow |= o.overflow;
+    }
+    ::sus::check(!overflow);
+  } else {
+    for (size_t i = 0u; i < N; ++i)
+      out[i].primitive_value = l[i].primitive_value - r[i].primitive_value;
+  }
+}
+
+template <size_t N, class T>
+inline void lanes_mul(T* out, const T* l, const T* r) noexcept {
+  if constexpr (::sus::num::Integer<T>) {
+    bool overflow = false;
+    for (size_t i = 0u; i < N; ++i) {
+      const auto o = ::sus::num::__private::mul_with_overflow(
+          l[i].primitive_value, r[i].primitive_value);
+      out[i].primitive_value = o.value;
+      overflow |= o.overflow;
+    }
+    ::sus::check(!overflow);
+  } else {
+    for (size_t i = 0u; i < N; ++i)
+      out[i].primitive_value = l[i].primitive_value * r[i].primitive_value;
+  }
+}
+
+template <size_t N, class T>
+inline void lanes_div(T* out, const T* l, const T* r) noexcept {
+  if constexpr (::sus::num::Integer<T>) {
+    // Integer division by zero, or of MIN by -1, is Undefined Behaviour, so
+    // every lane is checked before any division is done.
+    bool invalid = false;
+    for (size_t i = 0u; i < N; ++i) {
+      invalid |= r[i].primitive_value == 0;
+      if constexpr (::sus::num::Signed<T>) {
+        invalid |= l[i].primitive_value == T::MIN_PRIMITIVE &&
+                   r[i].primitive_value == -1;
+      }
+    }
+    ::sus::check(!invalid);
+  }
+  for (size_t i = 0u; i < N; ++i) {
+    out[i].primitive_value = static_cast<decltype(T::primitive_value)>(
+        l[i].primitive_value / r[i].primitive_value);
+  }
+}
+
+template <size_t N, class T>
+inline void lanes_mul_add(T* out, const T* s, const T* a,
+                          const T* b) noexcept {
+  if constexpr (::sus::num::Integer<T>) {
+    bool overflow = false;
+    for (size_t i = 0u; i < N; ++i) {
+      const auto m = ::sus::num::__private::mul_with_overflow(
+          s[i].primitive_value, a[i].primitive_value);
+      const auto o = ::sus::num::__private::add_with_overflow(
+          m.value, b[i].primitive_value);
+      out[i].primitive_value = o.value;
+      overflow |= m.overflow | o.overflow;
+    }
+    ::sus::check(!overflow);
+  } else {
+    for (size_t i = 0u; i < N; ++i) out[i] = s[i].mul_add(a[i], b[i]);
+  }
+}
+
+template <size_t N, class T>
+inline void lanes_min(T* out, const T* l, const T* r) noexcept {
+  if constexpr (::sus::num::Integer<T>) {
+    for (size_t i = 0u; i < N; ++i) {
+      out[i].primitive_value = r[i].primitive_value < l[i].primitive_value
+                                   ? r[i].primitive_value
+                                   : l[i].primitive_value;
+    }
+  } else {
+    for (size_t i = 0u; i < N; ++i) out[i] = l[i].min(r[i]);
+  }
+}
+
+template <size_t N, class T>
+inline void lanes_max(T* out, const T* l, const T* r) noexcept {
+  if constexpr (::sus::num::Integer<T>) {
+    for (size_t i = 0u; i < N; ++i) {
+      out[i].primitive_value = r[i].primitive_value > l[i].primitive_value
+                                   ? r[i].primitive_value
+                                   : l[i].primitive_value;
+    }
+  } else {
+    for (size_t i = 0u; i < N; ++i) out[i] = l[i].max(r[i]);
+  }
+}
+
+/// Adds up the `N` values at `l` in order, from the first to the last.
+template <size_t N, class T>
+inline T lanes_sum(const T* l) noexcept {
+  auto sum = decltype(T::primitive_value){0};
+  if constexpr (::sus::num::Integer<T>) {
+    bool overflow = false;
+    for (size_t i = 0u; i < N; ++i) {
+      const auto o =
+          ::sus::num::__private::add_with_overflow(sum, l[i].primitive_value);
+      sum = o.value;
+      overflow |= o.overflow;
+    }
+    ::sus::check(!overflow);
+  } else {
+    for (size_t i = 0u; i < N; ++i) sum += l[i].primitive_value;
+  }
+  return T(sum);
+}
+
+/// Writes `op(l[i], r[i])` for the primitive values in each lane to `mask`.
+template <size_t N, class T, class Op>
+inline void lanes_mask(bool* mask, const T* l, const T* r, Op op) noexcept {
+  for (size_t i = 0u; i < N; ++i)
+    mask[i] = op(l[i].primitive_value, r[i].primitive_value);
+}
+
+}  // namespace sus::containers::__private
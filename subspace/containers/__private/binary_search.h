@@ -0,0 +1,71 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <type_traits>
+
+#include "subspace/macros/builtin.h"
+
+namespace sus::containers::__private {
+
+/// Hints to the CPU that `p` will be read soon.
+inline void prefetch(const void* p) noexcept {
+#if __has_builtin(__builtin_prefetch)
+  __builtin_prefetch(p);
+#else
+  (void)p;
+#endif
+}
+
+/// Below this many elements, the search doesn't prefetch, as the whole slice
+/// is likely already in cache.
+constexpr inline size_t kPrefetchMinLen = 4096u;
+
+/// Returns the number of elements at the front of the `len` elements at `data`
+/// for which `is_before` returns true. The elements must be partitioned so
+/// that `is_before` returns true for every element before those for which it
+/// returns false.
+///
+/// The search does not branch on the result of `is_before`, which lets the
+/// compiler pick between the two halves with a conditional move instead of a
+/// mispredicted branch. For large slices, both of the possible next probes
+/// are prefetched while the current one is compared.
+template <class T, class F>
+constexpr size_t partition_point(const T* data, size_t len,
+                                 F& is_before) noexcept {
+  if (len == 0u) return 0u;
+  const T* base = data;
+  size_t n = len;
+  const bool prefetching =
+      !std::is_constant_evaluated() && len >= kPrefetchMinLen;
+  while (n > 1u) {
+    const size_t half = n / 2u;
+    if (prefetching) {
+      prefetch(base + half / 2u);
+      prefetch(base + half + half / 2u);
+    }
+    // The answer is in `[base, base + n]`. If `base[half]` is before the
+    // partition point, it is in `[base + half + 1, base + n]`, and otherwise
+    // it is in `[base, base + half]`. Both of these are inside a range of
+    // `n - half` elements.
+    base = is_before(base[half]) ? base + half : base;
+    n -= half;
+  }
+  return static_cast<size_t>(base - data) + (is_before(*base) ? 1u : 0u);
+}
+
+}  // namespace sus::containers::__private
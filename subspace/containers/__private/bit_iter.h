@@ -0,0 +1,81 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "subspace/containers/__private/bit_words.h"
+#include "subspace/iter/iterator_defn.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/num/unsigned_integer.h"
+
+namespace sus::containers {
+
+/// An iterator over the indices of the set bits in a `BitVec` or `BitArray`,
+/// in increasing order.
+///
+/// Each step finds the next set bit with a single `trailing_zeros()` on the
+/// current word, skipping over zero words entirely.
+struct [[sus_trivial_abi]] BitOnesIter final
+    : public ::sus::iter::IteratorImpl<BitOnesIter, ::sus::num::usize> {
+ public:
+  using Item = ::sus::num::usize;
+
+  static auto with(const __private::BitWord* words, usize num_words) noexcept {
+    return BitOnesIter(words, num_words.primitive_value);
+  }
+
+  Option<Item> next() noexcept final {
+    while (current_ == 0u) {
+      if (word_index_ + 1u >= num_words_) [[unlikely]]
+        return Option<Item>::none();
+      word_index_ += 1u;
+      current_ = words_[word_index_];
+    }
+    const uint32_t bit = ::sus::num::__private::trailing_zeros_nonzero(
+        ::sus::marker::unsafe_fn, current_);
+    // Clear the lowest set bit.
+    current_ &= current_ - 1u;
+    return Option<Item>::some(word_index_ * __private::kBitsPerWord + bit);
+  }
+
+  ::sus::iter::SizeHint size_hint() noexcept final {
+    size_t remaining = ::sus::num::__private::count_ones(current_);
+    if (word_index_ + 1u < num_words_) {
+      remaining += __private::words_count_ones(words_ + word_index_ + 1u,
+                                               num_words_ - word_index_ - 1u);
+    }
+    return ::sus::iter::SizeHint(
+        remaining, ::sus::Option<::sus::num::usize>::some(remaining));
+  }
+
+ private:
+  BitOnesIter(const __private::BitWord* words, size_t num_words) noexcept
+      : words_(words),
+        num_words_(num_words),
+        word_index_(0u),
+        current_(num_words > 0u ? words[0u] : 0u) {}
+
+  const __private::BitWord* words_;
+  size_t num_words_;
+  size_t word_index_;
+  __private::BitWord current_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(words_),
+                                  decltype(num_words_), decltype(word_index_),
+                                  decltype(current_));
+};
+
+}  // namespace sus::containers
@@ -0,0 +1,133 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subspace/macros/always_inline.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/num/__private/intrinsics.h"
+
+// Word-wise operations shared by BitVec and BitArray.
+//
+// The bulk operations are written as simple counted loops over the words with
+// no early exits, so that the compiler is able to vectorize them.
+namespace sus::containers::__private {
+
+using BitWord = uint64_t;
+
+inline constexpr size_t kBitsPerWord = 64u;
+
+/// The number of words needed to hold `bits` bits.
+sus_always_inline constexpr size_t words_for_bits(size_t bits) noexcept {
+  return (bits + (kBitsPerWord - 1u)) / kBitsPerWord;
+}
+
+/// The mask of valid bits in the last word of a bitset with `bits` bits. All
+/// bits are valid if `bits` is a multiple of the word size.
+sus_always_inline constexpr BitWord last_word_mask(size_t bits) noexcept {
+  const size_t rem = bits % kBitsPerWord;
+  return rem == 0u ? ~BitWord{0} : (BitWord{1} << rem) - 1u;
+}
+
+sus_always_inline constexpr bool bit_get(const BitWord* words,
+                                         size_t i) noexcept {
+  return ((words[i / kBitsPerWord] >> (i % kBitsPerWord)) & 1u) != 0u;
+}
+
+sus_always_inline constexpr void bit_set(BitWord* words, size_t i,
+                                         bool value) noexcept {
+  const BitWord mask = BitWord{1} << (i % kBitsPerWord);
+  if (value)
+    words[i / kBitsPerWord] |= mask;
+  else
+    words[i / kBitsPerWord] &= ~mask;
+}
+
+constexpr inline void words_and(BitWord* dst, const BitWord* src,
+                                size_t n) noexcept {
+  for (size_t i = 0u; i < n; ++i) dst[i] &= src[i];
+}
+
+constexpr inline void words_or(BitWord* dst, const BitWord* src,
+                               size_t n) noexcept {
+  for (size_t i = 0u; i < n; ++i) dst[i] |= src[i];
+}
+
+constexpr inline void words_xor(BitWord* dst, const BitWord* src,
+                                size_t n) noexcept {
+  for (size_t i = 0u; i < n; ++i) dst[i] ^= src[i];
+}
+
+constexpr inline void words_and_not(BitWord* dst, const BitWord* src,
+                                    size_t n) noexcept {
+  for (size_t i = 0u; i < n; ++i) dst[i] &= ~src[i];
+}
+
+constexpr inline void words_not(BitWord* dst, size_t n) noexcept {
+  for (size_t i = 0u; i < n; ++i) dst[i] = ~dst[i];
+}
+
+constexpr inline void words_fill(BitWord* dst, size_t n,
+                                 BitWord value) noexcept {
+  for (size_t i = 0u; i < n; ++i) dst[i] = value;
+}
+
+constexpr inline size_t words_count_ones(const BitWord* words,
+                                         size_t n) noexcept {
+  size_t count = 0u;
+  for (size_t i = 0u; i < n; ++i)
+    count += ::sus::num::__private::count_ones(words[i]);
+  return count;
+}
+
+constexpr inline bool words_any(const BitWord* words, size_t n) noexcept {
+  BitWord acc = 0u;
+  for (size_t i = 0u; i < n; ++i) acc |= words[i];
+  return acc != 0u;
+}
+
+constexpr inline bool words_eq(const BitWord* l, const BitWord* r,
+                               size_t n) noexcept {
+  BitWord acc = 0u;
+  for (size_t i = 0u; i < n; ++i) acc |= l[i] ^ r[i];
+  return acc == 0u;
+}
+
+/// Finds the index of the first set bit at or after bit `start`, within a
+/// bitset of `bits` bits. Returns `bits` if there is no such bit.
+///
+/// Bits past the end of the bitset in the last word must be zero.
+constexpr inline size_t words_find_set(const BitWord* words, size_t bits,
+                                       size_t start) noexcept {
+  if (start >= bits) return bits;
+  const size_t n = words_for_bits(bits);
+  size_t w = start / kBitsPerWord;
+  // Mask off the bits before `start` in its word.
+  BitWord word = words[w] & (~BitWord{0} << (start % kBitsPerWord));
+  while (true) {
+    if (word != 0u) {
+      return w * kBitsPerWord +
+             ::sus::num::__private::trailing_zeros_nonzero(
+                 ::sus::marker::unsafe_fn, word);
+    }
+    w += 1u;
+    if (w == n) return bits;
+    word = words[w];
+  }
+}
+
+}  // namespace sus::containers::__private
@@ -0,0 +1,372 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/iter/iterator_defn.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/num/unsigned_integer.h"
+
+namespace sus::containers {
+
+template <class T>
+class Slice;
+
+template <class T, size_t N>
+  requires(N <= PTRDIFF_MAX)
+class Array;
+
+/// An iterator over a slice in (non-overlapping) chunks of `chunk_size`
+/// elements, starting at the beginning of the slice.
+///
+/// The last chunk will be shorter than `chunk_size` if the slice's length is
+/// not a multiple of it. See `ChunksExact` for an iterator which yields only
+/// whole chunks.
+///
+/// The `T` is `const` for an iterator that gives const access to the
+/// elements.
+template <class T>
+struct [[sus_trivial_abi]] Chunks final
+    : public ::sus::iter::IteratorImpl<Chunks<T>, Slice<T>> {
+ public:
+  using Item = Slice<T>;
+
+  static constexpr auto with(T* data, usize len, usize chunk_size) noexcept {
+    check(chunk_size > 0u);
+    return Chunks(data, len.primitive_value, chunk_size.primitive_value);
+  }
+
+  Option<Item> next() noexcept final {
+    if (len_ == 0u) [[unlikely]]
+      return Option<Item>::none();
+    const size_t n = len_ < chunk_size_ ? len_ : chunk_size_;
+    auto chunk = Item::from_raw_parts(::sus::marker::unsafe_fn, data_, n);
+    data_ += n;
+    len_ -= n;
+    return Option<Item>::some(chunk);
+  }
+
+  ::sus::iter::SizeHint size_hint() noexcept final {
+    // Rounds up without adding to `len_`, which could overflow.
+    const usize remaining =
+        len_ / chunk_size_ + size_t{len_ % chunk_size_ != 0u};
+    return ::sus::iter::SizeHint(
+        remaining, ::sus::Option<::sus::num::usize>::some(remaining));
+  }
+
+ private:
+  constexpr Chunks(T* data, size_t len, size_t chunk_size) noexcept
+      : data_(data), len_(len), chunk_size_(chunk_size) {}
+
+  T* data_;
+  size_t len_;
+  size_t chunk_size_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(data_),
+                                  decltype(len_), decltype(chunk_size_));
+};
+
+/// An iterator over a slice in (non-overlapping) chunks of exactly
+/// `chunk_size` elements, starting at the beginning of the slice.
+///
+/// When the slice's length is not a multiple of `chunk_size`, the last up to
+/// `chunk_size - 1` elements are not yielded, and can be retrieved from
+/// `remainder()`.
+///
+/// Since every chunk has the same length, a loop over each chunk has a
+/// constant trip count that the compiler can unroll and vectorize.
+///
+/// The `T` is `const` for an iterator that gives const access to the
+/// elements.
+template <class T>
+struct [[sus_trivial_abi]] ChunksExact final
+    : public ::sus::iter::IteratorImpl<ChunksExact<T>, Slice<T>> {
+ public:
+  using Item = Slice<T>;
+
+  static constexpr auto with(T* data, usize len, usize chunk_size) noexcept {
+    check(chunk_size > 0u);
+    return ChunksExact(data, len.primitive_value, chunk_size.primitive_value);
+  }
+
+  Option<Item> next() noexcept final {
+    if (len_ < chunk_size_) [[unlikely]]
+      return Option<Item>::none();
+    auto chunk =
+        Item::from_raw_parts(::sus::marker::unsafe_fn, data_, chunk_size_);
+    data_ += chunk_size_;
+    len_ -= chunk_size_;
+    return Option<Item>::some(chunk);
+  }
+
+  ::sus::iter::SizeHint size_hint() noexcept final {
+    const usize remaining = len_ / chunk_size_;
+    return ::sus::iter::SizeHint(
+        remaining, ::sus::Option<::sus::num::usize>::some(remaining));
+  }
+
+  /// Returns the elements at the end of the slice which do not fill a whole
+  /// chunk, and are not yielded by the iterator.
+  Item remainder() const& noexcept {
+    const size_t rem = len_ % chunk_size_;
+    return Item::from_raw_parts(::sus::marker::unsafe_fn,
+                                data_ + (len_ - rem), rem);
+  }
+
+ private:
+  constexpr ChunksExact(T* data, size_t len, size_t chunk_size) noexcept
+      : data_(data), len_(len), chunk_size_(chunk_size) {}
+
+  T* data_;
+  size_t len_;
+  size_t chunk_size_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(data_),
+                                  decltype(len_), decltype(chunk_size_));
+};
+
+/// An iterator over a slice in (non-overlapping) chunks of `chunk_size`
+/// elements, starting at the end of the slice.
+///
+/// The last chunk, from the front of the slice, will be shorter than
+/// `chunk_size` if the slice's length is not a multiple of it.
+///
+/// The `T` is `const` for an iterator that gives const access to the
+/// elements.
+template <class T>
+struct [[sus_trivial_abi]] RChunks final
+    : public ::sus::iter::IteratorImpl<RChunks<T>, Slice<T>> {
+ public:
+  using Item = Slice<T>;
+
+  static constexpr auto with(T* data, usize len, usize chunk_size) noexcept {
+    check(chunk_size > 0u);
+    return RChunks(data, len.primitive_value, chunk_size.primitive_value);
+  }
+
+  Option<Item> next() noexcept final {
+    if (len_ == 0u) [[unlikely]]
+      return Option<Item>::none();
+    const size_t n = len_ < chunk_size_ ? len_ : chunk_size_;
+    len_ -= n;
+    return Option<Item>::some(
+        Item::from_raw_parts(::sus::marker::unsafe_fn, data_ + len_, n));
+  }
+
+  ::sus::iter::SizeHint size_hint() noexcept final {
+    // Rounds up without adding to `len_`, which could overflow.
+    const usize remaining =
+        len_ / chunk_size_ + size_t{len_ % chunk_size_ != 0u};
+    return ::sus::iter::SizeHint(
+        remaining, ::sus::Option<::sus::num::usize>::some(remaining));
+  }
+
+ private:
+  constexpr RChunks(T* data, size_t len, size_t chunk_size) noexcept
+      : data_(data), len_(len), chunk_size_(chunk_size) {}
+
+  T* data_;
+  size_t len_;
+  size_t chunk_size_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(data_),
+                                  decltype(len_), decltype(chunk_size_));
+};
+
+/// An iterator over overlapping subslices of `size` elements, starting at each
+/// element of the slice in turn.
+///
+/// If the slice is shorter than `size`, the iterator yields nothing.
+///
+/// The `T` is `const` for an iterator that gives const access to the
+/// elements.
+template <class T>
+struct [[sus_trivial_abi]] Windows final
+    : public ::sus::iter::IteratorImpl<Windows<T>, Slice<T>> {
+ public:
+  using Item = Slice<T>;
+
+  static constexpr auto with(T* data, usize len, usize size) noexcept {
+    check(size > 0u);
+    return Windows(data, len.primitive_value, size.primitive_value);
+  }
+
+  Option<Item> next() noexcept final {
+    if (len_ < size_) [[unlikely]]
+      return Option<Item>::none();
+    auto window = Item::from_raw_parts(::sus::marker::unsafe_fn, data_, size_);
+    data_ += 1u;
+    len_ -= 1u;
+    return Option<Item>::some(window);
+  }
+
+  ::sus::iter::SizeHint size_hint() noexcept final {
+    const usize remaining = len_ >= size_ ? len_ - size_ + 1u : 0u;
+    return ::sus::iter::SizeHint(
+        remaining, ::sus::Option<::sus::num::usize>::some(remaining));
+  }
+
+ private:
+  constexpr Windows(T* data, size_t len, size_t size) noexcept
+      : data_(data), len_(len), size_(size) {}
+
+  T* data_;
+  size_t len_;
+  size_t size_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(data_),
+                                  decltype(len_), decltype(size_));
+};
+
+/// An iterator over the subslices of a slice which are separated by elements
+/// that match a predicate. The matched elements are not included in the
+/// subslices.
+///
+/// If the first or last element matches, or two adjacent elements match, an
+/// empty subslice is yielded for the space between them.
+///
+/// The `T` is `const` for an iterator that gives const access to the
+/// elements.
+template <class T, class Pred>
+struct Split final
+    : public ::sus::iter::IteratorImpl<Split<T, Pred>, Slice<T>> {
+ public:
+  using Item = Slice<T>;
+
+  static constexpr auto with(T* data, usize len, Pred pred) noexcept {
+    return Split(data, len.primitive_value, ::sus::move(pred));
+  }
+
+  Option<Item> next() noexcept final {
+    if (finished_) [[unlikely]]
+      return Option<Item>::none();
+    for (size_t i = 0u; i < len_; ++i) {
+      if (pred_(static_cast<const T&>(data_[i]))) {
+        auto part = Item::from_raw_parts(::sus::marker::unsafe_fn, data_, i);
+        data_ += i + 1u;
+        len_ -= i + 1u;
+        return Option<Item>::some(part);
+      }
+    }
+    finished_ = true;
+    return Option<Item>::some(
+        Item::from_raw_parts(::sus::marker::unsafe_fn, data_, len_));
+  }
+
+  ::sus::iter::SizeHint size_hint() noexcept final {
+    if (finished_) {
+      return ::sus::iter::SizeHint(
+          0u, ::sus::Option<::sus::num::usize>::some(0u));
+    }
+    // At least the rest of the slice is yielded, and at most every element
+    // matches.
+    return ::sus::iter::SizeHint(
+        1u, ::sus::Option<::sus::num::usize>::some(len_ + 1u));
+  }
+
+ private:
+  constexpr Split(T* data, size_t len, Pred pred) noexcept
+      : data_(data), len_(len), finished_(false), pred_(::sus::move(pred)) {}
+
+  T* data_;
+  size_t len_;
+  bool finished_;
+  Pred pred_;
+
+  sus_class_trivially_relocatable_if_types(::sus::marker::unsafe_fn,
+                                           decltype(data_), decltype(len_),
+                                           decltype(finished_),
+                                           decltype(pred_));
+};
+
+/// An iterator over a slice in (non-overlapping) chunks of exactly `N`
+/// elements, which yields each chunk as a reference to an `Array<T, N>`.
+///
+/// When the slice's length is not a multiple of `N`, the last up to `N - 1`
+/// elements are not yielded, and can be retrieved from `remainder()`.
+///
+/// As the length of each chunk is part of its type, a loop over the elements
+/// of a chunk has a constant trip count that the compiler can unroll and
+/// vectorize.
+///
+/// The `T` is `const` for an iterator that gives const access to the
+/// elements.
+template <class T, size_t N>
+struct [[sus_trivial_abi]] ArrayChunks final
+    : public ::sus::iter::IteratorImpl<
+          ArrayChunks<T, N>,
+          std::conditional_t<std::is_const_v<T>,
+                             const Array<std::remove_const_t<T>, N>&,
+                             Array<T, N>&>> {
+ public:
+  using Item = std::conditional_t<std::is_const_v<T>,
+                                  const Array<std::remove_const_t<T>, N>&,
+                                  Array<T, N>&>;
+
+ private:
+  // `ArrayType` is an `Array<T, N>`, possibly const.
+  using ArrayType = std::remove_reference_t<Item>;
+
+ public:
+  static constexpr auto with(T* data, usize len) noexcept {
+    return ArrayChunks(data, len.primitive_value);
+  }
+
+  Option<Item> next() noexcept final {
+    // An `Array<T, N>` holds exactly its `N` elements, so a pointer to `N`
+    // contiguous elements can be viewed as a pointer to an `Array`.
+    static_assert(sizeof(ArrayType) == sizeof(T) * N);
+    static_assert(alignof(ArrayType) == alignof(T));
+    if (len_ < N) [[unlikely]]
+      return Option<Item>::none();
+    auto* chunk = reinterpret_cast<ArrayType*>(data_);
+    data_ += N;
+    len_ -= N;
+    return Option<Item>::some(mref(*chunk));
+  }
+
+  ::sus::iter::SizeHint size_hint() noexcept final {
+    const usize remaining = len_ / N;
+    return ::sus::iter::SizeHint(
+        remaining, ::sus::Option<::sus::num::usize>::some(remaining));
+  }
+
+  /// Returns the elements at the end of the slice which do not fill a whole
+  /// chunk, and are not yielded by the iterator.
+  Slice<T> remainder() const& noexcept {
+    const size_t rem = len_ % N;
+    return Slice<T>::from_raw_parts(::sus::marker::unsafe_fn,
+                                    data_ + (len_ - rem), rem);
+  }
+
+ private:
+  constexpr ArrayChunks(T* data, size_t len) noexcept
+      : data_(data), len_(len) {}
+
+  T* data_;
+  size_t len_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(data_),
+                                  decltype(len_));
+};
+
+}  // namespace sus::containers
@@ -0,0 +1,250 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+
+#include <compare>
+#include <concepts>
+#include <type_traits>
+
+#include "subspace/num/integer_concepts.h"
+#include "subspace/ops/ord.h"
+
+namespace sus::containers::__private {
+
+/// Types which are equal exactly when their bytes are equal, so that runs of
+/// them can be compared with memcmp() and searched with memchr().
+///
+/// Floating point types are excluded, as `0.0 == -0.0` and `NaN != NaN`.
+template <class T>
+concept BytewiseEq =
+    std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T> ||
+    ::sus::num::Integer<T>;
+
+/// Types whose ordering is the ordering of their bytes as compared by
+/// memcmp(), which treats each byte as unsigned. Wider integers are excluded
+/// as their bytes are not stored from most to least significant on every
+/// platform.
+template <class T>
+concept BytewiseOrd =
+    sizeof(T) == 1u &&
+    (std::same_as<T, bool> || std::same_as<T, unsigned char> ||
+     std::same_as<T, char8_t> || std::same_as<T, ::sus::num::u8> ||
+     (std::is_unsigned_v<char> && std::same_as<T, char>));
+
+/// Whether slices of `T` and `U` can be compared with memcmp() for equality.
+template <class T, class U>
+concept MemcmpEq =
+    std::same_as<std::remove_const_t<T>, std::remove_const_t<U>> &&
+    BytewiseEq<std::remove_const_t<T>>;
+
+/// Whether slices of `T` and `U` can be compared with memcmp() for ordering.
+template <class T, class U>
+concept MemcmpOrd =
+    std::same_as<std::remove_const_t<T>, std::remove_const_t<U>> &&
+    BytewiseOrd<std::remove_const_t<T>>;
+
+/// Returns whether the `len` elements at `l` and `r` are equal.
+template <class T, class U>
+constexpr bool slice_eq(const T* l, const U* r, size_t len) noexcept {
+  if constexpr (MemcmpEq<T, U>) {
+    if (!std::is_constant_evaluated()) {
+      return len == 0u || memcmp(l, r, len * sizeof(T)) == 0;
+    }
+  }
+  for (size_t i = 0u; i < len; ++i) {
+    if (!(l[i] == r[i])) return false;
+  }
+  return true;
+}
+
+/// Lexicographically compares the `llen` elements at `l` with the `rlen`
+/// elements at `r`, returning an ordering of the same type as `equal`.
+template <class Ordering, class T, class U>
+constexpr Ordering slice_cmp(Ordering equal, const T* l, size_t llen,
+                             const U* r, size_t rlen) noexcept {
+  const size_t len = llen < rlen ? llen : rlen;
+  if constexpr (MemcmpOrd<T, U>) {
+    if (!std::is_constant_evaluated()) {
+      if (len > 0u) {
+        if (const int c = memcmp(l, r, len); c != 0)
+          return c < 0 ? Ordering::less : Ordering::greater;
+      }
+      return llen <=> rlen;
+    }
+  }
+  for (size_t i = 0u; i < len; ++i) {
+    auto c = l[i] <=> r[i];
+    // Allow downgrading from equal to equivalent, but not the inverse.
+    if (c != 0) return c;
+  }
+  if (llen != rlen) return llen <=> rlen;
+  return equal;
+}
+
+/// Returns the index of the first element equal to `value` in the `len`
+/// elements at `data`, or `len` if there is none.
+template <class T, class V>
+constexpr size_t slice_find(const T* data, size_t len,
+                            const V& value) noexcept {
+  size_t i = 0u;
+  if constexpr (MemcmpEq<T, V>) {
+    if (!std::is_constant_evaluated()) {
+      if constexpr (sizeof(V) == 1u) {
+        unsigned char byte;
+        memcpy(&byte, &value, 1u);
+        const void* found = len > 0u ? memchr(data, byte, len) : nullptr;
+        if (found == nullptr) return len;
+        return static_cast<size_t>(static_cast<const T*>(found) - data);
+      } else {
+        // Compare a whole block of elements without branching on each one,
+        // which the compiler can vectorize, and only look for the position
+        // of the match inside a block that has one.
+        constexpr size_t kBlock = 32u / sizeof(V) > 4u ? 32u / sizeof(V) : 4u;
+        for (; i + kBlock <= len; i += kBlock) {
+          bool any = false;
+          for (size_t j = 0u; j < kBlock; ++j) any |= data[i + j] == value;
+          if (any) break;
+        }
+      }
+    }
+  }
+  for (; i < len; ++i) {
+    if (data[i] == value) return i;
+  }
+  return len;
+}
+
+/// Returns the start and period of the maximal suffix of the `nlen` elements
+/// at `needle`, under the elements' ordering if `reversed` is false, or under
+/// the reverse of it otherwise.
+template <class U>
+constexpr void slice_maximal_suffix(const U* needle, size_t nlen, bool reversed,
+                                    size_t& start, size_t& period) noexcept {
+  size_t left = 0u;
+  size_t right = 1u;
+  size_t offset = 0u;
+  period = 1u;
+  while (right + offset < nlen) {
+    const U& a = needle[right + offset];
+    const U& b = needle[left + offset];
+    if (reversed ? b < a : a < b) {
+      // The suffix is smaller, so the period is the whole prefix so far.
+      right += offset + 1u;
+      offset = 0u;
+      period = right - left;
+    } else if (a == b) {
+      // Advance through a repetition of the current period.
+      if (offset + 1u == period) {
+        right += offset + 1u;
+        offset = 0u;
+      } else {
+        offset += 1u;
+      }
+    } else {
+      // The suffix is larger, so start over from here.
+      left = right;
+      right += 1u;
+      offset = 0u;
+      period = 1u;
+    }
+  }
+  start = left;
+}
+
+/// Returns the index of the first occurrence of the `nlen` elements at
+/// `needle` in the `len` elements at `data`, or `len` if there is none.
+///
+/// When the elements of the needle have a total order, this is the two-way
+/// algorithm of Crochemore and Perrin, which takes linear time and constant
+/// space. The needle is split at a critical factorization, its right half is
+/// compared from left to right and then its left half from right to left, and
+/// the amount to shift by on a mismatch is known from the needle's period.
+/// Each position where the right half could start is found with
+/// `slice_find()`, which uses memchr() for byte-sized elements.
+///
+/// Otherwise, each candidate is found by searching for the first element of
+/// the needle, and then the rest of the needle is compared with `slice_eq()`,
+/// which can take O(len * nlen) time.
+template <class T, class U>
+constexpr size_t slice_find_subslice(const T* data, size_t len,
+                                     const U* needle, size_t nlen) noexcept {
+  if (nlen == 0u) return 0u;
+  if (nlen > len) return len;
+  const size_t last = len - nlen;
+
+  if constexpr (!::sus::ops::Ord<std::remove_const_t<U>>) {
+    size_t i = 0u;
+    while (i <= last) {
+      const size_t found = i + slice_find(data + i, last - i + 1u, needle[0u]);
+      if (found > last) break;
+      if (slice_eq(data + found + 1u, needle + 1u, nlen - 1u)) return found;
+      i = found + 1u;
+    }
+    return len;
+  } else {
+    // The critical factorization is the later of the maximal suffixes under
+    // the ordering and under its reverse.
+    size_t crit, period;
+    slice_maximal_suffix(needle, nlen, false, crit, period);
+    {
+      size_t crit_rev, period_rev;
+      slice_maximal_suffix(needle, nlen, true, crit_rev, period_rev);
+      if (crit_rev > crit) {
+        crit = crit_rev;
+        period = period_rev;
+      }
+    }
+    // If the left half repeats at the period, the needle is periodic and a
+    // match's overlap with the next window is remembered in `memory`, so it is
+    // not compared again. Otherwise any period longer than either half works.
+    const bool periodic =
+        period + crit <= nlen && slice_eq(needle, needle + period, crit);
+    if (!periodic) period = (crit > nlen - crit ? crit : nlen - crit) + 1u;
+
+    size_t pos = 0u;
+    size_t memory = 0u;
+    while (pos <= last) {
+      size_t i = crit > memory ? crit : memory;
+      if (memory == 0u) {
+        // Each position where the first element of the right half does not
+        // match would be shifted past one at a time, so skip ahead to where
+        // it does.
+        const size_t found =
+            pos + crit +
+            slice_find(data + pos + crit, last - pos + 1u, needle[crit]);
+        if (found > last + crit) break;
+        pos = found - crit;
+        i = crit + 1u;
+      }
+      while (i < nlen && data[pos + i] == needle[i]) ++i;
+      if (i < nlen) {
+        pos += i - crit + 1u;
+        memory = 0u;
+        continue;
+      }
+      size_t j = crit;
+      while (j > memory && data[pos + j - 1u] == needle[j - 1u]) --j;
+      if (j <= memory) return pos;
+      pos += period;
+      if (periodic) memory = nlen - period;
+    }
+    return len;
+  }
+}
+
+}  // namespace sus::containers::__private
@@ -0,0 +1,82 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+
+#include <type_traits>
+
+#include "subspace/num/__private/intrinsics.h"
+
+// Byte order conversion over runs of `sus::num` integers.
+//
+// Each function is a single loop that loads, byte-swaps and stores one
+// integer per iteration, with no branches in its body. Compilers turn this
+// into vector byte shuffles (such as `pshufb` or `rev`) that convert several
+// integers per instruction.
+namespace sus::containers::__private {
+
+template <class T>
+using EndianPrimitive = std::make_unsigned_t<decltype(T::primitive_value)>;
+
+/// Reverses the bytes of each of the `len` integers at `data`.
+template <class T>
+inline void swap_bytes_in_place(T* data, size_t len) noexcept {
+  using U = EndianPrimitive<T>;
+  if constexpr (sizeof(U) > 1u) {
+    for (size_t i = 0u; i < len; ++i) {
+      const U swapped = ::sus::num::__private::swap_bytes(
+          static_cast<U>(data[i].primitive_value));
+      data[i].primitive_value =
+          static_cast<decltype(T::primitive_value)>(swapped);
+    }
+  }
+}
+
+/// Reads `len` integers from the `len * sizeof(T)` bytes at `bytes` into
+/// `out`, reversing the bytes of each if `swap` is true.
+template <class T, class Byte>
+inline void copy_from_bytes(T* out, const Byte* bytes, size_t len,
+                            bool swap) noexcept {
+  static_assert(sizeof(Byte) == 1u);
+  using U = EndianPrimitive<T>;
+  for (size_t i = 0u; i < len; ++i) {
+    U val;
+    memcpy(&val, bytes + i * sizeof(U), sizeof(U));
+    if constexpr (sizeof(U) > 1u) {
+      if (swap) val = ::sus::num::__private::swap_bytes(val);
+    }
+    out[i].primitive_value = static_cast<decltype(T::primitive_value)>(val);
+  }
+}
+
+/// Writes the `len` integers at `data` to the `len * sizeof(T)` bytes at
+/// `out`, reversing the bytes of each if `swap` is true.
+template <class T, class Byte>
+inline void copy_to_bytes(Byte* out, const T* data, size_t len,
+                          bool swap) noexcept {
+  static_assert(sizeof(Byte) == 1u);
+  using U = EndianPrimitive<T>;
+  for (size_t i = 0u; i < len; ++i) {
+    U val = static_cast<U>(data[i].primitive_value);
+    if constexpr (sizeof(U) > 1u) {
+      if (swap) val = ::sus::num::__private::swap_bytes(val);
+    }
+    memcpy(out + i * sizeof(U), &val, sizeof(U));
+  }
+}
+
+}  // namespace sus::containers::__private
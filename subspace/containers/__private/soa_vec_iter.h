@@ -0,0 +1,124 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <type_traits>
+#include <utility>
+
+#include "subspace/iter/iterator_defn.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/tuple/tuple.h"
+
+namespace sus::containers {
+
+/// An iterator over the rows of a `SoaVec`, which yields a `Tuple` of const
+/// references to the elements of each row.
+template <class... Ts>
+struct [[sus_trivial_abi]] SoaVecIter final
+    : public ::sus::iter::IteratorImpl<SoaVecIter<Ts...>,
+                                       ::sus::Tuple<const Ts&...>> {
+ public:
+  using Item = ::sus::Tuple<const Ts&...>;
+
+  static constexpr auto with(::sus::Tuple<const Ts*...> columns,
+                             usize len) noexcept {
+    return SoaVecIter(columns, len);
+  }
+
+  Option<Item> next() noexcept final {
+    if (index_ == len_) [[unlikely]]
+      return Option<Item>::none();
+    const size_t i = index_;
+    index_ += 1u;
+    return Option<Item>::some(
+        row(i, std::make_index_sequence<sizeof...(Ts)>()));
+  }
+
+  ::sus::iter::SizeHint size_hint() noexcept final {
+    const usize remaining = len_ - index_;
+    return ::sus::iter::SizeHint(
+        remaining, ::sus::Option<::sus::num::usize>::some(remaining));
+  }
+
+ private:
+  constexpr SoaVecIter(::sus::Tuple<const Ts*...> columns, usize len) noexcept
+      : columns_(columns), index_(0u), len_(len.primitive_value) {}
+
+  template <size_t... Is>
+  constexpr Item row(size_t i, std::index_sequence<Is...>) const noexcept {
+    return Item::with(columns_.template at<Is>()[i]...);
+  }
+
+  ::sus::Tuple<const Ts*...> columns_;
+  size_t index_;
+  size_t len_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn,
+                                  decltype(columns_), decltype(index_),
+                                  decltype(len_));
+};
+
+/// An iterator over the rows of a `SoaVec`, which yields a `Tuple` of mutable
+/// references to the elements of each row.
+template <class... Ts>
+struct [[sus_trivial_abi]] SoaVecIterMut final
+    : public ::sus::iter::IteratorImpl<SoaVecIterMut<Ts...>,
+                                       ::sus::Tuple<Ts&...>> {
+ public:
+  using Item = ::sus::Tuple<Ts&...>;
+
+  static constexpr auto with(::sus::Tuple<Ts*...> columns,
+                             usize len) noexcept {
+    return SoaVecIterMut(columns, len);
+  }
+
+  Option<Item> next() noexcept final {
+    if (index_ == len_) [[unlikely]]
+      return Option<Item>::none();
+    const size_t i = index_;
+    index_ += 1u;
+    return Option<Item>::some(
+        row(i, std::make_index_sequence<sizeof...(Ts)>()));
+  }
+
+  ::sus::iter::SizeHint size_hint() noexcept final {
+    const usize remaining = len_ - index_;
+    return ::sus::iter::SizeHint(
+        remaining, ::sus::Option<::sus::num::usize>::some(remaining));
+  }
+
+ private:
+  constexpr SoaVecIterMut(::sus::Tuple<Ts*...> columns, usize len) noexcept
+      : columns_(columns), index_(0u), len_(len.primitive_value) {}
+
+  template <size_t... Is>
+  constexpr Item row(size_t i, std::index_sequence<Is...>) const noexcept {
+    return Item::with(mref(columns_.template at<Is>()[i])...);
+  }
+
+  ::sus::Tuple<Ts*...> columns_;
+  size_t index_;
+  size_t len_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn,
+                                  decltype(columns_), decltype(index_),
+                                  decltype(len_));
+};
+
+}  // namespace sus::containers
@@ -23,7 +23,9 @@
 #include "subspace/assertions/check.h"
 #include "subspace/construct/default.h"
 #include "subspace/containers/__private/array_iter.h"
+#include "subspace/containers/__private/array_lanes.h"
 #include "subspace/containers/__private/array_marker.h"
+#include "subspace/containers/__private/slice_cmp.h"
 #include "subspace/containers/__private/slice_iter.h"
 #include "subspace/containers/slice.h"
 #include "subspace/fn/callable.h"
@@ -289,12 +291,235 @@ class Array final {
     });
   }
 
+  /// Element-wise addition of two arrays of numbers.
+  ///
+  /// The additions are done without branching on each element, which allows
+  /// the compiler to use vector instructions.
+  ///
+  /// # Panics
+  /// For integers, panics if the addition of any element overflows, after
+  /// computing all elements.
+  friend Array operator+(const Array& l, const Array& r) noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto out = Array();
+    __private::lanes_add<N>(out.as_mut_ptr(), l.as_ptr(), r.as_ptr());
+    return out;
+  }
+  /// Element-wise subtraction of two arrays of numbers.
+  ///
+  /// # Panics
+  /// For integers, panics if the subtraction of any element overflows.
+  friend Array operator-(const Array& l, const Array& r) noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto out = Array();
+    __private::lanes_sub<N>(out.as_mut_ptr(), l.as_ptr(), r.as_ptr());
+    return out;
+  }
+  /// Element-wise multiplication of two arrays of numbers.
+  ///
+  /// # Panics
+  /// For integers, panics if the multiplication of any element overflows.
+  friend Array operator*(const Array& l, const Array& r) noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto out = Array();
+    __private::lanes_mul<N>(out.as_mut_ptr(), l.as_ptr(), r.as_ptr());
+    return out;
+  }
+  /// Element-wise division of two arrays of numbers.
+  ///
+  /// # Panics
+  /// For integers, panics if any element of `r` is zero, or if the division
+  /// of any element overflows. Every element is checked before dividing.
+  friend Array operator/(const Array& l, const Array& r) noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto out = Array();
+    __private::lanes_div<N>(out.as_mut_ptr(), l.as_ptr(), r.as_ptr());
+    return out;
+  }
+
+  /// Element-wise addition of `r` into this array of numbers.
+  ///
+  /// # Panics
+  /// For integers, panics if the addition of any element overflows.
+  void operator+=(const Array& r) & noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    __private::lanes_add<N>(as_mut_ptr(), as_ptr(), r.as_ptr());
+  }
+  /// Element-wise subtraction of `r` from this array of numbers.
+  ///
+  /// # Panics
+  /// For integers, panics if the subtraction of any element overflows.
+  void operator-=(const Array& r) & noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    __private::lanes_sub<N>(as_mut_ptr(), as_ptr(), r.as_ptr());
+  }
+  /// Element-wise multiplication of this array of numbers by `r`.
+  ///
+  /// # Panics
+  /// For integers, panics if the multiplication of any element overflows.
+  void operator*=(const Array& r) & noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    __private::lanes_mul<N>(as_mut_ptr(), as_ptr(), r.as_ptr());
+  }
+  /// Element-wise division of this array of numbers by `r`.
+  ///
+  /// # Panics
+  /// For integers, panics if any element of `r` is zero, or if the division
+  /// of any element overflows.
+  void operator/=(const Array& r) & noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    __private::lanes_div<N>(as_mut_ptr(), as_ptr(), r.as_ptr());
+  }
+
+  /// Element-wise multiply-add, computing `(self * a) + b` for each element.
+  ///
+  /// For floats, this is a fused multiply-add with only one rounding error,
+  /// as in `f32::mul_add()`.
+  ///
+  /// # Panics
+  /// For integers, panics if the multiplication or addition of any element
+  /// overflows.
+  Array mul_add(const Array& a, const Array& b) const& noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto out = Array();
+    __private::lanes_mul_add<N>(out.as_mut_ptr(), as_ptr(), a.as_ptr(),
+                                b.as_ptr());
+    return out;
+  }
+
+  /// Returns the element-wise minimum of two arrays of numbers.
+  ///
+  /// For floats, NaN is ignored as in `f32::min()`: if one of the elements is
+  /// NaN, then the other element is returned.
+  Array min(const Array& r) const& noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto out = Array();
+    __private::lanes_min<N>(out.as_mut_ptr(), as_ptr(), r.as_ptr());
+    return out;
+  }
+
+  /// Returns the element-wise maximum of two arrays of numbers.
+  ///
+  /// For floats, NaN is ignored as in `f32::max()`: if one of the elements is
+  /// NaN, then the other element is returned.
+  Array max(const Array& r) const& noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto out = Array();
+    __private::lanes_max<N>(out.as_mut_ptr(), as_ptr(), r.as_ptr());
+    return out;
+  }
+
+  /// Returns the sum of the elements of an array of numbers, added in order
+  /// from the first element to the last.
+  ///
+  /// # Panics
+  /// For integers, panics if the sum overflows at any step.
+  T sum() const& noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    return __private::lanes_sum<N>(as_ptr());
+  }
+
+  /// Returns a mask with each element set to whether the elements at the same
+  /// position in the two arrays of numbers are equal.
+  Array<bool, N> eq_mask(const Array& r) const& noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto mask = Array<bool, N>();
+    __private::lanes_mask<N>(mask.as_mut_ptr(), as_ptr(), r.as_ptr(),
+                             [](auto a, auto b) { return a == b; });
+    return mask;
+  }
+  /// Returns a mask with each element set to whether the elements at the same
+  /// position in the two arrays of numbers are not equal.
+  Array<bool, N> ne_mask(const Array& r) const& noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto mask = Array<bool, N>();
+    __private::lanes_mask<N>(mask.as_mut_ptr(), as_ptr(), r.as_ptr(),
+                             [](auto a, auto b) { return a != b; });
+    return mask;
+  }
+  /// Returns a mask with each element set to whether the element of this
+  /// array is less than the element at the same position in `r`.
+  Array<bool, N> lt_mask(const Array& r) const& noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto mask = Array<bool, N>();
+    __private::lanes_mask<N>(mask.as_mut_ptr(), as_ptr(), r.as_ptr(),
+                             [](auto a, auto b) { return a < b; });
+    return mask;
+  }
+  /// Returns a mask with each element set to whether the element of this
+  /// array is less than or equal to the element at the same position in `r`.
+  Array<bool, N> le_mask(const Array& r) const& noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto mask = Array<bool, N>();
+    __private::lanes_mask<N>(mask.as_mut_ptr(), as_ptr(), r.as_ptr(),
+                             [](auto a, auto b) { return a <= b; });
+    return mask;
+  }
+  /// Returns a mask with each element set to whether the element of this
+  /// array is greater than the element at the same position in `r`.
+  Array<bool, N> gt_mask(const Array& r) const& noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto mask = Array<bool, N>();
+    __private::lanes_mask<N>(mask.as_mut_ptr(), as_ptr(), r.as_ptr(),
+                             [](auto a, auto b) { return a > b; });
+    return mask;
+  }
+  /// Returns a mask with each element set to whether the element of this
+  /// array is greater than or equal to the element at the same position in
+  /// `r`.
+  Array<bool, N> ge_mask(const Array& r) const& noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto mask = Array<bool, N>();
+    __private::lanes_mask<N>(mask.as_mut_ptr(), as_ptr(), r.as_ptr(),
+                             [](auto a, auto b) { return a >= b; });
+    return mask;
+  }
+
+  /// Returns an array of numbers with each element chosen from `if_true` where
+  /// the same element of `mask` is true, and from `if_false` otherwise.
+  static Array select(const Array<bool, N>& mask, const Array& if_true,
+                      const Array& if_false) noexcept
+    requires(N > 0 && __private::LaneNumber<T>)
+  {
+    auto out = Array();
+    for (size_t i = 0u; i < N; ++i) {
+      out.storage_.data_[i] = mask.get_unchecked(::sus::marker::unsafe_fn, i)
+                                  ? if_true.storage_.data_[i]
+                                  : if_false.storage_.data_[i];
+    }
+    return out;
+  }
+
   /// sus::ops::Eq<Array<T, N>, Array<U, N>> trait.
+  ///
+  /// Arrays of integers are compared with memcmp().
   template <class U>
     requires(::sus::ops::Eq<T, U>)
   constexpr bool operator==(const Array<U, N>& r) const& noexcept
     requires(::sus::ops::Eq<T>)
   {
+    if constexpr (N > 0u && __private::MemcmpEq<T, U>) {
+      if (!std::is_constant_evaluated())
+        return __private::slice_eq(as_ptr(), r.as_ptr(), N);
+    }
     return eq_impl(r, std::make_index_sequence<N>());
   }
 
@@ -356,6 +581,10 @@ template <class T, class U, size_t N, size_t... Is>
 constexpr inline auto array_cmp(auto equal, const Array<T, N>& l,
                                 const Array<U, N>& r,
                                 std::index_sequence<Is...>) noexcept {
+  if constexpr (N > 0u && MemcmpOrd<T, U>) {
+    if (!std::is_constant_evaluated())
+      return slice_cmp(equal, l.as_ptr(), N, r.as_ptr(), N);
+  }
   auto val = equal;
   (true && ... && (array_cmp_impl<Is>(val, l, r)));
   return val;
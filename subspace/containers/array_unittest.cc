@@ -347,6 +347,22 @@ TEST(Array, Ord) {
   EXPECT_LT(a, b);
 }
 
+TEST(Array, OrdBytes) {
+  // Arrays of unsigned bytes compare each byte as unsigned.
+  auto a = sus::Array<u8, 3>::with_values(1_u8, 2_u8, 200_u8);
+  auto b = sus::Array<u8, 3>::with_values(1_u8, 2_u8, 3_u8);
+  EXPECT_GT(a, b);
+  EXPECT_EQ(a <=> a, std::strong_ordering::equal);
+  b[2_usize] = 200_u8;
+  EXPECT_EQ(a, b);
+
+  // The same results as at runtime are produced in a constant expression.
+  static_assert(sus::Array<u8, 2>::with_value(200_u8) >
+                sus::Array<u8, 2>::with_value(3_u8));
+  static_assert(sus::Array<i32, 2>::with_value(-1) ==
+                sus::Array<i32, 2>::with_value(-1));
+}
+
 TEST(Array, StrongOrder) {
   auto a = Array<int, 5>::with_initializer([i = 0]() mutable { return ++i; });
   auto b = Array<int, 5>::with_initializer([i = 0]() mutable { return ++i; });
@@ -592,4 +608,95 @@ TEST(Array, StructuredBinding) {
             (Array<i32, 3>::with_values(2, 4, 6)));
 }
 
+TEST(Array, ElementwiseArithmetic) {
+  auto a = Array<i32, 4>::with_values(1, 2, 3, 4);
+  auto b = Array<i32, 4>::with_values(10, 20, 30, 40);
+  EXPECT_EQ(a + b, (Array<i32, 4>::with_values(11, 22, 33, 44)));
+  EXPECT_EQ(b - a, (Array<i32, 4>::with_values(9, 18, 27, 36)));
+  EXPECT_EQ(a * b, (Array<i32, 4>::with_values(10, 40, 90, 160)));
+  EXPECT_EQ(b / a, (Array<i32, 4>::with_values(10, 10, 10, 10)));
+
+  a += b;
+  EXPECT_EQ(a, (Array<i32, 4>::with_values(11, 22, 33, 44)));
+  a -= b;
+  a *= b;
+  EXPECT_EQ(a, (Array<i32, 4>::with_values(10, 40, 90, 160)));
+  a /= b;
+  EXPECT_EQ(a, (Array<i32, 4>::with_values(1, 2, 3, 4)));
+
+  auto f = Array<f32, 4>::with_values(1.f, 2.f, 3.f, 4.f);
+  auto g = Array<f32, 4>::with_values(0.5f, 0.5f, 2.f, 8.f);
+  EXPECT_EQ(f + g, (Array<f32, 4>::with_values(1.5f, 2.5f, 5.f, 12.f)));
+  EXPECT_EQ(f - g, (Array<f32, 4>::with_values(0.5f, 1.5f, 1.f, -4.f)));
+  EXPECT_EQ(f * g, (Array<f32, 4>::with_values(0.5f, 1.f, 6.f, 32.f)));
+  EXPECT_EQ(f / g, (Array<f32, 4>::with_values(2.f, 4.f, 1.5f, 0.5f)));
+}
+
+TEST(Array, ElementwiseOverflow) {
+  auto u = Array<u8, 3>::with_values(1_u8, 2_u8, u8::MAX);
+  auto one = Array<u8, 3>::with_value(1_u8);
+  auto zero = Array<u8, 3>::with_value(0_u8);
+  EXPECT_EQ(u - one, (Array<u8, 3>::with_values(0_u8, 1_u8, 254_u8)));
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH(u + one, "");
+  EXPECT_DEATH(zero - one, "");
+  EXPECT_DEATH(u * u, "");
+  EXPECT_DEATH(u / zero, "");
+  auto m = Array<i32, 2>::with_values(i32::MIN, 1);
+  auto neg = Array<i32, 2>::with_value(-1);
+  EXPECT_DEATH(m / neg, "");
+#endif
+}
+
+TEST(Array, ElementwiseMulAddMinMax) {
+  auto a = Array<i32, 4>::with_values(1, -2, 3, -4);
+  auto b = Array<i32, 4>::with_values(2, 2, -2, -2);
+  auto c = Array<i32, 4>::with_value(1);
+  EXPECT_EQ(a.mul_add(b, c), (Array<i32, 4>::with_values(3, -3, -5, 9)));
+  EXPECT_EQ(a.min(b), (Array<i32, 4>::with_values(1, -2, -2, -4)));
+  EXPECT_EQ(a.max(b), (Array<i32, 4>::with_values(2, 2, 3, -2)));
+#if GTEST_HAS_DEATH_TEST
+  auto max = Array<i32, 1>::with_value(i32::MAX);
+  auto one = Array<i32, 1>::with_value(1);
+  EXPECT_DEATH(max.mul_add(one, one), "");
+#endif
+
+  auto f = Array<f32, 2>::with_values(1.5f, f32::NAN);
+  auto g = Array<f32, 2>::with_values(2.f, 3.f);
+  auto fma = f.mul_add(g, g);
+  EXPECT_EQ(fma[0u], 5.f);
+  EXPECT_TRUE(fma[1u].is_nan());
+  EXPECT_EQ(f.min(g), (Array<f32, 2>::with_values(1.5f, 3.f)));
+  EXPECT_EQ(f.max(g), (Array<f32, 2>::with_values(2.f, 3.f)));
+}
+
+TEST(Array, ElementwiseSum) {
+  EXPECT_EQ((Array<i32, 4>::with_values(1, 2, 3, 4).sum()), 10_i32);
+  EXPECT_EQ((Array<f64, 3>::with_values(0.5, 0.25, 1.0).sum()), 1.75_f64);
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH((Array<u8, 2>::with_values(200_u8, 100_u8).sum()), "");
+#endif
+}
+
+TEST(Array, ElementwiseMasks) {
+  auto a = Array<i32, 4>::with_values(1, 2, 3, 4);
+  auto b = Array<i32, 4>::with_values(4, 2, 2, 4);
+  using Mask = Array<bool, 4>;
+  EXPECT_EQ(a.eq_mask(b), Mask::with_values(false, true, false, true));
+  EXPECT_EQ(a.ne_mask(b), Mask::with_values(true, false, true, false));
+  EXPECT_EQ(a.lt_mask(b), Mask::with_values(true, false, false, false));
+  EXPECT_EQ(a.le_mask(b), Mask::with_values(true, true, false, true));
+  EXPECT_EQ(a.gt_mask(b), Mask::with_values(false, false, true, false));
+  EXPECT_EQ(a.ge_mask(b), Mask::with_values(false, true, true, true));
+  EXPECT_EQ((Array<i32, 4>::select(a.lt_mask(b), a, b)),
+            (Array<i32, 4>::with_values(1, 2, 2, 4)));
+
+  // NaN is not equal, or ordered, with anything.
+  auto f = Array<f32, 2>::with_values(f32::NAN, 1.f);
+  auto g = Array<f32, 2>::with_values(f32::NAN, 1.f);
+  EXPECT_EQ(f.eq_mask(g), (Array<bool, 2>::with_values(false, true)));
+  EXPECT_EQ(f.ne_mask(g), (Array<bool, 2>::with_values(true, false)));
+  EXPECT_EQ(f.le_mask(g), (Array<bool, 2>::with_values(false, true)));
+}
+
 }  // namespace
@@ -0,0 +1,210 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subspace/assertions/check.h"
+#include "subspace/containers/__private/bit_iter.h"
+#include "subspace/containers/__private/bit_words.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/option/option.h"
+
+namespace sus::containers {
+
+/// A fixed-size set of `N` bits, stored densely in 64-bit words.
+///
+/// All bits are unset on construction. Operations that combine two
+/// `BitArray`s (`&=`, `|=`, `^=`) work a whole word at a time, and counting
+/// and searching for set bits use the `count_ones()` and `trailing_zeros()`
+/// integer intrinsics.
+///
+/// The bits beyond `N` in the last word are always kept unset.
+template <size_t N>
+  requires(N <= PTRDIFF_MAX)
+class BitArray final {
+ public:
+  /// Constructs a `BitArray` with all bits unset.
+  ///
+  /// sus::construct::Default trait.
+  constexpr BitArray() noexcept = default;
+
+  /// Constructs a `BitArray` with all bits set.
+  static constexpr BitArray with_all_set() noexcept {
+    auto b = BitArray();
+    b.fill(true);
+    return b;
+  }
+
+  /// Returns the number of bits in the `BitArray`.
+  constexpr usize len() const& noexcept { return N; }
+
+  /// Returns the value of the bit at index `i`.
+  ///
+  /// # Panics
+  /// If the index `i` is beyond the end of the `BitArray`, the function will
+  /// panic.
+  constexpr bool operator[](usize i) const& noexcept {
+    check(i.primitive_value < N);
+    return __private::bit_get(words_, i.primitive_value);
+  }
+
+  /// Returns the value of the bit at index `i`, or `None` if `i` is beyond the
+  /// end of the `BitArray`.
+  constexpr Option<bool> get(usize i) const& noexcept {
+    if (i.primitive_value >= N) [[unlikely]]
+      return Option<bool>::none();
+    return Option<bool>::some(__private::bit_get(words_, i.primitive_value));
+  }
+
+  /// Sets the bit at index `i` to `value`.
+  ///
+  /// # Panics
+  /// If the index `i` is beyond the end of the `BitArray`, the function will
+  /// panic.
+  constexpr void set(usize i, bool value) & noexcept {
+    check(i.primitive_value < N);
+    __private::bit_set(words_, i.primitive_value, value);
+  }
+
+  /// Sets every bit in the `BitArray` to `value`.
+  constexpr void fill(bool value) & noexcept {
+    __private::words_fill(words_, kWords,
+                          value ? ~__private::BitWord{0} : 0u);
+    mask_last_word();
+  }
+
+  /// Returns the number of set bits.
+  constexpr usize count_ones() const& noexcept {
+    return __private::words_count_ones(words_, kWords);
+  }
+
+  /// Returns the number of unset bits.
+  constexpr usize count_zeros() const& noexcept {
+    return usize(N) - count_ones();
+  }
+
+  /// Returns true if any bit is set.
+  constexpr bool any() const& noexcept {
+    return __private::words_any(words_, kWords);
+  }
+
+  /// Returns true if no bit is set.
+  constexpr bool none() const& noexcept { return !any(); }
+
+  /// Returns true if every bit is set. This is true for an empty `BitArray`.
+  constexpr bool all() const& noexcept { return count_ones() == N; }
+
+  /// Returns the index of the first set bit, or `None` if no bit is set.
+  constexpr Option<usize> first_set() const& noexcept {
+    return find_set(0u);
+  }
+
+  /// Returns the index of the first set bit after the index `i`, or `None` if
+  /// no bit after `i` is set.
+  constexpr Option<usize> next_set(usize i) const& noexcept {
+    if (i.primitive_value >= N) return Option<usize>::none();
+    return find_set(i.primitive_value + 1u);
+  }
+
+  /// Returns an iterator over the indices of the set bits, in increasing
+  /// order.
+  BitOnesIter iter_ones() const& noexcept {
+    return BitOnesIter::with(words_, kWords);
+  }
+  BitOnesIter iter_ones() && = delete;
+
+  /// Inverts every bit in the `BitArray`.
+  constexpr void negate() & noexcept {
+    __private::words_not(words_, kWords);
+    mask_last_word();
+  }
+
+  /// Unsets every bit which is set in `other`.
+  constexpr void difference_with(const BitArray& other) & noexcept {
+    __private::words_and_not(words_, other.words_, kWords);
+  }
+
+  /// Bitwise-and with another `BitArray`, keeping only the bits that are set
+  /// in both.
+  constexpr BitArray& operator&=(const BitArray& other) & noexcept {
+    __private::words_and(words_, other.words_, kWords);
+    return *this;
+  }
+  /// Bitwise-or with another `BitArray`, keeping the bits that are set in
+  /// either.
+  constexpr BitArray& operator|=(const BitArray& other) & noexcept {
+    __private::words_or(words_, other.words_, kWords);
+    return *this;
+  }
+  /// Bitwise-xor with another `BitArray`, keeping the bits that are set in
+  /// exactly one of them.
+  constexpr BitArray& operator^=(const BitArray& other) & noexcept {
+    __private::words_xor(words_, other.words_, kWords);
+    return *this;
+  }
+
+  friend constexpr BitArray operator&(BitArray l, const BitArray& r) noexcept {
+    l &= r;
+    return l;
+  }
+  friend constexpr BitArray operator|(BitArray l, const BitArray& r) noexcept {
+    l |= r;
+    return l;
+  }
+  friend constexpr BitArray operator^(BitArray l, const BitArray& r) noexcept {
+    l ^= r;
+    return l;
+  }
+  friend constexpr BitArray operator~(BitArray b) noexcept {
+    b.negate();
+    return b;
+  }
+
+  /// sus::ops::Eq<BitArray<N>> trait.
+  friend constexpr bool operator==(const BitArray& l,
+                                   const BitArray& r) noexcept {
+    return __private::words_eq(l.words_, r.words_, kWords);
+  }
+
+ private:
+  static constexpr size_t kWords = __private::words_for_bits(N);
+
+  constexpr void mask_last_word() noexcept {
+    if constexpr (kWords > 0u)
+      words_[kWords - 1u] &= __private::last_word_mask(N);
+  }
+
+  constexpr Option<usize> find_set(size_t start) const noexcept {
+    const size_t found = __private::words_find_set(words_, N, start);
+    if (found == N) return Option<usize>::none();
+    return Option<usize>::some(found);
+  }
+
+  // A zero-length array is not allowed, so an empty BitArray holds one unused
+  // word.
+  __private::BitWord words_[kWords > 0u ? kWords : 1u] = {};
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(words_));
+};
+
+}  // namespace sus::containers
+
+// Promote BitArray into the `sus` namespace.
+namespace sus {
+using ::sus::containers::BitArray;
+}  // namespace sus
@@ -0,0 +1,134 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/containers/bit_array.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/construct/default.h"
+#include "subspace/iter/iterator.h"
+#include "subspace/mem/copy.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/size_of.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::containers::BitArray;
+
+static_assert(sus::mem::Copy<BitArray<10>>);
+static_assert(sus::construct::Default<BitArray<10>>);
+static_assert(sus::mem::relocate_by_memcpy<BitArray<10>>);
+
+static_assert(sus::mem::size_of<BitArray<1>>() == 8u);
+static_assert(sus::mem::size_of<BitArray<64>>() == 8u);
+static_assert(sus::mem::size_of<BitArray<65>>() == 16u);
+
+// Usable in constant expressions.
+static_assert([]() constexpr {
+  auto b = BitArray<100>();
+  b.set(3_usize, true);
+  b.set(99_usize, true);
+  return b.count_ones() == 2u && b.first_set().unwrap() == 3u;
+}());
+static_assert(BitArray<70>::with_all_set().count_ones() == 70u);
+
+TEST(BitArray, Default) {
+  auto b = BitArray<10>();
+  EXPECT_EQ(b.len(), 10_usize);
+  EXPECT_TRUE(b.none());
+  EXPECT_EQ(b.first_set(), sus::None);
+
+  auto e = BitArray<0>();
+  EXPECT_EQ(e.len(), 0_usize);
+  EXPECT_TRUE(e.all());
+  EXPECT_EQ(e.iter_ones().next(), sus::None);
+}
+
+TEST(BitArray, GetSet) {
+  auto b = BitArray<130>();
+  b.set(0_usize, true);
+  b.set(129_usize, true);
+  EXPECT_TRUE(b[0_usize]);
+  EXPECT_FALSE(b[1_usize]);
+  EXPECT_EQ(b.get(129_usize).unwrap(), true);
+  EXPECT_EQ(b.get(130_usize), sus::None);
+  EXPECT_EQ(b.count_ones(), 2_usize);
+  EXPECT_EQ(b.count_zeros(), 128_usize);
+}
+
+TEST(BitArrayDeathTest, OutOfBounds) {
+  auto b = BitArray<10>();
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH(b.set(10_usize, true), "");
+  EXPECT_DEATH(b[10_usize], "");
+#endif
+}
+
+TEST(BitArray, WordOps) {
+  auto a = BitArray<100>();
+  auto b = BitArray<100>();
+  a.set(1_usize, true);
+  a.set(70_usize, true);
+  b.set(70_usize, true);
+  b.set(99_usize, true);
+
+  EXPECT_EQ((a & b).count_ones(), 1_usize);
+  EXPECT_EQ((a | b).count_ones(), 3_usize);
+  EXPECT_EQ((a ^ b).count_ones(), 2_usize);
+  EXPECT_EQ((~a).count_ones(), 98_usize);
+
+  auto d = a;
+  d.difference_with(b);
+  EXPECT_EQ(d.count_ones(), 1_usize);
+  EXPECT_TRUE(d[1_usize]);
+
+  auto all = BitArray<100>::with_all_set();
+  EXPECT_TRUE(all.all());
+  all.negate();
+  EXPECT_TRUE(all.none());
+}
+
+TEST(BitArray, FirstNextSet) {
+  auto b = BitArray<200>();
+  b.set(64_usize, true);
+  b.set(65_usize, true);
+  b.set(199_usize, true);
+  EXPECT_EQ(b.first_set().unwrap(), 64_usize);
+  EXPECT_EQ(b.next_set(64_usize).unwrap(), 65_usize);
+  EXPECT_EQ(b.next_set(65_usize).unwrap(), 199_usize);
+  EXPECT_EQ(b.next_set(199_usize), sus::None);
+}
+
+TEST(BitArray, IterOnes) {
+  auto b = BitArray<200>();
+  b.set(2_usize, true);
+  b.set(128_usize, true);
+  usize expected[] = {2_usize, 128_usize};
+  usize i = 0u;
+  for (usize bit : b.iter_ones()) {
+    EXPECT_EQ(bit, expected[i.primitive_value]);
+    i += 1u;
+  }
+  EXPECT_EQ(i, 2_usize);
+}
+
+TEST(BitArray, Eq) {
+  auto a = BitArray<10>();
+  auto b = BitArray<10>();
+  EXPECT_EQ(a, b);
+  a.set(9_usize, true);
+  EXPECT_NE(a, b);
+}
+
+}  // namespace
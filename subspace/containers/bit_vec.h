@@ -0,0 +1,275 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subspace/assertions/check.h"
+#include "subspace/containers/__private/bit_iter.h"
+#include "subspace/containers/__private/bit_words.h"
+#include "subspace/containers/vec.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/option/option.h"
+
+namespace sus::containers {
+
+/// A resizeable set of bits, stored densely in 64-bit words.
+///
+/// Operations that combine two `BitVec`s (`&=`, `|=`, `^=`) work a whole word
+/// at a time, and counting and searching for set bits use the `count_ones()`
+/// and `trailing_zeros()` integer intrinsics.
+///
+/// The bits beyond `len()` in the last word are always kept unset.
+class BitVec final {
+ public:
+  /// Constructs an empty `BitVec`.
+  ///
+  /// sus::construct::Default trait.
+  BitVec() noexcept : words_(), len_(0_usize) {}
+
+  /// Constructs a `BitVec` of `len` bits which are all unset.
+  static BitVec with_len(usize len) noexcept {
+    auto b = BitVec::with_capacity(len);
+    const size_t num_words = __private::words_for_bits(len.primitive_value);
+    for (size_t i = 0u; i < num_words; ++i) b.words_.push(0u);
+    b.len_ = len;
+    return b;
+  }
+
+  /// Constructs an empty `BitVec` with space for at least `cap` bits before
+  /// it needs to reallocate.
+  static BitVec with_capacity(usize cap) noexcept {
+    auto b = BitVec();
+    b.words_ = Vec<__private::BitWord>::with_capacity(
+        __private::words_for_bits(cap.primitive_value));
+    return b;
+  }
+
+  BitVec(BitVec&&) noexcept = default;
+  BitVec& operator=(BitVec&&) noexcept = default;
+
+  /// sus::mem::Clone trait.
+  BitVec clone() const& noexcept {
+    auto b = BitVec();
+    b.words_ = ::sus::clone(words_);
+    b.len_ = len_;
+    return b;
+  }
+
+  void clone_from(const BitVec& source) & noexcept {
+    ::sus::clone_into(words_, source.words_);
+    len_ = source.len_;
+  }
+
+  /// Returns the number of bits in the `BitVec`.
+  usize len() const& noexcept { return len_; }
+
+  /// Returns true if the `BitVec` has a length of 0.
+  bool is_empty() const& noexcept { return len_ == 0u; }
+
+  /// Returns the value of the bit at index `i`.
+  ///
+  /// # Panics
+  /// If the index `i` is beyond the end of the `BitVec`, the function will
+  /// panic.
+  bool operator[](usize i) const& noexcept {
+    check(i < len_);
+    return __private::bit_get(words(), i.primitive_value);
+  }
+
+  /// Returns the value of the bit at index `i`, or `None` if `i` is beyond the
+  /// end of the `BitVec`.
+  Option<bool> get(usize i) const& noexcept {
+    if (i >= len_) [[unlikely]]
+      return Option<bool>::none();
+    return Option<bool>::some(__private::bit_get(words(), i.primitive_value));
+  }
+
+  /// Sets the bit at index `i` to `value`.
+  ///
+  /// # Panics
+  /// If the index `i` is beyond the end of the `BitVec`, the function will
+  /// panic.
+  void set(usize i, bool value) & noexcept {
+    check(i < len_);
+    __private::bit_set(words_mut(), i.primitive_value, value);
+  }
+
+  /// Appends a bit to the end of the `BitVec`.
+  void push(bool value) & noexcept {
+    if (len_.primitive_value % __private::kBitsPerWord == 0u)
+      words_.push(0u);
+    __private::bit_set(words_mut(), len_.primitive_value, value);
+    len_ += 1_usize;
+  }
+
+  /// Removes the last bit from the `BitVec` and returns it, or `None` if it is
+  /// empty.
+  Option<bool> pop() & noexcept {
+    if (len_ == 0u) return Option<bool>::none();
+    len_ -= 1_usize;
+    const bool value = __private::bit_get(words(), len_.primitive_value);
+    if (len_.primitive_value % __private::kBitsPerWord == 0u) {
+      // The last word is now empty, and is dropped.
+      (void)words_.pop();
+    } else {
+      __private::bit_set(words_mut(), len_.primitive_value, false);
+    }
+    return Option<bool>::some(value);
+  }
+
+  /// Removes all bits from the `BitVec`.
+  ///
+  /// This has no effect on the allocated capacity of the `BitVec`.
+  void clear() & noexcept {
+    words_.clear();
+    len_ = 0_usize;
+  }
+
+  /// Sets every bit in the `BitVec` to `value`.
+  void fill(bool value) & noexcept {
+    __private::words_fill(words_mut(), num_words(),
+                          value ? ~__private::BitWord{0} : 0u);
+    mask_last_word();
+  }
+
+  /// Returns the number of set bits.
+  usize count_ones() const& noexcept {
+    return __private::words_count_ones(words(), num_words());
+  }
+
+  /// Returns the number of unset bits.
+  usize count_zeros() const& noexcept { return len_ - count_ones(); }
+
+  /// Returns true if any bit is set.
+  bool any() const& noexcept {
+    return __private::words_any(words(), num_words());
+  }
+
+  /// Returns true if no bit is set.
+  bool none() const& noexcept { return !any(); }
+
+  /// Returns true if every bit is set. This is true for an empty `BitVec`.
+  bool all() const& noexcept { return count_ones() == len_; }
+
+  /// Returns the index of the first set bit, or `None` if no bit is set.
+  Option<usize> first_set() const& noexcept { return find_set(0u); }
+
+  /// Returns the index of the first set bit after the index `i`, or `None` if
+  /// no bit after `i` is set.
+  Option<usize> next_set(usize i) const& noexcept {
+    if (i >= len_) return Option<usize>::none();
+    return find_set(i.primitive_value + 1u);
+  }
+
+  /// Returns an iterator over the indices of the set bits, in increasing
+  /// order.
+  BitOnesIter iter_ones() const& noexcept {
+    return BitOnesIter::with(words(), num_words());
+  }
+  BitOnesIter iter_ones() && = delete;
+
+  /// Inverts every bit in the `BitVec`.
+  void negate() & noexcept {
+    __private::words_not(words_mut(), num_words());
+    mask_last_word();
+  }
+
+  /// Unsets every bit which is set in `other`.
+  ///
+  /// # Panics
+  /// Panics if the two `BitVec`s have different lengths.
+  void difference_with(const BitVec& other) & noexcept {
+    check(len_ == other.len_);
+    __private::words_and_not(words_mut(), other.words(), num_words());
+  }
+
+  /// Bitwise-and with another `BitVec`, keeping only the bits that are set in
+  /// both.
+  ///
+  /// # Panics
+  /// Panics if the two `BitVec`s have different lengths.
+  BitVec& operator&=(const BitVec& other) & noexcept {
+    check(len_ == other.len_);
+    __private::words_and(words_mut(), other.words(), num_words());
+    return *this;
+  }
+  /// Bitwise-or with another `BitVec`, keeping the bits that are set in
+  /// either.
+  ///
+  /// # Panics
+  /// Panics if the two `BitVec`s have different lengths.
+  BitVec& operator|=(const BitVec& other) & noexcept {
+    check(len_ == other.len_);
+    __private::words_or(words_mut(), other.words(), num_words());
+    return *this;
+  }
+  /// Bitwise-xor with another `BitVec`, keeping the bits that are set in
+  /// exactly one of them.
+  ///
+  /// # Panics
+  /// Panics if the two `BitVec`s have different lengths.
+  BitVec& operator^=(const BitVec& other) & noexcept {
+    check(len_ == other.len_);
+    __private::words_xor(words_mut(), other.words(), num_words());
+    return *this;
+  }
+
+  /// sus::ops::Eq<BitVec> trait.
+  friend bool operator==(const BitVec& l, const BitVec& r) noexcept {
+    return l.len_ == r.len_ &&
+           __private::words_eq(l.words(), r.words(), l.num_words());
+  }
+
+ private:
+  size_t num_words() const noexcept { return words_.len().primitive_value; }
+
+  // The Vec does not give out a pointer until it has allocated, but we only
+  // read through the pointer when there is at least one word.
+  const __private::BitWord* words() const noexcept {
+    return num_words() > 0u ? words_.as_ptr() : nullptr;
+  }
+  __private::BitWord* words_mut() noexcept {
+    return num_words() > 0u ? words_.as_mut_ptr() : nullptr;
+  }
+
+  void mask_last_word() noexcept {
+    if (const size_t n = num_words(); n > 0u)
+      words_mut()[n - 1u] &= __private::last_word_mask(len_.primitive_value);
+  }
+
+  Option<usize> find_set(size_t start) const noexcept {
+    const size_t found =
+        __private::words_find_set(words(), len_.primitive_value, start);
+    if (found == len_.primitive_value) return Option<usize>::none();
+    return Option<usize>::some(found);
+  }
+
+  Vec<__private::BitWord> words_;
+  usize len_;
+
+  sus_class_trivially_relocatable_if_types(::sus::marker::unsafe_fn,
+                                           decltype(words_), decltype(len_));
+};
+
+}  // namespace sus::containers
+
+// Promote BitVec into the `sus` namespace.
+namespace sus {
+using ::sus::containers::BitVec;
+}  // namespace sus
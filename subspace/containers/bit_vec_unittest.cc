@@ -0,0 +1,196 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/containers/bit_vec.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/iter/iterator.h"
+#include "subspace/mem/clone.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::containers::BitVec;
+
+static_assert(sus::mem::Move<BitVec>);
+static_assert(sus::mem::Clone<BitVec>);
+static_assert(!sus::mem::Copy<BitVec>);
+static_assert(sus::mem::relocate_by_memcpy<BitVec>);
+
+TEST(BitVec, Default) {
+  auto b = BitVec();
+  EXPECT_EQ(b.len(), 0_usize);
+  EXPECT_TRUE(b.is_empty());
+  EXPECT_EQ(b.count_ones(), 0_usize);
+  EXPECT_EQ(b.first_set(), sus::None);
+  EXPECT_TRUE(b.all());
+  EXPECT_TRUE(b.none());
+}
+
+TEST(BitVec, WithLen) {
+  auto b = BitVec::with_len(130_usize);
+  EXPECT_EQ(b.len(), 130_usize);
+  EXPECT_EQ(b.count_ones(), 0_usize);
+  EXPECT_EQ(b.count_zeros(), 130_usize);
+  for (usize i = 0u; i < 130u; i += 1u) EXPECT_FALSE(b[i]);
+  EXPECT_EQ(b.get(129_usize).unwrap(), false);
+  EXPECT_EQ(b.get(130_usize), sus::None);
+}
+
+TEST(BitVec, PushPop) {
+  auto b = BitVec();
+  for (usize i = 0u; i < 70u; i += 1u) b.push(i % 3u == 0u);
+  EXPECT_EQ(b.len(), 70_usize);
+  EXPECT_EQ(b.count_ones(), 24_usize);
+  for (usize i = 70u; i > 0u; i -= 1u)
+    EXPECT_EQ(b.pop().unwrap(), (i - 1u) % 3u == 0u);
+  EXPECT_EQ(b.pop(), sus::None);
+  EXPECT_TRUE(b.is_empty());
+  // Popping clears the bits, so pushing again starts from unset bits.
+  b.push(false);
+  EXPECT_EQ(b.count_ones(), 0_usize);
+}
+
+TEST(BitVec, SetAndFill) {
+  auto b = BitVec::with_len(100_usize);
+  b.set(3_usize, true);
+  b.set(64_usize, true);
+  b.set(99_usize, true);
+  EXPECT_EQ(b.count_ones(), 3_usize);
+  b.set(64_usize, false);
+  EXPECT_EQ(b.count_ones(), 2_usize);
+
+  b.fill(true);
+  EXPECT_EQ(b.count_ones(), 100_usize);
+  EXPECT_TRUE(b.all());
+  b.fill(false);
+  EXPECT_TRUE(b.none());
+}
+
+TEST(BitVecDeathTest, SetOutOfBounds) {
+  auto b = BitVec::with_len(10_usize);
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH(b.set(10_usize, true), "");
+  EXPECT_DEATH(b[10_usize], "");
+#endif
+}
+
+TEST(BitVec, WordOps) {
+  auto a = BitVec::with_len(200_usize);
+  auto b = BitVec::with_len(200_usize);
+  a.set(1_usize, true);
+  a.set(150_usize, true);
+  b.set(150_usize, true);
+  b.set(199_usize, true);
+
+  auto and_ = a.clone();
+  and_ &= b;
+  EXPECT_EQ(and_.count_ones(), 1_usize);
+  EXPECT_TRUE(and_[150_usize]);
+
+  auto or_ = a.clone();
+  or_ |= b;
+  EXPECT_EQ(or_.count_ones(), 3_usize);
+
+  auto xor_ = a.clone();
+  xor_ ^= b;
+  EXPECT_EQ(xor_.count_ones(), 2_usize);
+  EXPECT_FALSE(xor_[150_usize]);
+
+  auto diff = a.clone();
+  diff.difference_with(b);
+  EXPECT_EQ(diff.count_ones(), 1_usize);
+  EXPECT_TRUE(diff[1_usize]);
+
+  // Negating keeps the bits past the end unset.
+  auto neg = a.clone();
+  neg.negate();
+  EXPECT_EQ(neg.count_ones(), 198_usize);
+  EXPECT_FALSE(neg[1_usize]);
+}
+
+TEST(BitVecDeathTest, WordOpsLengthMismatch) {
+  auto a = BitVec::with_len(10_usize);
+  auto b = BitVec::with_len(11_usize);
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH(a &= b, "");
+  EXPECT_DEATH(a |= b, "");
+  EXPECT_DEATH(a ^= b, "");
+#endif
+}
+
+TEST(BitVec, FirstNextSet) {
+  auto b = BitVec::with_len(300_usize);
+  EXPECT_EQ(b.first_set(), sus::None);
+  b.set(5_usize, true);
+  b.set(63_usize, true);
+  b.set(64_usize, true);
+  b.set(299_usize, true);
+  EXPECT_EQ(b.first_set().unwrap(), 5_usize);
+  EXPECT_EQ(b.next_set(5_usize).unwrap(), 63_usize);
+  EXPECT_EQ(b.next_set(63_usize).unwrap(), 64_usize);
+  EXPECT_EQ(b.next_set(64_usize).unwrap(), 299_usize);
+  EXPECT_EQ(b.next_set(299_usize), sus::None);
+  EXPECT_EQ(b.next_set(1000_usize), sus::None);
+}
+
+TEST(BitVec, IterOnes) {
+  auto b = BitVec::with_len(300_usize);
+  b.set(0_usize, true);
+  b.set(63_usize, true);
+  b.set(200_usize, true);
+  b.set(299_usize, true);
+
+  auto it = b.iter_ones();
+  EXPECT_EQ(it.size_hint().lower, 4_usize);
+  EXPECT_EQ(it.next().unwrap(), 0_usize);
+  EXPECT_EQ(it.next().unwrap(), 63_usize);
+  EXPECT_EQ(it.size_hint().lower, 2_usize);
+  EXPECT_EQ(it.next().unwrap(), 200_usize);
+  EXPECT_EQ(it.next().unwrap(), 299_usize);
+  EXPECT_EQ(it.next(), sus::None);
+
+  auto v = b.iter_ones().collect_vec();
+  EXPECT_EQ(v.len(), 4_usize);
+  EXPECT_EQ(v[3u], 299_usize);
+
+  auto empty = BitVec();
+  EXPECT_EQ(empty.iter_ones().next(), sus::None);
+}
+
+TEST(BitVec, Eq) {
+  auto a = BitVec::with_len(70_usize);
+  auto b = BitVec::with_len(70_usize);
+  EXPECT_EQ(a, b);
+  a.set(69_usize, true);
+  EXPECT_NE(a, b);
+  b.set(69_usize, true);
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, BitVec::with_len(71_usize));
+}
+
+TEST(BitVec, Clone) {
+  auto a = BitVec::with_len(70_usize);
+  a.set(7_usize, true);
+  auto b = sus::clone(a);
+  EXPECT_EQ(a, b);
+
+  auto c = BitVec::with_len(3_usize);
+  sus::clone_into(c, a);
+  EXPECT_EQ(c, a);
+}
+
+}  // namespace
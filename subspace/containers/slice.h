@@ -17,22 +17,43 @@
 #include <stdint.h>
 
 #include <algorithm>  // Replace std::sort.
+#include <compare>
 #include <concepts>
 
 #include "subspace/assertions/check.h"
+#include "subspace/assertions/endian.h"
 #include "subspace/construct/into.h"
+#include "subspace/containers/__private/binary_search.h"
+#include "subspace/containers/__private/slice_chunks.h"
+#include "subspace/containers/__private/slice_cmp.h"
+#include "subspace/containers/__private/slice_endian.h"
 #include "subspace/containers/__private/slice_iter.h"
 #include "subspace/fn/callable.h"
 #include "subspace/iter/iterator_defn.h"
 #include "subspace/marker/unsafe.h"
+#include "subspace/num/integer_concepts.h"
 #include "subspace/num/unsigned_integer.h"
+#include "subspace/ops/eq.h"
 #include "subspace/ops/ord.h"
 #include "subspace/option/option.h"
+#include "subspace/result/result.h"
 
 // TODO: sort_by_key()
 // TODO: sort_by_cached_key()
 // TODO: sort_unstable_by_key()
 
+// Parallel iterators are defined in "subspace/thread/par_iter.h", which must be
+// included to use `par_iter()`.
+namespace sus::thread {
+template <class Producer, class Stage, class Item, bool Indexed>
+class ParIter;
+namespace __private {
+template <class T>
+class SliceProducer;
+struct Identity;
+}  // namespace __private
+}  // namespace sus::thread
+
 namespace sus::containers {
 
 /// A range designated by a `start` and `len`.
@@ -137,6 +158,68 @@ class Slice {
     return data_[i.primitive_value];
   }
 
+  /// Returns true if the slice contains an element equal to `x`.
+  ///
+  /// Slices of bytes are searched with memchr(), and slices of other integer
+  /// types a block of elements at a time.
+  constexpr bool contains(const std::remove_const_t<T>& x) const& noexcept
+    requires(::sus::ops::Eq<T>)
+  {
+    return __private::slice_find(data_, len_.primitive_value, x) != len_;
+  }
+
+  /// Returns the index of the first element equal to `x`, or `None` if there
+  /// is no such element in the slice.
+  ///
+  /// Slices of bytes are searched with memchr(), and slices of other integer
+  /// types a block of elements at a time.
+  constexpr Option<usize> position(
+      const std::remove_const_t<T>& x) const& noexcept
+    requires(::sus::ops::Eq<T>)
+  {
+    const size_t i = __private::slice_find(data_, len_.primitive_value, x);
+    if (i == len_) return Option<usize>::none();
+    return Option<usize>::some(i);
+  }
+
+  /// Returns true if `needle` is a prefix of the slice.
+  template <class U>
+    requires(::sus::ops::Eq<T, U>)
+  constexpr bool starts_with(const Slice<U>& needle) const& noexcept {
+    return needle.len_ <= len_ &&
+           __private::slice_eq(data_, needle.data_,
+                               needle.len_.primitive_value);
+  }
+
+  /// Returns true if `needle` is a suffix of the slice.
+  template <class U>
+    requires(::sus::ops::Eq<T, U>)
+  constexpr bool ends_with(const Slice<U>& needle) const& noexcept {
+    return needle.len_ <= len_ &&
+           __private::slice_eq(data_ + (len_ - needle.len_).primitive_value,
+                               needle.data_, needle.len_.primitive_value);
+  }
+
+  /// Returns the index of the first occurrence of `needle` as a contiguous
+  /// subslice of the slice, or `None` if it does not occur. An empty `needle`
+  /// is found at index 0.
+  ///
+  /// When the elements of `needle` are totally ordered (`sus::ops::Ord`), this
+  /// uses the two-way string matching algorithm, which runs in linear time
+  /// without allocating, and skips ahead with memchr() for slices of bytes.
+  /// Otherwise each candidate position is found by searching for the first
+  /// element of `needle` and then comparing the rest, which can take time
+  /// proportional to the product of the two lengths.
+  template <class U>
+    requires(::sus::ops::Eq<T, U>)
+  constexpr Option<usize> find_subslice(
+      const Slice<U>& needle) const& noexcept {
+    const size_t i = __private::slice_find_subslice(
+        data_, len_.primitive_value, needle.data_, needle.len_.primitive_value);
+    if (needle.len_ > 0u && i == len_) return Option<usize>::none();
+    return Option<usize>::some(i);
+  }
+
   /// Returns a subslice which contains elements in `Range`, which specifies a
   /// start and a length.
   ///
@@ -264,6 +347,191 @@ class Slice {
     }
   }
 
+  /// Binary searches this slice for a given element. This behaves similarly to
+  /// `contains()` if this slice is sorted.
+  ///
+  /// If the value is found then `Ok` is returned, containing the index of the
+  /// matching element. If there are multiple matches, then any one of the
+  /// matches could be returned. If the value is not found then `Err` is
+  /// returned, containing the index where a matching element could be inserted
+  /// while maintaining sorted order.
+  ///
+  /// The slice must be sorted, or the result is unspecified.
+  ///
+  /// The search is branchless, and prefetches its next probes in large slices.
+  /// For a read-mostly table of values that is searched many times, see
+  /// `SortedIndex`, which has a more cache-friendly layout.
+  constexpr ::sus::result::Result<usize, usize> binary_search(
+      const T& x) const& noexcept
+    requires(::sus::ops::Ord<T>)
+  {
+    return binary_search_by([&x](const T& e) { return e <=> x; });
+  }
+
+  /// Binary searches this slice with a comparator function.
+  ///
+  /// The comparator function should return an ordering that indicates whether
+  /// its argument is less than, equal to, or greater than the desired target.
+  /// The slice must be sorted by that ordering, or the result is unspecified.
+  ///
+  /// If the value is found then `Ok` is returned, containing the index of the
+  /// matching element. If there are multiple matches, then any one of the
+  /// matches could be returned. If the value is not found then `Err` is
+  /// returned, containing the index where a matching element could be inserted
+  /// while maintaining sorted order.
+  template <class F, int&..., class R = std::invoke_result_t<F, const T&>>
+    requires(::sus::ops::Ordering<R>)
+  constexpr ::sus::result::Result<usize, usize> binary_search_by(
+      F f) const& noexcept {
+    using Result = ::sus::result::Result<usize, usize>;
+    auto is_before = [&f](const T& e) { return f(e) < 0; };
+    const size_t i =
+        __private::partition_point(data_, len_.primitive_value, is_before);
+    if (i < len_ && f(data_[i]) == 0) return Result::with(i);
+    return Result::with_err(i);
+  }
+
+  /// Binary searches this slice with a key extraction function.
+  ///
+  /// The slice must be sorted by the key, or the result is unspecified.
+  ///
+  /// If the value is found then `Ok` is returned, containing the index of the
+  /// matching element. If there are multiple matches, then any one of the
+  /// matches could be returned. If the value is not found then `Err` is
+  /// returned, containing the index where a matching element could be inserted
+  /// while maintaining sorted order.
+  template <class Key, class F, int&...,
+            class R = std::invoke_result_t<F, const T&>>
+    requires(::sus::ops::Ord<R, Key>)
+  constexpr ::sus::result::Result<usize, usize> binary_search_by_key(
+      const Key& key, F f) const& noexcept {
+    return binary_search_by([&key, &f](const T& e) { return f(e) <=> key; });
+  }
+
+  /// Returns the index of the partition point according to the given
+  /// predicate (the index of the first element of the second partition).
+  ///
+  /// The slice is assumed to be partitioned according to the given predicate.
+  /// This means that all elements for which the predicate returns true are at
+  /// the start of the slice and all elements for which the predicate returns
+  /// false are at the end. For example, `[7, 15, 3, 5, 4, 12, 6]` is
+  /// partitioned under the predicate `x % 2 != 0` (all odd numbers are at the
+  /// start, all even at the end).
+  ///
+  /// If this slice is not partitioned, the returned result is unspecified.
+  template <class F, int&..., class R = std::invoke_result_t<F, const T&>>
+    requires(std::same_as<R, bool>)
+  constexpr usize partition_point(F pred) const& noexcept {
+    return __private::partition_point(data_, len_.primitive_value, pred);
+  }
+
+  /// Reverses the byte order of each integer in the slice.
+  ///
+  /// This is the same as calling `swap_bytes()` on each integer, but the
+  /// integers are converted together with vector byte shuffles where the
+  /// target supports them.
+  void swap_bytes_in_place() noexcept
+    requires(!std::is_const_v<T> && ::sus::num::Integer<T>)
+  {
+    __private::swap_bytes_in_place(data_, len_.primitive_value);
+  }
+
+  /// Converts each integer in the slice to big endian from the target's
+  /// endianness.
+  ///
+  /// On big endian this is a no-op. On little endian the bytes are swapped.
+  void to_be_in_place() noexcept
+    requires(!std::is_const_v<T> && ::sus::num::Integer<T>)
+  {
+    if (::sus::assertions::is_little_endian()) swap_bytes_in_place();
+  }
+
+  /// Converts each integer in the slice to little endian from the target's
+  /// endianness.
+  ///
+  /// On little endian this is a no-op. On big endian the bytes are swapped.
+  void to_le_in_place() noexcept
+    requires(!std::is_const_v<T> && ::sus::num::Integer<T>)
+  {
+    if (::sus::assertions::is_big_endian()) swap_bytes_in_place();
+  }
+
+  /// Converts each integer in the slice from big endian to the target's
+  /// endianness.
+  ///
+  /// On big endian this is a no-op. On little endian the bytes are swapped.
+  void from_be_in_place() noexcept
+    requires(!std::is_const_v<T> && ::sus::num::Integer<T>)
+  {
+    to_be_in_place();
+  }
+
+  /// Converts each integer in the slice from little endian to the target's
+  /// endianness.
+  ///
+  /// On little endian this is a no-op. On big endian the bytes are swapped.
+  void from_le_in_place() noexcept
+    requires(!std::is_const_v<T> && ::sus::num::Integer<T>)
+  {
+    to_le_in_place();
+  }
+
+  /// Fills the slice with integers read from their representation as bytes
+  /// in big endian, as with `from_be_bytes()` on each integer.
+  ///
+  /// # Panics
+  /// Panics if the length of `bytes` is not the length of the slice times the
+  /// size of each integer.
+  void copy_from_be_bytes(Slice<const ::sus::num::u8> bytes) noexcept
+    requires(!std::is_const_v<T> && ::sus::num::Integer<T>)
+  {
+    check(bytes.len_.primitive_value == len_.primitive_value * sizeof(T));
+    __private::copy_from_bytes(data_, bytes.data_, len_.primitive_value,
+                               ::sus::assertions::is_little_endian());
+  }
+
+  /// Fills the slice with integers read from their representation as bytes
+  /// in little endian, as with `from_le_bytes()` on each integer.
+  ///
+  /// # Panics
+  /// Panics if the length of `bytes` is not the length of the slice times the
+  /// size of each integer.
+  void copy_from_le_bytes(Slice<const ::sus::num::u8> bytes) noexcept
+    requires(!std::is_const_v<T> && ::sus::num::Integer<T>)
+  {
+    check(bytes.len_.primitive_value == len_.primitive_value * sizeof(T));
+    __private::copy_from_bytes(data_, bytes.data_, len_.primitive_value,
+                               ::sus::assertions::is_big_endian());
+  }
+
+  /// Writes the representation of each integer in the slice as bytes in big
+  /// endian to `bytes`, as with `to_be_bytes()` on each integer.
+  ///
+  /// # Panics
+  /// Panics if the length of `bytes` is not the length of the slice times the
+  /// size of each integer.
+  void copy_to_be_bytes(Slice<::sus::num::u8> bytes) const& noexcept
+    requires(::sus::num::Integer<std::remove_const_t<T>>)
+  {
+    check(bytes.len_.primitive_value == len_.primitive_value * sizeof(T));
+    __private::copy_to_bytes(bytes.data_, data_, len_.primitive_value,
+                             ::sus::assertions::is_little_endian());
+  }
+
+  /// Writes the representation of each integer in the slice as bytes in
+  /// little endian to `bytes`, as with `to_le_bytes()` on each integer.
+  ///
+  /// # Panics
+  /// Panics if the length of `bytes` is not the length of the slice times the
+  /// size of each integer.
+  void copy_to_le_bytes(Slice<::sus::num::u8> bytes) const& noexcept
+    requires(::sus::num::Integer<std::remove_const_t<T>>)
+  {
+    check(bytes.len_.primitive_value == len_.primitive_value * sizeof(T));
+    __private::copy_to_bytes(bytes.data_, data_, len_.primitive_value,
+                             ::sus::assertions::is_big_endian());
+  }
+
   /// Returns a const pointer to the first element in the slice.
   inline const T* as_ptr() const& noexcept {
     check(len_ > 0_usize);
@@ -294,6 +562,30 @@ class Slice {
     return SliceIterMut<T&>::with(data_, len_);
   }
 
+  /// Returns a parallel iterator over all the elements in the slice, which
+  /// gives const access to each element. The work is run on the threads of a
+  /// `sus::thread::ThreadPool`.
+  ///
+  /// Using this method requires including "subspace/thread/par_iter.h".
+  template <int&...,
+            class P = ::sus::thread::__private::SliceProducer<const T>>
+  auto par_iter() const& noexcept {
+    return ::sus::thread::ParIter<P, ::sus::thread::__private::Identity,
+                                  const T&, true>(P(data_, len_));
+  }
+
+  /// Returns a parallel iterator over all the elements in the slice, which
+  /// gives mutable access to each element.
+  ///
+  /// See `par_iter()` for details.
+  template <int&..., class P = ::sus::thread::__private::SliceProducer<T>>
+  auto par_iter_mut() noexcept
+    requires(!std::is_const_v<T>)
+  {
+    return ::sus::thread::ParIter<P, ::sus::thread::__private::Identity, T&,
+                                  true>(P(data_, len_));
+  }
+
   /// Converts the slice into an iterator that consumes the slice and returns
   /// each element in the same order they appear in the array.
   ///
@@ -310,7 +602,175 @@ class Slice {
     return SliceIterMut<T&>::with(data_, len_);
   }
 
+  /// Returns an iterator over `chunk_size` elements of the slice at a time,
+  /// starting at the beginning of the slice.
+  ///
+  /// The chunks are slices and do not overlap. If `chunk_size` does not divide
+  /// the length of the slice, then the last chunk will not have length
+  /// `chunk_size`.
+  ///
+  /// See `chunks_exact()` for a variant of this iterator that returns chunks
+  /// of always exactly `chunk_size` elements, and `rchunks()` for the same
+  /// iterator but starting at the end of the slice.
+  ///
+  /// # Panics
+  /// Panics if `chunk_size` is 0.
+  constexpr Chunks<const T> chunks(usize chunk_size) const& noexcept {
+    return Chunks<const T>::with(data_, len_, chunk_size);
+  }
+
+  /// Returns an iterator over `chunk_size` elements of the slice at a time,
+  /// starting at the beginning of the slice. The chunks are mutable slices.
+  ///
+  /// See `chunks()` for details.
+  constexpr Chunks<T> chunks_mut(usize chunk_size) noexcept
+    requires(!std::is_const_v<T>)
+  {
+    return Chunks<T>::with(data_, len_, chunk_size);
+  }
+
+  /// Returns an iterator over `chunk_size` elements of the slice at a time,
+  /// starting at the beginning of the slice.
+  ///
+  /// The chunks are slices and do not overlap. If `chunk_size` does not divide
+  /// the length of the slice, then the last up to `chunk_size - 1` elements
+  /// will be omitted and can be retrieved from the `remainder()` function of
+  /// the iterator.
+  ///
+  /// Due to each chunk having exactly `chunk_size` elements, the compiler can
+  /// often optimize the resulting code better than in the case of `chunks()`.
+  ///
+  /// # Panics
+  /// Panics if `chunk_size` is 0.
+  constexpr ChunksExact<const T> chunks_exact(
+      usize chunk_size) const& noexcept {
+    return ChunksExact<const T>::with(data_, len_, chunk_size);
+  }
+
+  /// Returns an iterator over `chunk_size` elements of the slice at a time,
+  /// starting at the beginning of the slice. The chunks are mutable slices.
+  ///
+  /// See `chunks_exact()` for details.
+  constexpr ChunksExact<T> chunks_exact_mut(usize chunk_size) noexcept
+    requires(!std::is_const_v<T>)
+  {
+    return ChunksExact<T>::with(data_, len_, chunk_size);
+  }
+
+  /// Returns an iterator over `chunk_size` elements of the slice at a time,
+  /// starting at the end of the slice.
+  ///
+  /// The chunks are slices and do not overlap. If `chunk_size` does not divide
+  /// the length of the slice, then the last chunk will not have length
+  /// `chunk_size`, and will hold the elements at the beginning of the slice.
+  ///
+  /// # Panics
+  /// Panics if `chunk_size` is 0.
+  constexpr RChunks<const T> rchunks(usize chunk_size) const& noexcept {
+    return RChunks<const T>::with(data_, len_, chunk_size);
+  }
+
+  /// Returns an iterator over all contiguous windows of length `size`. The
+  /// windows overlap. If the slice is shorter than `size`, the iterator
+  /// returns no values.
+  ///
+  /// # Panics
+  /// Panics if `size` is 0.
+  constexpr Windows<const T> windows(usize size) const& noexcept {
+    return Windows<const T>::with(data_, len_, size);
+  }
+
+  /// Returns an iterator over subslices separated by elements that match
+  /// `pred`. The matched element is not contained in the subslices.
+  ///
+  /// If the first element is matched, an empty slice will be the first item
+  /// returned by the iterator. Similarly, if the last element in the slice is
+  /// matched, an empty slice will be the last item returned by the iterator.
+  template <class Pred, int&...,
+            class R = std::invoke_result_t<Pred&, const T&>>
+    requires(std::same_as<R, bool>)
+  constexpr Split<const T, Pred> split(Pred pred) const& noexcept {
+    return Split<const T, Pred>::with(data_, len_, ::sus::move(pred));
+  }
+
+  /// Returns an iterator over `N` elements of the slice at a time, starting at
+  /// the beginning of the slice, as references to `Array<T, N>`.
+  ///
+  /// The chunks do not overlap. If `N` does not divide the length of the
+  /// slice, then the last up to `N - 1` elements will be omitted and can be
+  /// retrieved from the `remainder()` function of the iterator.
+  ///
+  /// As the length of each chunk is a constant, loops over the elements of
+  /// each chunk can be unrolled and vectorized by the compiler.
+  ///
+  /// This method requires `array.h` to be included to use the chunks.
+  template <size_t N>
+    requires(N > 0u && N <= PTRDIFF_MAX)
+  constexpr ArrayChunks<const T, N> array_chunks() const& noexcept {
+    return ArrayChunks<const T, N>::with(data_, len_);
+  }
+
+  /// Returns an iterator over `N` elements of the slice at a time, starting at
+  /// the beginning of the slice, as mutable references to `Array<T, N>`.
+  ///
+  /// See `array_chunks()` for details.
+  template <size_t N>
+    requires(N > 0u && N <= PTRDIFF_MAX)
+  constexpr ArrayChunks<T, N> array_chunks_mut() noexcept
+    requires(!std::is_const_v<T>)
+  {
+    return ArrayChunks<T, N>::with(data_, len_);
+  }
+
+  /// sus::ops::Eq<Slice<T>, Slice<U>> trait.
+  ///
+  /// Slices of integers are compared with memcmp().
+  template <class U>
+    requires(::sus::ops::Eq<T, U>)
+  constexpr bool operator==(const Slice<U>& r) const& noexcept {
+    return len_ == r.len_ &&
+           __private::slice_eq(data_, r.data_, len_.primitive_value);
+  }
+
+  /// Compares two Slices lexicographically.
+  ///
+  /// Satisfies sus::ops::Ord<Slice<T>> if sus::ops::Ord<T>.
+  ///
+  /// Satisfies sus::ops::WeakOrd<Slice<T>> if sus::ops::WeakOrd<T>.
+  ///
+  /// Satisfies sus::ops::PartialOrd<Slice<T>> if sus::ops::PartialOrd<T>.
+  ///
+  /// Slices of unsigned bytes are compared with memcmp().
+  //
+  // sus::ops::Ord<Slice<T>> trait.
+  // sus::ops::WeakOrd<Slice<T>> trait.
+  // sus::ops::PartialOrd<Slice<T>> trait.
+  template <class U>
+    requires(::sus::ops::ExclusiveOrd<T, U>)
+  constexpr auto operator<=>(const Slice<U>& r) const& noexcept {
+    return __private::slice_cmp(std::strong_ordering::equivalent, data_,
+                                len_.primitive_value, r.data_,
+                                r.len_.primitive_value);
+  }
+  template <class U>
+    requires(::sus::ops::ExclusiveWeakOrd<T, U>)
+  constexpr auto operator<=>(const Slice<U>& r) const& noexcept {
+    return __private::slice_cmp(std::weak_ordering::equivalent, data_,
+                                len_.primitive_value, r.data_,
+                                r.len_.primitive_value);
+  }
+  template <class U>
+    requires(::sus::ops::ExclusivePartialOrd<T, U>)
+  constexpr auto operator<=>(const Slice<U>& r) const& noexcept {
+    return __private::slice_cmp(std::partial_ordering::equivalent, data_,
+                                len_.primitive_value, r.data_,
+                                r.len_.primitive_value);
+  }
+
  private:
+  template <class U>
+  friend class Slice;
+
   constexpr Slice(T* data, usize len) noexcept : data_(data), len_(len) {}
 
   T* data_;
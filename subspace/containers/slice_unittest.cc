@@ -22,7 +22,10 @@
 #include "subspace/mem/copy.h"
 #include "subspace/mem/move.h"
 #include "subspace/num/types.h"
+#include "subspace/ops/eq.h"
+#include "subspace/ops/ord.h"
 #include "subspace/prelude.h"
+#include "subspace/tuple/tuple.h"
 
 using sus::containers::Range;
 using sus::containers::Slice;
@@ -436,6 +439,425 @@ TEST(Slice, SortUnstableBy) {
   }
 }
 
+static_assert(sus::ops::Eq<Slice<i32>>);
+static_assert(sus::ops::Eq<Slice<i32>, Slice<const i32>>);
+static_assert(sus::ops::Ord<Slice<i32>>);
+static_assert(sus::ops::Ord<Slice<u8>>);
+static_assert(!sus::ops::Ord<Slice<f32>>);
+static_assert(sus::ops::PartialOrd<Slice<f32>>);
+
+TEST(Slice, Eq) {
+  i32 a[] = {1, 2, 3};
+  i32 b[] = {1, 2, 3};
+  i32 c[] = {1, 2, 4};
+  auto sa = Slice<i32>::from(a);
+  EXPECT_EQ(sa, Slice<const i32>::from(b));
+  EXPECT_NE(sa, Slice<i32>::from(c));
+  EXPECT_NE(sa, Slice<i32>::from_raw_parts(unsafe_fn, a, 2_usize));
+  EXPECT_EQ(Slice<i32>(), Slice<i32>());
+
+  f32 f[] = {0.f, 1.f};
+  f32 g[] = {-0.f, 1.f};
+  // Floats are not compared by their bytes.
+  EXPECT_EQ(Slice<f32>::from(f), Slice<f32>::from(g));
+}
+
+TEST(Slice, Ord) {
+  u8 a[] = {1_u8, 2_u8, 200_u8};
+  u8 b[] = {1_u8, 2_u8, 3_u8};
+  auto sa = Slice<u8>::from(a);
+  auto sb = Slice<u8>::from(b);
+  EXPECT_GT(sa, sb);
+  EXPECT_LT(sb, sa);
+  EXPECT_EQ(sa <=> sa, std::strong_ordering::equal);
+  // A prefix is less.
+  EXPECT_LT(Slice<u8>::from_raw_parts(unsafe_fn, a, 2_usize), sa);
+  EXPECT_LT(Slice<u8>(), sa);
+
+  i32 c[] = {-1, 2};
+  i32 d[] = {1, 2};
+  EXPECT_LT(Slice<i32>::from(c), Slice<i32>::from(d));
+
+  f32 f[] = {1.f, 2.f};
+  f32 g[] = {1.f, f32::NAN};
+  EXPECT_EQ(Slice<f32>::from(f) <=> Slice<f32>::from(g),
+            std::partial_ordering::unordered);
+}
+
+TEST(Slice, Contains) {
+  u8 a[] = {1_u8, 2_u8, 3_u8, 2_u8};
+  auto s = Slice<u8>::from(a);
+  EXPECT_TRUE(s.contains(3_u8));
+  EXPECT_FALSE(s.contains(4_u8));
+  EXPECT_FALSE(Slice<u8>().contains(1_u8));
+  EXPECT_EQ(s.position(2_u8).unwrap(), 1_usize);
+  EXPECT_TRUE(s.position(4_u8).is_none());
+
+  // Enough elements to cover the block search and the remainder after it.
+  i64 b[100];
+  for (i64& x : b) x = 7;
+  b[77] = 9;
+  auto sb = Slice<i64>::from(b);
+  EXPECT_TRUE(sb.contains(9_i64));
+  EXPECT_EQ(sb.position(9_i64).unwrap(), 77_usize);
+  EXPECT_TRUE(sb.position(8_i64).is_none());
+  b[99] = 8;
+  EXPECT_EQ(sb.position(8_i64).unwrap(), 99_usize);
+}
+
+TEST(Slice, StartsEndsWith) {
+  i32 a[] = {1, 2, 3, 4};
+  i32 pre[] = {1, 2};
+  i32 post[] = {3, 4};
+  auto s = Slice<i32>::from(a);
+  EXPECT_TRUE(s.starts_with(Slice<i32>::from(pre)));
+  EXPECT_FALSE(s.starts_with(Slice<i32>::from(post)));
+  EXPECT_TRUE(s.ends_with(Slice<const i32>::from(post)));
+  EXPECT_FALSE(s.ends_with(Slice<i32>::from(pre)));
+  EXPECT_TRUE(s.starts_with(s));
+  EXPECT_TRUE(s.ends_with(Slice<i32>()));
+  EXPECT_FALSE(Slice<i32>::from(pre).starts_with(s));
+}
+
+TEST(Slice, FindSubslice) {
+  u8 a[] = {1_u8, 2_u8, 1_u8, 2_u8, 3_u8, 1_u8};
+  u8 n[] = {1_u8, 2_u8, 3_u8};
+  u8 missing[] = {2_u8, 3_u8, 2_u8};
+  auto s = Slice<u8>::from(a);
+  EXPECT_EQ(s.find_subslice(Slice<u8>::from(n)).unwrap(), 2_usize);
+  EXPECT_TRUE(s.find_subslice(Slice<u8>::from(missing)).is_none());
+  EXPECT_EQ(s.find_subslice(Slice<u8>()).unwrap(), 0_usize);
+  EXPECT_TRUE(Slice<u8>::from(n).find_subslice(s).is_none());
+  // A match at the very end.
+  u8 end[] = {3_u8, 1_u8};
+  EXPECT_EQ(s.find_subslice(Slice<u8>::from(end)).unwrap(), 4_usize);
+
+  f32 f[] = {1.f, 2.f, 3.f};
+  f32 g[] = {2.f, 3.f};
+  EXPECT_EQ(Slice<f32>::from(f).find_subslice(Slice<f32>::from(g)).unwrap(),
+            1_usize);
+}
+
+TEST(Slice, FindSubsliceRepetitive) {
+  // A needle which nearly matches at every position of the haystack, which
+  // would take O(len * nlen) time to compare at each one.
+  auto hay = sus::Vec<u8>::with_capacity(100001u);
+  for (usize i = 0u; i < 100000u; i += 1u) hay.push(1_u8);
+  auto needle = sus::Vec<u8>::with_capacity(5001u);
+  for (usize i = 0u; i < 5000u; i += 1u) needle.push(1_u8);
+  needle.push(2_u8);
+  EXPECT_TRUE(hay.find_subslice(needle.as_ref()).is_none());
+  hay.push(2_u8);
+  EXPECT_EQ(hay.find_subslice(needle.as_ref()).unwrap(), 100001u - 5001u);
+
+  // The same with elements that are not searched with memchr().
+  auto ihay = sus::Vec<i32>::with_capacity(100000u);
+  for (i32 i = 0; i < 100000; i += 1) ihay.push(i % 2);
+  auto ineedle = sus::Vec<i32>::with_capacity(5001u);
+  for (i32 i = 0; i < 5000; i += 1) ineedle.push(i % 2);
+  ineedle.push(7);
+  EXPECT_TRUE(ihay.find_subslice(ineedle.as_ref()).is_none());
+  ihay[50000u] = 7;
+  EXPECT_EQ(ihay.find_subslice(ineedle.as_ref()).unwrap(), 45000u);
+}
+
+TEST(Slice, BinarySearch) {
+  i32 a[] = {0, 1, 1, 1, 1, 2, 3, 5, 8, 13, 21, 34, 55};
+  auto s = Slice<i32>::from(a);
+
+  EXPECT_EQ(s.binary_search(13).unwrap(), 9_usize);
+  EXPECT_EQ(s.binary_search(4).unwrap_err(), 7_usize);
+  EXPECT_EQ(s.binary_search(100).unwrap_err(), 13_usize);
+  EXPECT_EQ(s.binary_search(-1).unwrap_err(), 0_usize);
+  // Any of the matches may be returned.
+  const usize one = s.binary_search(1).unwrap();
+  EXPECT_TRUE(one >= 1u && one <= 4u);
+
+  EXPECT_EQ(Slice<i32>().binary_search(1).unwrap_err(), 0_usize);
+
+  // Every value and every gap in a larger slice, which is long enough to
+  // prefetch.
+  auto v = sus::Vec<i32>::with_capacity(5000u);
+  for (i32 i = 0; i < 5000; i += 1) v.push(i * 2);
+  auto sv = v.as_ref();
+  for (i32 i = 0; i < 5000; i += 1) {
+    EXPECT_EQ(sv.binary_search(i * 2).unwrap(), usize::from(i));
+    EXPECT_EQ(sv.binary_search(i * 2 + 1).unwrap_err(), usize::from(i + 1));
+  }
+}
+
+TEST(Slice, BinarySearchBy) {
+  i32 a[] = {0, 1, 1, 1, 1, 2, 3, 5, 8, 13, 21, 34, 55};
+  auto s = Slice<i32>::from(a);
+  EXPECT_EQ(s.binary_search_by([](const i32& e) { return e <=> 13; }).unwrap(),
+            9_usize);
+  EXPECT_EQ(
+      s.binary_search_by([](const i32& e) { return e <=> 4; }).unwrap_err(),
+      7_usize);
+}
+
+TEST(Slice, BinarySearchByKey) {
+  sus::Tuple<i32, i32> a[] = {
+      sus::Tuple<i32, i32>::with(0, 0), sus::Tuple<i32, i32>::with(2, 1),
+      sus::Tuple<i32, i32>::with(4, 1), sus::Tuple<i32, i32>::with(5, 1),
+      sus::Tuple<i32, i32>::with(3, 2), sus::Tuple<i32, i32>::with(1, 3),
+      sus::Tuple<i32, i32>::with(9, 5)};
+  auto s = Slice<sus::Tuple<i32, i32>>::from(a);
+  auto second = [](const sus::Tuple<i32, i32>& t) { return t.at<1>(); };
+  EXPECT_EQ(s.binary_search_by_key(2_i32, second).unwrap(), 4_usize);
+  EXPECT_EQ(s.binary_search_by_key(4_i32, second).unwrap_err(), 6_usize);
+  EXPECT_EQ(s.binary_search_by_key(100_i32, second).unwrap_err(), 7_usize);
+}
+
+TEST(Slice, PartitionPoint) {
+  i32 a[] = {1, 2, 3, 3, 5, 6, 7};
+  auto s = Slice<i32>::from(a);
+  EXPECT_EQ(s.partition_point([](const i32& x) { return x < 5; }), 4_usize);
+  EXPECT_EQ(s.partition_point([](const i32&) { return true; }), 7_usize);
+  EXPECT_EQ(s.partition_point([](const i32&) { return false; }), 0_usize);
+  EXPECT_EQ(Slice<i32>().partition_point([](const i32&) { return true; }),
+            0_usize);
+
+  static_assert([]() constexpr {
+    i32 b[] = {1, 3, 5, 2, 4};
+    return Slice<i32>::from(b).partition_point(
+        [](const i32& x) { return x % 2 != 0; });
+  }() == 3u);
+}
+
+TEST(Slice, Chunks) {
+  i32 a[] = {1, 2, 3, 4, 5, 6, 7};
+  auto s = Slice<i32>::from(a);
+
+  auto it = s.chunks(3u);
+  EXPECT_EQ(it.size_hint().lower, 3_usize);
+  EXPECT_EQ(it.size_hint().upper, sus::Option<usize>::some(3_usize));
+  auto c = it.next().unwrap();
+  EXPECT_EQ(c.len(), 3_usize);
+  EXPECT_EQ(c[0u], 1);
+  EXPECT_EQ(it.next().unwrap()[0u], 4);
+  c = it.next().unwrap();
+  EXPECT_EQ(c.len(), 1_usize);
+  EXPECT_EQ(c[0u], 7);
+  EXPECT_TRUE(it.next().is_none());
+  EXPECT_EQ(it.size_hint().lower, 0_usize);
+
+  EXPECT_EQ(s.chunks(7u).count(), 1_usize);
+  EXPECT_EQ(s.chunks(100u).count(), 1_usize);
+  EXPECT_EQ(Slice<i32>().chunks(2u).count(), 0_usize);
+  // The size hint does not overflow for a huge chunk size.
+  EXPECT_EQ(s.chunks(usize::MAX).size_hint().lower, 1_usize);
+  EXPECT_EQ(s.chunks(usize::MAX).size_hint().upper,
+            sus::Option<usize>::some(1_usize));
+  EXPECT_EQ(s.chunks(usize::MAX).count(), 1_usize);
+
+  for (Slice<i32> chunk : s.chunks_mut(2u)) chunk[0u] *= 10;
+  EXPECT_EQ(a[0], 10);
+  EXPECT_EQ(a[1], 2);
+  EXPECT_EQ(a[6], 70);
+
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH(s.chunks(0u), "");
+#endif
+}
+
+TEST(Slice, ChunksExact) {
+  i32 a[] = {1, 2, 3, 4, 5, 6, 7};
+  auto s = Slice<i32>::from(a);
+
+  auto it = s.chunks_exact(3u);
+  EXPECT_EQ(it.size_hint().lower, 2_usize);
+  EXPECT_EQ(it.size_hint().upper, sus::Option<usize>::some(2_usize));
+  EXPECT_EQ(it.remainder().len(), 1_usize);
+  EXPECT_EQ(it.remainder()[0u], 7);
+  EXPECT_EQ(it.next().unwrap()[2u], 3);
+  EXPECT_EQ(it.next().unwrap()[2u], 6);
+  EXPECT_TRUE(it.next().is_none());
+  EXPECT_EQ(it.remainder()[0u], 7);
+
+  EXPECT_EQ(s.chunks_exact(7u).remainder().len(), 0_usize);
+  EXPECT_EQ(s.chunks_exact(8u).count(), 0_usize);
+  EXPECT_EQ(s.chunks_exact(8u).remainder().len(), 7_usize);
+
+  for (Slice<i32> chunk : s.chunks_exact_mut(2u)) chunk[1u] = 0;
+  EXPECT_EQ(a[1], 0);
+  EXPECT_EQ(a[5], 0);
+  EXPECT_EQ(a[6], 7);
+
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH(s.chunks_exact(0u), "");
+#endif
+}
+
+TEST(Slice, RChunks) {
+  i32 a[] = {1, 2, 3, 4, 5, 6, 7};
+  auto s = Slice<i32>::from(a);
+
+  auto it = s.rchunks(3u);
+  EXPECT_EQ(it.size_hint().lower, 3_usize);
+  auto c = it.next().unwrap();
+  EXPECT_EQ(c.len(), 3_usize);
+  EXPECT_EQ(c[0u], 5);
+  EXPECT_EQ(it.next().unwrap()[0u], 2);
+  c = it.next().unwrap();
+  EXPECT_EQ(c.len(), 1_usize);
+  EXPECT_EQ(c[0u], 1);
+  EXPECT_TRUE(it.next().is_none());
+  EXPECT_EQ(it.size_hint().lower, 0_usize);
+
+  EXPECT_EQ(s.rchunks(usize::MAX).size_hint().lower, 1_usize);
+  EXPECT_EQ(s.rchunks(usize::MAX).size_hint().upper,
+            sus::Option<usize>::some(1_usize));
+  EXPECT_EQ(s.rchunks(usize::MAX).next().unwrap().len(), 7_usize);
+}
+
+TEST(Slice, Windows) {
+  i32 a[] = {1, 2, 3, 4};
+  auto s = Slice<i32>::from(a);
+
+  auto it = s.windows(3u);
+  EXPECT_EQ(it.size_hint().lower, 2_usize);
+  EXPECT_EQ(it.size_hint().upper, sus::Option<usize>::some(2_usize));
+  auto w = it.next().unwrap();
+  EXPECT_EQ(w.len(), 3_usize);
+  EXPECT_EQ(w[0u], 1);
+  EXPECT_EQ(w[2u], 3);
+  w = it.next().unwrap();
+  EXPECT_EQ(w[0u], 2);
+  EXPECT_EQ(w[2u], 4);
+  EXPECT_TRUE(it.next().is_none());
+
+  EXPECT_EQ(s.windows(4u).count(), 1_usize);
+  EXPECT_EQ(s.windows(5u).count(), 0_usize);
+  EXPECT_EQ(s.windows(5u).size_hint().lower, 0_usize);
+}
+
+TEST(Slice, Split) {
+  i32 a[] = {10, 40, 33, 20, 0, 3};
+  auto s = Slice<i32>::from(a);
+  auto is_odd = [](const i32& x) { return x % 2 != 0; };
+
+  auto it = s.split(is_odd);
+  auto p = it.next().unwrap();
+  EXPECT_EQ(p.len(), 2_usize);
+  EXPECT_EQ(p[1u], 40);
+  p = it.next().unwrap();
+  EXPECT_EQ(p.len(), 2_usize);
+  EXPECT_EQ(p[0u], 20);
+  // The last element matched, so the last subslice is empty.
+  EXPECT_EQ(it.next().unwrap().len(), 0_usize);
+  EXPECT_TRUE(it.next().is_none());
+
+  EXPECT_EQ(Slice<i32>().split(is_odd).count(), 1_usize);
+  i32 b[] = {1, 1};
+  EXPECT_EQ(Slice<i32>::from(b).split(is_odd).count(), 3_usize);
+}
+
+TEST(Slice, ArrayChunks) {
+  i32 a[] = {1, 2, 3, 4, 5, 6, 7};
+  auto s = Slice<i32>::from(a);
+
+  auto it = s.array_chunks<2u>();
+  static_assert(std::same_as<decltype(it.next()),
+                             sus::Option<const sus::Array<i32, 2>&>>);
+  EXPECT_EQ(it.size_hint().lower, 3_usize);
+  EXPECT_EQ(it.remainder().len(), 1_usize);
+  EXPECT_EQ(it.remainder()[0u], 7);
+  const sus::Array<i32, 2>& first = it.next().unwrap();
+  EXPECT_EQ(first[0u], 1);
+  EXPECT_EQ(first[1u], 2);
+  EXPECT_EQ(&first[0u], &a[0]);
+
+  i32 sum = 0;
+  for (const sus::Array<i32, 2>& chunk : s.array_chunks<2u>()) {
+    for (const i32& x : chunk) sum += x;
+  }
+  EXPECT_EQ(sum, 1 + 2 + 3 + 4 + 5 + 6);
+
+  for (sus::Array<i32, 3>& chunk : s.array_chunks_mut<3u>()) chunk[0u] = 0;
+  EXPECT_EQ(a[0], 0);
+  EXPECT_EQ(a[3], 0);
+  EXPECT_EQ(a[6], 7);
+}
+
+TEST(Slice, SwapBytesInPlace) {
+  u32 a[] = {0x12345678_u32, 0xaabbccdd_u32, 0_u32, 0x01020304_u32,
+             0x11223344_u32};
+  auto s = Slice<u32>::from(a);
+  s.swap_bytes_in_place();
+  EXPECT_EQ(a[0], 0x78563412_u32);
+  EXPECT_EQ(a[1], 0xddccbbaa_u32);
+  EXPECT_EQ(a[2], 0_u32);
+  EXPECT_EQ(a[4], 0x44332211_u32);
+
+  i16 b[] = {0x0102_i16, -2_i16};
+  Slice<i16>::from(b).swap_bytes_in_place();
+  EXPECT_EQ(b[0], 0x0201_i16);
+  EXPECT_EQ(b[1], (-2_i16).swap_bytes());
+
+  u64 c[] = {0x0102030405060708_u64};
+  Slice<u64>::from(c).to_be_in_place();
+  EXPECT_EQ(c[0], (0x0102030405060708_u64).to_be());
+  Slice<u64>::from(c).from_be_in_place();
+  EXPECT_EQ(c[0], 0x0102030405060708_u64);
+  Slice<u64>::from(c).to_le_in_place();
+  EXPECT_EQ(c[0], (0x0102030405060708_u64).to_le());
+  Slice<u64>::from(c).from_le_in_place();
+  EXPECT_EQ(c[0], 0x0102030405060708_u64);
+
+  Slice<u32>().swap_bytes_in_place();
+}
+
+TEST(Slice, CopyFromBytes) {
+  u8 bytes[] = {0x01_u8, 0x02_u8, 0x03_u8, 0x04_u8,
+                0x05_u8, 0x06_u8, 0x07_u8, 0x08_u8};
+  auto b = Slice<const u8>::from(bytes);
+
+  u32 be[2];
+  Slice<u32>::from(be).copy_from_be_bytes(b);
+  EXPECT_EQ(be[0], 0x01020304_u32);
+  EXPECT_EQ(be[1], 0x05060708_u32);
+
+  u32 le[2];
+  Slice<u32>::from(le).copy_from_le_bytes(b);
+  EXPECT_EQ(le[0], 0x04030201_u32);
+  EXPECT_EQ(le[1], 0x08070605_u32);
+
+  i16 s[4];
+  Slice<i16>::from(s).copy_from_be_bytes(b);
+  EXPECT_EQ(s[3], 0x0708_i16);
+
+#if GTEST_HAS_DEATH_TEST
+  u32 wrong[3];
+  EXPECT_DEATH(Slice<u32>::from(wrong).copy_from_be_bytes(b), "");
+#endif
+}
+
+TEST(Slice, CopyToBytes) {
+  u16 a[] = {0x0102_u16, 0x0304_u16};
+  u8 out[4];
+
+  Slice<const u16>::from(a).copy_to_be_bytes(Slice<u8>::from(out));
+  EXPECT_EQ(out[0], 0x01_u8);
+  EXPECT_EQ(out[1], 0x02_u8);
+  EXPECT_EQ(out[3], 0x04_u8);
+  for (int i = 0; i < 2; ++i) {
+    auto pair = sus::Array<u8, 2>::with_values(out[2 * i], out[2 * i + 1]);
+    EXPECT_EQ(u16::from_be_bytes(pair), a[i]);
+  }
+
+  Slice<u16>::from(a).copy_to_le_bytes(Slice<u8>::from(out));
+  EXPECT_EQ(out[0], 0x02_u8);
+  EXPECT_EQ(out[1], 0x01_u8);
+  EXPECT_EQ(out[2], 0x04_u8);
+
+#if GTEST_HAS_DEATH_TEST
+  u8 short_out[3];
+  EXPECT_DEATH(
+      Slice<u16>::from(a).copy_to_le_bytes(Slice<u8>::from(short_out)), "");
+#endif
+}
+
 static_assert(sus::construct::Default<Slice<i32>>);
 
 TEST(Slice, Default) {
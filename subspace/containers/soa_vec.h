@@ -0,0 +1,311 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "subspace/assertions/check.h"
+#include "subspace/containers/__private/soa_vec_iter.h"
+#include "subspace/containers/slice.h"
+#include "subspace/containers/vec.h"
+#include "subspace/mem/clone.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/ops/ord.h"
+#include "subspace/option/option.h"
+#include "subspace/tuple/tuple.h"
+
+namespace sus::containers {
+
+/// A resizeable buffer of rows of type `Tuple<Ts...>`, which stores each
+/// element of the rows in its own contiguous column.
+///
+/// This is the "structure of arrays" layout, as opposed to the "array of
+/// structures" layout of a `Vec<Tuple<Ts...>>`. A scan over a single column,
+/// such as summing one field of every row, only touches the memory of that
+/// column, and the column can be accessed as a `Slice`.
+///
+/// Rows are pushed and popped as a `Tuple`, and `iter()` and `iter_mut()`
+/// walk over the rows, yielding a `Tuple` of references into each column.
+template <class... Ts>
+  requires(sizeof...(Ts) > 0u)
+class SoaVec final {
+ public:
+  /// The type of the elements in the `I`th column.
+  template <size_t I>
+  using Column = std::tuple_element_t<I, ::sus::Tuple<Ts...>>;
+
+  /// Constructs an empty `SoaVec`.
+  ///
+  /// sus::construct::Default trait.
+  SoaVec() noexcept
+      : columns_(::sus::Tuple<Vec<Ts>...>::with(Vec<Ts>()...)) {}
+
+  /// Constructs an empty `SoaVec` with space for at least `cap` rows before it
+  /// needs to reallocate.
+  static SoaVec with_capacity(usize cap) noexcept {
+    return SoaVec(
+        ::sus::Tuple<Vec<Ts>...>::with(Vec<Ts>::with_capacity(cap)...));
+  }
+
+  SoaVec(SoaVec&&) noexcept = default;
+  SoaVec& operator=(SoaVec&&) noexcept = default;
+
+  /// sus::mem::Clone trait.
+  SoaVec clone() const& noexcept
+    requires((... && ::sus::mem::Clone<Ts>))
+  {
+    return SoaVec(::sus::clone(columns_));
+  }
+
+  /// Returns the number of rows in the `SoaVec`.
+  usize len() const& noexcept { return columns_.template at<0u>().len(); }
+
+  /// Returns true if the `SoaVec` contains no rows.
+  bool is_empty() const& noexcept { return len() == 0u; }
+
+  /// Returns the number of rows the `SoaVec` can hold without reallocating
+  /// any of its columns.
+  usize capacity() const& noexcept {
+    return capacity_impl(std::make_index_sequence<sizeof...(Ts)>());
+  }
+
+  /// Reserves capacity for at least `additional` more rows in every column.
+  ///
+  /// # Panics
+  /// Panics if the new capacity of a column exceeds isize::MAX bytes.
+  void reserve(usize additional) & noexcept {
+    for_each_column([additional](auto& col) { col.reserve(additional); });
+  }
+
+  /// Clears the `SoaVec`, removing all rows.
+  ///
+  /// Note that this method has no effect on the allocated capacity of the
+  /// columns.
+  void clear() & noexcept {
+    for_each_column([](auto& col) { col.clear(); });
+  }
+
+  /// Appends a row to the back of the `SoaVec`, moving each element of the
+  /// `Tuple` into its column.
+  ///
+  /// # Panics
+  /// Panics if the new capacity of a column exceeds isize::MAX bytes.
+  void push(::sus::Tuple<Ts...> row) & noexcept {
+    push_impl(::sus::move(row), std::make_index_sequence<sizeof...(Ts)>());
+  }
+
+  /// Removes the last row from the `SoaVec` and returns it, or None if it is
+  /// empty.
+  Option<::sus::Tuple<Ts...>> pop() & noexcept {
+    if (is_empty()) return Option<::sus::Tuple<Ts...>>::none();
+    return Option<::sus::Tuple<Ts...>>::some(
+        pop_impl(std::make_index_sequence<sizeof...(Ts)>()));
+  }
+
+  /// Returns a `Tuple` of const references to the elements of the row at
+  /// index `i`, or None if `i` is out of bounds.
+  Option<::sus::Tuple<const Ts&...>> get(usize i) const& noexcept {
+    if (i >= len()) return Option<::sus::Tuple<const Ts&...>>::none();
+    return Option<::sus::Tuple<const Ts&...>>::some(
+        row_impl(i, std::make_index_sequence<sizeof...(Ts)>()));
+  }
+  Option<::sus::Tuple<const Ts&...>> get(usize i) && = delete;
+
+  /// Returns a `Tuple` of mutable references to the elements of the row at
+  /// index `i`, or None if `i` is out of bounds.
+  Option<::sus::Tuple<Ts&...>> get_mut(usize i) & noexcept {
+    if (i >= len()) return Option<::sus::Tuple<Ts&...>>::none();
+    return Option<::sus::Tuple<Ts&...>>::some(
+        row_mut_impl(i, std::make_index_sequence<sizeof...(Ts)>()));
+  }
+
+  /// Returns a const `Slice` over the `I`th column.
+  template <size_t I>
+    requires(I < sizeof...(Ts))
+  Slice<const Column<I>> column() const& noexcept {
+    return columns_.template at<I>().as_ref();
+  }
+  template <size_t I>
+  Slice<const Column<I>> column() && = delete;
+
+  /// Returns a mutable `Slice` over the `I`th column.
+  ///
+  /// Elements may be modified through the `Slice`, but reordering them will
+  /// move them out of their rows. Use `sort_by_column()` to reorder the rows.
+  template <size_t I>
+    requires(I < sizeof...(Ts))
+  Slice<Column<I>> column_mut() & noexcept {
+    return columns_.template at_mut<I>().as_mut();
+  }
+
+  /// Returns an iterator over the rows, which yields a `Tuple` of const
+  /// references to each row's elements.
+  SoaVecIter<Ts...> iter() const& noexcept {
+    return SoaVecIter<Ts...>::with(
+        column_ptrs(std::make_index_sequence<sizeof...(Ts)>()), len());
+  }
+  SoaVecIter<Ts...> iter() && = delete;
+
+  /// Returns an iterator over the rows, which yields a `Tuple` of mutable
+  /// references to each row's elements.
+  SoaVecIterMut<Ts...> iter_mut() & noexcept {
+    return SoaVecIterMut<Ts...>::with(
+        column_ptrs_mut(std::make_index_sequence<sizeof...(Ts)>()), len());
+  }
+
+  /// Sorts the rows by the values in the `I`th column.
+  ///
+  /// This sort is stable (i.e., does not reorder rows with equal values in the
+  /// column). The column is sorted to find the new order of the rows, and
+  /// then every column is permuted into that order with one move per element.
+  template <size_t I>
+    requires(I < sizeof...(Ts) && ::sus::ops::Ord<Column<I>>)
+  void sort_by_column() & noexcept {
+    const Vec<Column<I>>& key = columns_.template at<I>();
+    sort_by_permutation([&key](const usize& l, const usize& r) {
+      return key[l] <=> key[r];
+    });
+  }
+
+  /// Sorts the rows by the values in the `I`th column with a comparator
+  /// function.
+  ///
+  /// This sort is stable (i.e., does not reorder rows with equal values in the
+  /// column). The comparator function must define a total ordering for the
+  /// elements in the column.
+  template <size_t I, class F, int&...,
+            class R = std::invoke_result_t<F, const Column<I>&,
+                                           const Column<I>&>>
+    requires(I < sizeof...(Ts) && ::sus::ops::Ordering<R>)
+  void sort_by_column_by(F compare) & noexcept {
+    const Vec<Column<I>>& key = columns_.template at<I>();
+    sort_by_permutation([&key, &compare](const usize& l, const usize& r) {
+      return compare(key[l], key[r]);
+    });
+  }
+
+ private:
+  explicit SoaVec(::sus::Tuple<Vec<Ts>...> columns) noexcept
+      : columns_(::sus::move(columns)) {}
+
+  template <class F>
+  void for_each_column(F f) noexcept {
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+      (f(columns_.template at_mut<Is>()), ...);
+    }(std::make_index_sequence<sizeof...(Ts)>());
+  }
+
+  template <size_t... Is>
+  usize capacity_impl(std::index_sequence<Is...>) const noexcept {
+    usize cap = columns_.template at<0u>().capacity();
+    ((cap = ::sus::ops::min(cap, columns_.template at<Is>().capacity())), ...);
+    return cap;
+  }
+
+  template <size_t... Is>
+  void push_impl(::sus::Tuple<Ts...>&& row,
+                 std::index_sequence<Is...>) noexcept {
+    (columns_.template at_mut<Is>().push(
+         ::sus::move(row).template into_inner<Is>()),
+     ...);
+  }
+
+  template <size_t... Is>
+  ::sus::Tuple<Ts...> pop_impl(std::index_sequence<Is...>) noexcept {
+    // Safety: Every column has the same length, which was checked to be
+    // non-zero by the caller.
+    return ::sus::Tuple<Ts...>::with(
+        columns_.template at_mut<Is>().pop().unwrap_unchecked(
+            ::sus::marker::unsafe_fn)...);
+  }
+
+  template <size_t... Is>
+  ::sus::Tuple<const Ts&...> row_impl(usize i, std::index_sequence<Is...>)
+      const noexcept {
+    return ::sus::Tuple<const Ts&...>::with(
+        columns_.template at<Is>().get_unchecked(::sus::marker::unsafe_fn,
+                                                 i)...);
+  }
+
+  template <size_t... Is>
+  ::sus::Tuple<Ts&...> row_mut_impl(usize i,
+                                    std::index_sequence<Is...>) noexcept {
+    return ::sus::Tuple<Ts&...>::with(mref(
+        columns_.template at_mut<Is>().get_unchecked_mut(
+            ::sus::marker::unsafe_fn, i))...);
+  }
+
+  // The `Vec` does not give out a pointer until it has allocated, but the
+  // iterators only read through the pointers when there is at least one row.
+  template <size_t... Is>
+  ::sus::Tuple<const Ts*...> column_ptrs(
+      std::index_sequence<Is...>) const noexcept {
+    const bool empty = is_empty();
+    return ::sus::Tuple<const Ts*...>::with(
+        (empty ? nullptr : columns_.template at<Is>().as_ptr())...);
+  }
+
+  template <size_t... Is>
+  ::sus::Tuple<Ts*...> column_ptrs_mut(std::index_sequence<Is...>) noexcept {
+    const bool empty = is_empty();
+    return ::sus::Tuple<Ts*...>::with(
+        (empty ? nullptr : columns_.template at_mut<Is>().as_mut_ptr())...);
+  }
+
+  // Stable sorts the row indices with `compare`, then relocates the elements
+  // of every column into the sorted order.
+  template <class F>
+  void sort_by_permutation(F compare) noexcept {
+    const usize n = len();
+    if (n <= 1u) return;
+    auto order = Vec<usize>::with_capacity(n);
+    for (usize i = 0u; i < n; i += 1u) order.push(i);
+    order.sort_by(::sus::move(compare));
+    for_each_column([&order, n](auto& col) {
+      using V = std::remove_reference_t<decltype(col)>;
+      auto sorted = V::with_capacity(n);
+      auto* from = col.as_mut_ptr();
+      auto* to = sorted.as_mut_ptr();
+      for (size_t i = 0u; i < n; ++i) {
+        ::sus::mem::relocate_slice(::sus::marker::unsafe_fn,
+                                   from + order[i].primitive_value, to + i,
+                                   1u);
+      }
+      // Safety: Every element was relocated out of `col` into `sorted`.
+      col.set_len(::sus::marker::unsafe_fn, 0u);
+      sorted.set_len(::sus::marker::unsafe_fn, n);
+      col = ::sus::move(sorted);
+    });
+  }
+
+  ::sus::Tuple<Vec<Ts>...> columns_;
+
+  sus_class_trivially_relocatable_if_types(::sus::marker::unsafe_fn,
+                                           decltype(columns_));
+};
+
+}  // namespace sus::containers
+
+// Promote SoaVec into the `sus` namespace.
+namespace sus {
+using ::sus::containers::SoaVec;
+}  // namespace sus
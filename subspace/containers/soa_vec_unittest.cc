@@ -0,0 +1,166 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/containers/soa_vec.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/iter/iterator.h"
+#include "subspace/mem/clone.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::Tuple;
+using sus::containers::SoaVec;
+
+static_assert(sus::mem::Move<SoaVec<i32, u8>>);
+static_assert(sus::mem::Clone<SoaVec<i32, u8>>);
+static_assert(!sus::mem::Copy<SoaVec<i32, u8>>);
+static_assert(sus::mem::relocate_by_memcpy<SoaVec<i32, u8>>);
+
+TEST(SoaVec, Default) {
+  auto v = SoaVec<i32, u8>();
+  EXPECT_EQ(v.len(), 0_usize);
+  EXPECT_TRUE(v.is_empty());
+  EXPECT_EQ(v.capacity(), 0_usize);
+  EXPECT_EQ(v.column<0u>().len(), 0_usize);
+  EXPECT_TRUE(v.get(0u).is_none());
+  EXPECT_TRUE(v.iter().next().is_none());
+}
+
+TEST(SoaVec, WithCapacity) {
+  auto v = SoaVec<i32, u8>::with_capacity(5u);
+  EXPECT_EQ(v.len(), 0_usize);
+  EXPECT_GE(v.capacity(), 5_usize);
+  v.reserve(20u);
+  EXPECT_GE(v.capacity(), 20_usize);
+}
+
+TEST(SoaVec, PushPop) {
+  auto v = SoaVec<i32, u8>();
+  v.push(Tuple<i32, u8>::with(1, 10_u8));
+  v.push(Tuple<i32, u8>::with(2, 20_u8));
+  v.push(Tuple<i32, u8>::with(3, 30_u8));
+  EXPECT_EQ(v.len(), 3_usize);
+
+  EXPECT_EQ(v.pop().unwrap(), (Tuple<i32, u8>::with(3, 30_u8)));
+  EXPECT_EQ(v.len(), 2_usize);
+  EXPECT_EQ(v.pop().unwrap(), (Tuple<i32, u8>::with(2, 20_u8)));
+  EXPECT_EQ(v.pop().unwrap(), (Tuple<i32, u8>::with(1, 10_u8)));
+  EXPECT_TRUE(v.pop().is_none());
+}
+
+TEST(SoaVec, Columns) {
+  auto v = SoaVec<i32, u8>();
+  for (i32 i = 0; i < 5; i += 1) v.push(Tuple<i32, u8>::with(i, u8::MAX));
+
+  auto c0 = v.column<0u>();
+  static_assert(std::same_as<decltype(c0), sus::Slice<const i32>>);
+  EXPECT_EQ(c0.len(), 5_usize);
+  for (usize i = 0u; i < 5u; i += 1u) EXPECT_EQ(c0[i], i32::from(i));
+
+  auto c1 = v.column_mut<1u>();
+  static_assert(std::same_as<decltype(c1), sus::Slice<u8>>);
+  for (u8& b : c1.iter_mut()) b = 7_u8;
+  EXPECT_EQ(v.get(4u).unwrap(), (Tuple<i32, u8>::with(4, 7_u8)));
+}
+
+TEST(SoaVec, Get) {
+  auto v = SoaVec<i32, u8>();
+  v.push(Tuple<i32, u8>::with(1, 10_u8));
+  v.push(Tuple<i32, u8>::with(2, 20_u8));
+
+  auto r = v.get(1u).unwrap();
+  static_assert(std::same_as<decltype(r), Tuple<const i32&, const u8&>>);
+  EXPECT_EQ(r.at<0u>(), 2);
+  EXPECT_EQ(&r.at<0u>(), &v.column<0u>()[1u]);
+  EXPECT_TRUE(v.get(2u).is_none());
+
+  auto m = v.get_mut(0u).unwrap();
+  static_assert(std::same_as<decltype(m), Tuple<i32&, u8&>>);
+  m.at_mut<1u>() = 11_u8;
+  EXPECT_EQ(v.column<1u>()[0u], 11_u8);
+  EXPECT_TRUE(v.get_mut(2u).is_none());
+}
+
+TEST(SoaVec, Iter) {
+  auto v = SoaVec<i32, u8>();
+  v.push(Tuple<i32, u8>::with(1, 10_u8));
+  v.push(Tuple<i32, u8>::with(2, 20_u8));
+  v.push(Tuple<i32, u8>::with(3, 30_u8));
+
+  auto it = v.iter();
+  EXPECT_EQ(it.size_hint().lower, 3_usize);
+  i32 sum = 0;
+  for (Tuple<const i32&, const u8&> row : it) {
+    sum += row.at<0u>() * i32::from(row.at<1u>());
+  }
+  EXPECT_EQ(sum, 10 + 40 + 90);
+
+  for (Tuple<i32&, u8&> row : v.iter_mut()) row.at_mut<0u>() += 1;
+  EXPECT_EQ(v.column<0u>()[0u], 2);
+  EXPECT_EQ(v.column<0u>()[2u], 4);
+}
+
+TEST(SoaVec, SortByColumn) {
+  auto v = SoaVec<i32, u8, sus::Vec<i32>>();
+  v.push(Tuple<i32, u8, sus::Vec<i32>>::with(3, 0_u8, sus::vec(30)));
+  v.push(Tuple<i32, u8, sus::Vec<i32>>::with(1, 1_u8, sus::vec(10)));
+  v.push(Tuple<i32, u8, sus::Vec<i32>>::with(2, 2_u8, sus::vec(20)));
+  v.push(Tuple<i32, u8, sus::Vec<i32>>::with(1, 3_u8, sus::vec(11)));
+
+  v.sort_by_column<0u>();
+  EXPECT_EQ(v.column<0u>()[0u], 1);
+  EXPECT_EQ(v.column<0u>()[1u], 1);
+  EXPECT_EQ(v.column<0u>()[2u], 2);
+  EXPECT_EQ(v.column<0u>()[3u], 3);
+  // The sort is stable, and the other columns were permuted with the first.
+  EXPECT_EQ(v.column<1u>()[0u], 1_u8);
+  EXPECT_EQ(v.column<1u>()[1u], 3_u8);
+  EXPECT_EQ(v.column<1u>()[2u], 2_u8);
+  EXPECT_EQ(v.column<1u>()[3u], 0_u8);
+  EXPECT_EQ(v.column<2u>()[0u][0u], 10);
+  EXPECT_EQ(v.column<2u>()[1u][0u], 11);
+  EXPECT_EQ(v.column<2u>()[2u][0u], 20);
+  EXPECT_EQ(v.column<2u>()[3u][0u], 30);
+
+  v.sort_by_column_by<1u>([](const u8& l, const u8& r) { return r <=> l; });
+  EXPECT_EQ(v.column<1u>()[0u], 3_u8);
+  EXPECT_EQ(v.column<0u>()[0u], 1);
+  EXPECT_EQ(v.column<2u>()[0u][0u], 11);
+  EXPECT_EQ(v.column<1u>()[3u], 0_u8);
+  EXPECT_EQ(v.column<0u>()[3u], 3);
+}
+
+TEST(SoaVec, Clone) {
+  auto v = SoaVec<i32, sus::Vec<i32>>();
+  v.push(Tuple<i32, sus::Vec<i32>>::with(1, sus::vec(2, 3)));
+  auto c = sus::clone(v);
+  EXPECT_EQ(c.len(), 1_usize);
+  EXPECT_EQ(c.column<1u>()[0u][1u], 3);
+  EXPECT_NE(c.column<1u>()[0u].as_ptr(), v.column<1u>()[0u].as_ptr());
+}
+
+TEST(SoaVec, Clear) {
+  auto v = SoaVec<i32, u8>();
+  v.push(Tuple<i32, u8>::with(1, 10_u8));
+  const usize cap = v.capacity();
+  v.clear();
+  EXPECT_TRUE(v.is_empty());
+  EXPECT_EQ(v.capacity(), cap);
+}
+
+}  // namespace
@@ -0,0 +1,90 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/containers/sorted_index.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/mem/clone.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::containers::SortedIndex;
+
+static_assert(sus::mem::Move<SortedIndex<i32>>);
+static_assert(sus::mem::Clone<SortedIndex<i32>>);
+static_assert(sus::mem::relocate_by_memcpy<SortedIndex<i32>>);
+
+TEST(SortedIndex, Empty) {
+  auto index = SortedIndex<i32>();
+  EXPECT_TRUE(index.is_empty());
+  EXPECT_EQ(index.binary_search(3).unwrap_err(), 0_usize);
+  EXPECT_FALSE(index.contains(3));
+}
+
+TEST(SortedIndex, Small) {
+  sus::Vec<i32> v = sus::vec(1, 3, 5, 7, 9, 11);
+  auto index = SortedIndex<i32>::with_sorted(v.as_ref());
+  EXPECT_EQ(index.len(), 6_usize);
+  EXPECT_EQ(index.binary_search(1).unwrap(), 0_usize);
+  EXPECT_EQ(index.binary_search(7).unwrap(), 3_usize);
+  EXPECT_EQ(index.binary_search(11).unwrap(), 5_usize);
+  EXPECT_EQ(index.binary_search(0).unwrap_err(), 0_usize);
+  EXPECT_EQ(index.binary_search(6).unwrap_err(), 3_usize);
+  EXPECT_EQ(index.binary_search(12).unwrap_err(), 6_usize);
+  EXPECT_TRUE(index.contains(9));
+  EXPECT_FALSE(index.contains(10));
+}
+
+TEST(SortedIndex, MatchesSlice) {
+  // Every size up to a few complete trees, and every value and gap in them.
+  for (i32 n = 0; n < 70; n += 1) {
+    auto v = sus::Vec<i32>();
+    for (i32 i = 0; i < n; i += 1) v.push(i * 2);
+    auto index = SortedIndex<i32>::with_sorted(v.as_ref());
+    for (i32 x = -1; x <= n * 2; x += 1)
+      EXPECT_EQ(index.binary_search(x), v.binary_search(x));
+  }
+}
+
+TEST(SortedIndex, Large) {
+  // Large enough to prefetch.
+  auto v = sus::Vec<u32>::with_capacity(10000u);
+  for (u32 i = 0u; i < 10000u; i += 1u) v.push(i * 3u);
+  auto index = SortedIndex<u32>::with_sorted(v.as_ref());
+  for (u32 i = 0u; i < 10000u; i += 1u) {
+    EXPECT_EQ(index.binary_search(i * 3u).unwrap(), usize::from(i));
+    EXPECT_EQ(index.binary_search(i * 3u + 1u).unwrap_err(),
+              usize::from(i + 1u));
+  }
+}
+
+TEST(SortedIndex, Clone) {
+  sus::Vec<i32> v = sus::vec(1, 2, 3);
+  auto index = SortedIndex<i32>::with_sorted(v.as_ref());
+  auto c = sus::clone(index);
+  EXPECT_EQ(c.binary_search(2).unwrap(), 1_usize);
+}
+
+TEST(SortedIndexDeathTest, NotSorted) {
+  sus::Vec<i32> v = sus::vec(1, 3, 2);
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH(SortedIndex<i32>::with_sorted(v.as_ref()), "");
+#endif
+}
+
+}  // namespace
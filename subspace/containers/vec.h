@@ -18,6 +18,7 @@
 #include <stdlib.h>
 
 #include <concepts>
+#include <source_location>
 
 #include "subspace/assertions/check.h"
 #include "subspace/containers/__private/vec_iter.h"
@@ -25,14 +26,17 @@
 #include "subspace/containers/slice.h"
 #include "subspace/iter/from_iterator.h"
 #include "subspace/macros/compiler.h"
+#include "subspace/mem/alloc.h"
 #include "subspace/mem/move.h"
 #include "subspace/mem/relocate.h"
 #include "subspace/mem/replace.h"
 #include "subspace/mem/size_of.h"
 #include "subspace/num/integer_concepts.h"
 #include "subspace/num/unsigned_integer.h"
+#include "subspace/ops/eq.h"
 #include "subspace/ops/ord.h"
 #include "subspace/option/option.h"
+#include "subspace/result/result.h"
 #include "subspace/tuple/tuple.h"
 
 // TODO: sort_by_key()
@@ -66,19 +70,24 @@ class Vec {
   // sus::construct::Default trait.
   inline constexpr Vec() noexcept : Vec(kDefault) {}
 
-  static inline Vec with_capacity(usize cap) noexcept {
-    return Vec(kWithCap, cap);
+  static inline Vec with_capacity(
+      usize cap, const std::source_location location =
+                     std::source_location::current()) noexcept {
+    return Vec(kWithCap, cap, location);
   }
 
   /// Constructs a vector by taking all the elements from the iterator.
   ///
   /// sus::iter::FromIterator trait.
-  static constexpr Vec from_iter(::sus::iter::IteratorBase<T>&& iter) noexcept
+  static constexpr Vec from_iter(
+      ::sus::iter::IteratorBase<T>&& iter,
+      const std::source_location location =
+          std::source_location::current()) noexcept
     requires(::sus::mem::Move<T> && !std::is_reference_v<T>)
   {
     auto [lower, upper] = iter.size_hint();
-    auto v = Vec::with_capacity(::sus::move(upper).unwrap_or(lower));
-    for (T t : iter) v.push(::sus::move(t));
+    auto v = Vec::with_capacity(::sus::move(upper).unwrap_or(lower), location);
+    for (T t : iter) v.push(::sus::move(t), location);
     return v;
   }
 
@@ -102,11 +111,12 @@ class Vec {
     return *this;
   }
 
-  Vec clone() const& noexcept
+  Vec clone(const std::source_location location =
+                std::source_location::current()) const& noexcept
     requires(::sus::mem::Clone<T>)
   {
     check(!is_moved_from());
-    auto v = Vec::with_capacity(capacity_);
+    auto v = Vec::with_capacity(capacity_, location);
     for (auto i = size_t{0}; i < len_; ++i) {
       new (v.as_mut_ptr() + i)
           T(::sus::clone(get_unchecked(::sus::marker::unsafe_fn, i)));
@@ -115,19 +125,20 @@ class Vec {
     return v;
   }
 
-  void clone_from(const Vec& source) & noexcept
+  void clone_from(const Vec& source,
+                  const std::source_location location =
+                      std::source_location::current()) & noexcept
     requires(::sus::mem::Clone<T>)
   {
     check(!is_moved_from());
     check(!source.is_moved_from());
     if (source.capacity_ == 0_usize) {
-      destroy_storage_objects();
       free_storage();
       storage_ = nullptr;
       len_ = 0_usize;
       capacity_ = 0_usize;
     } else {
-      grow_to_exact(source.capacity_);
+      grow_to_exact(source.capacity_, location);
       const size_t in_place_count =
           sus::ops::min(len_, source.len_).primitive_value;
       for (auto i = size_t{0}; i < in_place_count; ++i) {
@@ -166,10 +177,12 @@ class Vec {
   ///
   /// # Panics
   /// Panics if the new capacity exceeds isize::MAX() bytes.
-  void reserve(usize additional) noexcept {
+  void reserve(usize additional,
+               const std::source_location location =
+                   std::source_location::current()) noexcept {
     check(!is_moved_from());
     if (len_ + additional <= capacity_) return;  // Nothing to do.
-    grow_to_exact(apply_growth_function(additional));
+    grow_to_exact(apply_growth_function(additional), location);
   }
 
   /// Reserves the minimum capacity for at least `additional` more elements to
@@ -185,11 +198,13 @@ class Vec {
   ///
   /// # Panics
   /// Panics if the new capacity exceeds isize::MAX bytes.
-  void reserve_exact(usize additional) noexcept {
+  void reserve_exact(usize additional,
+                     const std::source_location location =
+                         std::source_location::current()) noexcept {
     check(!is_moved_from());
     const usize cap = len_ + additional;
     if (cap <= capacity_) return;  // Nothing to do.
-    grow_to_exact(cap);
+    grow_to_exact(cap, location);
   }
 
   /// Increase the capacity of the vector (the total number of elements that the
@@ -200,34 +215,65 @@ class Vec {
   ///
   /// # Panics
   /// Panics if the new capacity exceeds isize::MAX() bytes.
-  void grow_to_exact(usize cap) noexcept {
+  void grow_to_exact(usize cap,
+                     const std::source_location location =
+                         std::source_location::current()) noexcept {
     check(!is_moved_from());
     if (cap <= capacity_) return;  // Nothing to do.
     const auto bytes = ::sus::mem::size_of<T>() * cap;
     check(bytes <= usize(size_t{PTRDIFF_MAX}));
     if (!is_alloced()) {
-      storage_ = static_cast<char*>(malloc(bytes.primitive_value));
+      storage_ = static_cast<char*>(::sus::mem::allocate(
+          bytes.primitive_value, alignof(T), location));
     } else {
       if constexpr (::sus::mem::relocate_by_memcpy<T>) {
-        storage_ = static_cast<char*>(realloc(storage_, bytes.primitive_value));
+        storage_ = static_cast<char*>(::sus::mem::reallocate(
+            storage_, size_t{::sus::mem::size_of<T>() * capacity_},
+            bytes.primitive_value, alignof(T), location));
       } else {
-        auto* const new_storage =
-            static_cast<char*>(malloc(bytes.primitive_value));
-        auto* old_t = reinterpret_cast<T*>(storage_);
-        auto* new_t = reinterpret_cast<T*>(new_storage);
-        const size_t len = len_.primitive_value;
-        for (auto i = size_t{0}; i < len; ++i) {
-          new (new_t) T(::sus::move(*old_t));
-          old_t->~T();
-          ++old_t;
-          ++new_t;
-        }
+        auto* const new_storage = static_cast<char*>(::sus::mem::allocate(
+            bytes.primitive_value, alignof(T), location));
+        ::sus::mem::relocate_slice(::sus::marker::unsafe_fn,
+                                   reinterpret_cast<T*>(storage_),
+                                   reinterpret_cast<T*>(new_storage),
+                                   len_.primitive_value);
+        ::sus::mem::deallocate(storage_, alignof(T));
         storage_ = new_storage;
       }
     }
     capacity_ = cap;
   }
 
+  /// Shrinks the capacity of the vector as much as possible, so that it holds
+  /// only its current elements.
+  void shrink_to_fit(const std::source_location location =
+                         std::source_location::current()) noexcept {
+    check(!is_moved_from());
+    if (capacity_ == len_) return;  // Nothing to do.
+    if (len_ == 0u) {
+      free_storage();
+      storage_ = nullptr;
+      capacity_ = 0_usize;
+      return;
+    }
+    const auto bytes = ::sus::mem::size_of<T>() * len_;
+    if constexpr (::sus::mem::relocate_by_memcpy<T>) {
+      storage_ = static_cast<char*>(::sus::mem::reallocate(
+          storage_, size_t{::sus::mem::size_of<T>() * capacity_},
+          bytes.primitive_value, alignof(T), location));
+    } else {
+      auto* const new_storage = static_cast<char*>(::sus::mem::allocate(
+          bytes.primitive_value, alignof(T), location));
+      ::sus::mem::relocate_slice(::sus::marker::unsafe_fn,
+                                 reinterpret_cast<T*>(storage_),
+                                 reinterpret_cast<T*>(new_storage),
+                                 len_.primitive_value);
+      ::sus::mem::deallocate(storage_, alignof(T));
+      storage_ = new_storage;
+    }
+    capacity_ = len_;
+  }
+
   // TODO: Clone.
 
   /// Returns the number of elements in the vector.
@@ -251,6 +297,23 @@ class Vec {
     return capacity_;
   }
 
+  /// Forces the length of the vector to `new_len`.
+  ///
+  /// This is a low-level operation that maintains none of the normal
+  /// invariants of the type. Normally changing the length of a vector is done
+  /// using one of the safe operations instead, such as `push()` or `clear()`.
+  ///
+  /// # Safety
+  /// The `new_len` must be less than or equal to `capacity()`, and the elements
+  /// at `old_len..new_len` must be initialized. Elements at `new_len..old_len`
+  /// will not be destroyed, so they must have been moved out or relocated
+  /// elsewhere already.
+  constexpr void set_len(::sus::marker::UnsafeFnMarker,
+                         usize new_len) noexcept {
+    check(!is_moved_from());
+    len_ = new_len;
+  }
+
   /// Removes the last element from a vector and returns it, or None if it is
   /// empty.
   Option<T> pop() noexcept {
@@ -275,11 +338,12 @@ class Vec {
   // Avoids use of a reference, and receives by value, to sidestep the whole
   // issue of the reference being to something inside the vector which
   // reserve() then invalidates.
-  void push(T t) noexcept
+  void push(T t, const std::source_location location =
+                    std::source_location::current()) noexcept
     requires(::sus::mem::Move<T> && !std::is_reference_v<T>)
   {
     check(!is_moved_from());
-    reserve(1_usize);
+    reserve(1_usize, location);
     new (as_mut_ptr() + len_.primitive_value) T(::sus::move(t));
     len_ += 1_usize;
   }
@@ -393,6 +457,193 @@ class Vec {
     as_mut().sort_by(sus::move(compare));
   }
 
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]contains]
+  bool contains(const T& x) const& noexcept
+    requires(::sus::ops::Eq<T>)
+  {
+    return as_ref().contains(x);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]position]
+  Option<usize> position(const T& x) const& noexcept
+    requires(::sus::ops::Eq<T>)
+  {
+    return as_ref().position(x);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]starts_with]
+  template <class U>
+    requires(::sus::ops::Eq<T, U>)
+  bool starts_with(const Slice<U>& needle) const& noexcept {
+    return as_ref().starts_with(needle);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]ends_with]
+  template <class U>
+    requires(::sus::ops::Eq<T, U>)
+  bool ends_with(const Slice<U>& needle) const& noexcept {
+    return as_ref().ends_with(needle);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]find_subslice]
+  template <class U>
+    requires(::sus::ops::Eq<T, U>)
+  Option<usize> find_subslice(const Slice<U>& needle) const& noexcept {
+    return as_ref().find_subslice(needle);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]binary_search]
+  ::sus::result::Result<usize, usize> binary_search(const T& x) const& noexcept
+    requires(::sus::ops::Ord<T>)
+  {
+    return as_ref().binary_search(x);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]binary_search_by]
+  template <class F, int&..., class R = std::invoke_result_t<F, const T&>>
+    requires(::sus::ops::Ordering<R>)
+  ::sus::result::Result<usize, usize> binary_search_by(F f) const& noexcept {
+    return as_ref().binary_search_by(::sus::move(f));
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]binary_search_by_key]
+  template <class Key, class F, int&...,
+            class R = std::invoke_result_t<F, const T&>>
+    requires(::sus::ops::Ord<R, Key>)
+  ::sus::result::Result<usize, usize> binary_search_by_key(
+      const Key& key, F f) const& noexcept {
+    return as_ref().binary_search_by_key(key, ::sus::move(f));
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]partition_point]
+  template <class F, int&..., class R = std::invoke_result_t<F, const T&>>
+    requires(std::same_as<R, bool>)
+  usize partition_point(F pred) const& noexcept {
+    return as_ref().partition_point(::sus::move(pred));
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]par_iter]
+  auto par_iter() const& noexcept { return as_ref().par_iter(); }
+  auto par_iter() && = delete;
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]par_iter_mut]
+  auto par_iter_mut() & noexcept { return as_mut().par_iter_mut(); }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]chunks]
+  Chunks<const T> chunks(usize chunk_size) const& noexcept {
+    return as_ref().chunks(chunk_size);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]chunks_mut]
+  Chunks<T> chunks_mut(usize chunk_size) & noexcept {
+    return as_mut().chunks_mut(chunk_size);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]chunks_exact]
+  ChunksExact<const T> chunks_exact(usize chunk_size) const& noexcept {
+    return as_ref().chunks_exact(chunk_size);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]chunks_exact_mut]
+  ChunksExact<T> chunks_exact_mut(usize chunk_size) & noexcept {
+    return as_mut().chunks_exact_mut(chunk_size);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]rchunks]
+  RChunks<const T> rchunks(usize chunk_size) const& noexcept {
+    return as_ref().rchunks(chunk_size);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]windows]
+  Windows<const T> windows(usize size) const& noexcept {
+    return as_ref().windows(size);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]split]
+  template <class Pred, int&...,
+            class R = std::invoke_result_t<Pred&, const T&>>
+    requires(std::same_as<R, bool>)
+  Split<const T, Pred> split(Pred pred) const& noexcept {
+    return as_ref().split(::sus::move(pred));
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]array_chunks]
+  template <size_t N>
+    requires(N > 0u && N <= PTRDIFF_MAX)
+  ArrayChunks<const T, N> array_chunks() const& noexcept {
+    return as_ref().template array_chunks<N>();
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]array_chunks_mut]
+  template <size_t N>
+    requires(N > 0u && N <= PTRDIFF_MAX)
+  ArrayChunks<T, N> array_chunks_mut() & noexcept {
+    return as_mut().template array_chunks_mut<N>();
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]swap_bytes_in_place]
+  void swap_bytes_in_place() & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    as_mut().swap_bytes_in_place();
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]to_be_in_place]
+  void to_be_in_place() & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    as_mut().to_be_in_place();
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]to_le_in_place]
+  void to_le_in_place() & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    as_mut().to_le_in_place();
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]from_be_in_place]
+  void from_be_in_place() & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    as_mut().from_be_in_place();
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]from_le_in_place]
+  void from_le_in_place() & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    as_mut().from_le_in_place();
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]copy_from_be_bytes]
+  void copy_from_be_bytes(Slice<const ::sus::num::u8> bytes) & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    as_mut().copy_from_be_bytes(bytes);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]copy_from_le_bytes]
+  void copy_from_le_bytes(Slice<const ::sus::num::u8> bytes) & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    as_mut().copy_from_le_bytes(bytes);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]copy_to_be_bytes]
+  void copy_to_be_bytes(Slice<::sus::num::u8> bytes) const& noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    as_ref().copy_to_be_bytes(bytes);
+  }
+
+  /// #[doc.inherit=[n]sus::[n]containers::[r]Slice::[f]copy_to_le_bytes]
+  void copy_to_le_bytes(Slice<::sus::num::u8> bytes) const& noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    as_ref().copy_to_le_bytes(bytes);
+  }
+
   /// Returns a const pointer to the first element in the vector.
   ///
   /// # Panics
@@ -460,15 +711,48 @@ class Vec {
     return VecIntoIter<T>::with(::sus::move(*this));
   }
 
+  /// sus::ops::Eq<Vec<T>, Vec<U>> trait.
+  ///
+  /// Vecs of integers are compared with memcmp().
+  template <class U>
+    requires(::sus::ops::Eq<T, U>)
+  bool operator==(const Vec<U>& r) const& noexcept {
+    return as_ref() == r.as_ref();
+  }
+
+  /// Compares two Vecs lexicographically.
+  ///
+  /// Satisfies sus::ops::Ord<Vec<T>> if sus::ops::Ord<T>.
+  ///
+  /// Satisfies sus::ops::WeakOrd<Vec<T>> if sus::ops::WeakOrd<T>.
+  ///
+  /// Satisfies sus::ops::PartialOrd<Vec<T>> if sus::ops::PartialOrd<T>.
+  ///
+  /// Vecs of unsigned bytes are compared with memcmp().
+  //
+  // sus::ops::Ord<Vec<T>> trait.
+  // sus::ops::WeakOrd<Vec<T>> trait.
+  // sus::ops::PartialOrd<Vec<T>> trait.
+  template <class U>
+    requires(::sus::ops::PartialOrd<T, U>)
+  auto operator<=>(const Vec<U>& r) const& noexcept {
+    return as_ref() <=> r.as_ref();
+  }
+
  private:
+  // Box<T[]> takes over the storage of a Vec<T>.
+  template <class U>
+  friend class ::sus::boxed::Box;
+
   enum Default { kDefault };
   inline constexpr Vec(Default)
       : storage_(nullptr), len_(0_usize), capacity_(0_usize) {}
 
   enum WithCap { kWithCap };
-  Vec(WithCap, usize cap)
-      : storage_(cap > 0_usize ? static_cast<char*>(malloc(
-                                     size_t{::sus::mem::size_of<T>() * cap}))
+  Vec(WithCap, usize cap, const std::source_location& location)
+      : storage_(cap > 0_usize ? static_cast<char*>(::sus::mem::allocate(
+                                     size_t{::sus::mem::size_of<T>() * cap},
+                                     alignof(T), location))
                                : nullptr),
         len_(0_usize),
         capacity_(cap) {
@@ -497,7 +781,7 @@ class Vec {
 
   inline void free_storage() {
     destroy_storage_objects();
-    free(storage_);
+    if (is_alloced()) ::sus::mem::deallocate(storage_, alignof(T));
   }
 
   // Checks if Vec has storage allocated.
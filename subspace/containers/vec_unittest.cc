@@ -14,6 +14,7 @@
 // limitations under the License.
 
 #include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/array.h"
 #include "subspace/containers/vec.h"
 #include "subspace/iter/iterator.h"
 #include "subspace/mem/move.h"
@@ -466,6 +467,21 @@ TEST(Vec, GrowToExact) {
   }
 }
 
+TEST(Vec, ShrinkToFit) {
+  auto v = Vec<i32>::with_capacity(5_usize);
+  v.push(1_i32);
+  v.push(2_i32);
+  v.shrink_to_fit();
+  EXPECT_EQ(v.capacity(), 2_usize);
+  EXPECT_EQ(v[0u], 1_i32);
+  EXPECT_EQ(v[1u], 2_i32);
+  v.clear();
+  v.shrink_to_fit();
+  EXPECT_EQ(v.capacity(), 0_usize);
+  v.push(3_i32);
+  EXPECT_EQ(v[0u], 3_i32);
+}
+
 TEST(Vec, Collect) {
   auto v = Vec<i32>();
   v.push(1_i32);
@@ -780,4 +796,67 @@ TEST(Vec, SortUnstableBy) {
     EXPECT_EQ(sorted[i], unsorted[i]);
   }
 }
+
+TEST(Vec, Eq) {
+  static_assert(sus::ops::Eq<sus::Vec<i32>>);
+  static_assert(sus::ops::Ord<sus::Vec<u8>>);
+  static_assert(sus::ops::PartialOrd<sus::Vec<f32>>);
+  static_assert(!sus::ops::Ord<sus::Vec<f32>>);
+
+  sus::Vec<i32> a = sus::vec(1, 2, 3);
+  sus::Vec<i32> b = sus::vec(1, 2, 3);
+  EXPECT_EQ(a, b);
+  b.push(4);
+  EXPECT_NE(a, b);
+  EXPECT_LT(a, b);
+  EXPECT_EQ(sus::Vec<i32>(), sus::Vec<i32>());
+}
+
+TEST(Vec, Search) {
+  sus::Vec<u8> v = sus::vec(1_u8, 2_u8, 3_u8, 4_u8);
+  sus::Vec<u8> pre = sus::vec(1_u8, 2_u8);
+  sus::Vec<u8> mid = sus::vec(2_u8, 3_u8);
+  EXPECT_TRUE(v.contains(3_u8));
+  EXPECT_FALSE(v.contains(5_u8));
+  EXPECT_EQ(v.position(4_u8).unwrap(), 3_usize);
+  EXPECT_TRUE(v.starts_with(pre.as_ref()));
+  EXPECT_FALSE(v.ends_with(pre.as_ref()));
+  EXPECT_EQ(v.find_subslice(mid.as_ref()).unwrap(), 1_usize);
+}
+
+TEST(Vec, Chunks) {
+  sus::Vec<i32> v = sus::vec(1, 2, 3, 4, 5);
+  EXPECT_EQ(v.chunks(2u).count(), 3_usize);
+  EXPECT_EQ(v.chunks_exact(2u).remainder()[0u], 5);
+  EXPECT_EQ(v.rchunks(2u).next().unwrap()[0u], 4);
+  EXPECT_EQ(v.windows(2u).count(), 4_usize);
+  EXPECT_EQ(v.split([](const i32& x) { return x == 3; }).count(), 2_usize);
+
+  for (sus::Slice<i32> c : v.chunks_exact_mut(2u)) c[0u] = 0;
+  EXPECT_EQ(v[2u], 0);
+  for (sus::Array<i32, 2>& c : v.array_chunks_mut<2u>()) c[1u] = 0;
+  EXPECT_EQ(v[3u], 0);
+  i32 sum = 0;
+  for (const sus::Array<i32, 2>& c : v.array_chunks<2u>()) sum += c[0u];
+  EXPECT_EQ(sum, 0);
+  EXPECT_EQ(v[4u], 5);
+}
+
+TEST(Vec, Endian) {
+  sus::Vec<u32> v = sus::vec(0x01020304_u32, 0x05060708_u32);
+  v.swap_bytes_in_place();
+  EXPECT_EQ(v[0u], 0x04030201_u32);
+  v.swap_bytes_in_place();
+
+  auto bytes = sus::Vec<u8>();
+  for (int i = 0; i < 8; ++i) bytes.push(0_u8);
+  v.copy_to_be_bytes(bytes.as_mut());
+  EXPECT_EQ(bytes[0u], 0x01_u8);
+  EXPECT_EQ(bytes[7u], 0x08_u8);
+
+  sus::Vec<u32> w = sus::vec(0_u32, 0_u32);
+  w.copy_from_le_bytes(bytes.as_ref());
+  EXPECT_EQ(w[0u], 0x04030201_u32);
+}
+
 }  // namespace
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "subspace/mem/alloc.h"
 #include "subspace/option/option.h"
 
 namespace sus::fn::__private {
@@ -30,6 +31,8 @@ struct FnStorageVtable final : public FnStorageVtableBase {
   R (*call_once)(__private::FnStorageBase&&, CallArgs...);
   R (*call_mut)(__private::FnStorageBase&, CallArgs...);
   R (*call)(const __private::FnStorageBase&, CallArgs...);
+  // Destroys the FnStorage and frees its heap allocation.
+  void (*destroy)(__private::FnStorageBase&);
 };
 
 template <class F>
@@ -37,6 +40,17 @@ class FnStorage final : public FnStorageBase {
  public:
   constexpr FnStorage(F&& callable) : callable_(::sus::move(callable)) {}
 
+  static FnStorage& create(F&& callable) noexcept {
+    void* p = ::sus::mem::allocate(sizeof(FnStorage), alignof(FnStorage));
+    return *new (p) FnStorage(::sus::move(callable));
+  }
+
+  static void destroy(FnStorageBase& self_base) noexcept {
+    auto& self = static_cast<FnStorage&>(self_base);
+    self.~FnStorage();
+    ::sus::mem::deallocate(&self, alignof(FnStorage));
+  }
+
   template <class R, class... CallArgs>
   static R call(const FnStorageBase& self_base, CallArgs... callargs) {
     const auto& self = static_cast<const FnStorage&>(self_base);
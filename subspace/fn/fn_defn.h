@@ -240,6 +240,9 @@ class [[sus_trivial_abi]] FnOnce<R(CallArgs...)> {
   static void make_vtable(FnStorage&,
                           __private::StorageConstructionFnType) noexcept;
 
+  // Destroys and frees the heap storage through its vtable.
+  static void destroy_storage(__private::FnStorageBase& storage) noexcept;
+
   sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(fn_ptr_),
                                   decltype(storage_), decltype(type_));
   // Set the never value field to FnPointer to perform a no-op destruction as
@@ -37,11 +37,9 @@ FnOnce<R(CallArgs...)>::FnOnce(ConstructionType construction,
                                F&& lambda) noexcept
     : type_(__private::Storage) {
   using FnStorage = __private::FnStorage<F>;
-  // TODO: Allow overriding the global allocator? Use the allocator in place of
-  // `new` and `delete` directly?
-  auto* s = new FnStorage(::sus::move(lambda));
-  make_vtable(*s, construction);
-  storage_ = s;
+  auto& s = FnStorage::create(::sus::move(lambda));
+  make_vtable(s, construction);
+  storage_ = &s;
 }
 
 template <class R, class... CallArgs>
@@ -52,6 +50,7 @@ void FnOnce<R(CallArgs...)>::make_vtable(
       .call_once = &FnStorage::template call_once<R, CallArgs...>,
       .call_mut = nullptr,
       .call = nullptr,
+      .destroy = &FnStorage::destroy,
   };
   storage.vtable.insert(vtable);
 }
@@ -64,6 +63,7 @@ void FnOnce<R(CallArgs...)>::make_vtable(
       .call_once = &FnStorage::template call_once<R, CallArgs...>,
       .call_mut = &FnStorage::template call_mut<R, CallArgs...>,
       .call = nullptr,
+      .destroy = &FnStorage::destroy,
   };
   storage.vtable.insert(vtable);
 }
@@ -76,10 +76,19 @@ void FnOnce<R(CallArgs...)>::make_vtable(
       .call_once = &FnStorage::template call_once<R, CallArgs...>,
       .call_mut = &FnStorage::template call_mut<R, CallArgs...>,
       .call = &FnStorage::template call<R, CallArgs...>,
+      .destroy = &FnStorage::destroy,
   };
   storage.vtable.insert(vtable);
 }
 
+template <class R, class... CallArgs>
+void FnOnce<R(CallArgs...)>::destroy_storage(
+    __private::FnStorageBase& storage) noexcept {
+  auto& vtable = static_cast<const __private::FnStorageVtable<R, CallArgs...>&>(
+      storage.vtable.as_mut().unwrap());
+  vtable.destroy(storage);
+}
+
 template <class R, class... CallArgs>
 FnOnce<R(CallArgs...)>::~FnOnce() noexcept {
   switch (type_) {
@@ -88,7 +97,7 @@ FnOnce<R(CallArgs...)>::~FnOnce() noexcept {
     case __private::FnPointer: break;
     case __private::Storage: {
       if (auto* s = ::sus::mem::replace_ptr(mref(storage_), nullptr); s)
-        delete s;
+        destroy_storage(*s);
       break;
     }
   }
@@ -114,7 +123,7 @@ FnOnce<R(CallArgs...)>& FnOnce<R(CallArgs...)>::operator=(FnOnce&& o) noexcept {
     case __private::FnPointer: break;
     case __private::Storage:
       if (auto* s = ::sus::mem::replace_ptr(mref(storage_), nullptr); s)
-        delete s;
+        destroy_storage(*s);
   }
   switch (type_ = o.type_) {
     case __private::FnPointer:
@@ -151,7 +160,7 @@ R FnOnce<R(CallArgs...)>::operator()(CallArgs&&... args) && noexcept {
         sus_clang_bug_54040(
             constexpr inline DeleteStorage(__private::FnStorageBase* storage)
             : storage(storage){});
-        ~DeleteStorage() { delete storage; }
+        ~DeleteStorage() { destroy_storage(*storage); }
         __private::FnStorageBase* storage;
       } deleter(storage);
 
@@ -0,0 +1,197 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/fs/mmap.h"
+
+#include <stdint.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sus::fs {
+
+using ::sus::io::Error;
+using ::sus::io::FileDesc;
+using ::sus::io::Result;
+
+#if defined(_WIN32)
+
+// Memory maps are not implemented on Windows yet.
+
+Result<Mmap> Mmap::open(const char*) noexcept {
+  return Result<Mmap>::with_err(Error(Error::Kind::Unsupported));
+}
+Result<Mmap> Mmap::map(const FileDesc&) noexcept {
+  return Result<Mmap>::with_err(Error(Error::Kind::Unsupported));
+}
+::sus::Option<Error> Mmap::advise(Advice) const& noexcept {
+  return ::sus::Option<Error>::some(Error(Error::Kind::Unsupported));
+}
+void Mmap::unmap() noexcept {}
+
+Result<MmapMut> MmapMut::create(const char*, usize) noexcept {
+  return Result<MmapMut>::with_err(Error(Error::Kind::Unsupported));
+}
+Result<MmapMut> MmapMut::map_anon(usize) noexcept {
+  return Result<MmapMut>::with_err(Error(Error::Kind::Unsupported));
+}
+::sus::Option<Error> MmapMut::flush() const& noexcept {
+  return ::sus::Option<Error>::some(Error(Error::Kind::Unsupported));
+}
+::sus::Option<Error> MmapMut::advise(Advice) const& noexcept {
+  return ::sus::Option<Error>::some(Error(Error::Kind::Unsupported));
+}
+Result<Mmap> MmapMut::make_read_only() && noexcept {
+  return Result<Mmap>::with_err(Error(Error::Kind::Unsupported));
+}
+void MmapMut::unmap() noexcept {}
+
+#else
+
+namespace {
+
+/// Returns the size of the open file `fd`, or an error if it does not fit in
+/// the address space.
+Result<size_t> file_size(int fd) noexcept {
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    return Result<size_t>::with_err(Error::last_os_error());
+  }
+  if (st.st_size < 0 ||
+      static_cast<uintmax_t>(st.st_size) > static_cast<uintmax_t>(SIZE_MAX)) {
+    return Result<size_t>::with_err(Error(Error::Kind::OutOfMemory));
+  }
+  return Result<size_t>::with(static_cast<size_t>(st.st_size));
+}
+
+/// Maps `len` bytes of `fd`, or of anonymous memory if `fd` is -1. An empty
+/// mapping is represented by a null pointer, as `mmap()` rejects a length of
+/// zero.
+Result<void*> map_fd(int fd, size_t len, int prot) noexcept {
+  if (len == 0u) return Result<void*>::with(nullptr);
+  const int flags = fd < 0 ? MAP_PRIVATE | MAP_ANONYMOUS : MAP_SHARED;
+  void* const ptr = ::mmap(nullptr, len, prot, flags, fd, 0);
+  if (ptr == MAP_FAILED) return Result<void*>::with_err(Error::last_os_error());
+  return Result<void*>::with(ptr);
+}
+
+::sus::Option<Error> advise_range(void* ptr, size_t len,
+                                  Advice advice) noexcept {
+  if (len == 0u) return ::sus::Option<Error>::none();
+  int flag = MADV_NORMAL;
+  switch (advice) {
+    case Advice::Normal: flag = MADV_NORMAL; break;
+    case Advice::Sequential: flag = MADV_SEQUENTIAL; break;
+    case Advice::Random: flag = MADV_RANDOM; break;
+    case Advice::WillNeed: flag = MADV_WILLNEED; break;
+    case Advice::HugePage:
+#if defined(MADV_HUGEPAGE)
+      flag = MADV_HUGEPAGE;
+      break;
+#else
+      return ::sus::Option<Error>::some(Error(Error::Kind::Unsupported));
+#endif
+  }
+  if (::madvise(ptr, len, flag) != 0) {
+    return ::sus::Option<Error>::some(Error::last_os_error());
+  }
+  return ::sus::Option<Error>::none();
+}
+
+}  // namespace
+
+Result<Mmap> Mmap::open(const char* path) noexcept {
+  Result<FileDesc> file = FileDesc::open(path);
+  if (file.is_err()) {
+    return Result<Mmap>::with_err(::sus::move(file).unwrap_err());
+  }
+  return map(::sus::move(file).unwrap());
+}
+
+Result<Mmap> Mmap::map(const FileDesc& file) noexcept {
+  Result<size_t> len = file_size(file.as_raw_fd());
+  if (len.is_err()) {
+    return Result<Mmap>::with_err(::sus::move(len).unwrap_err());
+  }
+  const size_t size = ::sus::move(len).unwrap();
+  Result<void*> ptr = map_fd(file.as_raw_fd(), size, PROT_READ);
+  if (ptr.is_err()) {
+    return Result<Mmap>::with_err(::sus::move(ptr).unwrap_err());
+  }
+  return Result<Mmap>::with(Mmap(::sus::move(ptr).unwrap(), size));
+}
+
+::sus::Option<Error> Mmap::advise(Advice advice) const& noexcept {
+  return advise_range(ptr_, len_, advice);
+}
+
+void Mmap::unmap() noexcept { ::munmap(ptr_, len_); }
+
+Result<MmapMut> MmapMut::create(const char* path, usize len) noexcept {
+  // FileDesc::create() opens the file write-only, but a shared writable
+  // mapping needs the file to be readable as well.
+  const int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+  if (fd < 0) return Result<MmapMut>::with_err(Error::last_os_error());
+  // Closes the file once it is mapped.
+  const auto file = FileDesc::from_raw_fd(::sus::marker::unsafe_fn, fd);
+  if (::ftruncate(fd, static_cast<off_t>(len.primitive_value)) != 0) {
+    return Result<MmapMut>::with_err(Error::last_os_error());
+  }
+  Result<void*> ptr =
+      map_fd(fd, len.primitive_value, PROT_READ | PROT_WRITE);
+  if (ptr.is_err()) {
+    return Result<MmapMut>::with_err(::sus::move(ptr).unwrap_err());
+  }
+  return Result<MmapMut>::with(
+      MmapMut(::sus::move(ptr).unwrap(), len.primitive_value));
+}
+
+Result<MmapMut> MmapMut::map_anon(usize len) noexcept {
+  Result<void*> ptr = map_fd(-1, len.primitive_value, PROT_READ | PROT_WRITE);
+  if (ptr.is_err()) {
+    return Result<MmapMut>::with_err(::sus::move(ptr).unwrap_err());
+  }
+  return Result<MmapMut>::with(
+      MmapMut(::sus::move(ptr).unwrap(), len.primitive_value));
+}
+
+::sus::Option<Error> MmapMut::flush() const& noexcept {
+  if (len_ > 0u && ::msync(ptr_, len_, MS_SYNC) != 0) {
+    return ::sus::Option<Error>::some(Error::last_os_error());
+  }
+  return ::sus::Option<Error>::none();
+}
+
+::sus::Option<Error> MmapMut::advise(Advice advice) const& noexcept {
+  return advise_range(ptr_, len_, advice);
+}
+
+Result<Mmap> MmapMut::make_read_only() && noexcept {
+  if (len_ > 0u && ::mprotect(ptr_, len_, PROT_READ) != 0) {
+    return Result<Mmap>::with_err(Error::last_os_error());
+  }
+  void* const ptr = ::sus::mem::replace_ptr(mref(ptr_), nullptr);
+  const size_t len = ::sus::mem::replace(mref(len_), size_t{0});
+  return Result<Mmap>::with(Mmap(ptr, len));
+}
+
+void MmapMut::unmap() noexcept { ::munmap(ptr_, len_); }
+
+#endif
+
+}  // namespace sus::fs
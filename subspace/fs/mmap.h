@@ -0,0 +1,204 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include "subspace/containers/slice.h"
+#include "subspace/io/error.h"
+#include "subspace/io/file_desc.h"
+#include "subspace/macros/compiler.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/option/option.h"
+
+namespace sus::fs {
+
+/// A hint to the operating system about how a memory map will be accessed,
+/// given to `Mmap::advise()` and `MmapMut::advise()`.
+enum class Advice {
+  /// No special treatment. This is the default.
+  Normal,
+  /// The pages will be accessed in order, so they can be read ahead
+  /// aggressively and dropped soon after they are accessed.
+  Sequential,
+  /// The pages will be accessed in random order, so reading ahead is not
+  /// useful.
+  Random,
+  /// The pages will be accessed soon, so they should be read in now.
+  WillNeed,
+  /// The mapping should be backed by huge pages where possible, to reduce
+  /// TLB misses. Only supported on Linux.
+  HugePage,
+};
+
+/// A read-only memory map of a file.
+///
+/// The contents of the file are exposed as a `Slice<const u8>`, and are read
+/// from the file by the operating system as they are accessed, without
+/// copying them into a buffer first. This is often the fastest way to scan a
+/// large file, especially with `Advice::Sequential`.
+///
+/// The `Slice` returned by `as_slice()` points into the mapping, so it must
+/// not outlive the `Mmap`. It can not be taken from a temporary `Mmap`.
+///
+/// # Safety
+/// The file must not be truncated or modified while it is mapped. Doing so
+/// changes the contents of the `Slice`, or makes accessing it crash.
+class [[sus_trivial_abi]] Mmap final {
+ public:
+  /// Opens the file at `path` and maps all of it.
+  static ::sus::io::Result<Mmap> open(const char* path) noexcept;
+
+  /// Maps all of an open file. The file must have been opened for reading,
+  /// and may be closed once it is mapped.
+  static ::sus::io::Result<Mmap> map(
+      const ::sus::io::FileDesc& file) noexcept;
+
+  Mmap(Mmap&& o) noexcept
+      : ptr_(::sus::mem::replace_ptr(mref(o.ptr_), nullptr)),
+        len_(::sus::mem::replace(mref(o.len_), size_t{0})) {}
+  Mmap& operator=(Mmap&& o) noexcept {
+    if (&o == this) return *this;
+    if (ptr_) unmap();
+    ptr_ = ::sus::mem::replace_ptr(mref(o.ptr_), nullptr);
+    len_ = ::sus::mem::replace(mref(o.len_), size_t{0});
+    return *this;
+  }
+
+  /// Unmaps the file.
+  ~Mmap() noexcept {
+    if (ptr_) unmap();
+  }
+
+  /// Returns the number of bytes in the mapping, which is the size of the
+  /// file when it was mapped.
+  usize len() const noexcept { return len_; }
+  /// Returns true if the mapping is empty.
+  bool is_empty() const noexcept { return len_ == 0u; }
+
+  /// Returns the contents of the mapping.
+  ::sus::Slice<const u8> as_slice() const& noexcept
+      sus_if_clang([[clang::lifetimebound]]) {
+    return ::sus::Slice<const u8>::from_raw_parts(
+        ::sus::marker::unsafe_fn, static_cast<const u8*>(ptr_), usize(len_));
+  }
+  ::sus::Slice<const u8> as_slice() && = delete;
+
+  /// Gives the operating system a hint about how the mapping will be
+  /// accessed. Returns `None` on success.
+  ::sus::Option<::sus::io::Error> advise(Advice advice) const& noexcept;
+
+ private:
+  friend class MmapMut;
+
+  Mmap(void* ptr, size_t len) noexcept : ptr_(ptr), len_(len) {}
+
+  void unmap() noexcept;
+
+  void* ptr_;
+  size_t len_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(ptr_),
+                                  decltype(len_));
+};
+
+/// A writable memory map of a file.
+///
+/// The contents of the file are exposed as a `Slice<u8>`, and writes to the
+/// `Slice` are written back to the file by the operating system. Use
+/// `flush()` to wait until they have been.
+///
+/// The `Slice` returned by `as_slice()` or `as_mut_slice()` points into the
+/// mapping, so it must not outlive the `MmapMut`. It can not be taken from a
+/// temporary `MmapMut`.
+///
+/// # Safety
+/// The file must not be truncated or modified by anything else while it is
+/// mapped.
+class [[sus_trivial_abi]] MmapMut final {
+ public:
+  /// Creates the file at `path`, or truncates it if it exists, and sets its
+  /// size to `len` bytes of zeros. Then maps all of it.
+  static ::sus::io::Result<MmapMut> create(const char* path,
+                                           usize len) noexcept;
+
+  /// Maps `len` bytes of zeroed memory which is not backed by a file.
+  static ::sus::io::Result<MmapMut> map_anon(usize len) noexcept;
+
+  MmapMut(MmapMut&& o) noexcept
+      : ptr_(::sus::mem::replace_ptr(mref(o.ptr_), nullptr)),
+        len_(::sus::mem::replace(mref(o.len_), size_t{0})) {}
+  MmapMut& operator=(MmapMut&& o) noexcept {
+    if (&o == this) return *this;
+    if (ptr_) unmap();
+    ptr_ = ::sus::mem::replace_ptr(mref(o.ptr_), nullptr);
+    len_ = ::sus::mem::replace(mref(o.len_), size_t{0});
+    return *this;
+  }
+
+  /// Unmaps the file. Writes which were not flushed are still written back
+  /// to the file by the operating system, at some later time.
+  ~MmapMut() noexcept {
+    if (ptr_) unmap();
+  }
+
+  /// Returns the number of bytes in the mapping.
+  usize len() const noexcept { return len_; }
+  /// Returns true if the mapping is empty.
+  bool is_empty() const noexcept { return len_ == 0u; }
+
+  /// Returns the contents of the mapping.
+  ::sus::Slice<const u8> as_slice() const& noexcept
+      sus_if_clang([[clang::lifetimebound]]) {
+    return ::sus::Slice<const u8>::from_raw_parts(
+        ::sus::marker::unsafe_fn, static_cast<const u8*>(ptr_), usize(len_));
+  }
+  ::sus::Slice<const u8> as_slice() && = delete;
+
+  /// Returns the contents of the mapping, which may be written to.
+  ::sus::Slice<u8> as_mut_slice() & noexcept
+      sus_if_clang([[clang::lifetimebound]]) {
+    return ::sus::Slice<u8>::from_raw_parts(
+        ::sus::marker::unsafe_fn, static_cast<u8*>(ptr_), usize(len_));
+  }
+
+  /// Writes any changes back to the file, and waits until they are written.
+  /// Returns `None` on success.
+  ::sus::Option<::sus::io::Error> flush() const& noexcept;
+
+  /// Gives the operating system a hint about how the mapping will be
+  /// accessed. Returns `None` on success.
+  ::sus::Option<::sus::io::Error> advise(Advice advice) const& noexcept;
+
+  /// Makes the mapping read-only, and returns it as an `Mmap`.
+  ::sus::io::Result<Mmap> make_read_only() && noexcept;
+
+ private:
+  MmapMut(void* ptr, size_t len) noexcept : ptr_(ptr), len_(len) {}
+
+  void unmap() noexcept;
+
+  void* ptr_;
+  size_t len_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(ptr_),
+                                  decltype(len_));
+};
+
+}  // namespace sus::fs
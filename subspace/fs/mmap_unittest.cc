@@ -0,0 +1,181 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/fs/mmap.h"
+
+#include <stdlib.h>
+
+#include <string>
+#include <string_view>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/slice.h"
+#include "subspace/io/file_desc.h"
+#include "subspace/io/write.h"
+#include "subspace/prelude.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+namespace {
+
+using sus::fs::Advice;
+using sus::fs::Mmap;
+using sus::fs::MmapMut;
+using sus::io::Error;
+using sus::io::FileDesc;
+
+// The contents can only be borrowed from a named map.
+template <class T>
+concept CanBorrow = requires(T&& m) { static_cast<T&&>(m).as_slice(); };
+template <class T>
+concept CanBorrowMut =
+    requires(T&& m) { static_cast<T&&>(m).as_mut_slice(); };
+static_assert(CanBorrow<const Mmap&>);
+static_assert(!CanBorrow<Mmap&&>);
+static_assert(CanBorrow<const MmapMut&>);
+static_assert(!CanBorrow<MmapMut&&>);
+static_assert(CanBorrowMut<MmapMut&>);
+static_assert(!CanBorrowMut<MmapMut&&>);
+
+#if !defined(_WIN32)
+
+std::string_view as_str(sus::Slice<const u8> s) {
+  if (s.is_empty()) return std::string_view();
+  return std::string_view(reinterpret_cast<const char*>(s.as_ptr()),
+                          s.len().primitive_value);
+}
+
+/// Returns the path to a new file holding `contents`, which is removed when
+/// the `TempFile` is destroyed.
+class TempFile {
+ public:
+  explicit TempFile(std::string_view contents) {
+    const char* dir = getenv("TMPDIR");
+    path_ = std::string(dir ? dir : "/tmp") + "/sus_mmap_XXXXXX";
+    const int fd = mkstemp(path_.data());
+    EXPECT_GE(fd, 0);
+    auto f = FileDesc::from_raw_fd(unsafe_fn, fd);
+    EXPECT_TRUE(sus::io::write_all(
+                    f, sus::Slice<const u8>::from_raw_parts(
+                           unsafe_fn,
+                           reinterpret_cast<const u8*>(contents.data()),
+                           contents.size()))
+                    .is_none());
+  }
+  ~TempFile() { unlink(path_.c_str()); }
+
+  const char* path() const { return path_.c_str(); }
+
+ private:
+  std::string path_;
+};
+
+TEST(Mmap, Open) {
+  std::string contents;
+  for (int i = 0; i < 10000; ++i) contents += static_cast<char>('a' + i % 26);
+  TempFile tmp(contents);
+  Mmap m = Mmap::open(tmp.path()).unwrap();
+  EXPECT_EQ(m.len(), 10000u);
+  EXPECT_FALSE(m.is_empty());
+  EXPECT_EQ(as_str(m.as_slice()), contents);
+  EXPECT_TRUE(m.advise(Advice::Sequential).is_none());
+  EXPECT_TRUE(m.advise(Advice::WillNeed).is_none());
+  EXPECT_TRUE(m.advise(Advice::Random).is_none());
+  EXPECT_TRUE(m.advise(Advice::Normal).is_none());
+  // Huge pages may not be available for file mappings, so the result is not
+  // checked, but it must not break the mapping.
+  (void)m.advise(Advice::HugePage);
+  EXPECT_EQ(as_str(m.as_slice()), contents);
+}
+
+TEST(Mmap, OpenEmpty) {
+  TempFile tmp("");
+  Mmap m = Mmap::open(tmp.path()).unwrap();
+  EXPECT_TRUE(m.is_empty());
+  EXPECT_TRUE(m.as_slice().is_empty());
+  EXPECT_TRUE(m.advise(Advice::Sequential).is_none());
+}
+
+TEST(Mmap, OpenMissing) {
+  auto r = Mmap::open("/this/file/does/not/exist");
+  ASSERT_TRUE(r.is_err());
+  EXPECT_EQ(sus::move(r).unwrap_err().kind(), Error::Kind::NotFound);
+}
+
+TEST(Mmap, MapOutlivesFile) {
+  TempFile tmp("hello");
+  Mmap m = [&]() {
+    FileDesc f = FileDesc::open(tmp.path()).unwrap();
+    return Mmap::map(f).unwrap();
+  }();
+  EXPECT_EQ(as_str(m.as_slice()), "hello");
+}
+
+TEST(Mmap, Move) {
+  TempFile tmp("hello");
+  Mmap a = Mmap::open(tmp.path()).unwrap();
+  Mmap b = sus::move(a);
+  EXPECT_EQ(as_str(b.as_slice()), "hello");
+  EXPECT_TRUE(a.is_empty());
+  a = sus::move(b);
+  EXPECT_EQ(as_str(a.as_slice()), "hello");
+  // Moving into itself does nothing.
+  auto& self = a;
+  a = sus::move(self);
+  EXPECT_EQ(as_str(a.as_slice()), "hello");
+}
+
+TEST(MmapMut, Create) {
+  TempFile tmp("");
+  {
+    MmapMut m = MmapMut::create(tmp.path(), 4096u).unwrap();
+    EXPECT_EQ(m.len(), 4096u);
+    sus::Slice<u8> s = m.as_mut_slice();
+    EXPECT_EQ(s[0u], 0u);
+    EXPECT_EQ(s[4095u], 0u);
+    s[0u] = u8(uint8_t{'a'});
+    s[4095u] = u8(uint8_t{'z'});
+    EXPECT_TRUE(m.flush().is_none());
+  }
+  Mmap m = Mmap::open(tmp.path()).unwrap();
+  ASSERT_EQ(m.len(), 4096u);
+  EXPECT_EQ(m.as_slice()[0u], u8(uint8_t{'a'}));
+  EXPECT_EQ(m.as_slice()[1u], 0u);
+  EXPECT_EQ(m.as_slice()[4095u], u8(uint8_t{'z'}));
+}
+
+TEST(MmapMut, Anon) {
+  MmapMut m = MmapMut::map_anon(1u << 20u).unwrap();
+  EXPECT_TRUE(m.advise(Advice::Sequential).is_none());
+  sus::Slice<u8> s = m.as_mut_slice();
+  for (usize i = 0u; i < s.len(); i += 4096u) s[i] = u8::from(i / 4096u % 256u);
+  EXPECT_EQ(m.as_slice()[4096u * 3u], 3u);
+
+  Mmap ro = sus::move(m).make_read_only().unwrap();
+  EXPECT_EQ(ro.len(), 1u << 20u);
+  EXPECT_EQ(ro.as_slice()[4096u * 3u], 3u);
+  EXPECT_TRUE(m.is_empty());
+}
+
+TEST(MmapMut, AnonEmpty) {
+  MmapMut m = MmapMut::map_anon(0u).unwrap();
+  EXPECT_TRUE(m.is_empty());
+  EXPECT_TRUE(m.flush().is_none());
+}
+
+#endif
+
+}  // namespace
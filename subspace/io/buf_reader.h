@@ -0,0 +1,261 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include "subspace/assertions/check.h"
+#include "subspace/containers/slice.h"
+#include "subspace/containers/vec.h"
+#include "subspace/io/error.h"
+#include "subspace/io/read.h"
+#include "subspace/iter/iterator_defn.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/option/option.h"
+
+namespace sus::io {
+
+/// The buffer capacity used by `BufReader::with()` and `BufWriter::with()`.
+inline constexpr usize DEFAULT_BUF_SIZE = 8u * 1024u;
+
+template <Read R>
+class BufReader;
+
+/// An iterator over the lines of a `BufReader`, returned by
+/// `BufReader::lines()`.
+///
+/// Each line is returned without its trailing `\n` or `\r\n`. A line which is
+/// held entirely in the reader's buffer is returned as a `Slice` into that
+/// buffer, without being copied. A line which spans more than one fill of the
+/// buffer is gathered into a `Vec` owned by the iterator. Either way, the
+/// `Slice` is only valid until `next()` is called again, or the reader is
+/// used.
+template <Read R>
+class [[nodiscard]] Lines final
+    : public ::sus::iter::IteratorImpl<Lines<R>,
+                                       Result<::sus::Slice<const u8>>> {
+ public:
+  using Item = Result<::sus::Slice<const u8>>;
+
+  static Lines with(BufReader<R>& reader) noexcept { return Lines(reader); }
+
+  ::sus::Option<Item> next() noexcept final {
+    scratch_.clear();
+    bool read_any = false;
+    while (true) {
+      Result<::sus::Slice<const u8>> fill = reader_->fill_buf();
+      if (fill.is_err()) {
+        return ::sus::Option<Item>::some(
+            Item::with_err(::sus::move(fill).unwrap_err()));
+      }
+      const ::sus::Slice<const u8> buf = ::sus::move(fill).unwrap();
+      if (buf.is_empty()) {
+        // The end of the input. A last line without a `\n` is still a line.
+        if (!read_any) return ::sus::Option<Item>::none();
+        return ::sus::Option<Item>::some(
+            Item::with(trim_line(scratch_.as_ref())));
+      }
+      read_any = true;
+
+      const u8* const data = buf.as_ptr();
+      const size_t len = buf.len().primitive_value;
+      const auto* newline = static_cast<const u8*>(memchr(data, '\n', len));
+      if (newline == nullptr) {
+        append(data, len);
+        reader_->consume(buf.len());
+        continue;
+      }
+
+      const size_t line_len = static_cast<size_t>(newline - data);
+      // The buffer is not refilled until the next call to `fill_buf()`, so the
+      // line stays valid after being consumed.
+      reader_->consume(usize(line_len + 1u));
+      if (scratch_.is_empty()) {
+        return ::sus::Option<Item>::some(
+            Item::with(trim_line(::sus::Slice<const u8>::from_raw_parts(
+                ::sus::marker::unsafe_fn, data, usize(line_len)))));
+      }
+      append(data, line_len);
+      return ::sus::Option<Item>::some(
+          Item::with(trim_line(scratch_.as_ref())));
+    }
+  }
+
+ private:
+  explicit Lines(BufReader<R>& reader) noexcept : reader_(&reader) {}
+
+  static ::sus::Slice<const u8> trim_line(::sus::Slice<const u8> s) noexcept {
+    if (!s.is_empty() && s[s.len() - 1u] == uint8_t{'\r'}) {
+      return s[::sus::containers::Range{.start = 0u, .len = s.len() - 1u}];
+    }
+    return s;
+  }
+
+  void append(const u8* data, size_t len) noexcept {
+    if (len == 0u) return;
+    const usize old_len = scratch_.len();
+    scratch_.reserve(usize(len));
+    memcpy(scratch_.as_mut_ptr() + old_len.primitive_value, data, len);
+    // SAFETY: The bytes in `[old_len, old_len + len)` were just written.
+    scratch_.set_len(::sus::marker::unsafe_fn, old_len + len);
+  }
+
+  BufReader<R>* reader_;
+  ::sus::Vec<u8> scratch_;
+
+  sus_class_trivially_relocatable_if_types(::sus::marker::unsafe_fn,
+                                           decltype(reader_),
+                                           decltype(scratch_));
+};
+
+/// Adds buffering to a `Read` type.
+///
+/// Each `read()` of a file descriptor or socket is a system call, so reading
+/// a few bytes at a time from one is slow. A `BufReader` reads large chunks
+/// into a buffer of its own, and serves small reads from the buffer.
+///
+/// Reads that are at least as large as the buffer skip it when it is empty,
+/// and go directly to the inner reader.
+///
+/// The buffer is exposed through `fill_buf()` and `consume()`, which allow
+/// parsing the input in place, and `lines()` which splits the input into lines
+/// without copying them.
+///
+/// `BufReader` satisfies the `Read` concept.
+template <Read R>
+class BufReader final {
+ public:
+  /// Constructs a `BufReader` reading from `inner`, with a buffer of
+  /// `DEFAULT_BUF_SIZE` bytes.
+  static BufReader with(R inner) noexcept {
+    return with_capacity(DEFAULT_BUF_SIZE, ::sus::move(inner));
+  }
+
+  /// Constructs a `BufReader` reading from `inner`, with a buffer of
+  /// `capacity` bytes.
+  ///
+  /// # Panics
+  /// Panics if `capacity` is zero.
+  static BufReader with_capacity(usize capacity, R inner) noexcept {
+    ::sus::check_with_message(capacity > 0u,
+                              *"BufReader capacity must be greater than 0");
+    auto buf = ::sus::Vec<u8>::with_capacity(capacity);
+    // SAFETY: The Vec has room for `capacity` bytes, and `u8` has no invalid
+    // values. Only bytes written by the inner reader are ever read.
+    buf.set_len(::sus::marker::unsafe_fn, capacity);
+    return BufReader(::sus::move(inner), ::sus::move(buf));
+  }
+
+  BufReader(BufReader&&) noexcept = default;
+  BufReader& operator=(BufReader&&) noexcept = default;
+
+  /// Reads bytes into `buf`, from the buffer if it holds any, or else from the
+  /// inner reader.
+  ///
+  /// sus::io::Read trait.
+  Result<usize> read(::sus::Slice<u8> buf) noexcept {
+    if (pos_ == filled_ && buf.len() >= buf_.len()) {
+      // Nothing is buffered and the read would fill the buffer anyway, so
+      // skip the copy.
+      return inner_.read(buf);
+    }
+    Result<::sus::Slice<const u8>> fill = fill_buf();
+    if (fill.is_err()) {
+      return Result<usize>::with_err(::sus::move(fill).unwrap_err());
+    }
+    const ::sus::Slice<const u8> avail = ::sus::move(fill).unwrap();
+    const usize n = avail.len() < buf.len() ? avail.len() : buf.len();
+    if (n > 0u) memcpy(buf.as_mut_ptr(), avail.as_ptr(), n.primitive_value);
+    consume(n);
+    return Result<usize>::with(n);
+  }
+
+  /// Returns the bytes in the buffer, first reading more from the inner
+  /// reader if the buffer is empty.
+  ///
+  /// An empty `Slice` is returned at the end of the input. The bytes stay in
+  /// the buffer until they are marked as used with `consume()`.
+  Result<::sus::Slice<const u8>> fill_buf() & noexcept {
+    if (pos_ >= filled_) {
+      Result<usize> read = inner_.read(::sus::Slice<u8>::from_raw_parts(
+          ::sus::marker::unsafe_fn, buf_.as_mut_ptr(), buf_.len()));
+      if (read.is_err()) {
+        return Result<::sus::Slice<const u8>>::with_err(
+            ::sus::move(read).unwrap_err());
+      }
+      filled_ = ::sus::move(read).unwrap();
+      pos_ = 0u;
+    }
+    return Result<::sus::Slice<const u8>>::with(buffer());
+  }
+
+  /// Marks `amount` bytes at the front of the buffer as used, so they are not
+  /// returned again by `fill_buf()` or `read()`.
+  ///
+  /// # Panics
+  /// Panics if `amount` is more than the number of bytes in the buffer.
+  void consume(usize amount) & noexcept {
+    ::sus::check(amount <= filled_ - pos_);
+    pos_ += amount;
+  }
+
+  /// Returns an iterator over the lines of the input.
+  ///
+  /// The iterator borrows the `BufReader`, which must outlive it.
+  Lines<R> lines() & noexcept { return Lines<R>::with(*this); }
+
+  /// Returns the bytes in the buffer which have not been used yet, without
+  /// reading from the inner reader.
+  ::sus::Slice<const u8> buffer() const& noexcept {
+    return buf_.as_ref()[::sus::containers::Range{.start = pos_,
+                                                  .len = filled_ - pos_}];
+  }
+  ::sus::Slice<const u8> buffer() && = delete;
+
+  /// Returns the size of the buffer.
+  usize capacity() const noexcept { return buf_.len(); }
+
+  /// Returns a const reference to the inner reader.
+  const R& get_ref() const& noexcept { return inner_; }
+  const R& get_ref() && = delete;
+
+  /// Returns a mutable reference to the inner reader.
+  ///
+  /// Reading directly from the inner reader will skip over any bytes in the
+  /// buffer.
+  R& get_mut() & noexcept { return inner_; }
+
+  /// Returns the inner reader. Any bytes left in the buffer are lost.
+  R into_inner() && noexcept { return ::sus::move(inner_); }
+
+ private:
+  BufReader(R&& inner, ::sus::Vec<u8>&& buf) noexcept
+      : inner_(::sus::move(inner)), buf_(::sus::move(buf)) {}
+
+  R inner_;
+  ::sus::Vec<u8> buf_;
+  usize pos_ = 0u;
+  usize filled_ = 0u;
+
+  sus_class_trivially_relocatable_if_types(::sus::marker::unsafe_fn,
+                                           decltype(inner_), decltype(buf_),
+                                           decltype(pos_), decltype(filled_));
+};
+
+}  // namespace sus::io
@@ -0,0 +1,197 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/io/buf_reader.h"
+
+#include <string>
+#include <string_view>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/slice.h"
+#include "subspace/containers/vec.h"
+#include "subspace/io/cursor.h"
+#include "subspace/io/read.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::io::BufReader;
+using sus::io::Cursor;
+using sus::io::Error;
+using sus::io::Result;
+
+sus::Slice<const u8> bytes(std::string_view s) {
+  return sus::Slice<const u8>::from_raw_parts(
+      unsafe_fn, reinterpret_cast<const u8*>(s.data()), s.size());
+}
+
+std::string_view as_str(sus::Slice<const u8> s) {
+  if (s.is_empty()) return std::string_view();
+  return std::string_view(reinterpret_cast<const char*>(s.as_ptr()),
+                          s.len().primitive_value);
+}
+
+/// A reader which returns at most `max` bytes from each read, and counts the
+/// reads made of it.
+struct Trickle {
+  Result<usize> read(sus::Slice<u8> buf) noexcept {
+    reads += 1u;
+    if (buf.len() > max) {
+      buf = buf[sus::containers::Range{.start = 0u, .len = max}];
+    }
+    return cursor.read(buf);
+  }
+
+  Cursor<sus::Slice<const u8>> cursor;
+  usize max;
+  usize reads = 0u;
+};
+
+/// A reader which fails every read.
+struct Failing {
+  Result<usize> read(sus::Slice<u8>) noexcept {
+    return Result<usize>::with_err(Error(Error::Kind::PermissionDenied));
+  }
+};
+
+static_assert(sus::io::Read<BufReader<Trickle>>);
+
+TEST(BufReader, SmallReadsAreBuffered) {
+  auto r = BufReader<Trickle>::with_capacity(
+      16u, Trickle{.cursor = Cursor<sus::Slice<const u8>>::with(
+                       bytes("abcdefghijklmnopqrstuvwxyz")),
+                   .max = 100u});
+  EXPECT_EQ(r.capacity(), 16u);
+  u8 buf[4];
+  EXPECT_EQ(r.read(sus::Slice<u8>::from(buf)).unwrap(), 4u);
+  EXPECT_EQ(as_str(sus::Slice<const u8>::from(buf)), "abcd");
+  EXPECT_EQ(r.buffer().len(), 12u);
+  EXPECT_EQ(r.read(sus::Slice<u8>::from(buf)).unwrap(), 4u);
+  EXPECT_EQ(r.read(sus::Slice<u8>::from(buf)).unwrap(), 4u);
+  EXPECT_EQ(r.read(sus::Slice<u8>::from(buf)).unwrap(), 4u);
+  EXPECT_EQ(as_str(sus::Slice<const u8>::from(buf)), "mnop");
+  // One read of the inner reader filled the buffer for all four.
+  EXPECT_EQ(r.get_ref().reads, 1u);
+
+  EXPECT_EQ(r.read(sus::Slice<u8>::from(buf)).unwrap(), 4u);
+  EXPECT_EQ(r.get_ref().reads, 2u);
+}
+
+TEST(BufReader, LargeReadsSkipTheBuffer) {
+  auto r = BufReader<Trickle>::with_capacity(
+      4u, Trickle{.cursor = Cursor<sus::Slice<const u8>>::with(
+                      bytes("abcdefghij")),
+                  .max = 100u});
+  u8 buf[8];
+  EXPECT_EQ(r.read(sus::Slice<u8>::from(buf)).unwrap(), 8u);
+  EXPECT_EQ(as_str(sus::Slice<const u8>::from(buf)), "abcdefgh");
+  EXPECT_EQ(r.buffer().len(), 0u);
+  EXPECT_EQ(r.get_ref().reads, 1u);
+}
+
+TEST(BufReader, FillBufConsume) {
+  auto r = BufReader<Cursor<sus::Slice<const u8>>>::with_capacity(
+      4u, Cursor<sus::Slice<const u8>>::with(bytes("abcdef")));
+  EXPECT_EQ(as_str(r.fill_buf().unwrap()), "abcd");
+  r.consume(3u);
+  EXPECT_EQ(as_str(r.fill_buf().unwrap()), "d");
+  r.consume(1u);
+  EXPECT_EQ(as_str(r.fill_buf().unwrap()), "ef");
+  r.consume(2u);
+  EXPECT_TRUE(r.fill_buf().unwrap().is_empty());
+}
+
+TEST(BufReaderDeathTest, ConsumeTooMuch) {
+#if GTEST_HAS_DEATH_TEST
+  auto r = BufReader<Cursor<sus::Slice<const u8>>>::with(
+      Cursor<sus::Slice<const u8>>::with(bytes("ab")));
+  EXPECT_DEATH(r.consume(1u), "");
+#endif
+}
+
+TEST(BufReader, ReadToEnd) {
+  std::string input;
+  for (int i = 0; i < 1000; ++i) input += static_cast<char>('a' + i % 26);
+  auto r = BufReader<Trickle>::with_capacity(
+      64u, Trickle{.cursor = Cursor<sus::Slice<const u8>>::with(bytes(input)),
+                   .max = 10u});
+  u8 first[3];
+  EXPECT_EQ(r.read(sus::Slice<u8>::from(first)).unwrap(), 3u);
+  auto v = sus::Vec<u8>();
+  EXPECT_EQ(sus::io::read_to_end(r, v).unwrap(), 997u);
+  EXPECT_EQ(as_str(v.as_ref()), std::string_view(input).substr(3));
+}
+
+TEST(BufReader, Lines) {
+  auto r = BufReader<Cursor<sus::Slice<const u8>>>::with(
+      Cursor<sus::Slice<const u8>>::with(bytes("one\ntwo\r\n\nthree")));
+  auto lines = r.lines();
+  EXPECT_EQ(as_str(lines.next().unwrap().unwrap()), "one");
+  EXPECT_EQ(as_str(lines.next().unwrap().unwrap()), "two");
+  EXPECT_EQ(as_str(lines.next().unwrap().unwrap()), "");
+  EXPECT_EQ(as_str(lines.next().unwrap().unwrap()), "three");
+  EXPECT_TRUE(lines.next().is_none());
+}
+
+TEST(BufReader, LinesAreNotCopied) {
+  auto r = BufReader<Cursor<sus::Slice<const u8>>>::with(
+      Cursor<sus::Slice<const u8>>::with(bytes("ab\ncd\n")));
+  const u8* const start = r.fill_buf().unwrap().as_ptr();
+  auto lines = r.lines();
+  EXPECT_EQ(lines.next().unwrap().unwrap().as_ptr(), start);
+  EXPECT_EQ(lines.next().unwrap().unwrap().as_ptr(), start + 3u);
+  EXPECT_TRUE(lines.next().is_none());
+}
+
+TEST(BufReader, LinesAcrossFills) {
+  // Lines which are longer than the buffer are gathered together.
+  std::string input;
+  std::string long_line(50, 'x');
+  input += "short\n" + long_line + "\r\nend\r";
+  auto r = BufReader<Trickle>::with_capacity(
+      8u, Trickle{.cursor = Cursor<sus::Slice<const u8>>::with(bytes(input)),
+                  .max = 3u});
+  auto lines = r.lines();
+  EXPECT_EQ(as_str(lines.next().unwrap().unwrap()), "short");
+  EXPECT_EQ(as_str(lines.next().unwrap().unwrap()), long_line);
+  EXPECT_EQ(as_str(lines.next().unwrap().unwrap()), "end");
+  EXPECT_TRUE(lines.next().is_none());
+}
+
+TEST(BufReader, LinesCount) {
+  std::string input;
+  for (int i = 0; i < 500; ++i) input += std::to_string(i) + "\n";
+  auto r = BufReader<Cursor<sus::Slice<const u8>>>::with_capacity(
+      16u, Cursor<sus::Slice<const u8>>::with(bytes(input)));
+  EXPECT_EQ(r.lines().count(), 500u);
+}
+
+TEST(BufReader, LinesError) {
+  auto r = BufReader<Failing>::with(Failing());
+  auto lines = r.lines();
+  Result<sus::Slice<const u8>> line = lines.next().unwrap();
+  ASSERT_TRUE(line.is_err());
+  EXPECT_EQ(sus::move(line).unwrap_err().kind(),
+            Error::Kind::PermissionDenied);
+}
+
+TEST(BufReader, IntoInner) {
+  auto r = BufReader<Cursor<sus::Slice<const u8>>>::with_capacity(
+      2u, Cursor<sus::Slice<const u8>>::with(bytes("abcd")));
+  EXPECT_EQ(as_str(r.fill_buf().unwrap()), "ab");
+  Cursor<sus::Slice<const u8>> c = sus::move(r).into_inner();
+  EXPECT_EQ(c.position(), 2u);
+}
+
+}  // namespace
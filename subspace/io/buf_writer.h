@@ -0,0 +1,255 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string.h>
+
+#include "subspace/assertions/check.h"
+#include "subspace/containers/slice.h"
+#include "subspace/containers/vec.h"
+#include "subspace/io/buf_reader.h"
+#include "subspace/io/error.h"
+#include "subspace/io/io_slice.h"
+#include "subspace/io/write.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/option/option.h"
+
+namespace sus::io {
+
+/// Adds buffering to a `Write` type.
+///
+/// Each `write()` to a file descriptor or socket is a system call, so writing
+/// a few bytes at a time to one is slow. A `BufWriter` gathers small writes
+/// in a buffer of its own, and writes the buffer to the inner writer when it
+/// fills up.
+///
+/// Writes that are at least as large as the buffer are not copied into it.
+/// If the inner writer satisfies `WriteVectored`, any bytes already in the
+/// buffer are written along with the large write in a single
+/// `write_vectored()` call, which for a file descriptor is one `writev()`
+/// system call.
+///
+/// The buffer is flushed when the `BufWriter` is destroyed, but any error
+/// from doing so is lost. Call `flush()` before then to see errors.
+///
+/// `BufWriter` satisfies the `Write` and `WriteVectored` concepts.
+template <Write W>
+class BufWriter final {
+ public:
+  /// Constructs a `BufWriter` writing to `inner`, with a buffer of
+  /// `DEFAULT_BUF_SIZE` bytes.
+  static BufWriter with(W inner) noexcept {
+    return with_capacity(DEFAULT_BUF_SIZE, ::sus::move(inner));
+  }
+
+  /// Constructs a `BufWriter` writing to `inner`, with a buffer of
+  /// `capacity` bytes.
+  ///
+  /// # Panics
+  /// Panics if `capacity` is zero.
+  static BufWriter with_capacity(usize capacity, W inner) noexcept {
+    ::sus::check_with_message(capacity > 0u,
+                              *"BufWriter capacity must be greater than 0");
+    auto buf = ::sus::Vec<u8>::with_capacity(capacity);
+    // SAFETY: The Vec has room for `capacity` bytes, and `u8` has no invalid
+    // values. Only bytes in `[0, len_)` are ever written out.
+    buf.set_len(::sus::marker::unsafe_fn, capacity);
+    return BufWriter(::sus::move(inner), ::sus::move(buf));
+  }
+
+  BufWriter(BufWriter&& o) noexcept
+      : inner_(::sus::move(o.inner_)),
+        buf_(::sus::move(o.buf_)),
+        len_(::sus::mem::replace(mref(o.len_), 0_usize)) {}
+  BufWriter& operator=(BufWriter&&) = delete;
+
+  /// Writes out the buffer, ignoring any error.
+  ~BufWriter() noexcept {
+    if (len_ > 0u) (void)flush_buf();
+  }
+
+  /// Writes `buf` into the buffer, first writing out the buffer if `buf`
+  /// does not fit.
+  ///
+  /// sus::io::Write trait.
+  Result<usize> write(::sus::Slice<const u8> buf) noexcept {
+    if (buf.is_empty()) return Result<usize>::with(0u);
+    const usize cap = capacity();
+    if (buf.len() > cap - len_) {
+      if constexpr (WriteVectored<W>) {
+        if (buf.len() >= cap) return write_through(buf);
+      }
+      if (::sus::Option<Error> e = flush_buf(); e.is_some()) {
+        return Result<usize>::with_err(::sus::move(e).unwrap());
+      }
+    }
+    if (buf.len() >= cap) return inner_.write(buf);
+    append(buf);
+    return Result<usize>::with(buf.len());
+  }
+
+  /// Writes the bytes of all of `bufs` into the buffer if they fit, or else
+  /// writes out the buffer and passes large writes to the inner writer.
+  ///
+  /// sus::io::WriteVectored trait.
+  Result<usize> write_vectored(::sus::Slice<const IoSlice> bufs) noexcept {
+    usize total = 0u;
+    for (const IoSlice& b : bufs.iter()) total += b.len();
+    const usize cap = capacity();
+    if (total > cap - len_) {
+      if (::sus::Option<Error> e = flush_buf(); e.is_some()) {
+        return Result<usize>::with_err(::sus::move(e).unwrap());
+      }
+    }
+    if (total >= cap) {
+      if constexpr (WriteVectored<W>) {
+        return inner_.write_vectored(bufs);
+      } else {
+        for (const IoSlice& b : bufs.iter()) {
+          if (b.len() > 0u) return inner_.write(b.as_slice());
+        }
+      }
+    }
+    for (const IoSlice& b : bufs.iter()) append(b.as_slice());
+    return Result<usize>::with(total);
+  }
+
+  /// Writes out the buffer, and then flushes the inner writer.
+  ///
+  /// sus::io::Write trait.
+  ::sus::Option<Error> flush() noexcept {
+    if (::sus::Option<Error> e = flush_buf(); e.is_some()) return e;
+    return inner_.flush();
+  }
+
+  /// Returns the bytes in the buffer which have not been written out yet.
+  ::sus::Slice<const u8> buffer() const& noexcept {
+    return buf_.as_ref()[::sus::containers::Range{.start = 0u, .len = len_}];
+  }
+  ::sus::Slice<const u8> buffer() && = delete;
+
+  /// Returns the size of the buffer.
+  usize capacity() const noexcept { return buf_.len(); }
+
+  /// Returns a const reference to the inner writer.
+  const W& get_ref() const& noexcept { return inner_; }
+  const W& get_ref() && = delete;
+
+  /// Returns a mutable reference to the inner writer.
+  ///
+  /// Writing directly to the inner writer will put the bytes ahead of any
+  /// bytes in the buffer.
+  W& get_mut() & noexcept { return inner_; }
+
+  /// Writes out the buffer and returns the inner writer.
+  ///
+  /// If writing out the buffer fails, the error is returned, and the inner
+  /// writer and any bytes left in the buffer are dropped.
+  Result<W> into_inner() && noexcept {
+    if (::sus::Option<Error> e = flush_buf(); e.is_some()) {
+      len_ = 0u;
+      return Result<W>::with_err(::sus::move(e).unwrap());
+    }
+    return Result<W>::with(::sus::move(inner_));
+  }
+
+ private:
+  BufWriter(W&& inner, ::sus::Vec<u8>&& buf) noexcept
+      : inner_(::sus::move(inner)), buf_(::sus::move(buf)) {}
+
+  void append(::sus::Slice<const u8> s) noexcept {
+    if (s.is_empty()) return;
+    memcpy(buf_.as_mut_ptr() + len_.primitive_value, s.as_ptr(),
+           s.len().primitive_value);
+    len_ += s.len();
+  }
+
+  /// Writes the buffer to the inner writer. Bytes which were written are
+  /// removed from the buffer even if an error occurs afterward.
+  ::sus::Option<Error> flush_buf() noexcept {
+    usize written = 0u;
+    ::sus::Option<Error> err;
+    while (written < len_) {
+      Result<usize> r = inner_.write(
+          buffer()[::sus::containers::Range{.start = written,
+                                            .len = len_ - written}]);
+      if (r.is_err()) {
+        Error e = ::sus::move(r).unwrap_err();
+        if (e.kind() == Error::Kind::Interrupted) continue;
+        err.insert(e);
+        break;
+      }
+      const usize n = ::sus::move(r).unwrap();
+      if (n == 0u) {
+        err.insert(Error(Error::Kind::WriteZero));
+        break;
+      }
+      written += n;
+    }
+    drain(written);
+    return err;
+  }
+
+  /// Writes the buffer and then `buf` with `write_vectored()`, so that a large
+  /// write does not need a separate write to flush the buffer first. Returns
+  /// the number of bytes of `buf` which were written.
+  Result<usize> write_through(::sus::Slice<const u8> buf) noexcept {
+    while (len_ > 0u) {
+      const IoSlice bufs[] = {IoSlice::from(buffer()), IoSlice::from(buf)};
+      Result<usize> r =
+          inner_.write_vectored(::sus::Slice<const IoSlice>::from(bufs));
+      if (r.is_err()) {
+        Error e = ::sus::move(r).unwrap_err();
+        if (e.kind() == Error::Kind::Interrupted) continue;
+        return Result<usize>::with_err(e);
+      }
+      const usize n = ::sus::move(r).unwrap();
+      if (n == 0u) {
+        return Result<usize>::with_err(Error(Error::Kind::WriteZero));
+      }
+      if (n < len_) {
+        drain(n);
+        continue;
+      }
+      const usize of_buf = n - len_;
+      len_ = 0u;
+      if (of_buf > 0u) return Result<usize>::with(of_buf);
+    }
+    return inner_.write(buf);
+  }
+
+  /// Removes the first `n` bytes from the buffer.
+  void drain(usize n) noexcept {
+    if (n == 0u) return;
+    u8* const p = buf_.as_mut_ptr();
+    memmove(p, p + n.primitive_value, (len_ - n).primitive_value);
+    len_ -= n;
+  }
+
+  W inner_;
+  ::sus::Vec<u8> buf_;
+  usize len_ = 0u;
+
+  sus_class_trivially_relocatable_if_types(::sus::marker::unsafe_fn,
+                                           decltype(inner_), decltype(buf_),
+                                           decltype(len_));
+};
+
+}  // namespace sus::io
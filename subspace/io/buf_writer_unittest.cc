@@ -0,0 +1,222 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/io/buf_writer.h"
+
+#include <string>
+#include <string_view>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/slice.h"
+#include "subspace/containers/vec.h"
+#include "subspace/io/cursor.h"
+#include "subspace/io/io_slice.h"
+#include "subspace/io/write.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::io::BufWriter;
+using sus::io::Cursor;
+using sus::io::Error;
+using sus::io::IoSlice;
+using sus::io::Result;
+
+sus::Slice<const u8> bytes(std::string_view s) {
+  return sus::Slice<const u8>::from_raw_parts(
+      unsafe_fn, reinterpret_cast<const u8*>(s.data()), s.size());
+}
+
+std::string_view as_str(sus::Slice<const u8> s) {
+  if (s.is_empty()) return std::string_view();
+  return std::string_view(reinterpret_cast<const char*>(s.as_ptr()),
+                          s.len().primitive_value);
+}
+
+/// A writer which counts the writes made to it, and accepts at most `max`
+/// bytes from each.
+struct Counting {
+  Result<usize> write(sus::Slice<const u8> buf) noexcept {
+    writes += 1u;
+    if (buf.len() > max) {
+      buf = buf[sus::containers::Range{.start = 0u, .len = max}];
+    }
+    out.append(as_str(buf));
+    return Result<usize>::with(buf.len());
+  }
+  sus::Option<Error> flush() noexcept {
+    flushes += 1u;
+    return sus::Option<Error>::none();
+  }
+
+  std::string out;
+  usize max = usize::MAX;
+  usize writes = 0u;
+  usize flushes = 0u;
+};
+
+/// A `Counting` writer which also has vectored writes.
+struct Vectored : Counting {
+  Result<usize> write_vectored(sus::Slice<const IoSlice> bufs) noexcept {
+    vectored_writes += 1u;
+    usize total = 0u;
+    for (const IoSlice& b : bufs.iter()) {
+      usize n = b.len();
+      if (total + n > max) n = max - total;
+      out.append(as_str(b.as_slice()).substr(0, n.primitive_value));
+      total += n;
+    }
+    return Result<usize>::with(total);
+  }
+
+  usize vectored_writes = 0u;
+};
+
+/// A writer which accepts nothing.
+struct Full {
+  Result<usize> write(sus::Slice<const u8>) noexcept {
+    return Result<usize>::with(0u);
+  }
+  sus::Option<Error> flush() noexcept { return sus::Option<Error>::none(); }
+};
+
+/// A writer which appends to a string that it does not own.
+struct ToString {
+  Result<usize> write(sus::Slice<const u8> buf) noexcept {
+    out->append(as_str(buf));
+    return Result<usize>::with(buf.len());
+  }
+  sus::Option<Error> flush() noexcept { return sus::Option<Error>::none(); }
+
+  std::string* out;
+};
+
+static_assert(sus::io::Write<BufWriter<Counting>>);
+static_assert(sus::io::WriteVectored<BufWriter<Counting>>);
+static_assert(!sus::io::WriteVectored<Counting>);
+static_assert(sus::io::WriteVectored<Vectored>);
+
+TEST(BufWriter, SmallWritesAreBuffered) {
+  auto w = BufWriter<Counting>::with_capacity(8u, Counting());
+  EXPECT_EQ(w.capacity(), 8u);
+  EXPECT_EQ(w.write(bytes("abc")).unwrap(), 3u);
+  EXPECT_EQ(w.write(bytes("def")).unwrap(), 3u);
+  EXPECT_EQ(as_str(w.buffer()), "abcdef");
+  EXPECT_EQ(w.get_ref().writes, 0u);
+
+  // Does not fit, so the buffer is written out first.
+  EXPECT_EQ(w.write(bytes("ghi")).unwrap(), 3u);
+  EXPECT_EQ(w.get_ref().writes, 1u);
+  EXPECT_EQ(w.get_ref().out, "abcdef");
+  EXPECT_EQ(as_str(w.buffer()), "ghi");
+
+  EXPECT_TRUE(w.flush().is_none());
+  EXPECT_EQ(w.get_ref().out, "abcdefghi");
+  EXPECT_EQ(w.get_ref().flushes, 1u);
+  EXPECT_TRUE(w.buffer().is_empty());
+}
+
+TEST(BufWriter, LargeWritesSkipTheBuffer) {
+  auto w = BufWriter<Counting>::with_capacity(4u, Counting());
+  EXPECT_EQ(w.write(bytes("ab")).unwrap(), 2u);
+  EXPECT_EQ(w.write(bytes("cdefgh")).unwrap(), 6u);
+  // One write flushed the buffer, and one wrote the large input directly.
+  EXPECT_EQ(w.get_ref().writes, 2u);
+  EXPECT_EQ(w.get_ref().out, "abcdefgh");
+  EXPECT_TRUE(w.buffer().is_empty());
+}
+
+TEST(BufWriter, LargeWritesAreVectored) {
+  auto w = BufWriter<Vectored>::with_capacity(4u, Vectored());
+  EXPECT_EQ(w.write(bytes("ab")).unwrap(), 2u);
+  EXPECT_EQ(w.write(bytes("cdefgh")).unwrap(), 6u);
+  // The buffer and the input went out together.
+  EXPECT_EQ(w.get_ref().vectored_writes, 1u);
+  EXPECT_EQ(w.get_ref().writes, 0u);
+  EXPECT_EQ(w.get_ref().out, "abcdefgh");
+}
+
+TEST(BufWriter, LargeWritesAreVectoredPartially) {
+  auto inner = Vectored();
+  inner.max = 1u;
+  auto w = BufWriter<Vectored>::with_capacity(4u, sus::move(inner));
+  EXPECT_EQ(w.write(bytes("abc")).unwrap(), 3u);
+  // The inner writer takes one byte at a time, so the buffer drains over a
+  // few writes before any of the input is written.
+  EXPECT_TRUE(sus::io::write_all(w, bytes("defgh")).is_none());
+  EXPECT_TRUE(w.flush().is_none());
+  EXPECT_EQ(w.get_ref().out, "abcdefgh");
+}
+
+TEST(BufWriter, WriteVectored) {
+  auto w = BufWriter<Counting>::with_capacity(8u, Counting());
+  const IoSlice bufs[] = {IoSlice::from(bytes("ab")), IoSlice::from(bytes("")),
+                          IoSlice::from(bytes("cd"))};
+  EXPECT_EQ(w.write_vectored(sus::Slice<const IoSlice>::from(bufs)).unwrap(),
+            4u);
+  EXPECT_EQ(as_str(w.buffer()), "abcd");
+  EXPECT_EQ(w.get_ref().writes, 0u);
+}
+
+TEST(BufWriter, PartialFlush) {
+  auto inner = Counting();
+  inner.max = 2u;
+  auto w = BufWriter<Counting>::with_capacity(8u, sus::move(inner));
+  EXPECT_TRUE(sus::io::write_all(w, bytes("abcdefg")).is_none());
+  EXPECT_TRUE(w.flush().is_none());
+  EXPECT_EQ(w.get_ref().out, "abcdefg");
+  EXPECT_EQ(w.get_ref().writes, 4u);
+}
+
+TEST(BufWriter, WriteZero) {
+  auto w = BufWriter<Full>::with_capacity(8u, Full());
+  EXPECT_EQ(w.write(bytes("abc")).unwrap(), 3u);
+  sus::Option<Error> e = w.flush();
+  ASSERT_TRUE(e.is_some());
+  EXPECT_EQ(e.as_ref().unwrap().kind(), Error::Kind::WriteZero);
+}
+
+TEST(BufWriter, FlushOnDestroy) {
+  std::string out;
+  {
+    auto w = BufWriter<ToString>::with(ToString{.out = &out});
+    EXPECT_EQ(w.write(bytes("hello")).unwrap(), 5u);
+    EXPECT_EQ(out, "");
+  }
+  EXPECT_EQ(out, "hello");
+}
+
+TEST(BufWriter, IntoInner) {
+  auto w = BufWriter<Counting>::with(Counting());
+  EXPECT_EQ(w.write(bytes("hello")).unwrap(), 5u);
+  Counting inner = sus::move(w).into_inner().unwrap();
+  EXPECT_EQ(inner.out, "hello");
+
+  auto full = BufWriter<Full>::with(Full());
+  EXPECT_EQ(full.write(bytes("hello")).unwrap(), 5u);
+  EXPECT_EQ(sus::move(full).into_inner().unwrap_err().kind(),
+            Error::Kind::WriteZero);
+}
+
+TEST(BufWriter, IntoCursor) {
+  auto w = BufWriter<Cursor<sus::Vec<u8>>>::with(
+      Cursor<sus::Vec<u8>>::with(sus::Vec<u8>()));
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(sus::io::write_all(w, bytes("line\n")).is_none());
+  }
+  sus::Vec<u8> v = sus::move(w).into_inner().unwrap().into_inner();
+  EXPECT_EQ(v.len(), 5000u);
+}
+
+}  // namespace
@@ -0,0 +1,137 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string.h>
+
+#include <concepts>
+
+#include "subspace/containers/slice.h"
+#include "subspace/containers/vec.h"
+#include "subspace/io/error.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/option/option.h"
+
+namespace sus::io {
+
+/// Wraps bytes in memory with a position, so they can be used with the `Read`
+/// and `Write` concepts.
+///
+/// A `Cursor<Slice<const u8>>` reads from the bytes in the `Slice`, and a
+/// `Cursor<Vec<u8>>` reads from, and writes to, the bytes in the `Vec`. Writes
+/// overwrite the bytes at the position, and grow the `Vec` as needed.
+template <class T>
+  requires(std::same_as<T, ::sus::Slice<const u8>> ||
+           std::same_as<T, ::sus::Vec<u8>>)
+class Cursor final {
+ public:
+  /// Constructs a `Cursor` over `inner`, at position `0`.
+  static constexpr Cursor with(T inner) noexcept {
+    return Cursor(::sus::move(inner));
+  }
+
+  /// Returns the position of the cursor, which is the index of the next byte
+  /// to be read or written.
+  constexpr usize position() const noexcept { return pos_; }
+
+  /// Moves the cursor to `pos`, which may be past the end of the bytes.
+  constexpr void set_position(usize pos) noexcept { pos_ = pos; }
+
+  /// Returns a const reference to the bytes being wrapped.
+  constexpr const T& get_ref() const& noexcept { return inner_; }
+  constexpr const T& get_ref() && = delete;
+
+  /// Returns a mutable reference to the bytes being wrapped.
+  constexpr T& get_mut() & noexcept { return inner_; }
+
+  /// Returns the bytes being wrapped.
+  constexpr T into_inner() && noexcept { return ::sus::move(inner_); }
+
+  /// Reads bytes from the position of the cursor into `buf`, and advances the
+  /// position past them.
+  ///
+  /// sus::io::Read trait.
+  Result<usize> read(::sus::Slice<u8> buf) noexcept {
+    const ::sus::Slice<const u8> bytes = as_bytes();
+    if (pos_ >= bytes.len()) return Result<usize>::with(0u);
+    const usize avail = bytes.len() - pos_;
+    const usize n = avail < buf.len() ? avail : buf.len();
+    if (n > 0u) {
+      memcpy(buf.as_mut_ptr(), bytes.as_ptr() + pos_.primitive_value,
+             n.primitive_value);
+    }
+    pos_ += n;
+    return Result<usize>::with(n);
+  }
+
+  /// Writes all of `buf` at the position of the cursor, and advances the
+  /// position past it. If the position is past the end of the `Vec`, the gap
+  /// is filled with zeros.
+  ///
+  /// sus::io::Write trait.
+  Result<usize> write(::sus::Slice<const u8> buf) noexcept
+    requires(std::same_as<T, ::sus::Vec<u8>>)
+  {
+    if (buf.is_empty()) return Result<usize>::with(0u);
+    const usize end = pos_ + buf.len();
+    if (end > inner_.len()) {
+      const usize old_len = inner_.len();
+      inner_.reserve(end - old_len);
+      // SAFETY: The gap, if any, is zeroed, and the rest of `[old_len, end)`
+      // is written by the copy below.
+      if (pos_ > old_len) {
+        memset(inner_.as_mut_ptr() + old_len.primitive_value, 0,
+               (pos_ - old_len).primitive_value);
+      }
+      inner_.set_len(::sus::marker::unsafe_fn, end);
+    }
+    memcpy(inner_.as_mut_ptr() + pos_.primitive_value, buf.as_ptr(),
+           buf.len().primitive_value);
+    pos_ = end;
+    return Result<usize>::with(buf.len());
+  }
+
+  /// Does nothing, as the bytes are written directly to the `Vec`.
+  ///
+  /// sus::io::Write trait.
+  ::sus::Option<Error> flush() noexcept
+    requires(std::same_as<T, ::sus::Vec<u8>>)
+  {
+    return ::sus::Option<Error>::none();
+  }
+
+ private:
+  constexpr explicit Cursor(T&& inner) noexcept
+      : inner_(::sus::move(inner)) {}
+
+  ::sus::Slice<const u8> as_bytes() const noexcept {
+    if constexpr (std::same_as<T, ::sus::Vec<u8>>) {
+      return inner_.as_ref();
+    } else {
+      return inner_;
+    }
+  }
+
+  T inner_;
+  usize pos_ = 0u;
+
+  sus_class_trivially_relocatable_if_types(::sus::marker::unsafe_fn,
+                                           decltype(inner_), decltype(pos_));
+};
+
+}  // namespace sus::io
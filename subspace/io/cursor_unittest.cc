@@ -0,0 +1,135 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/io/cursor.h"
+
+#include <errno.h>
+#include <stdint.h>
+
+#include <string>
+#include <string_view>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/slice.h"
+#include "subspace/containers/vec.h"
+#include "subspace/io/read.h"
+#include "subspace/io/write.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::io::Cursor;
+using sus::io::Error;
+
+static_assert(sus::io::Read<Cursor<sus::Slice<const u8>>>);
+static_assert(!sus::io::Write<Cursor<sus::Slice<const u8>>>);
+static_assert(sus::io::Read<Cursor<sus::Vec<u8>>>);
+static_assert(sus::io::Write<Cursor<sus::Vec<u8>>>);
+
+sus::Slice<const u8> bytes(std::string_view s) {
+  return sus::Slice<const u8>::from_raw_parts(
+      unsafe_fn, reinterpret_cast<const u8*>(s.data()), s.size());
+}
+
+std::string_view as_str(sus::Slice<const u8> s) {
+  if (s.is_empty()) return std::string_view();
+  return std::string_view(reinterpret_cast<const char*>(s.as_ptr()),
+                          s.len().primitive_value);
+}
+
+TEST(IoCursor, Read) {
+  auto c = Cursor<sus::Slice<const u8>>::with(bytes("hello world"));
+  u8 buf[5];
+  auto s = sus::Slice<u8>::from(buf);
+  EXPECT_EQ(c.read(s).unwrap(), 5u);
+  EXPECT_EQ(as_str(sus::Slice<const u8>::from(buf)), "hello");
+  EXPECT_EQ(c.position(), 5u);
+  EXPECT_EQ(c.read(s).unwrap(), 5u);
+  EXPECT_EQ(as_str(sus::Slice<const u8>::from(buf)), " worl");
+  EXPECT_EQ(c.read(s).unwrap(), 1u);
+  EXPECT_EQ(c.read(s).unwrap(), 0u);
+
+  c.set_position(100u);
+  EXPECT_EQ(c.read(s).unwrap(), 0u);
+}
+
+TEST(IoCursor, Write) {
+  auto c = Cursor<sus::Vec<u8>>::with(sus::Vec<u8>());
+  EXPECT_EQ(c.write(bytes("hello")).unwrap(), 5u);
+  EXPECT_EQ(c.write(bytes(" world")).unwrap(), 6u);
+  EXPECT_EQ(as_str(c.get_ref().as_ref()), "hello world");
+  EXPECT_TRUE(c.flush().is_none());
+
+  // Overwrites in the middle.
+  c.set_position(6u);
+  EXPECT_EQ(c.write(bytes("W")).unwrap(), 1u);
+  EXPECT_EQ(as_str(c.get_ref().as_ref()), "hello World");
+
+  // Fills a gap past the end with zeros.
+  c.set_position(13u);
+  EXPECT_EQ(c.write(bytes("!")).unwrap(), 1u);
+  sus::Vec<u8> v = sus::move(c).into_inner();
+  ASSERT_EQ(v.len(), 14u);
+  EXPECT_EQ(v[11u], 0u);
+  EXPECT_EQ(v[12u], 0u);
+  EXPECT_EQ(v[13u], u8(uint8_t{'!'}));
+}
+
+TEST(IoCursor, ReadToEnd) {
+  std::string long_str(1000, 'x');
+  for (size_t i = 0; i < long_str.size(); ++i) long_str[i] = 'a' + i % 26;
+  auto c = Cursor<sus::Slice<const u8>>::with(bytes(long_str));
+  auto v = sus::Vec<u8>();
+  v.push(u8(uint8_t{'>'}));
+  EXPECT_EQ(sus::io::read_to_end(c, v).unwrap(), 1000u);
+  ASSERT_EQ(v.len(), 1001u);
+  EXPECT_EQ(v[0u], u8(uint8_t{'>'}));
+  EXPECT_EQ(as_str(v.as_ref()).substr(1), long_str);
+
+  // Nothing is left.
+  EXPECT_EQ(sus::io::read_to_end(c, v).unwrap(), 0u);
+  EXPECT_EQ(v.len(), 1001u);
+}
+
+TEST(IoCursor, ReadExact) {
+  auto c = Cursor<sus::Slice<const u8>>::with(bytes("abcdef"));
+  u8 buf[4];
+  EXPECT_TRUE(sus::io::read_exact(c, sus::Slice<u8>::from(buf)).is_none());
+  EXPECT_EQ(as_str(sus::Slice<const u8>::from(buf)), "abcd");
+  sus::Option<Error> e = sus::io::read_exact(c, sus::Slice<u8>::from(buf));
+  ASSERT_TRUE(e.is_some());
+  EXPECT_EQ(e.as_ref().unwrap().kind(), Error::Kind::UnexpectedEof);
+}
+
+TEST(IoCursor, WriteAll) {
+  auto c = Cursor<sus::Vec<u8>>::with(sus::Vec<u8>());
+  EXPECT_TRUE(sus::io::write_all(c, bytes("abc")).is_none());
+  EXPECT_TRUE(sus::io::write_all(c, bytes("")).is_none());
+  EXPECT_EQ(as_str(c.get_ref().as_ref()), "abc");
+}
+
+TEST(IoError, ToString) {
+  EXPECT_EQ(Error(Error::Kind::UnexpectedEof).to_string(),
+            "unexpected end of file");
+  EXPECT_TRUE(Error(Error::Kind::Other).raw_os_error().is_none());
+
+  Error e = Error::from_raw_os_error(ENOENT);
+  EXPECT_EQ(e.kind(), Error::Kind::NotFound);
+  EXPECT_EQ(e.raw_os_error().unwrap(), ENOENT);
+  EXPECT_NE(e.to_string().find("(os error "), std::string::npos);
+  EXPECT_EQ(Error::from_raw_os_error(EINTR).kind(),
+            Error::Kind::Interrupted);
+}
+
+}  // namespace
@@ -0,0 +1,85 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/io/error.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include "subspace/assertions/unreachable.h"
+
+namespace sus::io {
+
+namespace {
+
+Error::Kind kind_of_os_error(int code) noexcept {
+  switch (code) {
+    case ENOENT: return Error::Kind::NotFound;
+    case EACCES:
+    case EPERM: return Error::Kind::PermissionDenied;
+    case EEXIST: return Error::Kind::AlreadyExists;
+    case EAGAIN:
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+    case EWOULDBLOCK:
+#endif
+      return Error::Kind::WouldBlock;
+    case EINVAL: return Error::Kind::InvalidInput;
+    case EINTR: return Error::Kind::Interrupted;
+    case EPIPE: return Error::Kind::BrokenPipe;
+    case ENOSYS: return Error::Kind::Unsupported;
+    case ENOMEM: return Error::Kind::OutOfMemory;
+  }
+  return Error::Kind::Other;
+}
+
+const char* describe(Error::Kind kind) noexcept {
+  switch (kind) {
+    case Error::Kind::NotFound: return "entity not found";
+    case Error::Kind::PermissionDenied: return "permission denied";
+    case Error::Kind::AlreadyExists: return "entity already exists";
+    case Error::Kind::WouldBlock: return "operation would block";
+    case Error::Kind::InvalidInput: return "invalid input parameter";
+    case Error::Kind::InvalidData: return "invalid data";
+    case Error::Kind::Interrupted: return "operation interrupted";
+    case Error::Kind::UnexpectedEof: return "unexpected end of file";
+    case Error::Kind::WriteZero: return "write zero";
+    case Error::Kind::BrokenPipe: return "broken pipe";
+    case Error::Kind::Unsupported: return "unsupported";
+    case Error::Kind::OutOfMemory: return "out of memory";
+    case Error::Kind::Other: return "other error";
+  }
+  ::sus::unreachable_unchecked(::sus::marker::unsafe_fn);
+}
+
+}  // namespace
+
+Error Error::from_raw_os_error(i32 code) noexcept {
+  return Error(kind_of_os_error(code.primitive_value), code);
+}
+
+Error Error::last_os_error() noexcept { return from_raw_os_error(errno); }
+
+std::string Error::to_string() const noexcept {
+  if (code_.is_none()) return std::string(describe(kind_));
+  const int code = code_.as_ref().unwrap().primitive_value;
+  // strerror() is not required to be thread-safe, but glibc and the other
+  // common C libraries return static strings for known error codes.
+  std::string s = strerror(code);
+  s += " (os error ";
+  s += std::to_string(code);
+  s += ")";
+  return s;
+}
+
+}  // namespace sus::io
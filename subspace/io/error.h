@@ -0,0 +1,102 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include "subspace/num/signed_integer.h"
+#include "subspace/option/option.h"
+#include "subspace/result/result.h"
+
+namespace sus::io {
+
+/// The error type for I/O operations of the `Read` and `Write` concepts and
+/// the types which implement them.
+///
+/// An error is either one of a set of general kinds of failure, or an error
+/// code from the operating system, which is also mapped to a kind.
+class Error final {
+ public:
+  /// A general category of I/O error.
+  enum class Kind {
+    /// An entity, such as a file, was not found.
+    NotFound,
+    /// The operation lacked the permissions to complete.
+    PermissionDenied,
+    /// An entity already exists, such as a file that was to be created.
+    AlreadyExists,
+    /// The operation needs to block to complete, but was asked not to.
+    WouldBlock,
+    /// An argument was not valid for the operation.
+    InvalidInput,
+    /// Data was not valid for the operation, such as malformed text.
+    InvalidData,
+    /// The operation was interrupted, and can typically be retried.
+    Interrupted,
+    /// The end of the input was reached before the operation could complete.
+    UnexpectedEof,
+    /// A write returned that it wrote zero bytes before all of the data was
+    /// written.
+    WriteZero,
+    /// The other end of a pipe or socket was closed.
+    BrokenPipe,
+    /// The operation is not supported on this platform.
+    Unsupported,
+    /// Memory could not be allocated for the operation.
+    OutOfMemory,
+    /// Any other error.
+    Other,
+  };
+
+  /// Constructs an Error with a `kind`.
+  explicit constexpr Error(Kind kind) noexcept : kind_(kind) {}
+
+  /// Constructs an Error from an error code of the operating system, such as
+  /// an `errno` value.
+  static Error from_raw_os_error(i32 code) noexcept;
+
+  /// Returns an Error for the most recent error of the operating system on
+  /// this thread, which is `errno` on POSIX systems.
+  static Error last_os_error() noexcept;
+
+  /// Returns the general category of the error.
+  constexpr Kind kind() const noexcept { return kind_; }
+
+  /// Returns the error code of the operating system, if the error came from
+  /// one.
+  constexpr ::sus::Option<i32> raw_os_error() const noexcept {
+    return code_;
+  }
+
+  /// Returns a human-readable description of the error.
+  std::string to_string() const noexcept;
+
+  friend constexpr bool operator==(const Error& l, const Error& r) noexcept {
+    return l.kind_ == r.kind_ && l.code_ == r.code_;
+  }
+
+ private:
+  constexpr Error(Kind kind, i32 code) noexcept
+      : kind_(kind), code_(::sus::Option<i32>::some(code)) {}
+
+  Kind kind_;
+  ::sus::Option<i32> code_;
+};
+
+/// The result of an I/O operation which produces a `T` when it succeeds.
+template <class T>
+using Result = ::sus::result::Result<T, Error>;
+
+}  // namespace sus::io
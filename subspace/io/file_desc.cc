@@ -0,0 +1,123 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/io/file_desc.h"
+
+#include <fcntl.h>
+#include <limits.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace sus::io {
+
+namespace {
+
+// Reads and writes are limited to this many bytes, as larger sizes are
+// rejected by some platforms, and Linux does not transfer more than this in
+// one call anyway.
+#if defined(_WIN32)
+constexpr size_t kMaxRw = INT_MAX;
+#else
+constexpr size_t kMaxRw = SSIZE_MAX < 0x7ffff000 ? SSIZE_MAX : 0x7ffff000;
+#endif
+
+constexpr size_t clamp_len(usize len) noexcept {
+  return len.primitive_value < kMaxRw ? len.primitive_value : kMaxRw;
+}
+
+Result<FileDesc> open_fd(const char* path, int flags) noexcept {
+#if defined(_WIN32)
+  const int fd = ::_open(path, flags | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+  const int fd = ::open(path, flags | O_CLOEXEC, 0666);
+#endif
+  if (fd < 0) return Result<FileDesc>::with_err(Error::last_os_error());
+  return Result<FileDesc>::with(
+      FileDesc::from_raw_fd(::sus::marker::unsafe_fn, fd));
+}
+
+}  // namespace
+
+Result<FileDesc> FileDesc::open(const char* path) noexcept {
+  return open_fd(path, O_RDONLY);
+}
+
+Result<FileDesc> FileDesc::create(const char* path) noexcept {
+  return open_fd(path, O_WRONLY | O_CREAT | O_TRUNC);
+}
+
+void FileDesc::close() noexcept {
+  // Errors from close() are ignored, as the descriptor is released either way
+  // and there is nothing useful to do about them here.
+#if defined(_WIN32)
+  ::_close(fd_);
+#else
+  ::close(fd_);
+#endif
+}
+
+Result<usize> FileDesc::read(::sus::Slice<u8> buf) noexcept {
+  if (buf.is_empty()) return Result<usize>::with(0u);
+#if defined(_WIN32)
+  const auto n = ::_read(fd_, buf.as_mut_ptr(),
+                         static_cast<unsigned>(clamp_len(buf.len())));
+#else
+  const ssize_t n = ::read(fd_, buf.as_mut_ptr(), clamp_len(buf.len()));
+#endif
+  if (n < 0) return Result<usize>::with_err(Error::last_os_error());
+  return Result<usize>::with(usize::from(n));
+}
+
+Result<usize> FileDesc::write(::sus::Slice<const u8> buf) noexcept {
+  if (buf.is_empty()) return Result<usize>::with(0u);
+#if defined(_WIN32)
+  const auto n = ::_write(fd_, buf.as_ptr(),
+                          static_cast<unsigned>(clamp_len(buf.len())));
+#else
+  const ssize_t n = ::write(fd_, buf.as_ptr(), clamp_len(buf.len()));
+#endif
+  if (n < 0) return Result<usize>::with_err(Error::last_os_error());
+  return Result<usize>::with(usize::from(n));
+}
+
+Result<usize> FileDesc::write_vectored(
+    ::sus::Slice<const IoSlice> bufs) noexcept {
+#if defined(_WIN32)
+  // There is no vectored write for file descriptors, so write the first
+  // non-empty buffer.
+  for (const IoSlice& b : bufs.iter()) {
+    if (b.len() > 0u) return write(b.as_slice());
+  }
+  return Result<usize>::with(0u);
+#else
+  static_assert(sizeof(IoSlice) == sizeof(struct iovec));
+  static_assert(alignof(IoSlice) == alignof(struct iovec));
+  if (bufs.is_empty()) return Result<usize>::with(0u);
+  const size_t count = bufs.len().primitive_value < IOV_MAX
+                           ? bufs.len().primitive_value
+                           : size_t{IOV_MAX};
+  // SAFETY: IoSlice has the same layout as `struct iovec`.
+  const auto* iov = reinterpret_cast<const struct iovec*>(bufs.as_ptr());
+  const ssize_t n = ::writev(fd_, iov, static_cast<int>(count));
+  if (n < 0) return Result<usize>::with_err(Error::last_os_error());
+  return Result<usize>::with(usize::from(n));
+#endif
+}
+
+}  // namespace sus::io
@@ -0,0 +1,110 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "subspace/containers/slice.h"
+#include "subspace/io/error.h"
+#include "subspace/io/io_slice.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/option/option.h"
+
+namespace sus::io {
+
+/// An owned file descriptor, which is closed when the `FileDesc` is
+/// destroyed.
+///
+/// Reads and writes go directly to the `read()`, `write()` and `writev()`
+/// system calls, without any buffering, so small reads and writes should go
+/// through a `BufReader` or `BufWriter`.
+///
+/// `FileDesc` satisfies the `Read`, `Write` and `WriteVectored` concepts.
+class [[sus_trivial_abi]] FileDesc final {
+ public:
+  /// Takes ownership of the open file descriptor `fd`.
+  ///
+  /// # Safety
+  /// The `fd` must be open, and must not be closed by anything else.
+  static FileDesc from_raw_fd(::sus::marker::UnsafeFnMarker,
+                              int fd) noexcept {
+    return FileDesc(fd);
+  }
+
+  /// Opens the file at `path` for reading.
+  static Result<FileDesc> open(const char* path) noexcept;
+
+  /// Opens the file at `path` for writing. The file is created if it does not
+  /// exist, and is truncated if it does.
+  static Result<FileDesc> create(const char* path) noexcept;
+
+  FileDesc(FileDesc&& o) noexcept
+      : fd_(::sus::mem::replace(mref(o.fd_), -1)) {}
+  FileDesc& operator=(FileDesc&& o) noexcept {
+    if (&o == this) return *this;
+    if (fd_ >= 0) close();
+    fd_ = ::sus::mem::replace(mref(o.fd_), -1);
+    return *this;
+  }
+
+  /// Closes the file descriptor.
+  ~FileDesc() noexcept {
+    if (fd_ >= 0) close();
+  }
+
+  /// Returns the file descriptor, which is still owned by the `FileDesc`.
+  int as_raw_fd() const noexcept { return fd_; }
+
+  /// Gives up ownership of the file descriptor and returns it. It will no
+  /// longer be closed by the `FileDesc`.
+  int into_raw_fd() && noexcept {
+    return ::sus::mem::replace(mref(fd_), -1);
+  }
+
+  /// Reads bytes into `buf` with a single `read()` system call.
+  ///
+  /// sus::io::Read trait.
+  Result<usize> read(::sus::Slice<u8> buf) noexcept;
+
+  /// Writes bytes from `buf` with a single `write()` system call.
+  ///
+  /// sus::io::Write trait.
+  Result<usize> write(::sus::Slice<const u8> buf) noexcept;
+
+  /// Writes bytes from `bufs` with a single `writev()` system call.
+  ///
+  /// sus::io::WriteVectored trait.
+  Result<usize> write_vectored(::sus::Slice<const IoSlice> bufs) noexcept;
+
+  /// Does nothing, as a `FileDesc` has no buffer.
+  ///
+  /// sus::io::Write trait.
+  ::sus::Option<Error> flush() noexcept {
+    return ::sus::Option<Error>::none();
+  }
+
+ private:
+  explicit FileDesc(int fd) noexcept : fd_(fd) {}
+
+  void close() noexcept;
+
+  int fd_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(fd_));
+};
+
+}  // namespace sus::io
@@ -0,0 +1,160 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/io/file_desc.h"
+
+#include <stdlib.h>
+
+#include <string>
+#include <string_view>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/slice.h"
+#include "subspace/containers/vec.h"
+#include "subspace/io/buf_reader.h"
+#include "subspace/io/buf_writer.h"
+#include "subspace/io/io_slice.h"
+#include "subspace/io/read.h"
+#include "subspace/io/write.h"
+#include "subspace/prelude.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+namespace {
+
+using sus::io::BufReader;
+using sus::io::BufWriter;
+using sus::io::Error;
+using sus::io::FileDesc;
+using sus::io::IoSlice;
+
+static_assert(sus::io::Read<FileDesc>);
+static_assert(sus::io::Write<FileDesc>);
+static_assert(sus::io::WriteVectored<FileDesc>);
+
+sus::Slice<const u8> bytes(std::string_view s) {
+  return sus::Slice<const u8>::from_raw_parts(
+      unsafe_fn, reinterpret_cast<const u8*>(s.data()), s.size());
+}
+
+std::string_view as_str(sus::Slice<const u8> s) {
+  if (s.is_empty()) return std::string_view();
+  return std::string_view(reinterpret_cast<const char*>(s.as_ptr()),
+                          s.len().primitive_value);
+}
+
+#if !defined(_WIN32)
+
+/// Returns the path to a new empty file, which is removed when the
+/// `TempFile` is destroyed.
+class TempFile {
+ public:
+  TempFile() {
+    const char* dir = getenv("TMPDIR");
+    path_ = std::string(dir ? dir : "/tmp") + "/sus_io_XXXXXX";
+    const int fd = mkstemp(path_.data());
+    EXPECT_GE(fd, 0);
+    close(fd);
+  }
+  ~TempFile() { unlink(path_.c_str()); }
+
+  const char* path() const { return path_.c_str(); }
+
+ private:
+  std::string path_;
+};
+
+TEST(FileDesc, OpenMissing) {
+  auto r = FileDesc::open("/this/file/does/not/exist");
+  ASSERT_TRUE(r.is_err());
+  Error e = sus::move(r).unwrap_err();
+  EXPECT_EQ(e.kind(), Error::Kind::NotFound);
+  EXPECT_TRUE(e.raw_os_error().is_some());
+}
+
+TEST(FileDesc, WriteThenRead) {
+  TempFile tmp;
+  {
+    FileDesc f = FileDesc::create(tmp.path()).unwrap();
+    EXPECT_TRUE(sus::io::write_all(f, bytes("hello ")).is_none());
+    const IoSlice bufs[] = {IoSlice::from(bytes("vectored ")),
+                            IoSlice::from(bytes("world"))};
+    EXPECT_EQ(f.write_vectored(sus::Slice<const IoSlice>::from(bufs)).unwrap(),
+              14u);
+  }
+  FileDesc f = FileDesc::open(tmp.path()).unwrap();
+  auto v = sus::Vec<u8>();
+  EXPECT_EQ(sus::io::read_to_end(f, v).unwrap(), 20u);
+  EXPECT_EQ(as_str(v.as_ref()), "hello vectored world");
+}
+
+TEST(FileDesc, Buffered) {
+  TempFile tmp;
+  {
+    auto w = BufWriter<FileDesc>::with_capacity(
+        64u, FileDesc::create(tmp.path()).unwrap());
+    for (int i = 0; i < 1000; ++i) {
+      const std::string line = std::to_string(i) + "\n";
+      EXPECT_TRUE(sus::io::write_all(w, bytes(line)).is_none());
+    }
+    // Larger than the buffer, so it is written with writev() along with the
+    // buffered bytes.
+    const std::string big(100, 'x');
+    EXPECT_TRUE(sus::io::write_all(w, bytes(big)).is_none());
+    EXPECT_TRUE(w.flush().is_none());
+  }
+  auto r = BufReader<FileDesc>::with_capacity(
+      64u, FileDesc::open(tmp.path()).unwrap());
+  auto lines = r.lines();
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(as_str(lines.next().unwrap().unwrap()), std::to_string(i));
+  }
+  EXPECT_EQ(as_str(lines.next().unwrap().unwrap()), std::string(100, 'x'));
+  EXPECT_TRUE(lines.next().is_none());
+}
+
+TEST(FileDesc, Pipe) {
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  auto reader = FileDesc::from_raw_fd(unsafe_fn, fds[0]);
+  auto writer = FileDesc::from_raw_fd(unsafe_fn, fds[1]);
+  EXPECT_TRUE(sus::io::write_all(writer, bytes("abc")).is_none());
+  {
+    // Closes the write end.
+    FileDesc closed = sus::move(writer);
+  }
+  EXPECT_EQ(writer.as_raw_fd(), -1);
+  auto v = sus::Vec<u8>();
+  EXPECT_EQ(sus::io::read_to_end(reader, v).unwrap(), 3u);
+  EXPECT_EQ(as_str(v.as_ref()), "abc");
+}
+
+TEST(FileDesc, IntoRawFd) {
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  auto f = FileDesc::from_raw_fd(unsafe_fn, fds[0]);
+  // Moving into itself does nothing.
+  auto& self = f;
+  f = sus::move(self);
+  EXPECT_EQ(sus::move(f).into_raw_fd(), fds[0]);
+  // Still open, as the FileDesc gave it up.
+  EXPECT_EQ(close(fds[0]), 0);
+  EXPECT_EQ(close(fds[1]), 0);
+}
+
+#endif
+
+}  // namespace
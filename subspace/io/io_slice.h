@@ -0,0 +1,58 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include "subspace/containers/slice.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/num/unsigned_integer.h"
+
+namespace sus::io {
+
+/// A buffer of bytes to be written by `write_vectored()`.
+///
+/// An `IoSlice` has the same layout as a `struct iovec` on POSIX systems, so a
+/// `Slice` of them is passed to `writev()` without being copied.
+class IoSlice final {
+ public:
+  /// Constructs an `IoSlice` which refers to the bytes in `s`.
+  static constexpr IoSlice from(::sus::Slice<const u8> s) noexcept {
+    return IoSlice(s.is_empty() ? nullptr : s.as_ptr(), s.len());
+  }
+
+  /// Returns the number of bytes in the buffer.
+  constexpr usize len() const noexcept { return len_; }
+
+  /// Returns the bytes in the buffer.
+  constexpr ::sus::Slice<const u8> as_slice() const noexcept {
+    return ::sus::Slice<const u8>::from_raw_parts(
+        ::sus::marker::unsafe_fn, static_cast<const u8*>(base_), usize(len_));
+  }
+
+ private:
+  constexpr IoSlice(const u8* base, usize len) noexcept
+      : base_(base), len_(len.primitive_value) {}
+
+  // The same fields, in the same order, as `struct iovec`.
+  const void* base_;
+  size_t len_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(base_),
+                                  decltype(len_));
+};
+
+}  // namespace sus::io
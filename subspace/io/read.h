@@ -0,0 +1,110 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <concepts>
+
+#include "subspace/containers/slice.h"
+#include "subspace/containers/vec.h"
+#include "subspace/io/error.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/option/option.h"
+
+namespace sus::io {
+
+/// A source of bytes.
+///
+/// A type is `Read` if it has a `read(Slice<u8> buf)` method which reads some
+/// bytes into the front of `buf` and returns how many were read, or returns
+/// an `Error`.
+///
+/// A return value of `0` means the end of the input was reached, unless `buf`
+/// was empty. Fewer bytes than `buf.len()` may be read even when more are
+/// coming. An error of kind `Error::Kind::Interrupted` means nothing was read
+/// and the read can be tried again.
+///
+/// The functions `read_exact()` and `read_to_end()` are built on `read()` for
+/// any `Read` type.
+template <class T>
+concept Read = requires(T& r, ::sus::Slice<u8> buf) {
+  { r.read(buf) } -> std::same_as<Result<usize>>;
+};
+
+/// Reads from `r` until the end of its input, appending the bytes to `out`,
+/// and returns the number of bytes read.
+///
+/// Reads are made directly into the spare capacity of `out`, which is grown as
+/// needed. Reads that are interrupted are retried.
+///
+/// If an error occurs, it is returned, and the bytes read before it are left
+/// in `out`.
+template <Read R>
+Result<usize> read_to_end(R& r, ::sus::Vec<u8>& out) noexcept {
+  constexpr usize kMinRead = 32u;
+  const usize start = out.len();
+  // The first read is sized to the existing spare capacity so that a caller
+  // which reserves the exact size up front does not grow the Vec.
+  while (true) {
+    if (out.capacity() - out.len() < kMinRead) {
+      // Grow by at least the current length, to amortize the cost of growth
+      // and read in larger chunks as the input gets larger.
+      out.reserve(out.len() > kMinRead ? out.len() : kMinRead);
+    }
+    const usize len = out.len();
+    auto spare = ::sus::Slice<u8>::from_raw_parts(
+        ::sus::marker::unsafe_fn, out.as_mut_ptr() + len.primitive_value,
+        out.capacity() - len);
+    Result<usize> read = r.read(spare);
+    if (read.is_err()) {
+      Error e = ::sus::move(read).unwrap_err();
+      if (e.kind() == Error::Kind::Interrupted) continue;
+      return Result<usize>::with_err(e);
+    }
+    const usize n = ::sus::move(read).unwrap();
+    if (n == 0u) return Result<usize>::with(out.len() - start);
+    // A reader that claims to have read more than it was given is broken.
+    check(n <= spare.len());
+    // SAFETY: The bytes in `[len, len + n)` were written by `read()`, and
+    // `u8` has no invalid values.
+    out.set_len(::sus::marker::unsafe_fn, len + n);
+  }
+}
+
+/// Reads exactly enough bytes from `r` to fill `buf`.
+///
+/// Reads that are interrupted are retried. Returns an error of kind
+/// `Error::Kind::UnexpectedEof` if the end of the input is reached before
+/// `buf` is filled, or any other error from `r`, in which case the contents
+/// of `buf` are unspecified. Returns `None` on success.
+template <Read R>
+::sus::Option<Error> read_exact(R& r, ::sus::Slice<u8> buf) noexcept {
+  while (!buf.is_empty()) {
+    Result<usize> read = r.read(buf);
+    if (read.is_err()) {
+      Error e = ::sus::move(read).unwrap_err();
+      if (e.kind() == Error::Kind::Interrupted) continue;
+      return ::sus::Option<Error>::some(e);
+    }
+    const usize n = ::sus::move(read).unwrap();
+    if (n == 0u) {
+      return ::sus::Option<Error>::some(Error(Error::Kind::UnexpectedEof));
+    }
+    buf = buf[::sus::containers::Range{.start = n, .len = buf.len() - n}];
+  }
+  return ::sus::Option<Error>::none();
+}
+
+}  // namespace sus::io
@@ -0,0 +1,331 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/io/uring.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <atomic>
+
+#include "subspace/assertions/check.h"
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+namespace sus::io::uring {
+
+namespace {
+
+Result<usize> to_result(int64_t res) noexcept {
+  if (res < 0) {
+    return Result<usize>::with_err(
+        Error::from_raw_os_error(static_cast<int32_t>(-res)));
+  }
+  return Result<usize>::with(usize(static_cast<size_t>(res)));
+}
+
+}  // namespace
+
+namespace __private {
+
+#if defined(__linux__) && defined(SYS_io_uring_setup)
+
+/// The rings shared with the kernel, which are mapped from the io_uring's
+/// file descriptor.
+struct Uring final {
+  static Uring* create(uint32_t entries) noexcept {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    const long fd = ::syscall(SYS_io_uring_setup, entries, &params);
+    if (fd < 0) return nullptr;
+
+    auto* u = new Uring();
+    u->fd = static_cast<int>(fd);
+    u->sq_entries = params.sq_entries;
+    u->cq_entries = params.cq_entries;
+    u->sq_ring_size =
+        params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    u->cq_ring_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+      if (u->cq_ring_size > u->sq_ring_size) u->sq_ring_size = u->cq_ring_size;
+      u->cq_ring_size = u->sq_ring_size;
+    }
+    u->sq_ring = ::mmap(nullptr, u->sq_ring_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_SQ_RING);
+    if (u->sq_ring == MAP_FAILED) {
+      u->sq_ring = nullptr;
+      delete u;
+      return nullptr;
+    }
+    if (single_mmap) {
+      u->cq_ring = u->sq_ring;
+    } else {
+      u->cq_ring = ::mmap(nullptr, u->cq_ring_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_CQ_RING);
+      if (u->cq_ring == MAP_FAILED) {
+        u->cq_ring = nullptr;
+        delete u;
+        return nullptr;
+      }
+    }
+    u->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, u->sqes_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, u->fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      delete u;
+      return nullptr;
+    }
+    u->sqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq = static_cast<char*>(u->sq_ring);
+    u->sq_head = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+    u->sq_tail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+    u->sq_mask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+    u->sq_array = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+    auto* cq = static_cast<char*>(u->cq_ring);
+    u->cq_head = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+    u->cq_tail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+    u->cq_mask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+    u->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    return u;
+  }
+
+  ~Uring() noexcept {
+    if (sqes) ::munmap(sqes, sqes_size);
+    if (cq_ring && cq_ring != sq_ring) ::munmap(cq_ring, cq_ring_size);
+    if (sq_ring) ::munmap(sq_ring, sq_ring_size);
+    ::close(fd);
+  }
+
+  /// Runs all of `requests`, and writes the completion result of each one to
+  /// the same index in `results`.
+  void run(::sus::Slice<const Request> requests, int64_t* results) noexcept {
+    const size_t n = requests.len().primitive_value;
+    // The kernel reads the iovecs when the request is submitted, but they are
+    // kept for the whole batch to keep things simple.
+    auto iovecs = ::sus::Vec<iovec>::with_capacity(requests.len());
+    for (const Request& r : requests.iter()) {
+      iovecs.push(iovec{.iov_base = r.ptr_, .iov_len = r.len_});
+    }
+
+    size_t next = 0u;
+    size_t in_flight = 0u;
+    size_t done = 0u;
+    while (done < n) {
+      // Queue as many requests as there is room for. The completion queue
+      // must also have room for all of them, or completions could be lost on
+      // older kernels.
+      uint32_t tail = *sq_tail;
+      const uint32_t head = load_acquire(sq_head);
+      while (next < n && tail - head < sq_entries && in_flight < cq_entries) {
+        const Request& r = requests[next];
+        const uint32_t index = tail & sq_mask;
+        io_uring_sqe& sqe = sqes[index];
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = r.op_ == Request::Op::Read ? IORING_OP_READV
+                                                : IORING_OP_WRITEV;
+        sqe.fd = r.fd_;
+        sqe.addr = reinterpret_cast<uint64_t>(iovecs.as_ptr() + next);
+        sqe.len = 1u;
+        sqe.off = r.offset_;
+        sqe.user_data = next;
+        sq_array[index] = index;
+        tail += 1u;
+        next += 1u;
+        in_flight += 1u;
+      }
+      store_release(sq_tail, tail);
+
+      // Submits everything the kernel has not taken yet, and waits for at
+      // least one completion.
+      const uint32_t to_submit = tail - load_acquire(sq_head);
+      const long entered =
+          ::syscall(SYS_io_uring_enter, fd, to_submit, 1u,
+                    IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (entered < 0 && errno != EINTR && errno != EAGAIN &&
+          errno != EBUSY) {
+        // The ring is unusable. Requests which the kernel has not taken from
+        // the submission queue are taken back, so they are never submitted.
+        const uint32_t taken = load_acquire(sq_head);
+        store_release(sq_tail, taken);
+        next -= tail - taken;
+        in_flight -= tail - taken;
+        // Requests the kernel did take may still write into their buffers
+        // or read `iovecs`, so wait for all of them to complete before
+        // returning. Only then are the rest run without the ring.
+        while (in_flight > 0u) {
+          if (reap(results, in_flight, done) > 0u) continue;
+          if (::syscall(SYS_io_uring_enter, fd, 0u, 1u,
+                        IORING_ENTER_GETEVENTS, nullptr, 0) < 0) {
+            ::sched_yield();
+          }
+        }
+        for (size_t i = next; i < n; ++i) {
+          results[i] = run_blocking(requests[i]);
+        }
+        return;
+      }
+
+      reap(results, in_flight, done);
+    }
+  }
+
+  /// Writes the results of the completions in the completion queue, and
+  /// returns how many there were.
+  size_t reap(int64_t* results, size_t& in_flight, size_t& done) noexcept {
+    uint32_t cq_h = *cq_head;
+    const uint32_t cq_t = load_acquire(cq_tail);
+    const size_t count = cq_t - cq_h;
+    while (cq_h != cq_t) {
+      const io_uring_cqe& cqe = cqes[cq_h & cq_mask];
+      results[cqe.user_data] = cqe.res;
+      cq_h += 1u;
+    }
+    store_release(cq_head, cq_h);
+    in_flight -= count;
+    done += count;
+    return count;
+  }
+
+  static int64_t run_blocking(const Request& r) noexcept;
+
+  /// Marks a result which has not completed yet.
+  static constexpr int64_t kPending = INT64_MIN;
+
+  static uint32_t load_acquire(uint32_t* p) noexcept {
+    return std::atomic_ref<uint32_t>(*p).load(std::memory_order_acquire);
+  }
+  static void store_release(uint32_t* p, uint32_t v) noexcept {
+    std::atomic_ref<uint32_t>(*p).store(v, std::memory_order_release);
+  }
+
+  int fd = -1;
+  uint32_t sq_entries = 0u;
+  uint32_t cq_entries = 0u;
+  void* sq_ring = nullptr;
+  size_t sq_ring_size = 0u;
+  void* cq_ring = nullptr;
+  size_t cq_ring_size = 0u;
+  io_uring_sqe* sqes = nullptr;
+  size_t sqes_size = 0u;
+  uint32_t* sq_head = nullptr;
+  uint32_t* sq_tail = nullptr;
+  uint32_t sq_mask = 0u;
+  uint32_t* sq_array = nullptr;
+  uint32_t* cq_head = nullptr;
+  uint32_t* cq_tail = nullptr;
+  uint32_t cq_mask = 0u;
+  io_uring_cqe* cqes = nullptr;
+};
+
+#else
+
+struct Uring final {
+  static Uring* create(uint32_t) noexcept { return nullptr; }
+  void run(::sus::Slice<const Request>, int64_t*) noexcept {}
+
+  static int64_t run_blocking(const Request& r) noexcept;
+
+  static constexpr int64_t kPending = INT64_MIN;
+};
+
+#endif
+
+/// Runs `r` as a blocking system call. Returns the number of bytes
+/// transferred, or a negated error code, in the manner of an io_uring
+/// completion.
+int64_t Uring::run_blocking(const Request& r) noexcept {
+#if defined(_WIN32)
+  (void)r;
+  return -ENOSYS;
+#else
+  while (true) {
+    const ssize_t n =
+        r.op_ == Request::Op::Read
+            ? ::pread(r.fd_, r.ptr_, r.len_, static_cast<off_t>(r.offset_))
+            : ::pwrite(r.fd_, r.ptr_, r.len_, static_cast<off_t>(r.offset_));
+    if (n >= 0) return n;
+    if (errno != EINTR) return -errno;
+  }
+#endif
+}
+
+}  // namespace __private
+
+Ring Ring::with_entries(u32 entries) noexcept {
+  ::sus::check_with_message(entries > 0u,
+                            *"Ring entries must be greater than 0");
+  // The kernel rejects more entries than this.
+  const uint32_t clamped =
+      entries.primitive_value < 4096u ? entries.primitive_value : 4096u;
+  return Ring(__private::Uring::create(clamped),
+              &::sus::thread::ThreadPool::global());
+}
+
+Ring Ring::with_thread_pool(::sus::thread::ThreadPool& pool) noexcept {
+  return Ring(nullptr, &pool);
+}
+
+Ring& Ring::operator=(Ring&& o) noexcept {
+  delete uring_;
+  uring_ = ::sus::mem::replace_ptr(mref(o.uring_), nullptr);
+  pool_ = o.pool_;
+  return *this;
+}
+
+Ring::~Ring() noexcept { delete uring_; }
+
+::sus::Vec<Result<usize>> Ring::submit(
+    ::sus::Slice<const Request> requests) & noexcept {
+  const size_t n = requests.len().primitive_value;
+  auto results = ::sus::Vec<int64_t>::with_capacity(requests.len());
+  for (size_t i = 0u; i < n; ++i) results.push(__private::Uring::kPending);
+
+  if (n > 0u && uring_) {
+    uring_->run(requests, results.as_mut_ptr());
+  } else if (n > 0u) {
+    // Each task runs a contiguous chunk of the requests, with a few chunks
+    // for each thread so that slow requests are balanced across threads.
+    const size_t chunks = pool_->num_threads().primitive_value * 4u;
+    const size_t chunk_len = (n + chunks - 1u) / chunks;
+    int64_t* const out = results.as_mut_ptr();
+    pool_->scope([&](::sus::thread::Scope& s) {
+      for (size_t start = 0u; start < n; start += chunk_len) {
+        const size_t end = start + chunk_len < n ? start + chunk_len : n;
+        s.spawn([requests, out, start, end]() {
+          for (size_t i = start; i < end; ++i) {
+            out[i] = __private::Uring::run_blocking(requests[i]);
+          }
+        });
+      }
+    });
+  }
+
+  auto out = ::sus::Vec<Result<usize>>::with_capacity(requests.len());
+  for (size_t i = 0u; i < n; ++i) out.push(to_result(results[i]));
+  return out;
+}
+
+}  // namespace sus::io::uring
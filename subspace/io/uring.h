@@ -0,0 +1,169 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "subspace/containers/slice.h"
+#include "subspace/containers/vec.h"
+#include "subspace/io/error.h"
+#include "subspace/io/file_desc.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/thread/thread_pool.h"
+
+/// Batched file I/O through io_uring.
+///
+/// A `Ring` runs a batch of reads and writes at once. On Linux it submits
+/// them to the kernel through an io_uring, so that a whole batch costs a few
+/// system calls instead of one for each operation. Where io_uring is not
+/// available, either because the kernel is too old or because it is blocked
+/// by a sandbox, the operations are run as blocking `pread()` and `pwrite()`
+/// calls spread over the threads of a `ThreadPool`.
+namespace sus::io::uring {
+
+namespace __private {
+struct Uring;
+}
+
+/// A read or write of a file at an offset, to be run by `Ring::submit()`.
+///
+/// A `Request` refers to the file descriptor and the buffer it was made
+/// from, which must stay valid until `Ring::submit()` returns.
+///
+/// The file must support reading and writing at an offset, like a regular
+/// file does. For pipes and sockets, which do not, the result depends on the
+/// `Backend`.
+class Request final {
+ public:
+  /// A request to read up to `buf.len()` bytes from `file`, starting at
+  /// `offset`, into `buf`.
+  static Request read(const FileDesc& file, ::sus::Slice<u8> buf,
+                      u64 offset) noexcept {
+    return Request(Op::Read, file.as_raw_fd(),
+                   buf.is_empty() ? nullptr : buf.as_mut_ptr(), buf.len(),
+                   offset);
+  }
+
+  /// A request to write up to `buf.len()` bytes from `buf` to `file`,
+  /// starting at `offset`.
+  static Request write(const FileDesc& file, ::sus::Slice<const u8> buf,
+                       u64 offset) noexcept {
+    return Request(Op::Write, file.as_raw_fd(),
+                   buf.is_empty() ? nullptr : const_cast<u8*>(buf.as_ptr()),
+                   buf.len(), offset);
+  }
+
+  /// Returns true if this is a read request.
+  bool is_read() const noexcept { return op_ == Op::Read; }
+  /// Returns true if this is a write request.
+  bool is_write() const noexcept { return op_ == Op::Write; }
+
+ private:
+  friend class Ring;
+  friend struct __private::Uring;
+
+  enum class Op : uint8_t { Read, Write };
+
+  Request(Op op, int fd, u8* ptr, usize len, u64 offset) noexcept
+      : op_(op),
+        fd_(fd),
+        ptr_(ptr),
+        len_(len.primitive_value),
+        offset_(offset.primitive_value) {}
+
+  Op op_;
+  int fd_;
+  u8* ptr_;
+  size_t len_;
+  uint64_t offset_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(op_),
+                                  decltype(fd_), decltype(ptr_),
+                                  decltype(len_), decltype(offset_));
+};
+
+/// How a `Ring` runs its requests.
+enum class Backend {
+  /// Requests are submitted to the kernel through an io_uring.
+  IoUring,
+  /// Requests are run as blocking system calls on a `ThreadPool`.
+  ThreadPool,
+};
+
+/// Runs batches of file reads and writes.
+///
+/// Each call to `submit()` runs a batch of `Request`s and returns the result
+/// of each one, in the same order, once all of them are done. The requests
+/// in a batch may run in any order, and at the same time as each other, so a
+/// batch should not hold two requests for overlapping parts of the same file
+/// unless they are both reads.
+///
+/// As with `read()` and `write()`, a request may transfer fewer bytes than
+/// asked for, and its result is the number of bytes transferred, or an
+/// `Error`.
+///
+/// A `Ring` is not thread-safe: `submit()` must not be called from two
+/// threads at once. Use a `Ring` for each thread instead.
+class [[sus_trivial_abi]] Ring final {
+ public:
+  /// Constructs a `Ring` which keeps up to `entries` requests in flight at
+  /// once. Larger batches are fed to the kernel as earlier requests finish.
+  ///
+  /// An io_uring is used if the system supports it. Otherwise the requests
+  /// are run on `ThreadPool::global()`.
+  ///
+  /// # Panics
+  /// Panics if `entries` is zero.
+  static Ring with_entries(u32 entries) noexcept;
+
+  /// Constructs a `Ring` which runs requests as blocking system calls on
+  /// `pool`, without trying to use io_uring. The `pool` must outlive the
+  /// `Ring`.
+  static Ring with_thread_pool(::sus::thread::ThreadPool& pool) noexcept;
+
+  Ring(Ring&& o) noexcept
+      : uring_(::sus::mem::replace_ptr(mref(o.uring_), nullptr)),
+        pool_(o.pool_) {}
+  Ring& operator=(Ring&& o) noexcept;
+
+  ~Ring() noexcept;
+
+  /// Returns how the requests are run.
+  Backend backend() const noexcept {
+    return uring_ ? Backend::IoUring : Backend::ThreadPool;
+  }
+
+  /// Runs all of `requests`, and returns the result of each one, in the same
+  /// order, once they have all finished.
+  ::sus::Vec<Result<usize>> submit(
+      ::sus::Slice<const Request> requests) & noexcept;
+
+ private:
+  Ring(__private::Uring* uring, ::sus::thread::ThreadPool* pool) noexcept
+      : uring_(uring), pool_(pool) {}
+
+  __private::Uring* uring_;
+  ::sus::thread::ThreadPool* pool_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(uring_),
+                                  decltype(pool_));
+};
+
+}  // namespace sus::io::uring
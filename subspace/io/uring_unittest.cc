@@ -0,0 +1,200 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/io/uring.h"
+
+#include <errno.h>
+#include <stdlib.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/slice.h"
+#include "subspace/containers/vec.h"
+#include "subspace/io/file_desc.h"
+#include "subspace/prelude.h"
+#include "subspace/thread/thread_pool.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+namespace {
+
+using sus::io::Error;
+using sus::io::FileDesc;
+using sus::io::uring::Backend;
+using sus::io::uring::Request;
+using sus::io::uring::Ring;
+
+#if !defined(_WIN32)
+
+sus::Slice<const u8> bytes(std::string_view s) {
+  return sus::Slice<const u8>::from_raw_parts(
+      unsafe_fn, reinterpret_cast<const u8*>(s.data()), s.size());
+}
+
+std::string_view as_str(sus::Slice<const u8> s) {
+  if (s.is_empty()) return std::string_view();
+  return std::string_view(reinterpret_cast<const char*>(s.as_ptr()),
+                          s.len().primitive_value);
+}
+
+/// A temporary directory, which is removed along with the files in it when
+/// the `TempDir` is destroyed.
+class TempDir {
+ public:
+  TempDir() {
+    const char* dir = getenv("TMPDIR");
+    path_ = std::string(dir ? dir : "/tmp") + "/sus_uring_XXXXXX";
+    EXPECT_NE(mkdtemp(path_.data()), nullptr);
+  }
+  ~TempDir() {
+    for (const std::string& f : files_) unlink(f.c_str());
+    rmdir(path_.c_str());
+  }
+
+  std::string file(int i) {
+    std::string f = path_ + "/" + std::to_string(i);
+    files_.push_back(f);
+    return f;
+  }
+
+ private:
+  std::string path_;
+  std::vector<std::string> files_;
+};
+
+/// Writes `num_files` small files with one batch, and reads them back with
+/// another.
+void write_and_read_files(Ring& ring, int num_files) {
+  TempDir dir;
+  std::vector<std::string> names;
+  std::vector<std::string> contents;
+  auto files = sus::Vec<FileDesc>();
+  for (int i = 0; i < num_files; ++i) {
+    names.push_back(dir.file(i));
+    contents.push_back("file " + std::to_string(i) + "\n");
+    files.push(FileDesc::create(names.back().c_str()).unwrap());
+  }
+
+  auto writes = sus::Vec<Request>();
+  for (int i = 0; i < num_files; ++i) {
+    writes.push(Request::write(files[usize::from(i)], bytes(contents[i]), 0u));
+  }
+  sus::Vec<sus::io::Result<usize>> written = ring.submit(writes.as_ref());
+  ASSERT_EQ(written.len(), usize::from(num_files));
+  for (int i = 0; i < num_files; ++i) {
+    EXPECT_EQ(sus::move(written[usize::from(i)]).unwrap(),
+              contents[i].size());
+  }
+  files.clear();
+
+  for (int i = 0; i < num_files; ++i) {
+    files.push(FileDesc::open(names[i].c_str()).unwrap());
+  }
+  std::vector<std::string> bufs(num_files, std::string(64, '\0'));
+  auto reads = sus::Vec<Request>();
+  for (int i = 0; i < num_files; ++i) {
+    reads.push(Request::read(
+        files[usize::from(i)],
+        sus::Slice<u8>::from_raw_parts(
+            unsafe_fn, reinterpret_cast<u8*>(bufs[i].data()), bufs[i].size()),
+        0u));
+  }
+  sus::Vec<sus::io::Result<usize>> read = ring.submit(reads.as_ref());
+  ASSERT_EQ(read.len(), usize::from(num_files));
+  for (int i = 0; i < num_files; ++i) {
+    const usize n = sus::move(read[usize::from(i)]).unwrap();
+    EXPECT_EQ(std::string_view(bufs[i]).substr(0, n.primitive_value),
+              contents[i]);
+  }
+}
+
+TEST(IoUring, Batch) {
+  auto ring = Ring::with_entries(64u);
+  write_and_read_files(ring, 300);
+}
+
+TEST(IoUring, BatchLargerThanRing) {
+  auto ring = Ring::with_entries(4u);
+  write_and_read_files(ring, 100);
+}
+
+TEST(IoUring, ThreadPool) {
+  auto pool = sus::thread::ThreadPool::with_num_threads(3u);
+  auto ring = Ring::with_thread_pool(pool);
+  EXPECT_EQ(ring.backend(), Backend::ThreadPool);
+  write_and_read_files(ring, 300);
+}
+
+TEST(IoUring, Empty) {
+  auto ring = Ring::with_entries(8u);
+  EXPECT_EQ(ring.submit(sus::Slice<const Request>()).len(), 0u);
+}
+
+TEST(IoUring, Offsets) {
+  TempDir dir;
+  const std::string name = dir.file(0);
+  auto ring = Ring::with_entries(8u);
+  {
+    FileDesc f = FileDesc::create(name.c_str()).unwrap();
+    const Request writes[] = {Request::write(f, bytes("world"), 6u),
+                              Request::write(f, bytes("hello "), 0u)};
+    auto r = ring.submit(sus::Slice<const Request>::from(writes));
+    EXPECT_EQ(sus::move(r[0u]).unwrap(), 5u);
+    EXPECT_EQ(sus::move(r[1u]).unwrap(), 6u);
+  }
+  FileDesc f = FileDesc::open(name.c_str()).unwrap();
+  u8 a[5];
+  u8 b[100];
+  const Request reads[] = {
+      Request::read(f, sus::Slice<u8>::from(a), 6u),
+      // Reads past the end of the file return what is there.
+      Request::read(f, sus::Slice<u8>::from(b), 3u),
+      Request::read(f, sus::Slice<u8>::from(b), 100u)};
+  auto r = ring.submit(sus::Slice<const Request>::from(reads));
+  EXPECT_EQ(sus::move(r[0u]).unwrap(), 5u);
+  EXPECT_EQ(as_str(sus::Slice<const u8>::from(a)), "world");
+  // The last two reads both wrote to `b`, but the last one read nothing.
+  EXPECT_EQ(sus::move(r[1u]).unwrap(), 8u);
+  EXPECT_EQ(sus::move(r[2u]).unwrap(), 0u);
+}
+
+TEST(IoUring, Errors) {
+  TempDir dir;
+  const std::string name = dir.file(0);
+  for (int pooled = 0; pooled < 2; ++pooled) {
+    auto pool = sus::thread::ThreadPool::with_num_threads(1u);
+    auto ring = pooled ? Ring::with_thread_pool(pool) : Ring::with_entries(8u);
+    FileDesc write_only = FileDesc::create(name.c_str()).unwrap();
+    FileDesc read_only = FileDesc::open(name.c_str()).unwrap();
+    u8 buf[4];
+    const Request requests[] = {
+        Request::read(write_only, sus::Slice<u8>::from(buf), 0u),
+        Request::write(read_only, bytes("abc"), 0u),
+        Request::write(write_only, bytes("abc"), 0u)};
+    auto r = ring.submit(sus::Slice<const Request>::from(requests));
+    ASSERT_EQ(r.len(), 3u);
+    EXPECT_EQ(sus::move(r[0u]).unwrap_err().raw_os_error().unwrap(), EBADF);
+    EXPECT_EQ(sus::move(r[1u]).unwrap_err().raw_os_error().unwrap(), EBADF);
+    EXPECT_EQ(sus::move(r[2u]).unwrap(), 3u);
+  }
+}
+
+#endif
+
+}  // namespace
@@ -0,0 +1,80 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <concepts>
+
+#include "subspace/containers/slice.h"
+#include "subspace/io/error.h"
+#include "subspace/io/io_slice.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/option/option.h"
+
+namespace sus::io {
+
+/// A sink for bytes.
+///
+/// A type is `Write` if it has:
+/// * A `write(Slice<const u8> buf)` method which writes some bytes from the
+///   front of `buf` and returns how many were written, or returns an `Error`.
+///   Fewer bytes than `buf.len()` may be written. An error of kind
+///   `Error::Kind::Interrupted` means nothing was written and the write can be
+///   tried again.
+/// * A `flush()` method which makes sure any buffered bytes reach their
+///   destination, and returns an `Error` if that fails or `None` otherwise.
+///
+/// The function `write_all()` is built on `write()` for any `Write` type.
+template <class T>
+concept Write = requires(T& w, ::sus::Slice<const u8> buf) {
+  { w.write(buf) } -> std::same_as<Result<usize>>;
+  { w.flush() } -> std::same_as<::sus::Option<Error>>;
+};
+
+/// A `Write` type which can also write from many buffers in one operation.
+///
+/// The `write_vectored(Slice<const IoSlice> bufs)` method writes some bytes
+/// from the buffers, in order, and returns how many were written in total, or
+/// returns an `Error`. For a file descriptor this is a single `writev()`
+/// call.
+template <class T>
+concept WriteVectored =
+    Write<T> && requires(T& w, ::sus::Slice<const IoSlice> bufs) {
+      { w.write_vectored(bufs) } -> std::same_as<Result<usize>>;
+    };
+
+/// Writes all of `buf` to `w`.
+///
+/// Writes that are interrupted are retried. Returns an error of kind
+/// `Error::Kind::WriteZero` if `w` stops accepting bytes before all of `buf`
+/// was written, or any other error from `w`. Returns `None` on success.
+template <Write W>
+::sus::Option<Error> write_all(W& w, ::sus::Slice<const u8> buf) noexcept {
+  while (!buf.is_empty()) {
+    Result<usize> written = w.write(buf);
+    if (written.is_err()) {
+      Error e = ::sus::move(written).unwrap_err();
+      if (e.kind() == Error::Kind::Interrupted) continue;
+      return ::sus::Option<Error>::some(e);
+    }
+    const usize n = ::sus::move(written).unwrap();
+    if (n == 0u) {
+      return ::sus::Option<Error>::some(Error(Error::Kind::WriteZero));
+    }
+    buf = buf[::sus::containers::Range{.start = n, .len = buf.len() - n}];
+  }
+  return ::sus::Option<Error>::none();
+}
+
+}  // namespace sus::io
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "subspace/boxed/box.h"
 #include "subspace/convert/subclass.h"
 #include "subspace/iter/iterator_concept.h"
 #include "subspace/mem/relocate.h"
@@ -48,9 +49,12 @@ class [[sus_trivial_abi]] BoxedIterator final
              !::sus::mem::relocate_by_memcpy<IteratorSubclass>)
   {
     return BoxedIterator(
-        *new IteratorSubclass(::sus::move(subclass)),  // Move it to the heap.
+        // Move it to the heap.
+        *::sus::boxed::Box<IteratorSubclass>::with(::sus::move(subclass))
+             .into_raw(),
         [](IteratorBase<Item>& iter) {
-          delete static_cast<IteratorSubclass*>(&iter);
+          (void)::sus::boxed::Box<IteratorSubclass>::from_raw(
+              ::sus::marker::unsafe_fn, static_cast<IteratorSubclass*>(&iter));
         });
   }
 
@@ -61,6 +65,7 @@ class [[sus_trivial_abi]] BoxedIterator final
     if (destroy_) destroy_(*iter_);
     iter_ = ::sus::mem::replace_ptr(mref(o.iter_), nullptr);
     destroy_ = ::sus::mem::replace_ptr(mref(o.destroy_), nullptr);
+    return *this;
   }
 
   ~BoxedIterator() {
@@ -0,0 +1,22 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "subspace/macros/compiler.h"
+
+/// Mark a function declaration with `sus_noinline` to keep the compiler from
+/// inlining it into its callers, such as for a rarely taken slow path.
+#define sus_noinline \
+  sus_if_msvc_else(__declspec(noinline), __attribute__((__noinline__)))
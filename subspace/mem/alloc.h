@@ -0,0 +1,164 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <new>
+#include <source_location>
+
+#include "subspace/assertions/check.h"
+#include "subspace/macros/always_inline.h"
+
+namespace sus::mem {
+
+namespace __private {
+
+// The global allocator used when `SUS_PROVIDE_ALLOCATOR` is not defined. A
+// provided allocator may also use these to get memory.
+
+sus_always_inline void* default_allocate(size_t size, size_t align) noexcept {
+  if (align <= alignof(max_align_t)) [[likely]]
+    return malloc(size);
+  return ::operator new(size, std::align_val_t{align}, std::nothrow);
+}
+
+sus_always_inline void default_deallocate(void* ptr, size_t align) noexcept {
+  if (align <= alignof(max_align_t)) [[likely]]
+    free(ptr);
+  else
+    ::operator delete(ptr, std::align_val_t{align});
+}
+
+sus_always_inline void* default_reallocate(void* ptr, size_t old_size,
+                                           size_t new_size,
+                                           size_t align) noexcept {
+  if (align <= alignof(max_align_t)) [[likely]]
+    return realloc(ptr, new_size);
+  // There is no aligned realloc(), so the memory is moved by hand.
+  void* p = default_allocate(new_size, align);
+  if (p != nullptr) {
+    memcpy(p, ptr, old_size < new_size ? old_size : new_size);
+    default_deallocate(ptr, align);
+  }
+  return p;
+}
+
+}  // namespace __private
+
+#if defined(SUS_PROVIDE_ALLOCATOR)
+// When `SUS_PROVIDE_ALLOCATOR` is defined, these functions must be defined by
+// the application, and `allocate()`, `reallocate()` and `deallocate()` go
+// through them.
+void* provided_allocate(size_t size, size_t align,
+                        const std::source_location& location) noexcept;
+void* provided_reallocate(void* ptr, size_t old_size, size_t new_size,
+                          size_t align,
+                          const std::source_location& location) noexcept;
+void provided_deallocate(void* ptr, size_t align) noexcept;
+#endif
+
+/// Allocates `size` bytes of uninitialized memory, aligned to `align`, from
+/// the global allocator.
+///
+/// The heap allocations made by the library's types, such as `Vec`, `Box`,
+/// `Rc`, `Arc`, `Fn` and `Arena`, go through this function. The functions of
+/// `Vec`, `Box`, `Rc` and `Arc` which allocate, like `Vec::push()` or
+/// `Box::with()`, receive the `std::source_location` of their caller and pass
+/// it on here, so the allocation is attributed to the code that asked for it.
+///
+/// The exceptions are the `SlabAllocator`, which gets its spans from the
+/// system allocator directly and which in turn serves the jobs of the
+/// `ThreadPool` and the frames of `sus::task::Task`, and the `ThreadPool`'s
+/// own state, which is created with `new`.
+///
+/// The default behaviour of this function is to use `malloc()`, or an aligned
+/// `operator new` if `align` is larger than `malloc()` guarantees. The
+/// behaviour can be overridden by defining a `SUS_PROVIDE_ALLOCATOR` macro
+/// when compiling the library, in which case the application must define
+/// `sus::mem::provided_allocate()`, `sus::mem::provided_reallocate()` and
+/// `sus::mem::provided_deallocate()`. They receive the `location` which is
+/// allocating.
+///
+/// # Panics
+/// Panics if the allocation fails.
+///
+/// # Safety
+/// If `SUS_PROVIDE_ALLOCATOR` is defined, `provided_allocate()` _must_ return
+/// memory with the requested size and alignment, or Undefined Behaviour will
+/// result.
+sus_always_inline void* allocate(
+    size_t size, size_t align,
+    const std::source_location location =
+        std::source_location::current()) noexcept {
+#if defined(SUS_PROVIDE_ALLOCATOR)
+  void* p = provided_allocate(size, align, location);
+#else
+  (void)location;
+  void* p = __private::default_allocate(size, align);
+#endif
+  check(p != nullptr || size == 0u);
+  return p;
+}
+
+/// Grows or shrinks an allocation from `allocate()` to `new_size` bytes,
+/// keeping its alignment. The first `min(old_size, new_size)` bytes are
+/// preserved, and the allocation may move.
+///
+/// The default behaviour of this function is to use `realloc()`. The behaviour
+/// can be overridden by defining a `SUS_PROVIDE_ALLOCATOR` macro when
+/// compiling the library; see `allocate()`.
+///
+/// # Panics
+/// Panics if the allocation fails.
+///
+/// # Safety
+/// The `ptr` must have come from `allocate()` or `reallocate()` with the same
+/// `align`, and `old_size` must be its size, or Undefined Behaviour will
+/// result.
+sus_always_inline void* reallocate(
+    void* ptr, size_t old_size, size_t new_size, size_t align,
+    const std::source_location location =
+        std::source_location::current()) noexcept {
+#if defined(SUS_PROVIDE_ALLOCATOR)
+  void* p = provided_reallocate(ptr, old_size, new_size, align, location);
+#else
+  (void)location;
+  void* p = __private::default_reallocate(ptr, old_size, new_size, align);
+#endif
+  check(p != nullptr || new_size == 0u);
+  return p;
+}
+
+/// Frees an allocation from `allocate()` or `reallocate()`.
+///
+/// The default behaviour of this function is to use `free()`. The behaviour
+/// can be overridden by defining a `SUS_PROVIDE_ALLOCATOR` macro when
+/// compiling the library; see `allocate()`.
+///
+/// # Safety
+/// The `ptr` must have come from `allocate()` or `reallocate()` with the same
+/// `align`, and must not be used after, or Undefined Behaviour will result.
+sus_always_inline void deallocate(void* ptr, size_t align) noexcept {
+#if defined(SUS_PROVIDE_ALLOCATOR)
+  provided_deallocate(ptr, align);
+#else
+  __private::default_deallocate(ptr, align);
+#endif
+}
+
+}  // namespace sus::mem
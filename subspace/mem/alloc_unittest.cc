@@ -0,0 +1,133 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "subspace/mem/alloc.h"
+
+#include <string_view>
+
+#include "googletest/include/gtest/gtest-spi.h"
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/boxed/box.h"
+#include "subspace/containers/vec.h"
+#include "subspace/fn/fn.h"
+#include "subspace/prelude.h"
+#include "subspace/test/counting_allocator.h"
+
+namespace {
+
+using sus::test::AllocationScope;
+
+TEST(Alloc, AllocateDeallocate) {
+  void* p = sus::mem::allocate(12u, 4u);
+  EXPECT_NE(p, nullptr);
+  sus::mem::deallocate(p, 4u);
+
+  void* q = sus::mem::allocate(12u, 64u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(q) % 64u, 0u);
+  q = sus::mem::reallocate(q, 12u, 200u, 64u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(q) % 64u, 0u);
+  sus::mem::deallocate(q, 64u);
+}
+
+TEST(Alloc, ScopeCounts) {
+  auto scope = AllocationScope();
+  {
+    auto v = Vec<i32>::with_capacity(4u);
+    EXPECT_EQ(scope.count(), 1u);
+    EXPECT_EQ(scope.bytes(), 16u);
+    v.reserve_exact(8u);
+    EXPECT_EQ(scope.count(), 2u);
+    EXPECT_EQ(scope.bytes(), 16u + 32u);
+    EXPECT_EQ(scope.peak_bytes(), 32u);
+  }
+  {
+    auto v = Vec<i32>::with_capacity(2u);
+    EXPECT_EQ(scope.peak_bytes(), 32u);
+  }
+  // Each allocation is recorded where it was asked for.
+  EXPECT_EQ(scope.count(), 3u);
+  EXPECT_EQ(scope.num_sites(), 3u);
+  for (usize i = 0u; i < scope.num_sites(); i += 1u) {
+    EXPECT_TRUE(std::string_view(scope.site(i).file_name)
+                    .ends_with("alloc_unittest.cc"));
+    EXPECT_EQ(scope.site(i).count, 1u);
+  }
+}
+
+TEST(Alloc, SitePeakBytes) {
+  auto scope = AllocationScope();
+  auto push_some = [](Vec<i32>& v, usize n) {
+    for (usize i = 0u; i < n; i += 1u) v.push(1);
+  };
+  {
+    auto v = Vec<i32>();
+    push_some(v, 4u);  // Grows to 3 and then 12 elements.
+  }
+  auto b = sus::Box<i32>::with(2);
+  {
+    auto v = Vec<i32>();
+    push_some(v, 2u);  // Grows to 3 elements.
+  }
+  ASSERT_EQ(scope.num_sites(), 2u);
+  const sus::test::AllocationSite& pushes = scope.site(0u);
+  EXPECT_EQ(pushes.count, 3u);
+  EXPECT_EQ(pushes.bytes, 12u + 48u + 12u);
+  // Only one of the pushed allocations is live at a time.
+  EXPECT_EQ(pushes.peak_bytes, 48u);
+  EXPECT_EQ(pushes.live_bytes, 0);
+  const sus::test::AllocationSite& box = scope.site(1u);
+  EXPECT_EQ(box.count, 1u);
+  EXPECT_EQ(box.peak_bytes, 4u);
+  EXPECT_EQ(box.live_bytes, 4);
+}
+
+TEST(Alloc, NestedScopes) {
+  auto outer = AllocationScope();
+  auto b = sus::Box<i32>::with(1);
+  {
+    auto inner = AllocationScope();
+    auto c = sus::Box<i32>::with(2);
+    EXPECT_EQ(inner.count(), 1u);
+  }
+  EXPECT_EQ(outer.count(), 2u);
+}
+
+TEST(Alloc, NoAllocations) {
+  auto v = Vec<i32>::with_capacity(4u);
+  EXPECT_NO_ALLOCATIONS {
+    v.push(1);
+    v.push(2);
+    (void)v.pop();
+  }
+  auto f = sus::fn::FnOnce<i32()>([]() -> i32 { return 2; });
+  EXPECT_NO_ALLOCATIONS { EXPECT_EQ(sus::move(f)(), 2); }
+}
+
+TEST(Alloc, NoAllocationsFails) {
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_NO_ALLOCATIONS { (void)Vec<i32>::with_capacity(1u); },
+      "Expected no allocations, but found 1 allocating 4 bytes");
+}
+
+TEST(Alloc, FnStorage) {
+  auto scope = AllocationScope();
+  {
+    auto f = sus::fn::FnOnce<i32()>(
+        sus_bind0([i = i32(3)]() -> i32 { return i; }));
+    EXPECT_EQ(scope.count(), 1u);
+    EXPECT_EQ(sus::move(f)(), 3);
+  }
+  EXPECT_EQ(scope.count(), 1u);
+}
+
+}  // namespace
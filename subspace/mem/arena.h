@@ -0,0 +1,363 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <new>
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/containers/slice.h"
+#include "subspace/macros/noinline.h"
+#include "subspace/mem/alloc.h"
+#include "subspace/mem/clone.h"
+#include "subspace/mem/forward.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/mem/size_of.h"
+#include "subspace/num/unsigned_integer.h"
+
+namespace sus::mem {
+
+/// A bump allocator, which hands out memory from large chunks and frees it all
+/// at once.
+///
+/// Allocating from an `Arena` is a pointer increment in the common case, and
+/// objects allocated in it are never freed individually. Instead the whole
+/// `Arena` is cleared by `reset()` or when it is destroyed. This suits building
+/// many small objects with the same lifetime, such as the nodes of a tree.
+///
+/// Objects made with `alloc()` or `alloc_slice()` are destroyed in the reverse
+/// order of their construction when the arena is reset. Only types that are not
+/// trivially destructible are tracked for this, so allocating trivial types
+/// costs nothing beyond the memory.
+///
+/// References into the `Arena` remain valid when it is moved, as the chunks do
+/// not move, but they are invalidated by `reset()`.
+class [[sus_trivial_abi]] Arena final {
+ public:
+  /// The size of the first chunk allocated by an `Arena` constructed with the
+  /// default constructor. Each new chunk is twice the size of the previous
+  /// one, up to `kMaxChunkSize`.
+  static constexpr size_t kDefaultChunkSize = 4096u;
+  /// The largest chunk size the `Arena` grows to on its own. Larger chunks
+  /// are still allocated for single allocations that do not fit in a chunk of
+  /// this size.
+  static constexpr size_t kMaxChunkSize = size_t{1u} << 20u;
+
+  /// Constructs an empty `Arena`. No memory is allocated until the first
+  /// allocation is made from it.
+  ///
+  /// sus::construct::Default trait.
+  Arena() noexcept : Arena(kDefaultChunkSize) {}
+
+  /// Constructs an empty `Arena` whose first chunk will be `chunk_size` bytes.
+  /// No memory is allocated until the first allocation is made from it.
+  ///
+  /// # Panics
+  /// Panics if `chunk_size` is 0.
+  static Arena with_chunk_size(usize chunk_size) noexcept {
+    check(chunk_size > 0u);
+    return Arena(chunk_size.primitive_value);
+  }
+
+  ~Arena() {
+    if (!is_moved_from()) {
+      run_drops();
+      free_chunks(nullptr);
+    }
+  }
+
+  Arena(Arena&& o) noexcept
+      : chunk_(::sus::mem::replace_ptr(mref(o.chunk_), moved_from_value())),
+        ptr_(::sus::mem::replace_ptr(mref(o.ptr_), nullptr)),
+        end_(::sus::mem::replace_ptr(mref(o.end_), nullptr)),
+        drops_(::sus::mem::replace_ptr(mref(o.drops_), nullptr)),
+        next_chunk_size_(o.next_chunk_size_),
+        allocated_bytes_(
+            ::sus::mem::replace(mref(o.allocated_bytes_), size_t{0u})) {
+    check(!is_moved_from());
+  }
+  Arena& operator=(Arena&& o) noexcept {
+    check(!o.is_moved_from());
+    if (&o == this) return *this;
+    if (!is_moved_from()) {
+      run_drops();
+      free_chunks(nullptr);
+    }
+    chunk_ = ::sus::mem::replace_ptr(mref(o.chunk_), moved_from_value());
+    ptr_ = ::sus::mem::replace_ptr(mref(o.ptr_), nullptr);
+    end_ = ::sus::mem::replace_ptr(mref(o.end_), nullptr);
+    drops_ = ::sus::mem::replace_ptr(mref(o.drops_), nullptr);
+    next_chunk_size_ = o.next_chunk_size_;
+    allocated_bytes_ =
+        ::sus::mem::replace(mref(o.allocated_bytes_), size_t{0u});
+    return *this;
+  }
+
+  /// Constructs a `T` in the arena from `args`, and returns a reference to it.
+  ///
+  /// If `T` is not trivially destructible, it will be destroyed when the arena
+  /// is reset or destroyed.
+  template <class T, class... Args>
+    requires(!std::is_reference_v<T> && std::is_constructible_v<T, Args&&...>)
+  T& alloc(Args&&... args) & noexcept {
+    check(!is_moved_from());
+    // The drop record is allocated first, so that constructing `T` can not
+    // leave an object that is never destroyed.
+    Drop* drop = nullptr;
+    if constexpr (!std::is_trivially_destructible_v<T>)
+      drop = static_cast<Drop*>(allocate_bytes(sizeof(Drop), alignof(Drop)));
+    T* t = new (allocate_bytes(sizeof(T), alignof(T)))
+        T(::sus::forward<Args>(args)...);
+    if constexpr (!std::is_trivially_destructible_v<T>)
+      push_drop(*drop, &drop_objects<T>, t, 1u);
+    return *t;
+  }
+
+  /// Constructs `len` default-constructed objects of type `T` contiguously in
+  /// the arena, and returns a `Slice` over them.
+  ///
+  /// If `T` is not trivially destructible, the objects will be destroyed when
+  /// the arena is reset or destroyed.
+  template <class T>
+    requires(!std::is_reference_v<T> && std::is_default_constructible_v<T>)
+  ::sus::containers::Slice<T> alloc_slice(usize len) & noexcept {
+    check(!is_moved_from());
+    T* data = begin_slice<T>(len);
+    for (size_t i = 0u; i < len.primitive_value; ++i) new (data + i) T();
+    return ::sus::containers::Slice<T>::from_raw_parts(::sus::marker::unsafe_fn,
+                                                       data, len);
+  }
+
+  /// Clones each object in `from` into the arena, contiguously, and returns a
+  /// `Slice` over the new objects.
+  ///
+  /// If `T` is not trivially destructible, the objects will be destroyed when
+  /// the arena is reset or destroyed.
+  template <class T>
+    requires(::sus::mem::Clone<T>)
+  ::sus::containers::Slice<T> alloc_slice_clone(
+      ::sus::containers::Slice<const T> from) & noexcept {
+    check(!is_moved_from());
+    const usize len = from.len();
+    T* data = begin_slice<T>(len);
+    if constexpr (::sus::mem::relocate_by_memcpy<T> &&
+                  ::sus::mem::Copy<T>) {
+      if (len > 0u) {
+        memcpy(data, from.as_ptr(),
+               len.primitive_value * ::sus::mem::size_of<T>());
+      }
+    } else {
+      for (size_t i = 0u; i < len.primitive_value; ++i)
+        new (data + i) T(::sus::clone(from[i]));
+    }
+    return ::sus::containers::Slice<T>::from_raw_parts(::sus::marker::unsafe_fn,
+                                                       data, len);
+  }
+
+  /// Allocates `size` bytes of uninitialized memory aligned to `align` from the
+  /// arena.
+  ///
+  /// The memory is released when the arena is reset or destroyed. Nothing is
+  /// destroyed in it.
+  ///
+  /// # Panics
+  /// Panics if `align` is not a power of two.
+  void* allocate(usize size, usize align) & noexcept {
+    check(!is_moved_from());
+    check(align.count_ones() == 1u);
+    return allocate_bytes(size.primitive_value, align.primitive_value);
+  }
+
+  /// Destroys every object in the arena, and releases its memory for reuse.
+  ///
+  /// The largest chunk is kept for future allocations and the others are
+  /// freed. After the first `reset()`, an arena that is repeatedly filled to
+  /// the same size does not allocate again.
+  void reset() & noexcept {
+    check(!is_moved_from());
+    run_drops();
+    if (chunk_ == nullptr) return;
+    Chunk* largest = chunk_;
+    for (Chunk* c = chunk_->prev; c != nullptr; c = c->prev) {
+      if (c->size > largest->size) largest = c;
+    }
+    free_chunks(largest);
+    largest->prev = nullptr;
+    chunk_ = largest;
+    ptr_ = largest->data();
+    end_ = ptr_ + largest->size;
+    allocated_bytes_ = largest->size;
+  }
+
+  /// Returns the total number of bytes in the chunks held by the arena,
+  /// including space which has not been handed out yet.
+  usize allocated_bytes() const& noexcept {
+    check(!is_moved_from());
+    return allocated_bytes_;
+  }
+
+ private:
+  struct Chunk {
+    Chunk* prev;
+    size_t size;
+
+    char* data() noexcept { return reinterpret_cast<char*>(this + 1); }
+  };
+  // A record of objects that need to be destroyed, which lives in the arena
+  // itself.
+  struct Drop {
+    void (*fn)(void* objects, size_t count);
+    void* objects;
+    size_t count;
+    Drop* prev;
+  };
+
+  explicit Arena(size_t chunk_size) noexcept
+      : chunk_(nullptr),
+        ptr_(nullptr),
+        end_(nullptr),
+        drops_(nullptr),
+        next_chunk_size_(chunk_size),
+        allocated_bytes_(0u) {}
+
+  template <class T>
+  static void drop_objects(void* objects, size_t count) noexcept {
+    T* t = static_cast<T*>(objects);
+    for (size_t i = count; i > 0u; --i) t[i - 1u].~T();
+  }
+
+  // Allocates space for `len` objects of type `T`, and registers them to be
+  // destroyed if needed. The caller must construct the objects.
+  template <class T>
+  T* begin_slice(usize len) noexcept {
+    const usize bytes = ::sus::mem::size_of<T>() * len;
+    check(bytes <= usize(size_t{PTRDIFF_MAX}));
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      if (len > 0u) {
+        auto* drop =
+            static_cast<Drop*>(allocate_bytes(sizeof(Drop), alignof(Drop)));
+        T* data =
+            static_cast<T*>(allocate_bytes(bytes.primitive_value, alignof(T)));
+        push_drop(*drop, &drop_objects<T>, data, len.primitive_value);
+        return data;
+      }
+    }
+    return static_cast<T*>(allocate_bytes(bytes.primitive_value, alignof(T)));
+  }
+
+  void push_drop(Drop& drop, void (*fn)(void*, size_t), void* objects,
+                 size_t count) noexcept {
+    drop.fn = fn;
+    drop.objects = objects;
+    drop.count = count;
+    drop.prev = drops_;
+    drops_ = &drop;
+  }
+
+  void run_drops() noexcept {
+    // Destroys objects in the reverse order that they were constructed.
+    Drop* drop = ::sus::mem::replace_ptr(mref(drops_), nullptr);
+    while (drop != nullptr) {
+      drop->fn(drop->objects, drop->count);
+      drop = drop->prev;
+    }
+  }
+
+  // The common case is inlined, and only moving to a new chunk is not.
+  void* allocate_bytes(size_t size, size_t align) noexcept {
+    const uintptr_t p = reinterpret_cast<uintptr_t>(ptr_);
+    const uintptr_t aligned = (p + (align - 1u)) & ~(uintptr_t{align} - 1u);
+    // Comparing sizes rather than pointers avoids forming a pointer past the
+    // end of the chunk.
+    const uintptr_t end = reinterpret_cast<uintptr_t>(end_);
+    if (ptr_ != nullptr && aligned <= end && size <= end - aligned)
+        [[likely]] {
+      ptr_ = reinterpret_cast<char*>(aligned + size);
+      return reinterpret_cast<char*>(aligned);
+    }
+    return allocate_in_new_chunk(size, align);
+  }
+
+  sus_noinline void* allocate_in_new_chunk(size_t size,
+                                           size_t align) noexcept {
+    // Room for the requested size and for aligning it within the chunk.
+    const size_t needed = size + align;
+    check(needed >= size);
+    size_t chunk_size = next_chunk_size_;
+    while (chunk_size < needed) {
+      check(chunk_size <= PTRDIFF_MAX / 2u);
+      chunk_size *= 2u;
+    }
+    if (next_chunk_size_ < kMaxChunkSize) next_chunk_size_ *= 2u;
+
+    auto* chunk = static_cast<Chunk*>(
+        ::sus::mem::allocate(sizeof(Chunk) + chunk_size, alignof(Chunk)));
+    chunk->prev = chunk_;
+    chunk->size = chunk_size;
+    chunk_ = chunk;
+    ptr_ = chunk->data();
+    end_ = ptr_ + chunk_size;
+    allocated_bytes_ += chunk_size;
+    return allocate_bytes(size, align);
+  }
+
+  // Frees every chunk except `keep`, if it is not null.
+  void free_chunks(Chunk* keep) noexcept {
+    Chunk* chunk = chunk_;
+    while (chunk != nullptr) {
+      Chunk* const c = ::sus::mem::replace_ptr(mref(chunk), chunk->prev);
+      if (c != keep) ::sus::mem::deallocate(c, alignof(Chunk));
+    }
+    if (keep == nullptr) {
+      chunk_ = nullptr;
+      ptr_ = end_ = nullptr;
+      allocated_bytes_ = 0u;
+    }
+  }
+
+  inline bool is_moved_from() const noexcept {
+    return chunk_ == moved_from_value();
+  }
+  // The value used in `chunk_` to indicate moved-from.
+  static Chunk* moved_from_value() noexcept {
+    return reinterpret_cast<Chunk*>(uintptr_t{alignof(Chunk)});
+  }
+
+  // The newest chunk, which allocations are made from. Older chunks are
+  // linked through `Chunk::prev`.
+  Chunk* chunk_;
+  // The next free byte in `chunk_`.
+  char* ptr_;
+  // The end of `chunk_`.
+  char* end_;
+  // The most recent object that needs to be destroyed.
+  Drop* drops_;
+  size_t next_chunk_size_;
+  size_t allocated_bytes_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(chunk_),
+                                  decltype(ptr_), decltype(end_),
+                                  decltype(drops_), decltype(next_chunk_size_),
+                                  decltype(allocated_bytes_));
+};
+
+}  // namespace sus::mem
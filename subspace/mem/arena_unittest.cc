@@ -0,0 +1,157 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/mem/arena.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::mem::Arena;
+
+static_assert(sus::mem::relocate_by_memcpy<Arena>);
+
+struct Tracked {
+  Tracked(i32 id, sus::Vec<i32>& destroyed) : id(id), destroyed(destroyed) {}
+  ~Tracked() { destroyed.push(id); }
+
+  i32 id;
+  sus::Vec<i32>& destroyed;
+};
+
+struct alignas(64) OverAligned {
+  i32 i;
+};
+
+TEST(Arena, Alloc) {
+  auto arena = Arena();
+  EXPECT_EQ(arena.allocated_bytes(), 0u);
+  i32& a = arena.alloc<i32>(3);
+  i32& b = arena.alloc<i32>(4);
+  EXPECT_EQ(a, 3);
+  EXPECT_EQ(b, 4);
+  EXPECT_NE(&a, &b);
+  EXPECT_EQ(arena.allocated_bytes(), Arena::kDefaultChunkSize);
+}
+
+TEST(Arena, Alignment) {
+  auto arena = Arena();
+  (void)arena.alloc<u8>(1_u8);
+  OverAligned& o = arena.alloc<OverAligned>(OverAligned(2));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(&o) % 64u, 0u);
+  void* p = arena.allocate(3u, 16u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 16u, 0u);
+}
+
+TEST(Arena, NewChunks) {
+  auto arena = Arena::with_chunk_size(64u);
+  for (i32 i = 0; i < 100; i += 1) EXPECT_EQ(arena.alloc<i32>(i), i);
+  EXPECT_GT(arena.allocated_bytes(), 64u);
+
+  // An allocation larger than any chunk gets a chunk of its own.
+  auto s = arena.alloc_slice<u8>(100000u);
+  EXPECT_EQ(s.len(), 100000u);
+  EXPECT_EQ(s[99999u], 0_u8);
+}
+
+TEST(Arena, DestroyInReverseOrder) {
+  auto destroyed = sus::Vec<i32>();
+  {
+    auto arena = Arena::with_chunk_size(32u);
+    for (i32 i = 0; i < 5; i += 1) (void)arena.alloc<Tracked>(i, destroyed);
+    EXPECT_EQ(destroyed.len(), 0u);
+  }
+  EXPECT_EQ(destroyed.len(), 5u);
+  EXPECT_EQ(destroyed[0u], 4);
+  EXPECT_EQ(destroyed[1u], 3);
+  EXPECT_EQ(destroyed[4u], 0);
+}
+
+TEST(Arena, Reset) {
+  auto destroyed = sus::Vec<i32>();
+  auto arena = Arena::with_chunk_size(64u);
+  for (i32 i = 0; i < 20; i += 1) (void)arena.alloc<Tracked>(i, destroyed);
+  arena.reset();
+  EXPECT_EQ(destroyed.len(), 20u);
+  const usize kept = arena.allocated_bytes();
+  EXPECT_GT(kept, 0u);
+
+  // The kept chunk is reused, without allocating.
+  destroyed.clear();
+  (void)arena.alloc<Tracked>(1, destroyed);
+  EXPECT_EQ(arena.allocated_bytes(), kept);
+  arena.reset();
+  EXPECT_EQ(destroyed.len(), 1u);
+}
+
+TEST(Arena, ResetKeepsLargest) {
+  auto arena = Arena::with_chunk_size(64u);
+  // An oversized allocation gets a chunk of its own, which is then larger
+  // than the newest chunk.
+  (void)arena.allocate(10000u, 8u);
+  (void)arena.allocate(8000u, 8u);
+  const usize before = arena.allocated_bytes();
+  arena.reset();
+  const usize kept = arena.allocated_bytes();
+  EXPECT_LT(kept, before);
+  EXPECT_GE(kept, 10000u);
+  (void)arena.allocate(10000u, 8u);
+  EXPECT_EQ(arena.allocated_bytes(), kept);
+}
+
+TEST(Arena, AllocSlice) {
+  auto arena = Arena();
+  auto s = arena.alloc_slice<i32>(4u);
+  EXPECT_EQ(s.len(), 4u);
+  for (usize i = 0u; i < 4u; i += 1u) EXPECT_EQ(s[i], 0);
+  s[3u] = 3;
+  EXPECT_EQ(s[3u], 3);
+
+  auto e = arena.alloc_slice<i32>(0u);
+  EXPECT_EQ(e.len(), 0u);
+}
+
+TEST(Arena, AllocSliceClone) {
+  auto arena = Arena();
+  auto v = sus::Vec<i32>();
+  v.push(1);
+  v.push(2);
+  auto s = arena.alloc_slice_clone(v.as_ref());
+  v[0u] = 3;
+  EXPECT_EQ(s.len(), 2u);
+  EXPECT_EQ(s[0u], 1);
+  EXPECT_EQ(s[1u], 2);
+}
+
+TEST(Arena, Move) {
+  auto destroyed = sus::Vec<i32>();
+  auto arena = Arena();
+  i32& a = arena.alloc<i32>(3);
+  (void)arena.alloc<Tracked>(1, destroyed);
+  auto moved = sus::move(arena);
+  EXPECT_EQ(a, 3);
+  EXPECT_EQ(destroyed.len(), 0u);
+  // Moving into itself does nothing.
+  auto& self = moved;
+  moved = sus::move(self);
+  EXPECT_EQ(a, 3);
+  EXPECT_EQ(destroyed.len(), 0u);
+  moved = Arena();
+  EXPECT_EQ(destroyed.len(), 1u);
+}
+
+}  // namespace
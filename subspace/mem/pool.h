@@ -0,0 +1,181 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <new>
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/alloc.h"
+#include "subspace/mem/forward.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/num/unsigned_integer.h"
+
+namespace sus::mem {
+
+/// A pool of same-sized slots for objects of type `T`, which are allocated and
+/// freed individually in O(1) time.
+///
+/// Freed slots are kept in a free list and handed out again by the next
+/// `alloc()`, so a workload which repeatedly creates and destroys objects of
+/// the same type stops allocating from the global allocator once the pool has
+/// grown to its working size. Slots are allocated in chunks, which are only
+/// returned to the global allocator when the pool is destroyed.
+///
+/// A `Pool` is not thread-safe. For a thread-safe allocator of small objects
+/// of any type, see `sus::mem::SlabAllocator`.
+///
+/// Every object allocated from the pool must be given back to `free()` before
+/// the pool is destroyed, or its destructor will not run.
+template <class T>
+  requires(!std::is_reference_v<T>)
+class [[sus_trivial_abi]] Pool final {
+ public:
+  /// Constructs an empty `Pool`. No memory is allocated until the first object
+  /// is allocated from it.
+  ///
+  /// sus::construct::Default trait.
+  Pool() noexcept
+      : free_(nullptr), chunks_(nullptr), len_(0u), capacity_(0u) {}
+
+  ~Pool() {
+    if (!is_moved_from()) free_chunks();
+  }
+
+  Pool(Pool&& o) noexcept
+      : free_(::sus::mem::replace_ptr(mref(o.free_), nullptr)),
+        chunks_(::sus::mem::replace_ptr(mref(o.chunks_), moved_from_value())),
+        len_(::sus::mem::replace(mref(o.len_), 0_usize)),
+        capacity_(::sus::mem::replace(mref(o.capacity_), 0_usize)) {
+    check(!is_moved_from());
+  }
+  Pool& operator=(Pool&& o) noexcept {
+    check(!o.is_moved_from());
+    if (!is_moved_from()) free_chunks();
+    free_ = ::sus::mem::replace_ptr(mref(o.free_), nullptr);
+    chunks_ = ::sus::mem::replace_ptr(mref(o.chunks_), moved_from_value());
+    len_ = ::sus::mem::replace(mref(o.len_), 0_usize);
+    capacity_ = ::sus::mem::replace(mref(o.capacity_), 0_usize);
+    return *this;
+  }
+
+  /// Constructs a `T` from `args` in a free slot of the pool, and returns a
+  /// reference to it.
+  template <class... Args>
+    requires(std::is_constructible_v<T, Args&&...>)
+  T& alloc(Args&&... args) & noexcept {
+    check(!is_moved_from());
+    if (free_ == nullptr) [[unlikely]]
+      grow();
+    Slot* slot = ::sus::mem::replace_ptr(mref(free_), free_->next);
+    len_ += 1u;
+    return *new (&slot->storage) T(::sus::forward<Args>(args)...);
+  }
+
+  /// Destroys the `T` and returns its slot to the pool.
+  ///
+  /// # Safety
+  /// The object must have come from `alloc()` on this pool, and must not be
+  /// used after, or Undefined Behaviour will result.
+  void free(::sus::marker::UnsafeFnMarker, T& t) & noexcept {
+    check(!is_moved_from());
+    t.~T();
+    auto* slot = reinterpret_cast<Slot*>(&t);
+    slot->next = free_;
+    free_ = slot;
+    len_ -= 1u;
+  }
+
+  /// Returns the number of objects allocated from the pool and not yet freed.
+  usize len() const& noexcept {
+    check(!is_moved_from());
+    return len_;
+  }
+
+  /// Returns the number of objects the pool can hold before it needs to
+  /// allocate another chunk.
+  usize capacity() const& noexcept {
+    check(!is_moved_from());
+    return capacity_;
+  }
+
+ private:
+  union Slot {
+    Slot* next;
+    alignas(T) char storage[sizeof(T)];
+  };
+  struct Chunk {
+    Chunk* prev;
+  };
+
+  // Chunks hold about a page of slots, and at least a few of them.
+  static constexpr size_t kSlotsPerChunk =
+      4096u / sizeof(Slot) > 8u ? 4096u / sizeof(Slot) : 8u;
+  // The slots start after the chunk header, at the slot alignment.
+  static constexpr size_t kSlotsOffset =
+      (sizeof(Chunk) + alignof(Slot) - 1u) / alignof(Slot) * alignof(Slot);
+  static constexpr size_t kChunkAlign =
+      alignof(Slot) > alignof(Chunk) ? alignof(Slot) : alignof(Chunk);
+
+  void grow() noexcept {
+    void* p = ::sus::mem::allocate(
+        kSlotsOffset + kSlotsPerChunk * sizeof(Slot), kChunkAlign);
+    auto* chunk = new (p) Chunk{.prev = chunks_};
+    chunks_ = chunk;
+    auto* slots =
+        reinterpret_cast<Slot*>(static_cast<char*>(p) + kSlotsOffset);
+    // Link the new slots in order, so they are handed out in address order.
+    for (size_t i = 0u; i < kSlotsPerChunk - 1u; ++i)
+      slots[i].next = &slots[i + 1u];
+    slots[kSlotsPerChunk - 1u].next = free_;
+    free_ = slots;
+    capacity_ += kSlotsPerChunk;
+  }
+
+  void free_chunks() noexcept {
+    Chunk* chunk = chunks_;
+    while (chunk != nullptr)
+      ::sus::mem::deallocate(::sus::mem::replace_ptr(mref(chunk), chunk->prev),
+                             kChunkAlign);
+  }
+
+  inline bool is_moved_from() const noexcept {
+    return chunks_ == moved_from_value();
+  }
+  // The value used in `chunks_` to indicate moved-from.
+  static Chunk* moved_from_value() noexcept {
+    return reinterpret_cast<Chunk*>(uintptr_t{alignof(Chunk)});
+  }
+
+  // The head of the list of free slots.
+  Slot* free_;
+  // The most recently allocated chunk. Older chunks are linked through
+  // `Chunk::prev`.
+  Chunk* chunks_;
+  usize len_;
+  usize capacity_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(free_),
+                                  decltype(chunks_), decltype(len_),
+                                  decltype(capacity_));
+};
+
+}  // namespace sus::mem
@@ -0,0 +1,107 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "subspace/mem/pool.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/prelude.h"
+#include "subspace/test/counting_allocator.h"
+
+namespace {
+
+using sus::mem::Pool;
+
+static_assert(sus::mem::relocate_by_memcpy<Pool<i32>>);
+
+struct Tracked {
+  Tracked(i32 id, i32& destroyed) : id(id), destroyed(destroyed) {}
+  ~Tracked() { destroyed += 1; }
+
+  i32 id;
+  i32& destroyed;
+};
+
+struct alignas(32) Aligned {
+  u8 b;
+};
+
+TEST(Pool, AllocFree) {
+  auto pool = Pool<i32>();
+  EXPECT_EQ(pool.len(), 0u);
+  EXPECT_EQ(pool.capacity(), 0u);
+  i32& a = pool.alloc(1);
+  i32& b = pool.alloc(2);
+  EXPECT_EQ(a, 1);
+  EXPECT_EQ(b, 2);
+  EXPECT_EQ(pool.len(), 2u);
+  EXPECT_GE(pool.capacity(), 2u);
+  pool.free(unsafe_fn, a);
+  EXPECT_EQ(pool.len(), 1u);
+  // The freed slot is reused.
+  i32& c = pool.alloc(3);
+  EXPECT_EQ(&c, &a);
+  pool.free(unsafe_fn, b);
+  pool.free(unsafe_fn, c);
+  EXPECT_EQ(pool.len(), 0u);
+}
+
+TEST(Pool, Destroys) {
+  i32 destroyed;
+  auto pool = Pool<Tracked>();
+  Tracked& t = pool.alloc(1, destroyed);
+  EXPECT_EQ(t.id, 1);
+  pool.free(unsafe_fn, t);
+  EXPECT_EQ(destroyed, 1);
+}
+
+TEST(Pool, Grows) {
+  auto pool = Pool<u64>();
+  auto v = Vec<u64*>();
+  for (u64 i = 0u; i < 2000u; i += 1u) v.push(&pool.alloc(i));
+  EXPECT_EQ(pool.len(), 2000u);
+  for (usize i = 0u; i < v.len(); i += 1u) EXPECT_EQ(*v[i], u64::from(i));
+  for (u64* p : v) pool.free(unsafe_fn, *p);
+  EXPECT_EQ(pool.len(), 0u);
+}
+
+TEST(Pool, Alignment) {
+  auto pool = Pool<Aligned>();
+  for (i32 i = 0; i < 200; i += 1) {
+    Aligned& a = pool.alloc(Aligned(1_u8));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&a) % 32u, 0u);
+  }
+}
+
+TEST(Pool, ChurnDoesNotAllocate) {
+  auto pool = Pool<u64>();
+  pool.free(unsafe_fn, pool.alloc(0u));
+  EXPECT_NO_ALLOCATIONS {
+    for (u64 i = 0u; i < 1000u; i += 1u) {
+      u64& a = pool.alloc(i);
+      pool.free(unsafe_fn, a);
+    }
+  }
+}
+
+TEST(Pool, Move) {
+  auto pool = Pool<i32>();
+  i32& a = pool.alloc(1);
+  auto moved = sus::move(pool);
+  EXPECT_EQ(a, 1);
+  EXPECT_EQ(moved.len(), 1u);
+  moved.free(unsafe_fn, a);
+}
+
+}  // namespace
@@ -14,26 +14,53 @@
 
 #pragma once
 
+#include <stddef.h>
+#include <string.h>
+
 #include <concepts>
+#include <new>
 #include <type_traits>
 
 #include "subspace/macros/builtin.h"
 #include "subspace/macros/compiler.h"
 #include "subspace/marker/unsafe.h"
+#include "subspace/mem/move.h"
 #include "subspace/mem/size_of.h"
 
 namespace sus::mem {
 
 namespace __private {
 
+/// Whether the compiler reports `T` as trivially relocatable, without the type
+/// having been marked by one of the `sus_class_trivially_relocatable` macros.
+///
+/// This includes types marked with the `[[clang::trivial_abi]]` attribute, such
+/// as third-party types, or the standard library types in a libc++ built with
+/// its trivial ABI. It is always false where the compiler has no builtin to
+/// answer the question.
+template <class T>
+constexpr bool builtin_trivially_relocatable() noexcept {
+#if __has_builtin(__is_trivially_relocatable) || \
+    __has_extension(trivially_relocatable)
+  return __is_trivially_relocatable(T);
+#elif __has_builtin(__builtin_is_cpp_trivially_relocatable)
+  return __builtin_is_cpp_trivially_relocatable(T);
+#else
+  return false;
+#endif
+}
+
 /// Detects the presence and value of the static const member
 /// `T::SusUnsafeTrivialRelocate`.
 ///
 /// The static member is created by `sus_class_trivially_relocatable()` and
-/// similar macros.
+/// similar macros. When it is not present, the compiler's answer is used, if
+/// it has one.
 template <class T>
 struct relocatable_tag final {
-  static constexpr bool value(...) { return false; }
+  static constexpr bool value(...) {
+    return builtin_trivially_relocatable<T>();
+  }
 
   static constexpr bool value(int)
     requires requires {
@@ -51,6 +78,11 @@ struct relocatable_tag final {
 /// [[trivial_abi]] clang attribute, as types annotated with the attribute are
 /// now considered "trivially relocatable" in https://reviews.llvm.org/D114732.
 ///
+/// A type marked with one of the `sus_class_trivially_relocatable` macros
+/// gets the answer given to the macro. Otherwise, where the compiler provides
+/// a builtin for it, an unannotated type that the compiler considers trivially
+/// relocatable satisfies the trait as well.
+///
 /// IMPORTANT: If a class satisfies this trait, only `sus::data_size_of<T>()`
 /// bytes should be memcpy'd or Undefine Behaviour can result, due to the
 /// possibility of overwriting data stored in the padding bytes of `T`.
@@ -77,14 +109,42 @@ concept relocate_by_memcpy =
         || (std::is_trivially_move_constructible_v<std::remove_all_extents_t<T>> &&
             std::is_trivially_move_assignable_v<std::remove_all_extents_t<T>> &&
             std::is_trivially_destructible_v<std::remove_all_extents_t<T>>)
-  #if __has_extension(trivially_relocatable)
-        || __is_trivially_relocatable(std::remove_all_extents_t<T>)
-  #endif
         )
     )
   );
 // clang-format on
 
+/// Moves `count` objects of type `T` from `src` to `dst`, ending the lifetime
+/// of the objects at `src`.
+///
+/// If `T` satisfies `relocate_by_memcpy`, the objects are moved together with
+/// a single memcpy(). Otherwise each object is move-constructed into `dst` and
+/// then destroyed at `src`.
+///
+/// # Safety
+/// The `count` objects at `src` must be constructed, and `dst` must point to
+/// uninitialized memory with space for `count` objects of type `T`. The two
+/// ranges must not overlap. The objects at `src` must not be used or destroyed
+/// afterward, or Undefined Behaviour results.
+template <class T>
+  requires(!std::is_const_v<T> && std::is_move_constructible_v<T>)
+inline void relocate_slice(::sus::marker::UnsafeFnMarker, T* src, T* dst,
+                           size_t count) noexcept {
+  if constexpr (relocate_by_memcpy<T>) {
+    // The tail padding of the last object is not copied, as it may be in use
+    // by an outer object. See `relocate_by_memcpy`.
+    if (count > 0u) {
+      memcpy(dst, src,
+             (count - 1u) * sizeof(T) + ::sus::mem::data_size_of<T>());
+    }
+  } else {
+    for (size_t i = 0u; i < count; ++i) {
+      new (dst + i) T(::sus::move(src[i]));
+      src[i].~T();
+    }
+  }
+}
+
 }  // namespace sus::mem
 
 /// An attribute to allow a class to be passed in registers.
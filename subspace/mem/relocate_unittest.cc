@@ -14,6 +14,9 @@
 
 #include "subspace/mem/relocate.h"
 
+#include <new>
+
+#include "googletest/include/gtest/gtest.h"
 #include "subspace/num/types.h"
 #include "subspace/prelude.h"
 
@@ -80,9 +83,12 @@ struct [[sus_trivial_abi]] F {
   ~F() {}
   i32 i;
 };
-#if defined(__clang__) && __has_extension(trivially_relocatable)
+// Without a tag, the compiler decides if the type is trivially relocatable,
+// which clang does for `[[clang::trivial_abi]]` types.
+#if defined(__clang__) && (__has_builtin(__is_trivially_relocatable) || \
+                           __has_extension(trivially_relocatable))
 static_assert(relocate_by_memcpy<F>);
-#else
+#elif !defined(__clang__)
 static_assert(!relocate_by_memcpy<F>);
 #endif
 
@@ -117,4 +123,62 @@ union U {
 // all fields are trivially relocatable *and have the same data-size*.
 static_assert(!relocate_by_memcpy<U>);
 
+struct Counted {
+  Counted(i32 i) : i(i) {}
+  Counted(Counted&& o) : i(o.i) { moves += 1; }
+  ~Counted() { destroys += 1; }
+  i32 i;
+
+  static inline i32 moves = 0;
+  static inline i32 destroys = 0;
+};
+static_assert(!relocate_by_memcpy<Counted>);
+
+TEST(Relocate, RelocateSliceMoves) {
+  alignas(Counted) char from_storage[sizeof(Counted) * 3u];
+  alignas(Counted) char to_storage[sizeof(Counted) * 3u];
+  auto* from = reinterpret_cast<Counted*>(from_storage);
+  auto* to = reinterpret_cast<Counted*>(to_storage);
+  for (int i = 0; i < 3; ++i) new (from + i) Counted(i);
+
+  Counted::moves = Counted::destroys = 0;
+  sus::mem::relocate_slice(unsafe_fn, from, to, 3u);
+  // Each object was moved to `to` and destroyed in `from`.
+  EXPECT_EQ(Counted::moves, 3);
+  EXPECT_EQ(Counted::destroys, 3);
+  EXPECT_EQ(to[0u].i, 0);
+  EXPECT_EQ(to[2u].i, 2);
+  for (size_t i = 0u; i < 3u; ++i) to[i].~Counted();
+}
+
+struct Tagged {
+  sus_class_trivially_relocatable_unchecked(unsafe_fn);
+  Tagged(i32 i) : i(i) {}
+  Tagged(Tagged&& o) : i(o.i) { moves += 1; }
+  ~Tagged() {}
+  i32 i;
+
+  static inline i32 moves = 0;
+};
+static_assert(relocate_by_memcpy<Tagged>);
+
+TEST(Relocate, RelocateSliceMemcpy) {
+  alignas(Tagged) char from_storage[sizeof(Tagged) * 3u];
+  alignas(Tagged) char to_storage[sizeof(Tagged) * 3u];
+  auto* from = reinterpret_cast<Tagged*>(from_storage);
+  auto* to = reinterpret_cast<Tagged*>(to_storage);
+  for (int i = 0; i < 3; ++i) new (from + i) Tagged(i);
+
+  Tagged::moves = 0;
+  sus::mem::relocate_slice(unsafe_fn, from, to, 3u);
+  // The objects were copied as bytes without running the move constructor.
+  EXPECT_EQ(Tagged::moves, 0);
+  EXPECT_EQ(to[0u].i, 0);
+  EXPECT_EQ(to[1u].i, 1);
+  EXPECT_EQ(to[2u].i, 2);
+
+  // Nothing is done for an empty slice.
+  sus::mem::relocate_slice(unsafe_fn, to, from, 0u);
+}
+
 }  // namespace
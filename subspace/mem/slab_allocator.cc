@@ -0,0 +1,315 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "subspace/mem/slab_allocator.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+#include <mutex>
+#include <new>
+
+#include "subspace/assertions/check.h"
+#include "subspace/mem/alloc.h"
+
+namespace sus::mem {
+
+namespace {
+
+// Small objects live in spans which are aligned to their size, so the span
+// header is found by masking the low bits of the pointer.
+constexpr size_t kSpanSize = size_t{64u} * 1024u;
+constexpr size_t kSpanBits = 16u;
+static_assert(size_t{1u} << kSpanBits == kSpanSize);
+// The header is padded so that the objects after it are 16-byte aligned.
+constexpr size_t kHeaderSize = 64u;
+constexpr size_t kSmallAlign = 16u;
+
+constexpr size_t kSizeClasses[] = {
+    16u,  32u,  48u,  64u,  80u,  96u,  112u, 128u, 160u,  192u,
+    224u, 256u, 320u, 384u, 448u, 512u, 640u, 768u, 896u, 1024u,
+};
+constexpr size_t kNumClasses = sizeof(kSizeClasses) / sizeof(kSizeClasses[0]);
+static_assert(kSizeClasses[kNumClasses - 1u] == SlabAllocator::kMaxSmallSize);
+
+// Maps (size + 15) / 16 to the size class index that holds it.
+struct ClassTable {
+  constexpr ClassTable() noexcept {
+    size_t c = 0u;
+    for (size_t i = 0u; i < kEntries; ++i) {
+      while (kSizeClasses[c] < i * kSmallAlign) ++c;
+      index[i] = static_cast<uint8_t>(c);
+    }
+  }
+
+  static constexpr size_t kEntries = SlabAllocator::kMaxSmallSize / 16u + 1u;
+  uint8_t index[kEntries] = {};
+};
+constexpr ClassTable kClassTable;
+
+// The number of objects in a span of the size class. A thread's free list is
+// moved to the shared lists in batches of this many objects.
+constexpr size_t batch_size(size_t size_class) noexcept {
+  return (kSpanSize - kHeaderSize) / kSizeClasses[size_class];
+}
+
+struct SpanHeader {
+  uint32_t size_class;
+};
+static_assert(sizeof(SpanHeader) <= kHeaderSize);
+
+struct FreeObject {
+  FreeObject* next;
+  // In the shared lists, the first object of each batch links to the next
+  // batch.
+  FreeObject* next_batch;
+};
+static_assert(sizeof(FreeObject) <= kSizeClasses[0]);
+
+// Records which span-sized blocks of the address space are spans of small
+// objects, so that any other pointer is known to be a large allocation. It
+// is a two-level radix tree indexed by the span number, with a bit per span
+// in the leaves. Spans are never freed, so bits are never cleared.
+class PageMap {
+ public:
+  bool is_span(const void* ptr) const noexcept {
+    const uintptr_t span = reinterpret_cast<uintptr_t>(ptr) >> kSpanBits;
+    if (span >> (kLeafBits + kRootBits) != 0u) return false;
+    const Leaf* leaf = root_[span >> kLeafBits].load(std::memory_order_acquire);
+    if (leaf == nullptr) return false;
+    const size_t bit = span & (kLeafSpans - 1u);
+    return (leaf->bits[bit / 64u].load(std::memory_order_relaxed) >>
+            (bit % 64u)) &
+           1u;
+  }
+
+  // Returns false if the span can not be recorded, in which case it must not
+  // be used for small objects.
+  bool add_span(const void* ptr) noexcept {
+    const uintptr_t span = reinterpret_cast<uintptr_t>(ptr) >> kSpanBits;
+    if (span >> (kLeafBits + kRootBits) != 0u) return false;
+    std::atomic<Leaf*>& slot = root_[span >> kLeafBits];
+    Leaf* leaf = slot.load(std::memory_order_acquire);
+    if (leaf == nullptr) {
+      void* p = __private::default_allocate(sizeof(Leaf), alignof(Leaf));
+      if (p == nullptr) return false;
+      auto* fresh = new (p) Leaf();
+      if (slot.compare_exchange_strong(leaf, fresh, std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+        leaf = fresh;
+      } else {
+        __private::default_deallocate(p, alignof(Leaf));
+      }
+    }
+    const size_t bit = span & (kLeafSpans - 1u);
+    leaf->bits[bit / 64u].fetch_or(uint64_t{1u} << (bit % 64u),
+                                   std::memory_order_relaxed);
+    return true;
+  }
+
+ private:
+  // Spans are recorded for the low 48 bits of the address space, which is
+  // all of it that user space gets on common 64-bit systems.
+  static constexpr size_t kAddressBits = sizeof(void*) >= 8u ? 48u : 32u;
+  static constexpr size_t kLeafBits = 16u;
+  static constexpr size_t kRootBits = kAddressBits - kSpanBits - kLeafBits;
+  static constexpr size_t kLeafSpans = size_t{1u} << kLeafBits;
+
+  struct Leaf {
+    std::atomic<uint64_t> bits[kLeafSpans / 64u] = {};
+  };
+
+  std::atomic<Leaf*> root_[size_t{1u} << kRootBits] = {};
+};
+
+// Never destroyed, as threads may free objects during static destruction.
+constinit PageMap page_map;
+
+// Free lists shared by all threads, which hold batches of objects that
+// threads have handed over, either because they freed more objects than they
+// keep or because they exited.
+struct Central {
+  std::mutex mutex;
+  FreeObject* batches[kNumClasses] = {};
+};
+
+Central& central() noexcept {
+  // Never destroyed, as threads may exit during static destruction.
+  static Central* c = new Central();
+  return *c;
+}
+
+void push_batch(size_t size_class, FreeObject* batch) noexcept {
+  Central& c = central();
+  auto lock = std::scoped_lock(c.mutex);
+  batch->next_batch = c.batches[size_class];
+  c.batches[size_class] = batch;
+}
+
+FreeObject* pop_batch(size_t size_class) noexcept {
+  Central& c = central();
+  auto lock = std::scoped_lock(c.mutex);
+  FreeObject* batch = c.batches[size_class];
+  if (batch != nullptr) c.batches[size_class] = batch->next_batch;
+  return batch;
+}
+
+// The cache is trivially destructible, so that it can still be used while the
+// thread's other thread-locals are destroyed, after `CacheFlusher` has handed
+// its objects over.
+struct ThreadCache {
+  FreeObject* free[kNumClasses];
+  // The number of objects in each of the `free` lists.
+  size_t count[kNumClasses];
+  // Set once the thread is exiting and the cache has been flushed. After
+  // that, objects go to and come from the shared lists and the default
+  // allocator directly.
+  bool flushed;
+};
+
+constinit thread_local ThreadCache cache = {};
+
+// Hands the thread's free objects over to the shared lists when it exits.
+struct CacheFlusher {
+  ~CacheFlusher() noexcept {
+    for (size_t i = 0u; i < kNumClasses; ++i) {
+      if (cache.free[i] != nullptr) push_batch(i, cache.free[i]);
+      cache.free[i] = nullptr;
+      cache.count[i] = 0u;
+    }
+    cache.flushed = true;
+  }
+};
+
+thread_local CacheFlusher flusher;
+
+// Makes sure the thread's cache is flushed when it exits.
+void register_flusher() noexcept { (void)&flusher; }
+
+SpanHeader& span_header(const void* ptr) noexcept {
+  return *reinterpret_cast<SpanHeader*>(reinterpret_cast<uintptr_t>(ptr) &
+                                        ~uintptr_t{kSpanSize - 1u});
+}
+
+// Fills the thread's empty free list for a size class, from the shared lists
+// if they have a batch, or else by carving up a new span.
+bool refill(size_t size_class) noexcept {
+  register_flusher();
+  if (FreeObject* batch = pop_batch(size_class); batch != nullptr) {
+    size_t count = 0u;
+    for (FreeObject* o = batch; o != nullptr; o = o->next) ++count;
+    cache.free[size_class] = batch;
+    cache.count[size_class] = count;
+    return true;
+  }
+
+  void* span = __private::default_allocate(kSpanSize, kSpanSize);
+  if (span == nullptr) return false;
+  if (!page_map.add_span(span)) [[unlikely]] {
+    __private::default_deallocate(span, kSpanSize);
+    return false;
+  }
+  new (span) SpanHeader{.size_class = static_cast<uint32_t>(size_class)};
+  const size_t object_size = kSizeClasses[size_class];
+  const size_t count = batch_size(size_class);
+  char* first = static_cast<char*>(span) + kHeaderSize;
+  for (size_t i = 0u; i < count - 1u; ++i) {
+    reinterpret_cast<FreeObject*>(first + i * object_size)->next =
+        reinterpret_cast<FreeObject*>(first + (i + 1u) * object_size);
+  }
+  reinterpret_cast<FreeObject*>(first + (count - 1u) * object_size)->next =
+      nullptr;
+  cache.free[size_class] = reinterpret_cast<FreeObject*>(first);
+  cache.count[size_class] = count;
+  return true;
+}
+
+// Moves a batch of objects from the thread's free list for a size class to
+// the shared lists. Without this, a thread which frees objects that another
+// thread allocated would collect them without bound.
+void release(size_t size_class) noexcept {
+  FreeObject* const batch = cache.free[size_class];
+  FreeObject* tail = batch;
+  for (size_t i = 1u; i < batch_size(size_class); ++i) tail = tail->next;
+  cache.free[size_class] = tail->next;
+  cache.count[size_class] -= batch_size(size_class);
+  tail->next = nullptr;
+  push_batch(size_class, batch);
+}
+
+}  // namespace
+
+void* SlabAllocator::allocate(size_t size, size_t align) noexcept {
+  // Large allocations go to the default allocator as is. The page map tells
+  // them apart from small objects when they are freed.
+  if (size > kMaxSmallSize || align > kSmallAlign) [[unlikely]]
+    return __private::default_allocate(size, align);
+  const size_t size_class = kClassTable.index[(size + 15u) / 16u];
+  if (cache.free[size_class] == nullptr) [[unlikely]] {
+    // The page map tells an object from the default allocator apart when it
+    // is freed, so that is used once the thread's cache is gone.
+    if (cache.flushed) return __private::default_allocate(size, align);
+    if (!refill(size_class)) return nullptr;
+  }
+  FreeObject* o = cache.free[size_class];
+  cache.free[size_class] = o->next;
+  cache.count[size_class] -= 1u;
+  return o;
+}
+
+void* SlabAllocator::reallocate(void* ptr, size_t old_size, size_t new_size,
+                                size_t align) noexcept {
+  if (!page_map.is_span(ptr)) {
+    // A large allocation stays with the default allocator, which can often
+    // resize it in place.
+    if (new_size > kMaxSmallSize || align > kSmallAlign)
+      return __private::default_reallocate(ptr, old_size, new_size, align);
+  } else if (new_size <= kSizeClasses[span_header(ptr).size_class]) {
+    return ptr;
+  }
+  void* p = allocate(new_size, align);
+  if (p == nullptr) return nullptr;
+  memcpy(p, ptr, old_size < new_size ? old_size : new_size);
+  deallocate(ptr, align);
+  return p;
+}
+
+void SlabAllocator::deallocate(void* ptr, size_t align) noexcept {
+  if (ptr == nullptr) return;
+  if (!page_map.is_span(ptr)) [[unlikely]] {
+    __private::default_deallocate(ptr, align);
+    return;
+  }
+  const size_t size_class = span_header(ptr).size_class;
+  auto* o = static_cast<FreeObject*>(ptr);
+  if (cache.free[size_class] == nullptr) [[unlikely]] {
+    if (cache.flushed) {
+      // The thread's cache is gone, so the object goes to the shared lists
+      // as a batch of its own.
+      o->next = nullptr;
+      push_batch(size_class, o);
+      return;
+    }
+    register_flusher();
+  }
+  o->next = cache.free[size_class];
+  cache.free[size_class] = o;
+  cache.count[size_class] += 1u;
+  // The thread keeps up to two spans' worth of free objects in each size
+  // class, and hands the rest over for other threads to allocate.
+  if (cache.count[size_class] >= 2u * batch_size(size_class)) [[unlikely]]
+    release(size_class);
+}
+
+}  // namespace sus::mem
@@ -0,0 +1,79 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <stddef.h>
+
+namespace sus::mem {
+
+/// A general purpose allocator which serves small allocations from size-class
+/// slabs with thread-local free lists.
+///
+/// Allocations of up to `kMaxSmallSize` bytes, with an alignment of up to 16,
+/// are rounded up to one of a fixed set of size classes. Each size class is
+/// carved out of 64KiB spans, and freed objects go on a free list for the
+/// current thread, so `allocate()` and `deallocate()` are O(1) and do not
+/// take a lock in the common case. Larger allocations are passed on to the
+/// default allocator.
+///
+/// Memory in the spans is reused for the same size class but never returned to
+/// the system. Objects may be freed on a different thread than allocated them.
+/// A thread keeps a bounded number of free objects in each size class, and
+/// hands any more over to shared lists for other threads to allocate, in
+/// batches of a span's worth. When a thread exits, all of its free objects
+/// are handed over.
+///
+/// The `SlabAllocator` can be made the global allocator for the library by
+/// defining `SUS_PROVIDE_ALLOCATOR` and forwarding to it:
+/// ```
+/// void* sus::mem::provided_allocate(size_t size, size_t align,
+///                                   const std::source_location&) noexcept {
+///   return sus::mem::SlabAllocator::allocate(size, align);
+/// }
+/// void* sus::mem::provided_reallocate(void* ptr, size_t old_size,
+///                                     size_t new_size, size_t align,
+///                                     const std::source_location&) noexcept {
+///   return sus::mem::SlabAllocator::reallocate(ptr, old_size, new_size,
+///                                              align);
+/// }
+/// void sus::mem::provided_deallocate(void* ptr, size_t align) noexcept {
+///   sus::mem::SlabAllocator::deallocate(ptr, align);
+/// }
+/// ```
+class SlabAllocator final {
+ public:
+  /// The largest allocation that is served from a size class.
+  static constexpr size_t kMaxSmallSize = 1024u;
+
+  /// Allocates `size` bytes of uninitialized memory, aligned to `align`.
+  ///
+  /// Returns null if the memory can not be allocated.
+  static void* allocate(size_t size, size_t align) noexcept;
+
+  /// Grows or shrinks an allocation from `allocate()` to `new_size` bytes,
+  /// keeping the first `min(old_size, new_size)` bytes. The allocation does
+  /// not move if it still fits in its size class, and a large allocation is
+  /// resized by the default allocator, which can often do so in place.
+  ///
+  /// Returns null if the memory can not be allocated, in which case `ptr` is
+  /// not freed.
+  static void* reallocate(void* ptr, size_t old_size, size_t new_size,
+                          size_t align) noexcept;
+
+  /// Frees an allocation from `allocate()` or `reallocate()`. The `ptr` may
+  /// be null, and may be freed on any thread.
+  static void deallocate(void* ptr, size_t align) noexcept;
+};
+
+}  // namespace sus::mem
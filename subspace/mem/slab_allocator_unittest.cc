@@ -0,0 +1,206 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "subspace/mem/slab_allocator.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::mem::SlabAllocator;
+
+TEST(SlabAllocator, SmallSizes) {
+  for (size_t size = 1u; size <= SlabAllocator::kMaxSmallSize; ++size) {
+    void* p = SlabAllocator::allocate(size, 8u);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 16u, 0u);
+    memset(p, 0xab, size);
+    SlabAllocator::deallocate(p, 8u);
+  }
+}
+
+TEST(SlabAllocator, ReusesFreed) {
+  void* p = SlabAllocator::allocate(24u, 8u);
+  SlabAllocator::deallocate(p, 8u);
+  void* q = SlabAllocator::allocate(30u, 8u);
+  // Both sizes are in the same size class.
+  EXPECT_EQ(p, q);
+  SlabAllocator::deallocate(q, 8u);
+}
+
+TEST(SlabAllocator, Large) {
+  void* p = SlabAllocator::allocate(100000u, 8u);
+  ASSERT_NE(p, nullptr);
+  memset(p, 0xab, 100000u);
+  SlabAllocator::deallocate(p, 8u);
+
+  void* q = SlabAllocator::allocate(10u, 256u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(q) % 256u, 0u);
+  SlabAllocator::deallocate(q, 256u);
+}
+
+TEST(SlabAllocator, LargeIsNotSpanAligned) {
+  // Large allocations are not padded out to a span of their own, so they do
+  // not all share the same offset into a span.
+  void* ptrs[8];
+  std::set<uintptr_t> offsets;
+  for (void*& p : ptrs) {
+    p = SlabAllocator::allocate(2000u, 8u);
+    offsets.insert(reinterpret_cast<uintptr_t>(p) % (64u * 1024u));
+  }
+  EXPECT_GT(offsets.size(), 1u);
+  for (void* p : ptrs) SlabAllocator::deallocate(p, 8u);
+}
+
+TEST(SlabAllocator, Reallocate) {
+  auto* p = static_cast<char*>(SlabAllocator::allocate(20u, 8u));
+  memset(p, 7, 20u);
+  // Fits in the same size class.
+  EXPECT_EQ(SlabAllocator::reallocate(p, 20u, 32u, 8u), p);
+  auto* q = static_cast<char*>(SlabAllocator::reallocate(p, 32u, 5000u, 8u));
+  EXPECT_EQ(q[0], 7);
+  EXPECT_EQ(q[19], 7);
+  auto* r = static_cast<char*>(SlabAllocator::reallocate(q, 5000u, 10u, 8u));
+  EXPECT_EQ(r[0], 7);
+  EXPECT_EQ(r[9], 7);
+  SlabAllocator::deallocate(r, 8u);
+  SlabAllocator::deallocate(nullptr, 8u);
+}
+
+TEST(SlabAllocator, ThreadChurn) {
+  // Allocations are freed on other threads and threads exit, moving objects
+  // between the thread-local and shared free lists.
+  constexpr size_t kCount = 2000u;
+  auto ptrs = Vec<void*>::with_capacity(kCount);
+  for (size_t i = 0u; i < kCount; ++i) {
+    void* p = SlabAllocator::allocate(i % 200u + 1u, 8u);
+    memset(p, static_cast<int>(i % 256u), i % 200u + 1u);
+    ptrs.push(p);
+  }
+  auto churn = [](Vec<void*>& ptrs, size_t start) {
+    for (size_t i = start; i < kCount; i += 4u) {
+      auto* p = static_cast<unsigned char*>(ptrs[i]);
+      EXPECT_EQ(p[0], i % 256u);
+      SlabAllocator::deallocate(p, 8u);
+      // Allocate and free on this thread too.
+      for (size_t j = 0u; j < 10u; ++j) {
+        void* q = SlabAllocator::allocate(j * 50u + 1u, 8u);
+        memset(q, 0, j * 50u + 1u);
+        SlabAllocator::deallocate(q, 8u);
+      }
+    }
+  };
+  auto threads = Vec<std::thread>();
+  for (size_t t = 0u; t < 4u; ++t)
+    threads.push(std::thread(churn, std::ref(ptrs), t));
+  for (std::thread& t : threads.iter_mut()) t.join();
+
+  // Objects left by the exited threads are reused.
+  for (size_t i = 0u; i < kCount; ++i) {
+    void* p = SlabAllocator::allocate(i % 200u + 1u, 8u);
+    memset(p, 0, i % 200u + 1u);
+    SlabAllocator::deallocate(p, 8u);
+  }
+}
+
+// Objects which a thread allocated while it was exiting.
+std::set<void*> allocated_on_exit;
+
+struct UsesOnExit {
+  ~UsesOnExit() noexcept {
+    // Runs after the thread's cache has been flushed, as this was made before
+    // the thread first used the allocator.
+    for (void* p : ptrs) SlabAllocator::deallocate(p, 8u);
+    for (size_t i = 0u; i < 2000u; ++i)
+      allocated_on_exit.insert(SlabAllocator::allocate(48u, 8u));
+  }
+  void* ptrs[100] = {};
+};
+
+TEST(SlabAllocator, UseDuringThreadExit) {
+  auto t = std::thread([]() {
+    thread_local UsesOnExit holder;
+    for (void*& p : holder.ptrs) p = SlabAllocator::allocate(48u, 8u);
+  });
+  t.join();
+  EXPECT_EQ(allocated_on_exit.size(), 2000u);
+  // The objects handed over by the thread are not also still in use by it.
+  std::set<void*> seen;
+  for (size_t i = 0u; i < 10000u; ++i) {
+    void* p = SlabAllocator::allocate(48u, 8u);
+    EXPECT_TRUE(seen.insert(p).second);
+    EXPECT_FALSE(allocated_on_exit.contains(p));
+  }
+  for (void* p : seen) SlabAllocator::deallocate(p, 8u);
+  for (void* p : allocated_on_exit) SlabAllocator::deallocate(p, 8u);
+  allocated_on_exit.clear();
+}
+
+TEST(SlabAllocator, FreeOnOtherThread) {
+  // One thread allocates and another frees, over and over, with neither
+  // thread exiting. The freed objects must make their way back to the
+  // allocating thread, rather than piling up on the freeing thread.
+  constexpr size_t kRounds = 200u;
+  constexpr size_t kCount = 1000u;
+  std::mutex mutex;
+  std::condition_variable cv;
+  auto ptrs = Vec<void*>::with_capacity(kCount);
+  bool full = false;
+  bool done = false;
+  auto freer = std::thread([&]() {
+    while (true) {
+      auto lock = std::unique_lock(mutex);
+      cv.wait(lock, [&]() { return full || done; });
+      if (!full) return;
+      for (void* p : ptrs.iter()) SlabAllocator::deallocate(p, 8u);
+      ptrs.clear();
+      full = false;
+      cv.notify_all();
+    }
+  });
+
+  std::set<uintptr_t> spans;
+  for (size_t round = 0u; round < kRounds; ++round) {
+    auto lock = std::unique_lock(mutex);
+    cv.wait(lock, [&]() { return !full; });
+    for (size_t i = 0u; i < kCount; ++i) {
+      void* p = SlabAllocator::allocate(64u, 8u);
+      spans.insert(reinterpret_cast<uintptr_t>(p) / (64u * 1024u));
+      ptrs.push(p);
+    }
+    full = true;
+    cv.notify_all();
+  }
+  {
+    auto lock = std::unique_lock(mutex);
+    cv.wait(lock, [&]() { return !full; });
+    done = true;
+    cv.notify_all();
+  }
+  freer.join();
+  // Each round's objects would fill a span, so without reuse there would be
+  // a new span for nearly every round.
+  EXPECT_LT(spans.size(), 10u);
+}
+
+}  // namespace
@@ -0,0 +1,267 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <compare>
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/never_value.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/num/integer_concepts.h"
+#include "subspace/num/signed_integer.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/option/option.h"
+
+namespace sus::num {
+
+/// An integer of type `T` that is known not to be zero.
+///
+/// Zero is used as the never-value of the `NonZero`, so an `Option` of a
+/// `NonZero` is the same size as the integer, and `None` is represented by
+/// zero. For example, `Option<NonZeroU32>` is 4 bytes, where `Option<u32>`
+/// needs a separate flag.
+///
+/// Arithmetic methods are provided only where the non-zero-ness of the result
+/// can be preserved, otherwise the value can be retrieved with `get()`.
+///
+/// The NonZero type is trivially copyable and moveable.
+template <Integer T>
+class [[sus_trivial_abi]] NonZero final {
+ public:
+  /// Constructs a `NonZero` if `value` is not zero, or returns `None`.
+  static constexpr inline Option<NonZero> with(T value) noexcept {
+    if (value != T()) [[likely]]
+      return Option<NonZero>::some(NonZero(value));
+    else
+      return Option<NonZero>::none();
+  }
+
+  /// Constructs a `NonZero` without checking that `value` is not zero.
+  ///
+  /// # Safety
+  /// The `value` must not be zero, or Undefined Behaviour results.
+  static constexpr inline NonZero with_unchecked(
+      ::sus::marker::UnsafeFnMarker, T value) noexcept {
+    return NonZero(value);
+  }
+
+  /// sus::construct::From<NonZero<T>, T> trait.
+  ///
+  /// # Panics
+  /// The method will panic if `value` is zero.
+  static constexpr inline NonZero from(T value) noexcept {
+    check(value != T());
+    return NonZero(value);
+  }
+
+  /// NonZero<T> is copyable, so this is the copy constructor.
+  constexpr NonZero(const NonZero&) = default;
+  /// NonZero<T> is copyable, so this is the copy assignment operator.
+  constexpr NonZero& operator=(const NonZero&) = default;
+
+  /// Returns the value as the integer type `T`.
+  constexpr inline T get() const& noexcept { return value_; }
+
+  /// Returns the number of leading zeros in the binary representation of the
+  /// value.
+  constexpr inline u32 leading_zeros() const& noexcept {
+    return value_.leading_zeros();
+  }
+
+  /// Returns the number of trailing zeros in the binary representation of the
+  /// value.
+  constexpr inline u32 trailing_zeros() const& noexcept {
+    return value_.trailing_zeros();
+  }
+
+  /// Multiplies two non-zero integers together, returning `None` on overflow.
+  constexpr Option<NonZero> checked_mul(const NonZero& rhs) const& noexcept {
+    return from_checked(value_.checked_mul(rhs.value_));
+  }
+
+  /// Multiplies two non-zero integers together, saturating at the numeric
+  /// bounds instead of overflowing.
+  constexpr NonZero saturating_mul(const NonZero& rhs) const& noexcept {
+    return NonZero(value_.saturating_mul(rhs.value_));
+  }
+
+  /// Raises the value to the power of `exp`, returning `None` on overflow.
+  constexpr Option<NonZero> checked_pow(const u32& exp) const& noexcept {
+    return from_checked(value_.checked_pow(exp));
+  }
+
+  /// Adds an unsigned integer to the non-zero value, returning `None` on
+  /// overflow.
+  constexpr Option<NonZero> checked_add(const T& rhs) const& noexcept
+    requires(Unsigned<T>)
+  {
+    return from_checked(value_.checked_add(rhs));
+  }
+
+  /// Adds an unsigned integer to the non-zero value, saturating at `T::MAX`
+  /// instead of overflowing.
+  constexpr NonZero saturating_add(const T& rhs) const& noexcept
+    requires(Unsigned<T>)
+  {
+    return NonZero(value_.saturating_add(rhs));
+  }
+
+  /// Returns true if the value is a power of two.
+  constexpr bool is_power_of_two() const& noexcept
+    requires(Unsigned<T>)
+  {
+    return value_.count_ones() == 1u;
+  }
+
+  /// Returns the smallest power of two greater than or equal to the value, or
+  /// `None` if it would overflow.
+  constexpr Option<NonZero> checked_next_power_of_two() const& noexcept
+    requires(Unsigned<T>)
+  {
+    return from_checked(value_.checked_next_power_of_two());
+  }
+
+  /// Returns true if the value is negative.
+  constexpr bool is_negative() const& noexcept
+    requires(Signed<T>)
+  {
+    return value_.is_negative();
+  }
+
+  /// Returns true if the value is positive.
+  constexpr bool is_positive() const& noexcept
+    requires(Signed<T>)
+  {
+    return value_.is_positive();
+  }
+
+  /// Computes the absolute value, returning `None` if the value is `T::MIN`.
+  constexpr Option<NonZero> checked_abs() const& noexcept
+    requires(Signed<T>)
+  {
+    return from_checked(value_.checked_abs());
+  }
+
+  /// Computes the absolute value, wrapping to `T::MIN` if the value is
+  /// `T::MIN`.
+  constexpr NonZero wrapping_abs() const& noexcept
+    requires(Signed<T>)
+  {
+    return NonZero(value_.wrapping_abs());
+  }
+
+  /// Computes the absolute value, saturating to `T::MAX` if the value is
+  /// `T::MIN`.
+  constexpr NonZero saturating_abs() const& noexcept
+    requires(Signed<T>)
+  {
+    return NonZero(value_.saturating_abs());
+  }
+
+  /// Computes the absolute value as an unsigned integer, which can not
+  /// overflow.
+  constexpr auto unsigned_abs() const& noexcept
+    requires(Signed<T>)
+  {
+    using U = decltype(value_.unsigned_abs());
+    return NonZero<U>::with_unchecked(::sus::marker::unsafe_fn,
+                                      value_.unsigned_abs());
+  }
+
+  /// Negates the value, returning `None` if the value is `T::MIN`.
+  constexpr Option<NonZero> checked_neg() const& noexcept
+    requires(Signed<T>)
+  {
+    return from_checked(value_.checked_neg());
+  }
+
+  /// Negates the value, wrapping to `T::MIN` if the value is `T::MIN`.
+  constexpr NonZero wrapping_neg() const& noexcept
+    requires(Signed<T>)
+  {
+    return NonZero(value_.wrapping_neg());
+  }
+
+  /// Bitwise OR of two non-zero integers is non-zero.
+  friend constexpr inline NonZero operator|(const NonZero& l,
+                                            const NonZero& r) noexcept {
+    return NonZero(l.value_ | r.value_);
+  }
+  /// Bitwise OR of a non-zero integer with any integer is non-zero.
+  friend constexpr inline NonZero operator|(const NonZero& l,
+                                            const T& r) noexcept {
+    return NonZero(l.value_ | r);
+  }
+
+  /// sus::ops::Eq<NonZero<T>> trait.
+  friend constexpr inline bool operator==(const NonZero& l,
+                                          const NonZero& r) noexcept {
+    return l.value_ == r.value_;
+  }
+  /// sus::ops::Ord<NonZero<T>> trait.
+  friend constexpr inline std::strong_ordering operator<=>(
+      const NonZero& l, const NonZero& r) noexcept {
+    return l.value_ <=> r.value_;
+  }
+
+ private:
+  explicit constexpr inline NonZero(T value) noexcept : value_(value) {}
+
+  // Converts the result of a checked operation on non-zero values, which is
+  // non-zero if it is present.
+  static constexpr inline Option<NonZero> from_checked(Option<T> o) noexcept {
+    if (o.is_some()) [[likely]]
+      return Option<NonZero>::some(NonZero(
+          ::sus::move(o).unwrap_unchecked(::sus::marker::unsafe_fn)));
+    else
+      return Option<NonZero>::none();
+  }
+
+  T value_;
+
+  // Declare that this type can always be trivially relocated for library
+  // optimizations.
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(value_));
+  // Declare that the `value_` field is never set to zero for library
+  // optimizations.
+  sus_class_never_value_field(::sus::marker::unsafe_fn, NonZero, value_, T(),
+                              T());
+  constexpr NonZero() = default;  // For the NeverValueField.
+};
+
+/// A `u8` that is known not to be zero.
+using NonZeroU8 = NonZero<u8>;
+/// A `u16` that is known not to be zero.
+using NonZeroU16 = NonZero<u16>;
+/// A `u32` that is known not to be zero.
+using NonZeroU32 = NonZero<u32>;
+/// A `u64` that is known not to be zero.
+using NonZeroU64 = NonZero<u64>;
+/// A `usize` that is known not to be zero.
+using NonZeroUsize = NonZero<usize>;
+/// An `i8` that is known not to be zero.
+using NonZeroI8 = NonZero<i8>;
+/// An `i16` that is known not to be zero.
+using NonZeroI16 = NonZero<i16>;
+/// An `i32` that is known not to be zero.
+using NonZeroI32 = NonZero<i32>;
+/// An `i64` that is known not to be zero.
+using NonZeroI64 = NonZero<i64>;
+/// An `isize` that is known not to be zero.
+using NonZeroIsize = NonZero<isize>;
+
+}  // namespace sus::num
@@ -0,0 +1,180 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/num/nonzero.h"
+
+#include <type_traits>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/mem/never_value.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/ops/eq.h"
+#include "subspace/ops/ord.h"
+#include "subspace/option/option.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::Option;
+using sus::num::NonZero;
+using sus::num::NonZeroI16;
+using sus::num::NonZeroI32;
+using sus::num::NonZeroI64;
+using sus::num::NonZeroI8;
+using sus::num::NonZeroIsize;
+using sus::num::NonZeroU16;
+using sus::num::NonZeroU32;
+using sus::num::NonZeroU64;
+using sus::num::NonZeroU8;
+using sus::num::NonZeroUsize;
+
+static_assert(sizeof(NonZeroU32) == sizeof(u32));
+static_assert(std::is_trivially_copyable_v<NonZeroU32>);
+static_assert(sus::mem::relocate_by_memcpy<NonZeroU32>);
+static_assert(sus::mem::NeverValueField<NonZeroU32>);
+static_assert(sus::ops::Eq<NonZeroU32>);
+static_assert(sus::ops::Ord<NonZeroU32>);
+
+// The Option uses zero to represent None.
+static_assert(sizeof(Option<NonZeroU8>) == 1u);
+static_assert(sizeof(Option<NonZeroU16>) == 2u);
+static_assert(sizeof(Option<NonZeroU32>) == 4u);
+static_assert(sizeof(Option<NonZeroU64>) == 8u);
+static_assert(sizeof(Option<NonZeroUsize>) == sizeof(usize));
+static_assert(sizeof(Option<NonZeroI8>) == 1u);
+static_assert(sizeof(Option<NonZeroI16>) == 2u);
+static_assert(sizeof(Option<NonZeroI32>) == 4u);
+static_assert(sizeof(Option<NonZeroI64>) == 8u);
+static_assert(sizeof(Option<NonZeroIsize>) == sizeof(isize));
+// Where the same Option of a plain integer needs a flag.
+static_assert(sizeof(Option<u32>) > 4u);
+
+TEST(NonZero, With) {
+  auto a = NonZeroU32::with(3u);
+  EXPECT_EQ(sus::move(a).unwrap().get(), 3u);
+  EXPECT_EQ(NonZeroU32::with(0u).is_none(), true);
+  EXPECT_EQ(NonZeroI32::with(-3).unwrap().get(), -3);
+  EXPECT_EQ(NonZeroI32::with(0).is_none(), true);
+
+  static_assert(NonZeroU32::with(5u).unwrap().get() == 5u);
+
+  auto u = NonZeroU64::with_unchecked(unsafe_fn, 9u);
+  EXPECT_EQ(u.get(), 9u);
+}
+
+TEST(NonZero, From) {
+  static_assert(sus::construct::From<NonZeroU32, u32>);
+  EXPECT_EQ(NonZeroU32::from(7u).get(), 7u);
+}
+
+TEST(NonZeroDeathTest, FromZero) {
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH(
+      {
+        auto n = NonZeroU32::from(0u);
+        EXPECT_EQ(n.get(), 0u);
+      },
+      "");
+#endif
+}
+
+TEST(NonZero, OptionNiche) {
+  auto o = Option<NonZeroU32>::some(NonZeroU32::from(4u));
+  EXPECT_EQ(o.as_ref().unwrap().get(), 4u);
+  o = Option<NonZeroU32>::none();
+  EXPECT_EQ(o.is_none(), true);
+  o.insert(NonZeroU32::from(5u));
+  EXPECT_EQ(o.as_ref().unwrap().get(), 5u);
+
+  auto v = sus::Vec<Option<NonZeroU32>>();
+  v.push(Option<NonZeroU32>::some(NonZeroU32::from(1u)));
+  v.push(Option<NonZeroU32>::none());
+  EXPECT_EQ(v[0u].as_ref().unwrap().get(), 1u);
+  EXPECT_EQ(v[1u].is_none(), true);
+}
+
+TEST(NonZero, Eq) {
+  EXPECT_EQ(NonZeroU32::from(2u), NonZeroU32::from(2u));
+  EXPECT_NE(NonZeroU32::from(2u), NonZeroU32::from(3u));
+  EXPECT_LT(NonZeroI32::from(-2), NonZeroI32::from(3));
+  EXPECT_GT(NonZeroU32::from(4u), NonZeroU32::from(3u));
+}
+
+TEST(NonZero, Bits) {
+  EXPECT_EQ(NonZeroU32::from(1u).leading_zeros(), 31u);
+  EXPECT_EQ(NonZeroU32::from(8u).trailing_zeros(), 3u);
+  EXPECT_EQ(NonZeroU32::from(8u).is_power_of_two(), true);
+  EXPECT_EQ(NonZeroU32::from(6u).is_power_of_two(), false);
+  EXPECT_EQ((NonZeroU32::from(4u) | NonZeroU32::from(1u)).get(), 5u);
+  EXPECT_EQ((NonZeroU32::from(4u) | 0_u32).get(), 4u);
+}
+
+TEST(NonZero, UnsignedArithmetic) {
+  EXPECT_EQ(NonZeroU8::from(200_u8).checked_add(55_u8).unwrap().get(), 255u);
+  EXPECT_EQ(NonZeroU8::from(200_u8).checked_add(56_u8).is_none(), true);
+  EXPECT_EQ(NonZeroU8::from(200_u8).saturating_add(100_u8).get(), 255u);
+
+  EXPECT_EQ(NonZeroU8::from(15_u8).checked_mul(NonZeroU8::from(17_u8))
+                .unwrap()
+                .get(),
+            255u);
+  EXPECT_EQ(
+      NonZeroU8::from(16_u8).checked_mul(NonZeroU8::from(16_u8)).is_none(),
+      true);
+  EXPECT_EQ(
+      NonZeroU8::from(16_u8).saturating_mul(NonZeroU8::from(16_u8)).get(),
+      255u);
+
+  EXPECT_EQ(NonZeroU32::from(2u).checked_pow(10u).unwrap().get(), 1024u);
+  EXPECT_EQ(NonZeroU32::from(2u).checked_pow(32u).is_none(), true);
+
+  EXPECT_EQ(NonZeroU32::from(5u).checked_next_power_of_two().unwrap().get(),
+            8u);
+  EXPECT_EQ(NonZeroU8::from(129_u8).checked_next_power_of_two().is_none(),
+            true);
+}
+
+TEST(NonZero, SignedArithmetic) {
+  EXPECT_EQ(NonZeroI32::from(-2).is_negative(), true);
+  EXPECT_EQ(NonZeroI32::from(-2).is_positive(), false);
+  EXPECT_EQ(NonZeroI32::from(2).is_positive(), true);
+
+  EXPECT_EQ(NonZeroI8::from(-5_i8).checked_abs().unwrap().get(), 5);
+  EXPECT_EQ(NonZeroI8::from(i8::MIN).checked_abs().is_none(), true);
+  EXPECT_EQ(NonZeroI8::from(i8::MIN).wrapping_abs().get(), i8::MIN);
+  EXPECT_EQ(NonZeroI8::from(i8::MIN).saturating_abs().get(), i8::MAX);
+
+  auto u = NonZeroI8::from(i8::MIN).unsigned_abs();
+  static_assert(std::same_as<decltype(u), NonZeroU8>);
+  EXPECT_EQ(u.get(), 128u);
+
+  EXPECT_EQ(NonZeroI8::from(5_i8).checked_neg().unwrap().get(), -5);
+  EXPECT_EQ(NonZeroI8::from(i8::MIN).checked_neg().is_none(), true);
+  EXPECT_EQ(NonZeroI8::from(i8::MIN).wrapping_neg().get(), i8::MIN);
+
+  EXPECT_EQ(NonZeroI8::from(-2_i8).checked_mul(NonZeroI8::from(64_i8))
+                .unwrap()
+                .get(),
+            i8::MIN);
+  EXPECT_EQ(
+      NonZeroI8::from(2_i8).checked_mul(NonZeroI8::from(64_i8)).is_none(),
+      true);
+  EXPECT_EQ(
+      NonZeroI8::from(-2_i8).saturating_mul(NonZeroI8::from(127_i8)).get(),
+      i8::MIN);
+  EXPECT_EQ(NonZeroI32::from(-3).checked_pow(3u).unwrap().get(), -27);
+}
+
+}  // namespace
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "subspace/macros/always_inline.h"
 #include "subspace/marker/unsafe.h"
 #include "subspace/mem/addressof.h"
@@ -235,14 +237,18 @@ struct Storage<T, true> final {
   [[nodiscard]] constexpr inline T take_and_set_none() noexcept {
     auto t = T(::sus::move(access_.as_inner_mut()));
     access_.~NeverValueAccess();
-    access_ = NeverValueAccess();
+    // The object was destroyed, so it is constructed again rather than
+    // assigned to.
+    std::construct_at(&access_);
     access_.set_never_value(::sus::marker::unsafe_fn);
     return t;
   }
 
   constexpr inline void set_none() noexcept {
     access_.~NeverValueAccess();
-    access_ = NeverValueAccess();
+    // The object was destroyed, so it is constructed again rather than
+    // assigned to.
+    std::construct_at(&access_);
     access_.set_never_value(::sus::marker::unsafe_fn);
   }
 
@@ -0,0 +1,312 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <source_location>
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/alloc.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/never_value.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/ops/eq.h"
+#include "subspace/option/option.h"
+
+namespace sus::rc {
+
+namespace __private {
+
+/// The single heap allocation behind an `Rc<T>`, which holds the reference
+/// counts and the value together.
+template <class T>
+struct RcBox final {
+  constexpr RcBox(T&& t) noexcept : value(::sus::move(t)) {}
+  // The value is destroyed explicitly when the strong count reaches zero.
+  constexpr ~RcBox() noexcept {}
+
+  // The number of `Rc` pointing to the value.
+  size_t strong = 1u;
+  // The number of `Weak` pointing to the allocation, plus one which is held
+  // collectively by all of the `Rc`. The allocation is freed when this
+  // reaches zero.
+  size_t weak = 1u;
+  union {
+    T value;
+  };
+};
+
+}  // namespace __private
+
+template <class T>
+class Weak;
+
+/// A single-threaded reference-counting pointer.
+///
+/// An `Rc` provides shared ownership of a value of type `T`, allocated on the
+/// heap. The reference counts and the value are placed in a single heap
+/// allocation. Calling `clone()` on an `Rc` produces a new `Rc` pointing to the
+/// same allocation, and the value is destroyed when the last `Rc` is
+/// destroyed.
+///
+/// Shared references do not allow mutation, so an `Rc` only gives const access
+/// to the value, unless it is the only reference (see `get_mut()`).
+///
+/// A `Weak` pointer can be made from an `Rc` with `downgrade()`, which does not
+/// keep the value alive, but can be upgraded back to an `Rc` while it is.
+///
+/// The reference counts are not atomic, so an `Rc` must not be shared between
+/// threads. Use `sus::sync::Arc` for that.
+///
+/// `Rc` is trivially relocatable, and it has a never-value field, so an
+/// `Option<Rc<T>>` is the same size as a pointer.
+template <class T>
+class [[sus_trivial_abi]] Rc final {
+  static_assert(!std::is_reference_v<T>, "Rc<T&> is not a valid type.");
+  static_assert(!std::is_const_v<T>,
+                "`Rc<const T>` should be written `Rc<T>`, as an Rc only gives "
+                "const access to the value.");
+
+ public:
+  /// Constructs an `Rc<T>` by moving `t` into a new heap allocation.
+  static Rc with(T t, const std::source_location location =
+                          std::source_location::current()) noexcept
+    requires(::sus::mem::Move<T>)
+  {
+    using RcBox = __private::RcBox<T>;
+    void* p = ::sus::mem::allocate(sizeof(RcBox), alignof(RcBox), location);
+    return Rc(*new (p) RcBox(::sus::move(t)));
+  }
+
+  /// sus::construct::From<Rc<T>, T> trait.
+  static Rc from(T t, const std::source_location location =
+                          std::source_location::current()) noexcept
+    requires(::sus::mem::Move<T>)
+  {
+    return with(::sus::move(t), location);
+  }
+
+  ~Rc() {
+    // The `box_` is null when being destroyed from the never-value state.
+    if (box_ != nullptr && !is_moved_from()) release();
+  }
+
+  Rc(Rc&& o) noexcept
+      : box_(::sus::mem::replace_ptr(mref(o.box_), moved_from_value())) {
+    check(!is_moved_from());
+  }
+  Rc& operator=(Rc&& o) noexcept {
+    if (&o == this) return *this;
+    check(!o.is_moved_from());
+    if (!is_moved_from()) release();
+    box_ = ::sus::mem::replace_ptr(mref(o.box_), moved_from_value());
+    return *this;
+  }
+
+  /// Makes another `Rc` pointing to the same allocation, increasing the strong
+  /// reference count.
+  ///
+  /// sus::mem::Clone trait.
+  Rc clone() const& noexcept {
+    check(!is_moved_from());
+    box_->strong += 1u;
+    return Rc(*box_);
+  }
+
+  /// Returns a const reference to the shared value.
+  const T& as_ref() const& noexcept {
+    check(!is_moved_from());
+    return box_->value;
+  }
+  const T& as_ref() && = delete;
+
+  const T& operator*() const& noexcept { return as_ref(); }
+  const T& operator*() && = delete;
+
+  const T* operator->() const& noexcept { return &as_ref(); }
+  const T* operator->() && = delete;
+
+  /// Returns a mutable reference to the value, if there are no other `Rc` or
+  /// `Weak` pointers to the same allocation. Otherwise returns `None`, as it is
+  /// not safe to mutate a shared value.
+  Option<T&> get_mut() & noexcept {
+    check(!is_moved_from());
+    if (box_->strong == 1u && box_->weak == 1u)
+      return Option<T&>::some(mref(box_->value));
+    return Option<T&>::none();
+  }
+
+  /// Consumes the `Rc` and returns the inner value, if this was the only `Rc`
+  /// pointing to it. Otherwise returns `None`, and the value is left for the
+  /// other `Rc` pointers.
+  Option<T> into_inner() && noexcept {
+    check(!is_moved_from());
+    auto* box = ::sus::mem::replace_ptr(mref(box_), moved_from_value());
+    box->strong -= 1u;
+    if (box->strong != 0u) return Option<T>::none();
+    auto o = Option<T>::some(::sus::move(box->value));
+    box->value.~T();
+    release_weak(*box);
+    return o;
+  }
+
+  /// Makes a new `Weak` pointer to the allocation.
+  Weak<T> downgrade() const& noexcept {
+    check(!is_moved_from());
+    box_->weak += 1u;
+    return Weak<T>(*box_);
+  }
+
+  /// Returns the number of `Rc` pointers to the allocation.
+  usize strong_count() const& noexcept {
+    check(!is_moved_from());
+    return box_->strong;
+  }
+
+  /// Returns the number of `Weak` pointers to the allocation.
+  usize weak_count() const& noexcept {
+    check(!is_moved_from());
+    return box_->weak - 1u;
+  }
+
+  /// Returns true if the two `Rc` point to the same allocation.
+  bool ptr_eq(const Rc& other) const& noexcept {
+    check(!is_moved_from());
+    return box_ == other.box_;
+  }
+
+  /// sus::ops::Eq<Rc<T>, Rc<U>> trait.
+  template <class U>
+    requires(::sus::ops::Eq<T, U>)
+  friend bool operator==(const Rc& l, const Rc<U>& r) noexcept {
+    return l.as_ref() == r.as_ref();
+  }
+
+ private:
+  friend class Weak<T>;
+
+  explicit Rc(__private::RcBox<T>& box) noexcept : box_(&box) {}
+
+  void release() noexcept {
+    box_->strong -= 1u;
+    if (box_->strong == 0u) {
+      box_->value.~T();
+      release_weak(*box_);
+    }
+  }
+  static void release_weak(__private::RcBox<T>& box) noexcept {
+    box.weak -= 1u;
+    if (box.weak == 0u) {
+      box.~RcBox();
+      ::sus::mem::deallocate(&box, alignof(__private::RcBox<T>));
+    }
+  }
+
+  constexpr inline bool is_moved_from() const noexcept {
+    return box_ == moved_from_value();
+  }
+  // The value used in `box_` to indicate moved-from. It is not null, so that
+  // a moved-from Rc is not mistaken for the never-value.
+  static __private::RcBox<T>* moved_from_value() noexcept {
+    return reinterpret_cast<__private::RcBox<T>*>(
+        uintptr_t{alignof(__private::RcBox<T>)});
+  }
+
+  __private::RcBox<T>* box_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(box_));
+  // The `box_` is never null in public usage.
+  sus_class_never_value_field(::sus::marker::unsafe_fn, Rc, box_, nullptr,
+                              nullptr);
+  constexpr Rc() : box_(nullptr) {}  // For the NeverValueField.
+};
+
+/// A non-owning pointer to the allocation of an `Rc<T>`.
+///
+/// A `Weak` does not keep the value alive, but it does keep the allocation
+/// alive. The value can be accessed by converting the `Weak` back to an `Rc`
+/// with `upgrade()`, which fails if the value has already been destroyed.
+template <class T>
+class [[sus_trivial_abi]] Weak final {
+ public:
+  ~Weak() {
+    if (!is_moved_from()) Rc<T>::release_weak(*box_);
+  }
+
+  Weak(Weak&& o) noexcept
+      : box_(::sus::mem::replace_ptr(mref(o.box_), moved_from_value())) {
+    check(!is_moved_from());
+  }
+  Weak& operator=(Weak&& o) noexcept {
+    if (&o == this) return *this;
+    check(!o.is_moved_from());
+    if (!is_moved_from()) Rc<T>::release_weak(*box_);
+    box_ = ::sus::mem::replace_ptr(mref(o.box_), moved_from_value());
+    return *this;
+  }
+
+  /// Makes another `Weak` pointing to the same allocation.
+  ///
+  /// sus::mem::Clone trait.
+  Weak clone() const& noexcept {
+    check(!is_moved_from());
+    box_->weak += 1u;
+    return Weak(*box_);
+  }
+
+  /// Attempts to make an `Rc` pointing to the value. Returns `None` if the
+  /// value has already been destroyed.
+  Option<Rc<T>> upgrade() const& noexcept {
+    check(!is_moved_from());
+    if (box_->strong == 0u) return Option<Rc<T>>::none();
+    box_->strong += 1u;
+    return Option<Rc<T>>::some(Rc<T>(*box_));
+  }
+
+  /// Returns the number of `Rc` pointers to the allocation.
+  usize strong_count() const& noexcept {
+    check(!is_moved_from());
+    return box_->strong;
+  }
+
+ private:
+  friend class Rc<T>;
+
+  explicit Weak(__private::RcBox<T>& box) noexcept : box_(&box) {}
+
+  constexpr inline bool is_moved_from() const noexcept {
+    return box_ == moved_from_value();
+  }
+  static __private::RcBox<T>* moved_from_value() noexcept {
+    return Rc<T>::moved_from_value();
+  }
+
+  __private::RcBox<T>* box_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(box_));
+};
+
+}  // namespace sus::rc
+
+// Promote Rc into the `sus` namespace.
+namespace sus {
+using ::sus::rc::Rc;
+}  // namespace sus
@@ -0,0 +1,136 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "subspace/rc/rc.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/size_of.h"
+#include "subspace/option/option.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::rc::Rc;
+
+static_assert(sus::mem::relocate_by_memcpy<Rc<i32>>);
+static_assert(sus::mem::relocate_by_memcpy<sus::rc::Weak<i32>>);
+// The never-value field makes Option<Rc<T>> the same size as a pointer.
+static_assert(sus::mem::size_of<sus::Option<Rc<i32>>>() == sizeof(void*));
+
+struct Counted {
+  Counted(i32& destroyed) : destroyed(destroyed) {}
+  Counted(Counted&& o) : destroyed(o.destroyed), moved(o.moved) {
+    o.moved = true;
+  }
+  ~Counted() {
+    if (!moved) destroyed += 1;
+  }
+
+  i32& destroyed;
+  bool moved = false;
+};
+
+TEST(Rc, With) {
+  auto r = Rc<i32>::with(3);
+  EXPECT_EQ(*r, 3);
+  EXPECT_EQ(r.as_ref(), 3);
+  EXPECT_EQ(r.strong_count(), 1u);
+  EXPECT_EQ(r.weak_count(), 0u);
+}
+
+TEST(Rc, Clone) {
+  i32 destroyed;
+  {
+    auto r = Rc<Counted>::with(Counted(destroyed));
+    {
+      auto s = sus::clone(r);
+      EXPECT_TRUE(r.ptr_eq(s));
+      EXPECT_EQ(r.strong_count(), 2u);
+      EXPECT_EQ(s.strong_count(), 2u);
+    }
+    EXPECT_EQ(destroyed, 0);
+    EXPECT_EQ(r.strong_count(), 1u);
+  }
+  EXPECT_EQ(destroyed, 1);
+}
+
+TEST(Rc, Move) {
+  auto r = Rc<i32>::with(3);
+  auto s = sus::move(r);
+  EXPECT_EQ(*s, 3);
+  r = Rc<i32>::with(4);
+  s = sus::move(r);
+  EXPECT_EQ(*s, 4);
+  EXPECT_EQ(s.strong_count(), 1u);
+
+  // Moving into itself does nothing.
+  auto& self = s;
+  s = sus::move(self);
+  EXPECT_EQ(*s, 4);
+  EXPECT_EQ(s.strong_count(), 1u);
+}
+
+TEST(Rc, GetMut) {
+  auto r = Rc<i32>::with(3);
+  r.get_mut().unwrap() = 4;
+  EXPECT_EQ(*r, 4);
+  {
+    auto s = r.clone();
+    EXPECT_TRUE(r.get_mut().is_none());
+  }
+  {
+    auto w = r.downgrade();
+    EXPECT_TRUE(r.get_mut().is_none());
+  }
+  EXPECT_TRUE(r.get_mut().is_some());
+}
+
+TEST(Rc, IntoInner) {
+  auto r = Rc<i32>::with(3);
+  auto s = r.clone();
+  EXPECT_TRUE(sus::move(r).into_inner().is_none());
+  EXPECT_EQ(s.strong_count(), 1u);
+  EXPECT_EQ(sus::move(s).into_inner().unwrap(), 3);
+}
+
+TEST(Rc, Weak) {
+  i32 destroyed;
+  auto r = Rc<Counted>::with(Counted(destroyed));
+  auto w = r.downgrade();
+  EXPECT_EQ(r.weak_count(), 1u);
+  EXPECT_EQ(w.strong_count(), 1u);
+  {
+    auto u = w.upgrade().unwrap();
+    EXPECT_TRUE(u.ptr_eq(r));
+    EXPECT_EQ(r.strong_count(), 2u);
+  }
+  auto w2 = w.clone();
+  EXPECT_EQ(r.weak_count(), 2u);
+
+  r = Rc<Counted>::with(Counted(destroyed));
+  EXPECT_EQ(destroyed, 1);
+  EXPECT_EQ(w.strong_count(), 0u);
+  EXPECT_TRUE(w.upgrade().is_none());
+  EXPECT_TRUE(w2.upgrade().is_none());
+}
+
+TEST(Rc, Eq) {
+  auto r = Rc<i32>::with(3);
+  auto s = Rc<i32>::with(3);
+  EXPECT_EQ(r, s);
+  EXPECT_FALSE(r.ptr_eq(s));
+  EXPECT_NE(r, Rc<i32>::with(4));
+}
+
+}  // namespace
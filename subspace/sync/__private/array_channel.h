@@ -0,0 +1,207 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+#include <bit>
+#include <new>
+
+#include "subspace/mem/move.h"
+#include "subspace/option/option.h"
+#include "subspace/sync/__private/futex.h"
+#include "subspace/sync/__private/wait_queue.h"
+#include "subspace/sync/cache_padded.h"
+
+namespace sus::sync::__private {
+
+/// A bounded multi-producer multi-consumer queue in a ring buffer, after
+/// Dmitry Vyukov's bounded MPMC queue, as used by crossbeam's array channel.
+///
+/// The head and tail are each an index into the buffer in the low bits, and a
+/// lap count in the high bits. Each slot holds a stamp, which is the tail at
+/// which the slot can next be written, or one more than the head at which it
+/// can next be read. A lap is longer than the capacity, so that a stamp
+/// which is one more than the last index can't be mistaken for the start of
+/// the next lap. The head and tail are on cache lines of their own, so
+/// that producers and consumers do not contend on them with each other.
+template <class T>
+class ArrayChannel final {
+ public:
+  explicit ArrayChannel(size_t cap) noexcept
+      : cap_(cap),
+        one_lap_(std::bit_ceil(cap + 1u)),
+        buffer_(new Slot[cap]) {
+    for (size_t i = 0u; i < cap; ++i)
+      buffer_[i].stamp.store(i, std::memory_order_relaxed);
+  }
+
+  ~ArrayChannel() noexcept {
+    const size_t head = head_->load(std::memory_order_relaxed);
+    const size_t tail = tail_->load(std::memory_order_relaxed);
+    const size_t hix = head & (one_lap_ - 1u);
+    const size_t tix = tail & (one_lap_ - 1u);
+    size_t len;
+    if (hix < tix)
+      len = tix - hix;
+    else if (hix > tix)
+      len = cap_ - hix + tix;
+    else if (head == tail)
+      len = 0u;
+    else
+      len = cap_;
+    for (size_t i = 0u; i < len; ++i) {
+      const size_t index = hix + i < cap_ ? hix + i : hix + i - cap_;
+      buffer_[index].value.~T();
+    }
+    delete[] buffer_;
+  }
+
+  ArrayChannel(const ArrayChannel&) = delete;
+  ArrayChannel& operator=(const ArrayChannel&) = delete;
+
+  size_t capacity() const noexcept { return cap_; }
+
+  /// Moves from `value` into the queue and returns true, or returns false
+  /// without touching `value` if the queue is full.
+  bool try_push(T& value) const noexcept {
+    size_t tail = tail_->load(std::memory_order_relaxed);
+    while (true) {
+      const size_t index = tail & (one_lap_ - 1u);
+      const size_t lap = tail & ~(one_lap_ - 1u);
+      Slot& slot = buffer_[index];
+      const size_t stamp = slot.stamp.load(std::memory_order_acquire);
+      if (tail == stamp) {
+        // The slot is empty and ready for this lap.
+        const size_t new_tail = index + 1u < cap_ ? tail + 1u : lap + one_lap_;
+        if (tail_->compare_exchange_weak(tail, new_tail,
+                                         std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+          new (&slot.value) T(::sus::move(value));
+          slot.stamp.store(tail + 1u, std::memory_order_release);
+          not_empty_.notify_one();
+          return true;
+        }
+      } else if (stamp + one_lap_ == tail + 1u) {
+        // The slot still holds the value from the previous lap, so the queue
+        // may be full.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const size_t head = head_->load(std::memory_order_relaxed);
+        if (head + one_lap_ == tail) return false;
+        spin_loop_hint();
+        tail = tail_->load(std::memory_order_relaxed);
+      } else {
+        // Another producer moved the tail past this slot.
+        spin_loop_hint();
+        tail = tail_->load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Moves a value out of the queue, or returns None if it is empty.
+  ::sus::Option<T> try_pop() const noexcept {
+    size_t head = head_->load(std::memory_order_relaxed);
+    while (true) {
+      const size_t index = head & (one_lap_ - 1u);
+      const size_t lap = head & ~(one_lap_ - 1u);
+      Slot& slot = buffer_[index];
+      const size_t stamp = slot.stamp.load(std::memory_order_acquire);
+      if (head + 1u == stamp) {
+        // The slot holds a value for this lap.
+        const size_t new_head = index + 1u < cap_ ? head + 1u : lap + one_lap_;
+        if (head_->compare_exchange_weak(head, new_head,
+                                         std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+          auto o = ::sus::Option<T>::some(::sus::move(slot.value));
+          slot.value.~T();
+          slot.stamp.store(head + one_lap_, std::memory_order_release);
+          not_full_.notify_one();
+          return o;
+        }
+      } else if (stamp == head) {
+        // The slot was not written yet in this lap, so the queue may be
+        // empty.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const size_t tail = tail_->load(std::memory_order_relaxed);
+        if (tail == head) return ::sus::Option<T>::none();
+        spin_loop_hint();
+        head = head_->load(std::memory_order_relaxed);
+      } else {
+        // Another consumer moved the head past this slot.
+        spin_loop_hint();
+        head = head_->load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool is_empty() const noexcept {
+    return head_->load(std::memory_order_seq_cst) ==
+           tail_->load(std::memory_order_seq_cst);
+  }
+  bool is_full() const noexcept {
+    return head_->load(std::memory_order_seq_cst) + one_lap_ ==
+           tail_->load(std::memory_order_seq_cst);
+  }
+
+  /// Blocks until the queue may not be empty, or the senders disconnect.
+  void wait_not_empty() const noexcept {
+    not_empty_.wait_until(
+        [this]() { return !is_empty() || senders_gone(); });
+  }
+  /// Blocks until the queue may not be full, or the receivers disconnect.
+  void wait_not_full() const noexcept {
+    not_full_.wait_until(
+        [this]() { return !is_full() || receivers_gone(); });
+  }
+
+  bool senders_gone() const noexcept {
+    return senders_gone_.load(std::memory_order_acquire);
+  }
+  bool receivers_gone() const noexcept {
+    return receivers_gone_.load(std::memory_order_acquire);
+  }
+  void disconnect_senders() const noexcept {
+    senders_gone_.store(true, std::memory_order_release);
+    not_empty_.notify_all();
+  }
+  void disconnect_receivers() const noexcept {
+    receivers_gone_.store(true, std::memory_order_release);
+    not_full_.notify_all();
+  }
+
+ private:
+  struct Slot {
+    Slot() noexcept {}
+    ~Slot() noexcept {}
+
+    std::atomic<size_t> stamp;
+    union {
+      T value;
+    };
+  };
+
+  mutable CachePadded<std::atomic<size_t>> head_;
+  mutable CachePadded<std::atomic<size_t>> tail_;
+  const size_t cap_;
+  const size_t one_lap_;
+  Slot* const buffer_;
+  WaitQueue not_empty_;
+  WaitQueue not_full_;
+  mutable std::atomic<bool> senders_gone_ = false;
+  mutable std::atomic<bool> receivers_gone_ = false;
+};
+
+}  // namespace sus::sync::__private
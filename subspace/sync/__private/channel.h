@@ -0,0 +1,114 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+
+#include "subspace/mem/forward.h"
+#include "subspace/option/option.h"
+
+namespace sus::sync::__private {
+
+/// The shared state of a channel, which is owned jointly by its senders and
+/// receivers.
+///
+/// Each side disconnects the channel when its last handle is dropped, and
+/// whichever side disconnects second frees the channel.
+template <class Chan>
+struct ChannelCounter final {
+  template <class... Args>
+  explicit ChannelCounter(Args&&... args) noexcept
+      : chan(::sus::forward<Args>(args)...) {}
+
+  std::atomic<size_t> senders = 1u;
+  std::atomic<size_t> receivers = 1u;
+  std::atomic<bool> destroy = false;
+  Chan chan;
+};
+
+template <class Chan>
+ChannelCounter<Chan>* acquire_sender(ChannelCounter<Chan>* c) noexcept {
+  c->senders.fetch_add(1u, std::memory_order_relaxed);
+  return c;
+}
+template <class Chan>
+ChannelCounter<Chan>* acquire_receiver(ChannelCounter<Chan>* c) noexcept {
+  c->receivers.fetch_add(1u, std::memory_order_relaxed);
+  return c;
+}
+
+template <class Chan>
+void release_sender(ChannelCounter<Chan>* c) noexcept {
+  if (c->senders.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+    c->chan.disconnect_senders();
+    if (c->destroy.exchange(true, std::memory_order_acq_rel)) delete c;
+  }
+}
+template <class Chan>
+void release_receiver(ChannelCounter<Chan>* c) noexcept {
+  if (c->receivers.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+    c->chan.disconnect_receivers();
+    if (c->destroy.exchange(true, std::memory_order_acq_rel)) delete c;
+  }
+}
+
+enum class ChannelStatus {
+  Ok,
+  Full,
+  Empty,
+  Disconnected,
+};
+
+/// Moves from `value` into the channel, and returns `Ok`. If the channel is
+/// full, it blocks when `block` is true, and returns `Full` otherwise. If the
+/// receivers are gone, it returns `Disconnected`. The `value` is only moved
+/// from when `Ok` is returned.
+template <class Chan, class T>
+ChannelStatus channel_send(const Chan& chan, T& value, bool block) noexcept {
+  while (true) {
+    if (chan.receivers_gone()) return ChannelStatus::Disconnected;
+    if (chan.try_push(value)) return ChannelStatus::Ok;
+    if (!block) return ChannelStatus::Full;
+    chan.wait_not_full();
+  }
+}
+
+/// Moves a value out of the channel, setting `status` to `Ok`. If the channel
+/// is empty, it blocks when `block` is true, and otherwise returns None with
+/// `status` set to `Empty`. If the channel is empty and the senders are gone,
+/// it returns None with `status` set to `Disconnected`.
+template <class Chan>
+auto channel_recv(const Chan& chan, ChannelStatus& status, bool block) noexcept
+    -> decltype(chan.try_pop()) {
+  status = ChannelStatus::Ok;
+  while (true) {
+    if (auto out = chan.try_pop(); out.is_some()) return out;
+    if (chan.senders_gone()) {
+      // Values sent before the senders disconnected are still received.
+      if (auto out = chan.try_pop(); out.is_some()) return out;
+      status = ChannelStatus::Disconnected;
+      return decltype(chan.try_pop())::none();
+    }
+    if (!block) {
+      status = ChannelStatus::Empty;
+      return decltype(chan.try_pop())::none();
+    }
+    chan.wait_not_empty();
+  }
+}
+
+}  // namespace sus::sync::__private
@@ -0,0 +1,97 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "subspace/iter/iterator_defn.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/option/option.h"
+
+namespace sus::sync::__private {
+
+/// An iterator which receives from a channel, blocking for each value, until
+/// the channel is disconnected.
+template <class Receiver, class ItemT>
+class [[nodiscard]] RecvIter final
+    : public ::sus::iter::IteratorImpl<RecvIter<Receiver, ItemT>, ItemT> {
+ public:
+  using Item = ItemT;
+
+  static RecvIter with(Receiver& receiver) noexcept {
+    return RecvIter(receiver);
+  }
+
+  ::sus::Option<Item> next() noexcept final { return receiver_->recv().ok(); }
+
+ private:
+  explicit RecvIter(Receiver& receiver) noexcept : receiver_(&receiver) {}
+
+  Receiver* receiver_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn,
+                                  decltype(receiver_));
+};
+
+/// An iterator which receives the values which are already in a channel,
+/// without blocking.
+template <class Receiver, class ItemT>
+class [[nodiscard]] TryRecvIter final
+    : public ::sus::iter::IteratorImpl<TryRecvIter<Receiver, ItemT>, ItemT> {
+ public:
+  using Item = ItemT;
+
+  static TryRecvIter with(Receiver& receiver) noexcept {
+    return TryRecvIter(receiver);
+  }
+
+  ::sus::Option<Item> next() noexcept final {
+    return receiver_->try_recv().ok();
+  }
+
+ private:
+  explicit TryRecvIter(Receiver& receiver) noexcept : receiver_(&receiver) {}
+
+  Receiver* receiver_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn,
+                                  decltype(receiver_));
+};
+
+/// An iterator which owns a receiver, and receives from it, blocking for each
+/// value, until the channel is disconnected.
+template <class Receiver, class ItemT>
+class [[nodiscard]] RecvIntoIter final
+    : public ::sus::iter::IteratorImpl<RecvIntoIter<Receiver, ItemT>, ItemT> {
+ public:
+  using Item = ItemT;
+
+  static RecvIntoIter with(Receiver&& receiver) noexcept {
+    return RecvIntoIter(::sus::move(receiver));
+  }
+
+  ::sus::Option<Item> next() noexcept final { return receiver_.recv().ok(); }
+
+ private:
+  explicit RecvIntoIter(Receiver&& receiver) noexcept
+      : receiver_(::sus::move(receiver)) {}
+
+  Receiver receiver_;
+
+  sus_class_trivially_relocatable_if_types(::sus::marker::unsafe_fn,
+                                           decltype(receiver_));
+};
+
+}  // namespace sus::sync::__private
@@ -0,0 +1,68 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/sync/__private/futex.h"
+
+#if defined(__linux__)
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace sus::sync::__private {
+
+#if defined(__linux__)
+
+void futex_wait(const std::atomic<uint32_t>& futex,
+                uint32_t expected) noexcept {
+  // Interruptions (EINTR) and a changed value (EAGAIN) both return to the
+  // caller, which checks the value again.
+  syscall(SYS_futex, &futex, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr,
+          0);
+}
+
+bool futex_wake(const std::atomic<uint32_t>& futex) noexcept {
+  return syscall(SYS_futex, &futex, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr,
+                 0) > 0;
+}
+
+void futex_wake_all(const std::atomic<uint32_t>& futex) noexcept {
+  syscall(SYS_futex, &futex, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr,
+          0);
+}
+
+#else
+
+// Elsewhere, the standard library's atomic wait is used, which is built on
+// the platform's equivalent of a futex where there is one.
+
+void futex_wait(const std::atomic<uint32_t>& futex,
+                uint32_t expected) noexcept {
+  futex.wait(expected, std::memory_order_relaxed);
+}
+
+bool futex_wake(const std::atomic<uint32_t>& futex) noexcept {
+  // There's no way to tell if a thread was woken.
+  const_cast<std::atomic<uint32_t>&>(futex).notify_one();
+  return true;
+}
+
+void futex_wake_all(const std::atomic<uint32_t>& futex) noexcept {
+  const_cast<std::atomic<uint32_t>&>(futex).notify_all();
+}
+
+#endif
+
+}  // namespace sus::sync::__private
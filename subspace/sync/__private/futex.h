@@ -0,0 +1,45 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+namespace sus::sync::__private {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+/// Blocks the calling thread while `futex` holds `expected`. May return
+/// spuriously, so the caller must check the value again.
+void futex_wait(const std::atomic<uint32_t>& futex, uint32_t expected) noexcept;
+
+/// Wakes one thread blocked in `futex_wait()` on `futex`. Returns whether a
+/// thread may have been woken; it is false only if no thread was waiting.
+bool futex_wake(const std::atomic<uint32_t>& futex) noexcept;
+
+/// Wakes all threads blocked in `futex_wait()` on `futex`.
+void futex_wake_all(const std::atomic<uint32_t>& futex) noexcept;
+
+/// Tells the CPU that the thread is spinning on a lock.
+inline void spin_loop_hint() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+}  // namespace sus::sync::__private
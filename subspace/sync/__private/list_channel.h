@@ -0,0 +1,198 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+#include <new>
+
+#include "subspace/mem/move.h"
+#include "subspace/option/option.h"
+#include "subspace/sync/__private/futex.h"
+#include "subspace/sync/__private/wait_queue.h"
+#include "subspace/sync/cache_padded.h"
+
+namespace sus::sync::__private {
+
+/// An unbounded multi-producer single-consumer queue in a linked list of
+/// blocks, after crossbeam's list channel.
+///
+/// Each block holds `BLOCK_CAP` slots. Producers claim a slot by advancing the
+/// tail index, and write their value into it afterward. The index counts one
+/// more position per block than there are slots: when a producer claims the
+/// last slot of a block it installs the next block, and moves the tail past
+/// that extra position, during which other producers wait.
+///
+/// The consumer's head is only touched by the single consumer, and the
+/// consumer frees each block once it has read all of its slots.
+template <class T>
+class ListChannel final {
+ public:
+  ListChannel() noexcept {
+    Block* const block = new Block();
+    head_->block = block;
+    tail_->block.store(block, std::memory_order_relaxed);
+  }
+
+  ~ListChannel() noexcept {
+    const size_t tail = tail_->index.load(std::memory_order_relaxed);
+    size_t head = head_->index;
+    Block* block = head_->block;
+    for (; head != tail; ++head) {
+      const size_t offset = head % LAP;
+      if (offset == BLOCK_CAP) {
+        Block* const next = block->next.load(std::memory_order_relaxed);
+        delete block;
+        block = next;
+      } else {
+        block->slots[offset].value.~T();
+      }
+    }
+    delete block;
+  }
+
+  ListChannel(const ListChannel&) = delete;
+  ListChannel& operator=(const ListChannel&) = delete;
+
+  /// Moves from `value` into the queue. Producers may call this concurrently.
+  ///
+  /// The queue is never full, so this always returns true.
+  bool try_push(T& value) const noexcept {
+    Block* next_block = nullptr;
+    size_t tail = tail_->index.load(std::memory_order_acquire);
+    while (true) {
+      const size_t offset = tail % LAP;
+      if (offset == BLOCK_CAP) {
+        // Another producer is installing the next block.
+        spin_loop_hint();
+        tail = tail_->index.load(std::memory_order_acquire);
+        continue;
+      }
+      Block* const block = tail_->block.load(std::memory_order_acquire);
+      // Allocate the next block before claiming the last slot, to keep the
+      // time other producers wait for it short.
+      if (offset + 1u == BLOCK_CAP && next_block == nullptr)
+        next_block = new Block();
+      if (tail_->index.compare_exchange_weak(tail, tail + 1u,
+                                             std::memory_order_seq_cst,
+                                             std::memory_order_acquire)) {
+        if (offset + 1u == BLOCK_CAP) {
+          tail_->block.store(next_block, std::memory_order_release);
+          tail_->index.fetch_add(1u, std::memory_order_release);
+          block->next.store(next_block, std::memory_order_release);
+          next_block = nullptr;
+        }
+        Slot& slot = block->slots[offset];
+        new (&slot.value) T(::sus::move(value));
+        slot.ready.store(true, std::memory_order_release);
+        break;
+      }
+    }
+    delete next_block;
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /// Moves a value out of the queue, or returns None if it is empty. Only the
+  /// single consumer may call this.
+  ::sus::Option<T> try_pop() const noexcept {
+    size_t offset = head_->index % LAP;
+    if (offset == BLOCK_CAP) {
+      // The last slot of the block was read, and the producer which claimed
+      // it installed the next block before writing it.
+      Block* const next = head_->block->next.load(std::memory_order_acquire);
+      delete head_->block;
+      head_->block = next;
+      head_->index += 1u;
+      offset = 0u;
+    }
+    if (head_->index == tail_->index.load(std::memory_order_seq_cst))
+      return ::sus::Option<T>::none();
+    // The slot is claimed, but its producer may not have written it yet.
+    Slot& slot = head_->block->slots[offset];
+    while (!slot.ready.load(std::memory_order_acquire)) spin_loop_hint();
+    auto o = ::sus::Option<T>::some(::sus::move(slot.value));
+    slot.value.~T();
+    head_->index += 1u;
+    return o;
+  }
+
+  bool is_empty() const noexcept {
+    // The positions past the end of each block never hold a value.
+    const size_t tail = tail_->index.load(std::memory_order_seq_cst);
+    return head_->index == tail ||
+           (head_->index + 1u == tail && head_->index % LAP == BLOCK_CAP);
+  }
+
+  /// Blocks until the queue may not be empty, or the senders disconnect.
+  void wait_not_empty() const noexcept {
+    not_empty_.wait_until(
+        [this]() { return !is_empty() || senders_gone(); });
+  }
+
+  /// The queue is never full, so there's nothing to wait for.
+  void wait_not_full() const noexcept {}
+
+  bool senders_gone() const noexcept {
+    return senders_gone_.load(std::memory_order_acquire);
+  }
+  bool receivers_gone() const noexcept {
+    return receivers_gone_.load(std::memory_order_acquire);
+  }
+  void disconnect_senders() const noexcept {
+    senders_gone_.store(true, std::memory_order_release);
+    not_empty_.notify_all();
+  }
+  void disconnect_receivers() const noexcept {
+    receivers_gone_.store(true, std::memory_order_release);
+  }
+
+ private:
+  static constexpr size_t BLOCK_CAP = 31u;
+  static constexpr size_t LAP = BLOCK_CAP + 1u;
+
+  struct Slot {
+    Slot() noexcept {}
+    ~Slot() noexcept {}
+
+    std::atomic<bool> ready = false;
+    union {
+      T value;
+    };
+  };
+
+  struct Block {
+    std::atomic<Block*> next = nullptr;
+    Slot slots[BLOCK_CAP];
+  };
+
+  struct Head {
+    size_t index = 0u;
+    Block* block = nullptr;
+  };
+  struct Tail {
+    std::atomic<size_t> index = 0u;
+    std::atomic<Block*> block = nullptr;
+  };
+
+  mutable CachePadded<Head> head_;
+  mutable CachePadded<Tail> tail_;
+  WaitQueue not_empty_;
+  mutable std::atomic<bool> senders_gone_ = false;
+  mutable std::atomic<bool> receivers_gone_ = false;
+};
+
+}  // namespace sus::sync::__private
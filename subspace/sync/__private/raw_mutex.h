@@ -0,0 +1,101 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "subspace/sync/__private/futex.h"
+
+namespace sus::sync::__private {
+
+/// A mutual exclusion lock in a single 32-bit futex word.
+///
+/// The state is 0 when unlocked, 1 when locked, and 2 when locked with other
+/// threads possibly waiting, as in "Futexes Are Tricky" (Drepper, 2011).
+/// Locking spins for a short while before parking the thread in the kernel,
+/// and unlocking only makes a syscall when a thread may be waiting.
+class RawMutex final {
+ public:
+  constexpr RawMutex() noexcept = default;
+
+  RawMutex(const RawMutex&) = delete;
+  RawMutex& operator=(const RawMutex&) = delete;
+
+  bool try_lock() const noexcept {
+    uint32_t unlocked = UNLOCKED;
+    return state_.compare_exchange_strong(unlocked, LOCKED,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed);
+  }
+
+  void lock() const noexcept {
+    if (!try_lock()) [[unlikely]]
+      lock_contended();
+  }
+
+  void unlock() const noexcept {
+    if (state_.exchange(UNLOCKED, std::memory_order_release) == CONTENDED)
+        [[unlikely]] {
+      // A thread may be parked. Wake one; the rest stay parked until it
+      // unlocks in turn, as it will set the state to CONTENDED.
+      futex_wake(state_);
+    }
+  }
+
+ private:
+  static constexpr uint32_t UNLOCKED = 0u;
+  static constexpr uint32_t LOCKED = 1u;
+  static constexpr uint32_t CONTENDED = 2u;
+
+  void lock_contended() const noexcept {
+    uint32_t state = spin();
+    if (state == UNLOCKED) {
+      if (state_.compare_exchange_strong(state, LOCKED,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+        return;
+      }
+    }
+    while (true) {
+      // Mark the lock as contended before parking, so that the thread which
+      // holds it wakes this one when it unlocks. This also takes the lock if
+      // it was unlocked, in which case it stays marked as contended, which
+      // may cost a spurious wake later but is never wrong.
+      if (state != CONTENDED &&
+          state_.exchange(CONTENDED, std::memory_order_acquire) == UNLOCKED) {
+        return;
+      }
+      futex_wait(state_, CONTENDED);
+      state = spin();
+    }
+  }
+
+  // Spins while the lock is held without any parked threads, for a short
+  // while, in the hope that it is unlocked soon.
+  uint32_t spin() const noexcept {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    for (int i = 0; state == LOCKED && i < 100; ++i) {
+      spin_loop_hint();
+      state = state_.load(std::memory_order_relaxed);
+    }
+    return state;
+  }
+
+  mutable std::atomic<uint32_t> state_ = UNLOCKED;
+};
+
+}  // namespace sus::sync::__private
@@ -0,0 +1,93 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "subspace/sync/__private/futex.h"
+
+namespace sus::sync::__private {
+
+/// Runs a function once, across all threads, in a single 32-bit futex word.
+///
+/// Checking whether it has run is a single acquire load. Threads which find
+/// the function running on another thread park until it completes.
+class RawOnce final {
+ public:
+  constexpr RawOnce() noexcept = default;
+
+  RawOnce(const RawOnce&) = delete;
+  RawOnce& operator=(const RawOnce&) = delete;
+
+  /// Returns true once a call to `call_once()` has completed. Everything done
+  /// by the function which ran is visible to the caller afterward.
+  bool is_completed() const noexcept {
+    return state_.load(std::memory_order_acquire) == COMPLETE;
+  }
+
+  /// Calls `f` if no call to `call_once()` has completed or is running,
+  /// otherwise waits for the running call to complete.
+  ///
+  /// Calling `call_once()` from inside `f` will deadlock.
+  template <class F>
+  void call_once(F& f) const noexcept {
+    uint32_t state = state_.load(std::memory_order_acquire);
+    while (true) {
+      switch (state) {
+        case COMPLETE: return;
+        case INCOMPLETE:
+          if (!state_.compare_exchange_weak(state, RUNNING,
+                                            std::memory_order_acquire,
+                                            std::memory_order_acquire)) {
+            continue;
+          }
+          f();
+          if (state_.exchange(COMPLETE, std::memory_order_release) == QUEUED)
+            futex_wake_all(state_);
+          return;
+        case RUNNING:
+          // Mark that a thread is waiting, so that the running thread wakes
+          // it when done.
+          if (!state_.compare_exchange_weak(state, QUEUED,
+                                            std::memory_order_acquire,
+                                            std::memory_order_acquire)) {
+            continue;
+          }
+          [[fallthrough]];
+        case QUEUED:
+          futex_wait(state_, QUEUED);
+          state = state_.load(std::memory_order_acquire);
+      }
+    }
+  }
+
+  /// Returns to the state before `call_once()` was called. The caller must
+  /// have exclusive access.
+  void reset() & noexcept {
+    state_.store(INCOMPLETE, std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint32_t INCOMPLETE = 0u;
+  static constexpr uint32_t RUNNING = 1u;
+  static constexpr uint32_t QUEUED = 2u;
+  static constexpr uint32_t COMPLETE = 3u;
+
+  mutable std::atomic<uint32_t> state_ = INCOMPLETE;
+};
+
+}  // namespace sus::sync::__private
@@ -0,0 +1,255 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "subspace/assertions/check.h"
+#include "subspace/sync/__private/futex.h"
+
+namespace sus::sync::__private {
+
+/// A reader-writer lock in two 32-bit futex words, following the futex
+/// `RwLock` of the Rust standard library.
+///
+/// The low 30 bits of `state_` count the readers, with all of them set when a
+/// writer holds the lock. The top two bits mark that readers or writers are
+/// parked. Readers park on `state_`, and writers park on `writer_notify_`,
+/// which is bumped whenever a writer is woken.
+///
+/// Waiting writers are preferred: new readers do not take the lock while a
+/// writer is waiting, so a stream of readers can not starve writers.
+class RawRwLock final {
+ public:
+  constexpr RawRwLock() noexcept = default;
+
+  RawRwLock(const RawRwLock&) = delete;
+  RawRwLock& operator=(const RawRwLock&) = delete;
+
+  bool try_read() const noexcept {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    while (is_read_lockable(state)) {
+      if (state_.compare_exchange_weak(state, state + READ_LOCKED,
+                                       std::memory_order_acquire,
+                                       std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void read() const noexcept {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    if (!is_read_lockable(state) ||
+        !state_.compare_exchange_weak(state, state + READ_LOCKED,
+                                      std::memory_order_acquire,
+                                      std::memory_order_relaxed))
+        [[unlikely]] {
+      read_contended();
+    }
+  }
+
+  void read_unlock() const noexcept {
+    const uint32_t state =
+        state_.fetch_sub(READ_LOCKED, std::memory_order_release) - READ_LOCKED;
+    // A reader can only be parked on a read-locked lock if a writer is also
+    // waiting, so readers only need to wake a writer.
+    if (is_unlocked(state) && has_writers_waiting(state)) [[unlikely]]
+      wake_writer_or_readers(state);
+  }
+
+  bool try_write() const noexcept {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    while (is_unlocked(state)) {
+      if (state_.compare_exchange_weak(state, state + WRITE_LOCKED,
+                                       std::memory_order_acquire,
+                                       std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void write() const noexcept {
+    uint32_t unlocked = 0u;
+    if (!state_.compare_exchange_weak(unlocked, WRITE_LOCKED,
+                                      std::memory_order_acquire,
+                                      std::memory_order_relaxed))
+        [[unlikely]] {
+      write_contended();
+    }
+  }
+
+  void write_unlock() const noexcept {
+    const uint32_t state =
+        state_.fetch_sub(WRITE_LOCKED, std::memory_order_release) -
+        WRITE_LOCKED;
+    if (has_writers_waiting(state) || has_readers_waiting(state)) [[unlikely]]
+      wake_writer_or_readers(state);
+  }
+
+ private:
+  static constexpr uint32_t READ_LOCKED = 1u;
+  static constexpr uint32_t MASK = (1u << 30u) - 1u;
+  static constexpr uint32_t WRITE_LOCKED = MASK;
+  static constexpr uint32_t MAX_READERS = MASK - 1u;
+  static constexpr uint32_t READERS_WAITING = 1u << 30u;
+  static constexpr uint32_t WRITERS_WAITING = 1u << 31u;
+
+  static constexpr bool is_unlocked(uint32_t state) noexcept {
+    return (state & MASK) == 0u;
+  }
+  static constexpr bool is_write_locked(uint32_t state) noexcept {
+    return (state & MASK) == WRITE_LOCKED;
+  }
+  static constexpr bool has_readers_waiting(uint32_t state) noexcept {
+    return (state & READERS_WAITING) != 0u;
+  }
+  static constexpr bool has_writers_waiting(uint32_t state) noexcept {
+    return (state & WRITERS_WAITING) != 0u;
+  }
+  static constexpr bool is_read_lockable(uint32_t state) noexcept {
+    // Readers do not jump ahead of waiting threads.
+    return (state & MASK) < MAX_READERS && !has_readers_waiting(state) &&
+           !has_writers_waiting(state);
+  }
+
+  void read_contended() const noexcept {
+    uint32_t state = spin_read();
+    while (true) {
+      if (is_read_lockable(state)) {
+        if (state_.compare_exchange_weak(state, state + READ_LOCKED,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+          return;
+        }
+        continue;
+      }
+      // Panics on too many readers, rather than overflowing into the bits
+      // which mark a writer.
+      check((state & MASK) != MAX_READERS);
+      // Mark that a reader is parked, so that it is woken on unlock.
+      if (!has_readers_waiting(state)) {
+        if (!state_.compare_exchange_weak(state, state | READERS_WAITING,
+                                          std::memory_order_relaxed,
+                                          std::memory_order_relaxed)) {
+          continue;
+        }
+      }
+      futex_wait(state_, state | READERS_WAITING);
+      state = spin_read();
+    }
+  }
+
+  void write_contended() const noexcept {
+    uint32_t state = spin_write();
+    // Once this writer has parked, other writers may be parked too, so the
+    // WRITERS_WAITING bit is kept when the lock is taken.
+    uint32_t other_writers_waiting = 0u;
+    while (true) {
+      if (is_unlocked(state)) {
+        if (state_.compare_exchange_weak(
+                state, state | WRITE_LOCKED | other_writers_waiting,
+                std::memory_order_acquire, std::memory_order_relaxed)) {
+          return;
+        }
+        continue;
+      }
+      if (!has_writers_waiting(state)) {
+        if (!state_.compare_exchange_weak(state, state | WRITERS_WAITING,
+                                          std::memory_order_relaxed,
+                                          std::memory_order_relaxed)) {
+          continue;
+        }
+      }
+      other_writers_waiting = WRITERS_WAITING;
+      // Read the notification counter before checking the state again, so a
+      // wake in between changes the counter and `futex_wait()` returns.
+      const uint32_t seq = writer_notify_.load(std::memory_order_acquire);
+      state = state_.load(std::memory_order_relaxed);
+      if (is_unlocked(state) || !has_writers_waiting(state)) continue;
+      futex_wait(writer_notify_, seq);
+      state = spin_write();
+    }
+  }
+
+  // Called on unlock, when the lock is unlocked and threads are waiting.
+  void wake_writer_or_readers(uint32_t state) const noexcept {
+    // Prefer waking a writer, and clear the bit for it. Writers which are
+    // still parked set it again before parking.
+    if (state == WRITERS_WAITING) {
+      if (state_.compare_exchange_strong(state, 0u, std::memory_order_relaxed,
+                                         std::memory_order_relaxed)) {
+        wake_writer();
+        return;
+      }
+    }
+    if (state == READERS_WAITING + WRITERS_WAITING) {
+      if (!state_.compare_exchange_strong(state, READERS_WAITING,
+                                          std::memory_order_relaxed,
+                                          std::memory_order_relaxed)) {
+        // Another thread took the lock, and it will wake the waiters when
+        // it unlocks.
+        return;
+      }
+      if (wake_writer()) return;
+      // No writer was parked, so wake the readers instead.
+      state = READERS_WAITING;
+    }
+    if (state == READERS_WAITING) {
+      if (state_.compare_exchange_strong(state, 0u, std::memory_order_relaxed,
+                                         std::memory_order_relaxed)) {
+        futex_wake_all(state_);
+      }
+    }
+  }
+
+  bool wake_writer() const noexcept {
+    writer_notify_.fetch_add(1u, std::memory_order_release);
+    return futex_wake(writer_notify_);
+  }
+
+  uint32_t spin_read() const noexcept {
+    // Stop spinning when the lock is no longer write-locked, or when threads
+    // are parked, as the lock will not become read-lockable without them.
+    return spin_until([](uint32_t state) {
+      return !is_write_locked(state) || has_readers_waiting(state) ||
+             has_writers_waiting(state);
+    });
+  }
+
+  uint32_t spin_write() const noexcept {
+    return spin_until([](uint32_t state) {
+      return is_unlocked(state) || has_writers_waiting(state);
+    });
+  }
+
+  template <class F>
+  uint32_t spin_until(F f) const noexcept {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    for (int i = 0; !f(state) && i < 100; ++i) {
+      spin_loop_hint();
+      state = state_.load(std::memory_order_relaxed);
+    }
+    return state;
+  }
+
+  mutable std::atomic<uint32_t> state_ = 0u;
+  mutable std::atomic<uint32_t> writer_notify_ = 0u;
+};
+
+}  // namespace sus::sync::__private
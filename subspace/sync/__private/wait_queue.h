@@ -0,0 +1,79 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "subspace/sync/__private/futex.h"
+
+namespace sus::sync::__private {
+
+/// A place for threads to park until a condition, which is changed by other
+/// threads without holding a lock, becomes true.
+///
+/// A thread which changes the condition calls `notify_one()` or
+/// `notify_all()` afterward. That costs a fence and a load when no thread is
+/// waiting, and only makes a syscall when one is.
+class WaitQueue final {
+ public:
+  constexpr WaitQueue() noexcept = default;
+
+  WaitQueue(const WaitQueue&) = delete;
+  WaitQueue& operator=(const WaitQueue&) = delete;
+
+  /// Blocks until `ready()` returns true. It spins for a short while before
+  /// parking the thread, and may return spuriously once it has parked, so the
+  /// caller must check its condition again.
+  template <class Ready>
+  void wait_until(const Ready& ready) const noexcept {
+    for (int i = 0; i < 100; ++i) {
+      if (ready()) return;
+      spin_loop_hint();
+    }
+    waiters_.fetch_add(1u, std::memory_order_seq_cst);
+    const uint32_t epoch = epoch_.load(std::memory_order_seq_cst);
+    // Pairs with the fence in `notify()`: either the condition is seen as
+    // ready here, or the notifying thread sees this thread as a waiter and
+    // changes the epoch, so the wait below can't miss the change.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!ready()) futex_wait(epoch_, epoch);
+    waiters_.fetch_sub(1u, std::memory_order_relaxed);
+  }
+
+  /// Wakes one parked thread, if any, after the condition has changed.
+  void notify_one() const noexcept {
+    if (notify()) futex_wake(epoch_);
+  }
+
+  /// Wakes all parked threads, if any, after the condition has changed.
+  void notify_all() const noexcept {
+    if (notify()) futex_wake_all(epoch_);
+  }
+
+ private:
+  bool notify() const noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) == 0u) return false;
+    epoch_.fetch_add(1u, std::memory_order_seq_cst);
+    return true;
+  }
+
+  mutable std::atomic<uint32_t> epoch_ = 0u;
+  mutable std::atomic<uint32_t> waiters_ = 0u;
+};
+
+}  // namespace sus::sync::__private
@@ -0,0 +1,373 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <source_location>
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/alloc.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/never_value.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/ops/eq.h"
+#include "subspace/option/option.h"
+#include "subspace/sync/__private/futex.h"
+
+namespace sus::sync {
+
+namespace __private {
+
+/// The value of `ArcInner::weak` while `Arc::get_mut()` has locked it.
+constexpr size_t kWeakLocked = SIZE_MAX;
+
+/// The single heap allocation behind an `Arc<T>`, which holds the atomic
+/// reference counts and the value together.
+template <class T>
+struct ArcInner final {
+  constexpr ArcInner(T&& t) noexcept : value(::sus::move(t)) {}
+  // The value is destroyed explicitly when the strong count reaches zero.
+  constexpr ~ArcInner() noexcept {}
+
+  // The number of `Arc` pointing to the value.
+  std::atomic<size_t> strong = 1u;
+  // The number of `Weak` pointing to the allocation, plus one which is held
+  // collectively by all of the `Arc`. The allocation is freed when this
+  // reaches zero. It is `kWeakLocked` while `Arc::get_mut()` checks whether
+  // the `Arc` is unique.
+  std::atomic<size_t> weak = 1u;
+  union {
+    T value;
+  };
+};
+
+}  // namespace __private
+
+template <class T>
+class Weak;
+
+/// A thread-safe reference-counting pointer. "Arc" stands for "Atomically
+/// Reference Counted".
+///
+/// An `Arc` provides shared ownership of a value of type `T`, allocated on the
+/// heap. The reference counts and the value are placed in a single heap
+/// allocation. Calling `clone()` on an `Arc` produces a new `Arc` pointing to
+/// the same allocation, and the value is destroyed when the last `Arc` is
+/// destroyed.
+///
+/// Shared references do not allow mutation, so an `Arc` only gives const
+/// access to the value, unless it is the only reference (see `get_mut()`).
+/// The value should provide its own synchronization for any mutation through
+/// a const reference.
+///
+/// A `Weak` pointer can be made from an `Arc` with `downgrade()`, which does
+/// not keep the value alive, but can be upgraded back to an `Arc` while it is.
+///
+/// Unlike `sus::rc::Rc`, the reference counts are atomic, so `Arc` pointers to
+/// the same allocation may be used and destroyed from different threads.
+///
+/// `Arc` is trivially relocatable, and it has a never-value field, so an
+/// `Option<Arc<T>>` is the same size as a pointer.
+template <class T>
+class [[sus_trivial_abi]] Arc final {
+  static_assert(!std::is_reference_v<T>, "Arc<T&> is not a valid type.");
+  static_assert(!std::is_const_v<T>,
+                "`Arc<const T>` should be written `Arc<T>`, as an Arc only "
+                "gives const access to the value.");
+
+ public:
+  /// Constructs an `Arc<T>` by moving `t` into a new heap allocation.
+  static Arc with(T t, const std::source_location location =
+                           std::source_location::current()) noexcept
+    requires(::sus::mem::Move<T>)
+  {
+    using ArcInner = __private::ArcInner<T>;
+    void* p =
+        ::sus::mem::allocate(sizeof(ArcInner), alignof(ArcInner), location);
+    return Arc(*new (p) ArcInner(::sus::move(t)));
+  }
+
+  /// sus::construct::From<Arc<T>, T> trait.
+  static Arc from(T t, const std::source_location location =
+                           std::source_location::current()) noexcept
+    requires(::sus::mem::Move<T>)
+  {
+    return with(::sus::move(t), location);
+  }
+
+  ~Arc() {
+    // The `inner_` is null when being destroyed from the never-value state.
+    if (inner_ != nullptr && !is_moved_from()) release();
+  }
+
+  Arc(Arc&& o) noexcept
+      : inner_(::sus::mem::replace_ptr(mref(o.inner_), moved_from_value())) {
+    check(!is_moved_from());
+  }
+  Arc& operator=(Arc&& o) noexcept {
+    if (&o == this) return *this;
+    check(!o.is_moved_from());
+    if (!is_moved_from()) release();
+    inner_ = ::sus::mem::replace_ptr(mref(o.inner_), moved_from_value());
+    return *this;
+  }
+
+  /// Makes another `Arc` pointing to the same allocation, increasing the
+  /// strong reference count.
+  ///
+  /// sus::mem::Clone trait.
+  Arc clone() const& noexcept {
+    check(!is_moved_from());
+    // A new reference can only be made from an existing one, which keeps the
+    // value alive, so no ordering is needed with other operations.
+    inner_->strong.fetch_add(1u, std::memory_order_relaxed);
+    return Arc(*inner_);
+  }
+
+  /// Returns a const reference to the shared value.
+  const T& as_ref() const& noexcept {
+    check(!is_moved_from());
+    return inner_->value;
+  }
+  const T& as_ref() && = delete;
+
+  const T& operator*() const& noexcept { return as_ref(); }
+  const T& operator*() && = delete;
+
+  const T* operator->() const& noexcept { return &as_ref(); }
+  const T* operator->() && = delete;
+
+  /// Returns a mutable reference to the value, if there are no other `Arc` or
+  /// `Weak` pointers to the same allocation. Otherwise returns `None`, as it is
+  /// not safe to mutate a shared value.
+  Option<T&> get_mut() & noexcept {
+    check(!is_moved_from());
+    // With no `Weak` pointers, and this being the only `Arc`, no other thread
+    // can make a new pointer to the allocation. The weak count is locked
+    // while the strong count is checked, so that another `Arc` can not be
+    // downgraded and then dropped in between. The acquire operations
+    // synchronize with the release of other pointers on other threads.
+    size_t weak = 1u;
+    if (!inner_->weak.compare_exchange_strong(weak, __private::kWeakLocked,
+                                              std::memory_order_acquire,
+                                              std::memory_order_relaxed)) {
+      return Option<T&>::none();
+    }
+    const bool unique = inner_->strong.load(std::memory_order_acquire) == 1u;
+    inner_->weak.store(1u, std::memory_order_release);
+    if (unique) return Option<T&>::some(mref(inner_->value));
+    return Option<T&>::none();
+  }
+
+  /// Consumes the `Arc` and returns the inner value, if this was the only
+  /// `Arc` pointing to it. Otherwise returns `None`, and the value is left for
+  /// the other `Arc` pointers.
+  ///
+  /// If `into_inner()` is called on every clone of an `Arc`, it is guaranteed
+  /// that exactly one of them will return the value.
+  Option<T> into_inner() && noexcept {
+    check(!is_moved_from());
+    auto* inner = ::sus::mem::replace_ptr(mref(inner_), moved_from_value());
+    if (inner->strong.fetch_sub(1u, std::memory_order_release) != 1u)
+      return Option<T>::none();
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto o = Option<T>::some(::sus::move(inner->value));
+    inner->value.~T();
+    release_weak(*inner);
+    return o;
+  }
+
+  /// Makes a new `Weak` pointer to the allocation.
+  Weak<T> downgrade() const& noexcept {
+    check(!is_moved_from());
+    // While `get_mut()` has the weak count locked, it is waited for, as it
+    // holds the lock only briefly.
+    size_t n = inner_->weak.load(std::memory_order_relaxed);
+    while (true) {
+      if (n == __private::kWeakLocked) {
+        ::sus::sync::__private::spin_loop_hint();
+        n = inner_->weak.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (inner_->weak.compare_exchange_weak(n, n + 1u,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+        return Weak<T>(*inner_);
+      }
+    }
+  }
+
+  /// Returns the number of `Arc` pointers to the allocation.
+  ///
+  /// Other threads may change the count at any time, so this is only a
+  /// snapshot.
+  usize strong_count() const& noexcept {
+    check(!is_moved_from());
+    return inner_->strong.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the number of `Weak` pointers to the allocation.
+  ///
+  /// Other threads may change the count at any time, so this is only a
+  /// snapshot.
+  usize weak_count() const& noexcept {
+    check(!is_moved_from());
+    const size_t n = inner_->weak.load(std::memory_order_relaxed);
+    // A locked count means there are no `Weak` pointers.
+    if (n == __private::kWeakLocked) return 0u;
+    return n - 1u;
+  }
+
+  /// Returns true if the two `Arc` point to the same allocation.
+  bool ptr_eq(const Arc& other) const& noexcept {
+    check(!is_moved_from());
+    return inner_ == other.inner_;
+  }
+
+  /// sus::ops::Eq<Arc<T>, Arc<U>> trait.
+  template <class U>
+    requires(::sus::ops::Eq<T, U>)
+  friend bool operator==(const Arc& l, const Arc<U>& r) noexcept {
+    return l.as_ref() == r.as_ref();
+  }
+
+ private:
+  friend class Weak<T>;
+
+  explicit Arc(__private::ArcInner<T>& inner) noexcept : inner_(&inner) {}
+
+  void release() noexcept {
+    // The release ordering makes all uses of the value through this pointer
+    // happen before the value is destroyed by whichever thread releases the
+    // last pointer, and that thread acquires them all before destroying it.
+    if (inner_->strong.fetch_sub(1u, std::memory_order_release) == 1u) {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      inner_->value.~T();
+      release_weak(*inner_);
+    }
+  }
+  static void release_weak(__private::ArcInner<T>& inner) noexcept {
+    if (inner.weak.fetch_sub(1u, std::memory_order_release) == 1u) {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      inner.~ArcInner();
+      ::sus::mem::deallocate(&inner, alignof(__private::ArcInner<T>));
+    }
+  }
+
+  constexpr inline bool is_moved_from() const noexcept {
+    return inner_ == moved_from_value();
+  }
+  // The value used in `inner_` to indicate moved-from. It is not null, so that
+  // a moved-from Arc is not mistaken for the never-value.
+  static __private::ArcInner<T>* moved_from_value() noexcept {
+    return reinterpret_cast<__private::ArcInner<T>*>(
+        uintptr_t{alignof(__private::ArcInner<T>)});
+  }
+
+  __private::ArcInner<T>* inner_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(inner_));
+  // The `inner_` is never null in public usage.
+  sus_class_never_value_field(::sus::marker::unsafe_fn, Arc, inner_, nullptr,
+                              nullptr);
+  constexpr Arc() : inner_(nullptr) {}  // For the NeverValueField.
+};
+
+/// A non-owning pointer to the allocation of an `Arc<T>`.
+///
+/// A `Weak` does not keep the value alive, but it does keep the allocation
+/// alive. The value can be accessed by converting the `Weak` back to an `Arc`
+/// with `upgrade()`, which fails if the value has already been destroyed.
+template <class T>
+class [[sus_trivial_abi]] Weak final {
+ public:
+  ~Weak() {
+    if (!is_moved_from()) Arc<T>::release_weak(*inner_);
+  }
+
+  Weak(Weak&& o) noexcept
+      : inner_(::sus::mem::replace_ptr(mref(o.inner_), moved_from_value())) {
+    check(!is_moved_from());
+  }
+  Weak& operator=(Weak&& o) noexcept {
+    if (&o == this) return *this;
+    check(!o.is_moved_from());
+    if (!is_moved_from()) Arc<T>::release_weak(*inner_);
+    inner_ = ::sus::mem::replace_ptr(mref(o.inner_), moved_from_value());
+    return *this;
+  }
+
+  /// Makes another `Weak` pointing to the same allocation.
+  ///
+  /// sus::mem::Clone trait.
+  Weak clone() const& noexcept {
+    check(!is_moved_from());
+    inner_->weak.fetch_add(1u, std::memory_order_relaxed);
+    return Weak(*inner_);
+  }
+
+  /// Attempts to make an `Arc` pointing to the value. Returns `None` if the
+  /// value has already been destroyed.
+  Option<Arc<T>> upgrade() const& noexcept {
+    check(!is_moved_from());
+    // The strong count must not be incremented from zero, as the value may
+    // already be destroyed, so this can not be a fetch_add().
+    size_t n = inner_->strong.load(std::memory_order_relaxed);
+    while (true) {
+      if (n == 0u) return Option<Arc<T>>::none();
+      if (inner_->strong.compare_exchange_weak(n, n + 1u,
+                                               std::memory_order_acquire,
+                                               std::memory_order_relaxed)) {
+        return Option<Arc<T>>::some(Arc<T>(*inner_));
+      }
+    }
+  }
+
+  /// Returns the number of `Arc` pointers to the allocation.
+  usize strong_count() const& noexcept {
+    check(!is_moved_from());
+    return inner_->strong.load(std::memory_order_relaxed);
+  }
+
+ private:
+  friend class Arc<T>;
+
+  explicit Weak(__private::ArcInner<T>& inner) noexcept : inner_(&inner) {}
+
+  constexpr inline bool is_moved_from() const noexcept {
+    return inner_ == moved_from_value();
+  }
+  static __private::ArcInner<T>* moved_from_value() noexcept {
+    return Arc<T>::moved_from_value();
+  }
+
+  __private::ArcInner<T>* inner_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(inner_));
+};
+
+}  // namespace sus::sync
+
+// Promote Arc into the `sus` namespace.
+namespace sus {
+using ::sus::sync::Arc;
+}  // namespace sus
@@ -0,0 +1,393 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/assertions/unreachable.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/num/__private/intrinsics.h"
+#include "subspace/num/integer_concepts.h"
+#include "subspace/option/option.h"
+#include "subspace/result/result.h"
+
+namespace sus::sync {
+
+/// Memory orderings for atomic operations, which say how the operation
+/// synchronizes memory with other threads. These match the orderings of
+/// C++20, and of Rust's `std::sync::atomic::Ordering`.
+enum class Ordering {
+  /// No ordering constraints, only atomicity of the operation itself.
+  Relaxed,
+  /// For stores. Writes from before the store are visible to threads which
+  /// load the stored value with `Acquire`.
+  Release,
+  /// For loads. Writes from before a `Release` store of the loaded value are
+  /// visible after the load.
+  Acquire,
+  /// For read-modify-write operations, both `Acquire` and `Release`.
+  AcqRel,
+  /// Like `Acquire`, `Release` or `AcqRel`, and all `SeqCst` operations are
+  /// also seen in a single total order by all threads.
+  SeqCst,
+};
+
+namespace __private {
+
+constexpr std::memory_order to_memory_order(Ordering o) noexcept {
+  switch (o) {
+    case Ordering::Relaxed: return std::memory_order_relaxed;
+    case Ordering::Release: return std::memory_order_release;
+    case Ordering::Acquire: return std::memory_order_acquire;
+    case Ordering::AcqRel: return std::memory_order_acq_rel;
+    case Ordering::SeqCst: return std::memory_order_seq_cst;
+  }
+  ::sus::unreachable_unchecked(::sus::marker::unsafe_fn);
+}
+
+/// Returns the strongest ordering that can be used for the load of a
+/// read-modify-write operation with the ordering `o`.
+constexpr Ordering load_order(Ordering o) noexcept {
+  switch (o) {
+    case Ordering::Release: return Ordering::Relaxed;
+    case Ordering::AcqRel: return Ordering::Acquire;
+    default: return o;
+  }
+}
+
+/// Maps a type to the primitive type which is stored in a `std::atomic` for
+/// it.
+template <class T>
+struct AtomicRepr;
+
+template <::sus::num::Integer T>
+struct AtomicRepr<T> {
+  using Primitive = decltype(T::primitive_value);
+  static constexpr Primitive into(T t) noexcept { return t.primitive_value; }
+  static constexpr T from(Primitive p) noexcept { return T(p); }
+};
+
+template <>
+struct AtomicRepr<bool> {
+  using Primitive = bool;
+  static constexpr bool into(bool b) noexcept { return b; }
+  static constexpr bool from(bool b) noexcept { return b; }
+};
+
+template <class T>
+struct AtomicRepr<T*> {
+  using Primitive = T*;
+  static constexpr T* into(T* p) noexcept { return p; }
+  static constexpr T* from(T* p) noexcept { return p; }
+};
+
+}  // namespace __private
+
+/// The types which can be held in an `Atomic`.
+template <class T>
+concept AtomicType = ::sus::num::Integer<T> || std::same_as<T, bool> ||
+                     std::is_pointer_v<T>;
+
+/// A value which can be safely shared between threads.
+///
+/// `Atomic<T>` is provided for all `sus::num` integer types, for `bool`, and
+/// for pointers. It has the same in-memory representation as the underlying
+/// primitive type, and every operation takes an explicit `Ordering`.
+///
+/// Arithmetic follows the rules of the `sus::num` types: `fetch_add()` and
+/// `fetch_sub()` panic on overflow, `wrapping_fetch_add()` and
+/// `wrapping_fetch_sub()` wrap around, and `checked_fetch_add()` and
+/// `checked_fetch_sub()` leave the value unchanged and return `None` if the
+/// result would overflow.
+///
+/// An `Atomic` is neither copyable nor movable, as other threads may be
+/// accessing it. It is usually shared between threads by reference, or in an
+/// `Arc`.
+template <AtomicType T>
+class Atomic final {
+  using Repr = __private::AtomicRepr<T>;
+  using Primitive = typename Repr::Primitive;
+
+ public:
+  /// Constructs an `Atomic` holding zero, false, or null.
+  ///
+  /// sus::construct::Default trait.
+  constexpr Atomic() noexcept : v_(Primitive()) {}
+
+  /// Constructs an `Atomic` holding `value`.
+  static constexpr Atomic with(T value) noexcept { return Atomic(value); }
+
+  Atomic(const Atomic&) = delete;
+  Atomic& operator=(const Atomic&) = delete;
+
+  /// Loads the value.
+  ///
+  /// # Panics
+  /// Panics if `order` is `Release` or `AcqRel`.
+  T load(Ordering order) const& noexcept {
+    check(order != Ordering::Release && order != Ordering::AcqRel);
+    return Repr::from(v_.load(__private::to_memory_order(order)));
+  }
+
+  /// Stores `value`.
+  ///
+  /// # Panics
+  /// Panics if `order` is `Acquire` or `AcqRel`.
+  void store(T value, Ordering order) & noexcept {
+    check(order != Ordering::Acquire && order != Ordering::AcqRel);
+    v_.store(Repr::into(value), __private::to_memory_order(order));
+  }
+
+  /// Stores `value`, and returns the previous value.
+  T swap(T value, Ordering order) & noexcept {
+    return Repr::from(
+        v_.exchange(Repr::into(value), __private::to_memory_order(order)));
+  }
+
+  /// Stores `new_value` if the current value is equal to `current`.
+  ///
+  /// Returns an Ok holding the previous value if the value was replaced, and
+  /// otherwise an Err holding the current value. The `success` ordering is
+  /// used if the value is replaced, and the `failure` ordering for the load
+  /// otherwise.
+  ///
+  /// # Panics
+  /// Panics if `failure` is `Release` or `AcqRel`.
+  ::sus::result::Result<T, T> compare_exchange(T current, T new_value,
+                                               Ordering success,
+                                               Ordering failure) & noexcept {
+    check(failure != Ordering::Release && failure != Ordering::AcqRel);
+    Primitive p = Repr::into(current);
+    if (v_.compare_exchange_strong(p, Repr::into(new_value),
+                                   __private::to_memory_order(success),
+                                   __private::to_memory_order(failure))) {
+      return ::sus::result::Result<T, T>::with(Repr::from(p));
+    } else {
+      return ::sus::result::Result<T, T>::with_err(Repr::from(p));
+    }
+  }
+
+  /// Like `compare_exchange()`, but may fail spuriously even when the current
+  /// value is equal to `current`, which can generate more efficient code on
+  /// some platforms. For use in a loop which retries until it succeeds.
+  ///
+  /// # Panics
+  /// Panics if `failure` is `Release` or `AcqRel`.
+  ::sus::result::Result<T, T> compare_exchange_weak(
+      T current, T new_value, Ordering success, Ordering failure) & noexcept {
+    check(failure != Ordering::Release && failure != Ordering::AcqRel);
+    Primitive p = Repr::into(current);
+    if (v_.compare_exchange_weak(p, Repr::into(new_value),
+                                 __private::to_memory_order(success),
+                                 __private::to_memory_order(failure))) {
+      return ::sus::result::Result<T, T>::with(Repr::from(p));
+    } else {
+      return ::sus::result::Result<T, T>::with_err(Repr::from(p));
+    }
+  }
+
+  /// Replaces the value with the result of `f`, retrying if another thread
+  /// changes the value in between. If `f` returns `None`, the value is left
+  /// unchanged.
+  ///
+  /// Returns an Ok holding the previous value if it was replaced, and
+  /// otherwise an Err holding the value that was given to `f`.
+  ///
+  /// # Panics
+  /// Panics if `fetch_order` is `Release` or `AcqRel`.
+  template <class F>
+    requires(std::is_invocable_r_v<::sus::Option<T>, F&, T>)
+  ::sus::result::Result<T, T> fetch_update(Ordering set_order,
+                                           Ordering fetch_order,
+                                           F f) & noexcept {
+    T prev = load(fetch_order);
+    while (true) {
+      ::sus::Option<T> next = f(prev);
+      if (next.is_none()) return ::sus::result::Result<T, T>::with_err(prev);
+      auto r = compare_exchange_weak(prev, ::sus::move(next).unwrap(),
+                                     set_order, fetch_order);
+      if (r.is_ok()) return r;
+      prev = ::sus::move(r).unwrap_err();
+    }
+  }
+
+  /// Adds `value` to the current value, and returns the previous value.
+  ///
+  /// # Panics
+  /// Panics if the result overflows. The value has already been updated when
+  /// the panic happens.
+  T fetch_add(T value, Ordering order) & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    const Primitive p = Repr::into(value);
+    const Primitive old = v_.fetch_add(p, __private::to_memory_order(order));
+    check(!::sus::num::__private::add_with_overflow(old, p).overflow);
+    return Repr::from(old);
+  }
+
+  /// Subtracts `value` from the current value, and returns the previous value.
+  ///
+  /// # Panics
+  /// Panics if the result overflows. The value has already been updated when
+  /// the panic happens.
+  T fetch_sub(T value, Ordering order) & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    const Primitive p = Repr::into(value);
+    const Primitive old = v_.fetch_sub(p, __private::to_memory_order(order));
+    check(!::sus::num::__private::sub_with_overflow(old, p).overflow);
+    return Repr::from(old);
+  }
+
+  /// Adds `value` to the current value, wrapping around at the boundary of
+  /// the type, and returns the previous value.
+  T wrapping_fetch_add(T value, Ordering order) & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    return Repr::from(
+        v_.fetch_add(Repr::into(value), __private::to_memory_order(order)));
+  }
+
+  /// Subtracts `value` from the current value, wrapping around at the
+  /// boundary of the type, and returns the previous value.
+  T wrapping_fetch_sub(T value, Ordering order) & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    return Repr::from(
+        v_.fetch_sub(Repr::into(value), __private::to_memory_order(order)));
+  }
+
+  /// Adds `value` to the current value if the result does not overflow, and
+  /// returns the previous value. If it would overflow, the value is left
+  /// unchanged and `None` is returned.
+  ::sus::Option<T> checked_fetch_add(T value, Ordering order) & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    return fetch_update(order, __private::load_order(order),
+                        [&value](T cur) { return cur.checked_add(value); })
+        .ok();
+  }
+
+  /// Subtracts `value` from the current value if the result does not
+  /// overflow, and returns the previous value. If it would overflow, the
+  /// value is left unchanged and `None` is returned.
+  ::sus::Option<T> checked_fetch_sub(T value, Ordering order) & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    return fetch_update(order, __private::load_order(order),
+                        [&value](T cur) { return cur.checked_sub(value); })
+        .ok();
+  }
+
+  /// Stores the maximum of the current value and `value`, and returns the
+  /// previous value.
+  T fetch_max(T value, Ordering order) & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    // The value is stored even when it does not change, so that this is
+    // always a read-modify-write with the ordering `order`, as it is for
+    // the other `fetch_*` operations.
+    const std::memory_order failure =
+        __private::to_memory_order(__private::load_order(order));
+    Primitive old = v_.load(failure);
+    const Primitive p = Repr::into(value);
+    while (!v_.compare_exchange_weak(old, old < p ? p : old,
+                                     __private::to_memory_order(order),
+                                     failure)) {
+    }
+    return Repr::from(old);
+  }
+
+  /// Stores the minimum of the current value and `value`, and returns the
+  /// previous value.
+  T fetch_min(T value, Ordering order) & noexcept
+    requires(::sus::num::Integer<T>)
+  {
+    // The value is stored even when it does not change, so that this is
+    // always a read-modify-write with the ordering `order`, as it is for
+    // the other `fetch_*` operations.
+    const std::memory_order failure =
+        __private::to_memory_order(__private::load_order(order));
+    Primitive old = v_.load(failure);
+    const Primitive p = Repr::into(value);
+    while (!v_.compare_exchange_weak(old, old > p ? p : old,
+                                     __private::to_memory_order(order),
+                                     failure)) {
+    }
+    return Repr::from(old);
+  }
+
+  /// Applies bitwise "and" with `value` to the current value, and returns the
+  /// previous value.
+  T fetch_and(T value, Ordering order) & noexcept
+    requires(!std::is_pointer_v<T>)
+  {
+    if constexpr (std::same_as<T, bool>) {
+      // std::atomic<bool> has no bitwise operations.
+      return fetch_bool(order, [value](bool b) { return b && value; });
+    } else {
+      return Repr::from(
+          v_.fetch_and(Repr::into(value), __private::to_memory_order(order)));
+    }
+  }
+
+  /// Applies bitwise "or" with `value` to the current value, and returns the
+  /// previous value.
+  T fetch_or(T value, Ordering order) & noexcept
+    requires(!std::is_pointer_v<T>)
+  {
+    if constexpr (std::same_as<T, bool>) {
+      return fetch_bool(order, [value](bool b) { return b || value; });
+    } else {
+      return Repr::from(
+          v_.fetch_or(Repr::into(value), __private::to_memory_order(order)));
+    }
+  }
+
+  /// Applies bitwise "xor" with `value` to the current value, and returns the
+  /// previous value.
+  T fetch_xor(T value, Ordering order) & noexcept
+    requires(!std::is_pointer_v<T>)
+  {
+    if constexpr (std::same_as<T, bool>) {
+      return fetch_bool(order, [value](bool b) { return b != value; });
+    } else {
+      return Repr::from(
+          v_.fetch_xor(Repr::into(value), __private::to_memory_order(order)));
+    }
+  }
+
+ private:
+  constexpr explicit Atomic(T value) noexcept : v_(Repr::into(value)) {}
+
+  // Replaces the bool value with `op(value)` and returns the previous value.
+  template <class Op>
+  bool fetch_bool(Ordering order, Op op) & noexcept {
+    const std::memory_order failure =
+        __private::to_memory_order(__private::load_order(order));
+    bool old = v_.load(failure);
+    while (!v_.compare_exchange_weak(
+        old, op(old), __private::to_memory_order(order), failure)) {
+    }
+    return old;
+  }
+
+  std::atomic<Primitive> v_;
+};
+
+}  // namespace sus::sync
@@ -0,0 +1,181 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/sync/atomic.h"
+
+#include <thread>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::sync::Atomic;
+using sus::sync::Ordering;
+
+static_assert(sizeof(Atomic<u32>) == sizeof(uint32_t));
+static_assert(sizeof(Atomic<i64>) == sizeof(int64_t));
+static_assert(sizeof(Atomic<bool>) == sizeof(bool));
+static_assert(sizeof(Atomic<int*>) == sizeof(int*));
+static_assert(!std::is_copy_constructible_v<Atomic<u32>>);
+static_assert(!std::is_move_constructible_v<Atomic<u32>>);
+
+TEST(Atomic, LoadStore) {
+  auto a = Atomic<u32>();
+  EXPECT_EQ(a.load(Ordering::Relaxed), 0_u32);
+  a.store(5_u32, Ordering::Release);
+  EXPECT_EQ(a.load(Ordering::Acquire), 5_u32);
+
+  auto b = Atomic<i8>::with(-3_i8);
+  EXPECT_EQ(b.load(Ordering::SeqCst), -3_i8);
+
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH(a.load(Ordering::Release), "");
+  EXPECT_DEATH(a.store(1_u32, Ordering::Acquire), "");
+#endif
+}
+
+TEST(Atomic, Swap) {
+  auto a = Atomic<usize>::with(1u);
+  EXPECT_EQ(a.swap(2u, Ordering::AcqRel), 1_usize);
+  EXPECT_EQ(a.load(Ordering::Relaxed), 2_usize);
+}
+
+TEST(Atomic, CompareExchange) {
+  auto a = Atomic<u64>::with(10u);
+  auto ok = a.compare_exchange(10u, 11u, Ordering::AcqRel, Ordering::Acquire);
+  EXPECT_EQ(sus::move(ok).unwrap(), 10_u64);
+  auto err = a.compare_exchange(10u, 12u, Ordering::AcqRel, Ordering::Acquire);
+  EXPECT_EQ(sus::move(err).unwrap_err(), 11_u64);
+  EXPECT_EQ(a.load(Ordering::Relaxed), 11_u64);
+
+  u64 cur = a.load(Ordering::Relaxed);
+  while (true) {
+    auto r = a.compare_exchange_weak(cur, cur * 2u, Ordering::AcqRel,
+                                     Ordering::Relaxed);
+    if (r.is_ok()) break;
+    cur = sus::move(r).unwrap_err();
+  }
+  EXPECT_EQ(a.load(Ordering::Relaxed), 22_u64);
+
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH((void)a.compare_exchange(0u, 1u, Ordering::SeqCst,
+                                        Ordering::Release),
+               "");
+#endif
+}
+
+TEST(Atomic, FetchAdd) {
+  auto a = Atomic<u8>::with(250_u8);
+  EXPECT_EQ(a.fetch_add(5_u8, Ordering::Relaxed), 250_u8);
+  EXPECT_EQ(a.fetch_sub(10_u8, Ordering::Relaxed), 255_u8);
+  EXPECT_EQ(a.load(Ordering::Relaxed), 245_u8);
+
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH(a.fetch_add(11_u8, Ordering::Relaxed), "");
+  auto s = Atomic<i32>::with(i32::MIN);
+  EXPECT_DEATH(s.fetch_sub(1, Ordering::Relaxed), "");
+#endif
+}
+
+TEST(Atomic, WrappingFetchAdd) {
+  auto a = Atomic<u8>::with(250_u8);
+  EXPECT_EQ(a.wrapping_fetch_add(10_u8, Ordering::Relaxed), 250_u8);
+  EXPECT_EQ(a.load(Ordering::Relaxed), 4_u8);
+  EXPECT_EQ(a.wrapping_fetch_sub(5_u8, Ordering::Relaxed), 4_u8);
+  EXPECT_EQ(a.load(Ordering::Relaxed), 255_u8);
+
+  auto s = Atomic<i32>::with(i32::MAX);
+  EXPECT_EQ(s.wrapping_fetch_add(1, Ordering::Relaxed), i32::MAX);
+  EXPECT_EQ(s.load(Ordering::Relaxed), i32::MIN);
+}
+
+TEST(Atomic, CheckedFetchAdd) {
+  auto a = Atomic<u8>::with(250_u8);
+  EXPECT_EQ(a.checked_fetch_add(5_u8, Ordering::Release),
+            sus::Option<u8>::some(250_u8));
+  EXPECT_EQ(a.checked_fetch_add(1_u8, Ordering::AcqRel),
+            sus::Option<u8>::none());
+  EXPECT_EQ(a.load(Ordering::Relaxed), 255_u8);
+  EXPECT_EQ(a.checked_fetch_sub(255_u8, Ordering::SeqCst),
+            sus::Option<u8>::some(255_u8));
+  EXPECT_EQ(a.checked_fetch_sub(1_u8, Ordering::SeqCst),
+            sus::Option<u8>::none());
+  EXPECT_EQ(a.load(Ordering::Relaxed), 0_u8);
+}
+
+TEST(Atomic, FetchUpdate) {
+  auto a = Atomic<u32>::with(7u);
+  auto r = a.fetch_update(Ordering::SeqCst, Ordering::SeqCst, [](u32 x) {
+    return sus::Option<u32>::some(x + 1u);
+  });
+  EXPECT_EQ(sus::move(r).unwrap(), 7_u32);
+  auto n = a.fetch_update(Ordering::SeqCst, Ordering::SeqCst,
+                          [](u32) { return sus::Option<u32>::none(); });
+  EXPECT_EQ(sus::move(n).unwrap_err(), 8_u32);
+  EXPECT_EQ(a.load(Ordering::Relaxed), 8_u32);
+}
+
+TEST(Atomic, FetchMaxMin) {
+  auto a = Atomic<i32>::with(5);
+  EXPECT_EQ(a.fetch_max(3, Ordering::Relaxed), 5_i32);
+  EXPECT_EQ(a.fetch_max(9, Ordering::Relaxed), 5_i32);
+  EXPECT_EQ(a.fetch_min(-2, Ordering::Relaxed), 9_i32);
+  EXPECT_EQ(a.load(Ordering::Relaxed), -2_i32);
+}
+
+TEST(Atomic, FetchBits) {
+  auto a = Atomic<u16>::with(0b1100_u16);
+  EXPECT_EQ(a.fetch_and(0b1010_u16, Ordering::Relaxed), 0b1100_u16);
+  EXPECT_EQ(a.fetch_or(0b0001_u16, Ordering::Relaxed), 0b1000_u16);
+  EXPECT_EQ(a.fetch_xor(0b1111_u16, Ordering::Relaxed), 0b1001_u16);
+  EXPECT_EQ(a.load(Ordering::Relaxed), 0b0110_u16);
+}
+
+TEST(Atomic, Bool) {
+  auto a = Atomic<bool>();
+  EXPECT_FALSE(a.load(Ordering::Relaxed));
+  EXPECT_FALSE(a.fetch_or(true, Ordering::AcqRel));
+  EXPECT_TRUE(a.fetch_and(true, Ordering::AcqRel));
+  EXPECT_TRUE(a.fetch_xor(true, Ordering::AcqRel));
+  EXPECT_FALSE(a.load(Ordering::Relaxed));
+  EXPECT_FALSE(a.swap(true, Ordering::SeqCst));
+  EXPECT_TRUE(sus::move(a.compare_exchange(true, false, Ordering::SeqCst,
+                                           Ordering::SeqCst))
+                  .unwrap());
+}
+
+TEST(Atomic, Pointer) {
+  int x = 1, y = 2;
+  auto a = Atomic<int*>();
+  EXPECT_EQ(a.load(Ordering::Acquire), nullptr);
+  a.store(&x, Ordering::Release);
+  EXPECT_EQ(a.swap(&y, Ordering::AcqRel), &x);
+  EXPECT_EQ(*a.load(Ordering::Acquire), 2);
+}
+
+TEST(Atomic, Contended) {
+  auto a = Atomic<u64>();
+  sus::Vec<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push(std::thread([&a]() {
+      for (int j = 0; j < 10000; ++j) a.fetch_add(1u, Ordering::Relaxed);
+    }));
+  }
+  for (std::thread& t : threads.iter_mut()) t.join();
+  EXPECT_EQ(a.load(Ordering::Relaxed), 40000_u64);
+}
+
+}  // namespace
@@ -0,0 +1,95 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <type_traits>
+
+#include "subspace/mem/move.h"
+
+namespace sus::sync {
+
+/// The alignment of a `CachePadded` value.
+///
+/// On x86-64 and AArch64 the hardware may prefetch cache lines in pairs, so
+/// values on adjacent 64 byte lines can still interfere with each other, and
+/// two lines are used.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__aarch64__) || \
+    defined(_M_ARM64)
+inline constexpr size_t CACHE_PADDED_ALIGN = 128u;
+#else
+inline constexpr size_t CACHE_PADDED_ALIGN = 64u;
+#endif
+
+/// Pads and aligns a value to the length of a cache line.
+///
+/// When two values which are written by different threads sit on the same
+/// cache line, each write by one thread forces the other thread's core to
+/// reload the line, even though the threads do not share any data. This is
+/// called false sharing, and it can make contended counters much slower.
+/// Wrapping each value in a `CachePadded` gives it a cache line of its own.
+///
+/// The value is accessed through `as_ref()` and `as_mut()`, or through the
+/// `*` and `->` operators.
+template <class T>
+class alignas(CACHE_PADDED_ALIGN) CachePadded final {
+ public:
+  /// Constructs a `CachePadded` holding the default value of `T`.
+  ///
+  /// This can be used for types which can not be moved, such as
+  /// `sus::sync::Atomic`.
+  ///
+  /// sus::construct::Default trait.
+  constexpr CachePadded() noexcept
+    requires(std::is_default_constructible_v<T>)
+      : value_() {}
+
+  /// Constructs a `CachePadded` holding `value`.
+  static constexpr CachePadded with(T value) noexcept
+    requires(std::is_move_constructible_v<T>)
+  {
+    return CachePadded(::sus::move(value));
+  }
+
+  /// Returns a const reference to the padded value.
+  constexpr const T& as_ref() const& noexcept { return value_; }
+  constexpr const T& as_ref() && = delete;
+  /// Returns a mutable reference to the padded value.
+  constexpr T& as_mut() & noexcept { return value_; }
+
+  constexpr const T& operator*() const& noexcept { return value_; }
+  constexpr const T& operator*() && = delete;
+  constexpr T& operator*() & noexcept { return value_; }
+
+  constexpr const T* operator->() const& noexcept { return &value_; }
+  constexpr const T* operator->() && = delete;
+  constexpr T* operator->() & noexcept { return &value_; }
+
+  /// Moves the padded value out.
+  constexpr T into_inner() && noexcept
+    requires(std::is_move_constructible_v<T>)
+  {
+    return ::sus::move(value_);
+  }
+
+ private:
+  constexpr explicit CachePadded(T&& value) noexcept
+      : value_(::sus::move(value)) {}
+
+  T value_;
+};
+
+}  // namespace sus::sync
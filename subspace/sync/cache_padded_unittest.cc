@@ -0,0 +1,53 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/sync/cache_padded.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/prelude.h"
+#include "subspace/sync/atomic.h"
+
+namespace {
+
+using sus::sync::Atomic;
+using sus::sync::CACHE_PADDED_ALIGN;
+using sus::sync::CachePadded;
+using sus::sync::Ordering;
+
+static_assert(alignof(CachePadded<u8>) == CACHE_PADDED_ALIGN);
+static_assert(sizeof(CachePadded<u8>) == CACHE_PADDED_ALIGN);
+static_assert(sizeof(CachePadded<u64>[2]) == 2u * CACHE_PADDED_ALIGN);
+
+TEST(CachePadded, With) {
+  auto p = CachePadded<i32>::with(4);
+  EXPECT_EQ(p.as_ref(), 4_i32);
+  *p += 1;
+  EXPECT_EQ(*p, 5_i32);
+  p.as_mut() = 2;
+  EXPECT_EQ(sus::move(p).into_inner(), 2_i32);
+}
+
+TEST(CachePadded, Atomic) {
+  CachePadded<Atomic<u32>> counters[2];
+  counters[0]->fetch_add(1u, Ordering::Relaxed);
+  counters[1]->fetch_add(2u, Ordering::Relaxed);
+  EXPECT_EQ(counters[0]->load(Ordering::Relaxed), 1_u32);
+  EXPECT_EQ(counters[1]->load(Ordering::Relaxed), 2_u32);
+  // Each value is on its own cache line.
+  auto a = reinterpret_cast<uintptr_t>(&counters[0].as_ref());
+  auto b = reinterpret_cast<uintptr_t>(&counters[1].as_ref());
+  EXPECT_GE(b - a, CACHE_PADDED_ALIGN);
+}
+
+}  // namespace
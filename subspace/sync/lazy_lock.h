@@ -0,0 +1,78 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <type_traits>
+
+#include "subspace/mem/move.h"
+#include "subspace/sync/once_lock.h"
+
+namespace sus::sync {
+
+/// A value which is initialized on first use, and can be used from many
+/// threads.
+///
+/// The value is made by calling the initializer given to the constructor the
+/// first time it is accessed, through `force()`, `*` or `->`. If many threads
+/// access it at once, only one calls the initializer, and the others wait for
+/// it. After that, an access costs a single acquire load.
+///
+/// The initializer is a function pointer by default, so that a `LazyLock` can
+/// be constant-initialized at namespace scope, which avoids any concern for
+/// the order of static initialization:
+/// ```
+/// constinit sus::sync::LazyLock<Table> TABLE(&build_table);
+/// ```
+/// Any other callable type, such as `sus::fn::FnOnce<T()>`, can be given as
+/// `F`.
+template <class T, class F = T (*)()>
+class LazyLock final {
+  static_assert(std::is_invocable_r_v<T, F&&>,
+                "The initializer must return a T when called.");
+
+ public:
+  /// Constructs a `LazyLock` which will be initialized by calling `init`.
+  ///
+  /// This is a constructor, rather than a `with()` method, as a `LazyLock`
+  /// holding a type with a non-trivial destructor is not a literal type, and
+  /// can only be constant-initialized by a constexpr constructor.
+  constexpr explicit LazyLock(F init) noexcept : init_(::sus::move(init)) {}
+
+  LazyLock(const LazyLock&) = delete;
+  LazyLock& operator=(const LazyLock&) = delete;
+
+  /// Returns a reference to the value, initializing it first if this is the
+  /// first access.
+  const T& force() const& noexcept {
+    return lock_.get_or_init([this]() { return ::sus::move(init_)(); });
+  }
+  const T& force() && = delete;
+
+  const T& operator*() const& noexcept { return force(); }
+  const T& operator*() && = delete;
+
+  const T* operator->() const& noexcept { return &force(); }
+  const T* operator->() && = delete;
+
+  /// Returns whether the value has been initialized.
+  bool is_initialized() const& noexcept { return lock_.get().is_some(); }
+
+ private:
+  OnceLock<T> lock_;
+  // Called, at most once, by the thread which initializes `lock_`.
+  mutable F init_;
+};
+
+}  // namespace sus::sync
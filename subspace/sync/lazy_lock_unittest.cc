@@ -0,0 +1,78 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/sync/lazy_lock.h"
+
+#include <atomic>
+#include <thread>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/fn/fn.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::sync::LazyLock;
+
+int table_builds = 0;
+
+sus::Vec<u32> build_table() {
+  table_builds += 1;
+  auto v = sus::Vec<u32>::with_capacity(256u);
+  for (u32 i = 0u; i < 256u; i += 1u) v.push(i * i);
+  return v;
+}
+
+constinit LazyLock<sus::Vec<u32>> TABLE(&build_table);
+
+TEST(LazyLock, Global) {
+  EXPECT_FALSE(TABLE.is_initialized());
+  EXPECT_EQ(TABLE->len(), 256u);
+  EXPECT_EQ((*TABLE)[16u], 256u);
+  EXPECT_EQ(TABLE.force()[3u], 9u);
+  EXPECT_TRUE(TABLE.is_initialized());
+  EXPECT_EQ(table_builds, 1);
+}
+
+TEST(LazyLock, Lambda) {
+  auto init = []() { return 7_i32; };
+  auto l = LazyLock<i32, decltype(init)>(init);
+  EXPECT_EQ(*l, 7_i32);
+}
+
+TEST(LazyLock, FnOnce) {
+  auto l = LazyLock<i32, sus::fn::FnOnce<i32()>>(
+      sus::fn::FnOnce<i32()>::from([]() { return 5_i32; }));
+  EXPECT_FALSE(l.is_initialized());
+  EXPECT_EQ(*l, 5_i32);
+  EXPECT_EQ(l.force(), 5_i32);
+}
+
+TEST(LazyLock, Threads) {
+  static std::atomic<int> calls = 0;
+  auto l = LazyLock<u64>([]() {
+    calls.fetch_add(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return 42_u64;
+  });
+  constexpr int kThreads = 8;
+  std::thread threads[kThreads];
+  for (auto& t : threads)
+    t = std::thread([&l]() { EXPECT_EQ(*l, 42_u64); });
+  for (auto& t : threads) t.join();
+  EXPECT_EQ(calls.load(), 1);
+}
+
+}  // namespace
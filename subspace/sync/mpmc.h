@@ -0,0 +1,281 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/iter/iterator.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/option/option.h"
+#include "subspace/result/result.h"
+#include "subspace/sync/__private/array_channel.h"
+#include "subspace/sync/__private/channel.h"
+#include "subspace/sync/__private/channel_iter.h"
+#include "subspace/sync/mpsc.h"
+#include "subspace/tuple/tuple.h"
+
+/// Multi-producer, multi-consumer bounded channels, for sending values between
+/// threads.
+///
+/// A channel is made by `bounded()`, which returns a `Sender` and a
+/// `Receiver`. Both can be cloned, and each value sent is received by exactly
+/// one of the receivers. This makes a channel a work queue which can be
+/// drained by a group of threads.
+///
+/// The errors are the same as those of `sus::sync::mpsc`.
+namespace sus::sync::mpmc {
+
+using ::sus::sync::mpsc::RecvError;
+using ::sus::sync::mpsc::SendError;
+using ::sus::sync::mpsc::TryRecvError;
+using ::sus::sync::mpsc::TrySendError;
+
+template <class T>
+class Sender;
+template <class T>
+class Receiver;
+
+template <class T>
+::sus::Tuple<Sender<T>, Receiver<T>> bounded(usize cap) noexcept;
+
+namespace __private {
+
+template <class T>
+using Counter = ::sus::sync::__private::ChannelCounter<
+    ::sus::sync::__private::ArrayChannel<T>>;
+
+}  // namespace __private
+
+/// The sending half of a channel.
+///
+/// A `Sender` can be cloned, and the clones sent to other threads, to send
+/// into the same channel from many threads at once. The channel is
+/// disconnected for the receivers once every `Sender` is gone.
+template <class T>
+class [[sus_trivial_abi]] Sender final {
+  static_assert(!std::is_reference_v<T>, "Sender<T&> is not a valid type.");
+
+ public:
+  ~Sender() noexcept {
+    if (counter_ != nullptr) ::sus::sync::__private::release_sender(counter_);
+  }
+
+  Sender(Sender&& o) noexcept
+      : counter_(::sus::mem::replace_ptr(mref(o.counter_), nullptr)) {
+    check(counter_ != nullptr);
+  }
+  Sender& operator=(Sender&& o) noexcept {
+    check(o.counter_ != nullptr);
+    if (&o == this) return *this;
+    if (counter_ != nullptr) ::sus::sync::__private::release_sender(counter_);
+    counter_ = ::sus::mem::replace_ptr(mref(o.counter_), nullptr);
+    return *this;
+  }
+
+  /// Returns another `Sender` into the same channel.
+  ///
+  /// sus::mem::Clone trait.
+  Sender clone() const& noexcept {
+    check(counter_ != nullptr);
+    return Sender(*::sus::sync::__private::acquire_sender(counter_));
+  }
+
+  /// Sends `value` into the channel, blocking while the channel is full.
+  ///
+  /// Returns None once the value is sent, or an error holding the value if
+  /// every `Receiver` is gone.
+  ::sus::Option<SendError<T>> send(T value) const& noexcept {
+    check(counter_ != nullptr);
+    if (::sus::sync::__private::channel_send(counter_->chan, value, true) ==
+        ::sus::sync::__private::ChannelStatus::Ok) {
+      return ::sus::Option<SendError<T>>::none();
+    }
+    return ::sus::Option<SendError<T>>::some(SendError<T>(::sus::move(value)));
+  }
+
+  /// Sends `value` into the channel if that can be done without blocking.
+  ///
+  /// Returns None once the value is sent, or an error holding the value if
+  /// the channel is full, or every `Receiver` is gone.
+  ::sus::Option<TrySendError<T>> try_send(T value) const& noexcept {
+    using ::sus::sync::__private::ChannelStatus;
+    using Kind = typename TrySendError<T>::Kind;
+    check(counter_ != nullptr);
+    switch (::sus::sync::__private::channel_send(counter_->chan, value,
+                                                 false)) {
+      case ChannelStatus::Ok: return ::sus::Option<TrySendError<T>>::none();
+      case ChannelStatus::Full:
+        return ::sus::Option<TrySendError<T>>::some(
+            TrySendError<T>(Kind::Full, ::sus::move(value)));
+      default:
+        return ::sus::Option<TrySendError<T>>::some(
+            TrySendError<T>(Kind::Disconnected, ::sus::move(value)));
+    }
+  }
+
+  /// Returns the number of values the channel can hold.
+  usize capacity() const& noexcept {
+    check(counter_ != nullptr);
+    return counter_->chan.capacity();
+  }
+
+ private:
+  friend ::sus::Tuple<Sender<T>, Receiver<T>> bounded<T>(usize) noexcept;
+
+  explicit Sender(__private::Counter<T>& counter) noexcept
+      : counter_(&counter) {}
+
+  __private::Counter<T>* counter_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn,
+                                  decltype(counter_));
+};
+
+/// The receiving half of a channel.
+///
+/// A `Receiver` can be cloned, and the clones sent to other threads, to
+/// receive from the same channel from many threads at once. Each value is
+/// received by only one of them.
+///
+/// Besides `recv()` and `try_recv()`, the values can be received through an
+/// `Iterator` from `iter()` or `into_iter()`, which ends once the channel is
+/// empty and disconnected, or from `try_iter()`, which ends once the channel
+/// is empty.
+template <class T>
+class [[sus_trivial_abi]] Receiver final {
+  static_assert(!std::is_reference_v<T>, "Receiver<T&> is not a valid type.");
+
+ public:
+  using Iter = ::sus::sync::__private::RecvIter<const Receiver, T>;
+  using TryIter = ::sus::sync::__private::TryRecvIter<const Receiver, T>;
+  using IntoIter = ::sus::sync::__private::RecvIntoIter<Receiver, T>;
+
+  ~Receiver() noexcept {
+    if (counter_ != nullptr)
+      ::sus::sync::__private::release_receiver(counter_);
+  }
+
+  Receiver(Receiver&& o) noexcept
+      : counter_(::sus::mem::replace_ptr(mref(o.counter_), nullptr)) {
+    check(counter_ != nullptr);
+  }
+  Receiver& operator=(Receiver&& o) noexcept {
+    check(o.counter_ != nullptr);
+    if (&o == this) return *this;
+    if (counter_ != nullptr)
+      ::sus::sync::__private::release_receiver(counter_);
+    counter_ = ::sus::mem::replace_ptr(mref(o.counter_), nullptr);
+    return *this;
+  }
+
+  /// Returns another `Receiver` from the same channel.
+  ///
+  /// sus::mem::Clone trait.
+  Receiver clone() const& noexcept {
+    check(counter_ != nullptr);
+    return Receiver(*::sus::sync::__private::acquire_receiver(counter_));
+  }
+
+  /// Receives the next value from the channel, blocking until one is sent.
+  ///
+  /// Returns an error once the channel is empty and every `Sender` is gone.
+  ::sus::result::Result<T, RecvError> recv() const& noexcept {
+    using R = ::sus::result::Result<T, RecvError>;
+    check(counter_ != nullptr);
+    auto status = ::sus::sync::__private::ChannelStatus::Ok;
+    auto out =
+        ::sus::sync::__private::channel_recv(counter_->chan, status, true);
+    if (status == ::sus::sync::__private::ChannelStatus::Ok)
+      return R::with(::sus::move(out).unwrap());
+    return R::with_err(RecvError());
+  }
+
+  /// Receives the next value from the channel if there is one, without
+  /// blocking.
+  ::sus::result::Result<T, TryRecvError> try_recv() const& noexcept {
+    using R = ::sus::result::Result<T, TryRecvError>;
+    using ::sus::sync::__private::ChannelStatus;
+    check(counter_ != nullptr);
+    auto status = ChannelStatus::Ok;
+    auto out =
+        ::sus::sync::__private::channel_recv(counter_->chan, status, false);
+    switch (status) {
+      case ChannelStatus::Ok: return R::with(::sus::move(out).unwrap());
+      case ChannelStatus::Empty:
+        return R::with_err(TryRecvError(TryRecvError::Kind::Empty));
+      default:
+        return R::with_err(TryRecvError(TryRecvError::Kind::Disconnected));
+    }
+  }
+
+  /// Returns an iterator which receives values, blocking for each one, until
+  /// the channel is empty and every `Sender` is gone.
+  Iter iter() const& noexcept {
+    check(counter_ != nullptr);
+    return Iter::with(*this);
+  }
+  Iter iter() && = delete;
+
+  /// Returns an iterator which receives the values already in the channel,
+  /// without blocking, and ends once it is empty.
+  TryIter try_iter() const& noexcept {
+    check(counter_ != nullptr);
+    return TryIter::with(*this);
+  }
+  TryIter try_iter() && = delete;
+
+  /// Consumes the `Receiver` into an iterator which receives values, blocking
+  /// for each one, until the channel is empty and every `Sender` is gone.
+  IntoIter into_iter() && noexcept {
+    check(counter_ != nullptr);
+    return IntoIter::with(::sus::move(*this));
+  }
+
+ private:
+  friend ::sus::Tuple<Sender<T>, Receiver<T>> bounded<T>(usize) noexcept;
+
+  explicit Receiver(__private::Counter<T>& counter) noexcept
+      : counter_(&counter) {}
+
+  __private::Counter<T>* counter_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn,
+                                  decltype(counter_));
+};
+
+/// Creates a bounded channel, which holds up to `cap` values, returning its
+/// `Sender` and `Receiver`.
+///
+/// Sending blocks while the channel is full, and receiving blocks while it is
+/// empty. The values are held in a ring buffer which is allocated up front, so
+/// sending and receiving never allocate.
+///
+/// # Panics
+/// Panics if `cap` is zero.
+template <class T>
+::sus::Tuple<Sender<T>, Receiver<T>> bounded(usize cap) noexcept {
+  check(cap > 0u);
+  auto& counter = *new __private::Counter<T>(cap.primitive_value);
+  return ::sus::Tuple<Sender<T>, Receiver<T>>::with(Sender<T>(counter),
+                                                    Receiver<T>(counter));
+}
+
+}  // namespace sus::sync::mpmc
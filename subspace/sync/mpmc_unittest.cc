@@ -0,0 +1,112 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/sync/mpmc.h"
+
+#include <atomic>
+#include <thread>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::sync::mpmc::bounded;
+using sus::sync::mpmc::TryRecvError;
+using sus::sync::mpmc::TrySendError;
+
+TEST(Mpmc, SendRecv) {
+  auto [tx, rx] = bounded<i32>(4u);
+  // Moving into itself does nothing.
+  auto& tx_self = tx;
+  tx = sus::move(tx_self);
+  auto& rx_self = rx;
+  rx = sus::move(rx_self);
+  EXPECT_EQ(tx.capacity(), 4u);
+  EXPECT_TRUE(tx.send(1).is_none());
+  EXPECT_TRUE(tx.send(2).is_none());
+  auto rx2 = rx.clone();
+  EXPECT_EQ(rx.recv().unwrap(), 1_i32);
+  EXPECT_EQ(rx2.recv().unwrap(), 2_i32);
+  EXPECT_EQ(rx.try_recv().unwrap_err().kind(), TryRecvError::Kind::Empty);
+}
+
+TEST(Mpmc, Full) {
+  // A capacity which is not a power of two.
+  auto [tx, rx] = bounded<i32>(3u);
+  for (i32 lap = 0; lap < 4; lap += 1) {
+    for (i32 i = 0; i < 3; i += 1) EXPECT_TRUE(tx.try_send(i).is_none());
+    EXPECT_EQ(tx.try_send(9).unwrap().kind(), TrySendError<i32>::Kind::Full);
+    for (i32 i = 0; i < 3; i += 1) EXPECT_EQ(rx.recv().unwrap(), i);
+  }
+}
+
+TEST(Mpmc, Disconnect) {
+  auto [tx, rx] = bounded<i32>(2u);
+  auto rx2 = rx.clone();
+  EXPECT_TRUE(tx.send(1).is_none());
+  { auto drop = sus::move(tx); }
+  EXPECT_EQ(rx2.recv().unwrap(), 1_i32);
+  EXPECT_TRUE(rx.recv().is_err());
+  EXPECT_EQ(rx2.try_recv().unwrap_err().kind(),
+            TryRecvError::Kind::Disconnected);
+
+  auto [tx2, rx3] = bounded<i32>(2u);
+  { auto drop = sus::move(rx3); }
+  EXPECT_EQ(tx2.send(5).unwrap().into_inner(), 5_i32);
+}
+
+TEST(Mpmc, ManyToMany) {
+  auto [tx, rx] = bounded<sus::Vec<u64>>(8u);
+  constexpr int kProducers = 3;
+  constexpr int kConsumers = 3;
+  constexpr u64 kEach = 2000u;
+  std::atomic<uint64_t> sum = 0u;
+  std::atomic<uint64_t> count = 0u;
+  std::thread threads[kProducers + kConsumers];
+  for (int i = 0; i < kProducers; ++i) {
+    threads[i] = std::thread([tx = tx.clone(), kEach]() {
+      for (u64 j = 1u; j <= kEach; j += 1u) {
+        auto batch = sus::Vec<u64>();
+        batch.push(j);
+        EXPECT_TRUE(tx.send(sus::move(batch)).is_none());
+      }
+    });
+  }
+  for (int i = kProducers; i < kProducers + kConsumers; ++i) {
+    threads[i] = std::thread([rx = rx.clone(), &sum, &count]() {
+      for (sus::Vec<u64> batch : rx.iter()) {
+        sum.fetch_add(batch[0u].primitive_value);
+        count.fetch_add(1u);
+      }
+    });
+  }
+  { auto drop = sus::move(tx); }
+  { auto drop = sus::move(rx); }
+  for (auto& t : threads) t.join();
+  EXPECT_EQ(u64(count.load()), u64::from(kProducers) * kEach);
+  EXPECT_EQ(u64(sum.load()), u64::from(kProducers) * kEach * (kEach + 1u) / 2u);
+}
+
+TEST(Mpmc, Iterators) {
+  auto [tx, rx] = bounded<i32>(8u);
+  for (i32 i = 0; i < 5; i += 1) EXPECT_TRUE(tx.send(i).is_none());
+  EXPECT_EQ(rx.try_iter().count(), 5u);
+  EXPECT_TRUE(tx.send(1).is_none());
+  { auto drop = sus::move(tx); }
+  EXPECT_EQ(sus::move(rx).into_iter().count(), 1u);
+}
+
+}  // namespace
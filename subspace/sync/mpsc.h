@@ -0,0 +1,442 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/assertions/unreachable.h"
+#include "subspace/iter/iterator.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/option/option.h"
+#include "subspace/result/result.h"
+#include "subspace/sync/__private/array_channel.h"
+#include "subspace/sync/__private/channel.h"
+#include "subspace/sync/__private/channel_iter.h"
+#include "subspace/sync/__private/list_channel.h"
+#include "subspace/tuple/tuple.h"
+
+/// Multi-producer, single-consumer channels, for sending values between
+/// threads.
+///
+/// A channel is made by `channel()`, which is unbounded, or by
+/// `sync_channel()`, which holds at most a fixed number of values. Each
+/// returns a `Sender`, which can be cloned to send from many threads, and a
+/// `Receiver`, which receives the values in the order they were sent.
+///
+/// Values are moved through the channel, so move-only types like `Vec` and
+/// `Box` are sent without copying their contents.
+namespace sus::sync::mpsc {
+
+/// The error returned by `Sender::send()` when the receiving half of the
+/// channel is gone. It holds the value which could not be sent.
+template <class T>
+class SendError final {
+ public:
+  explicit SendError(T value) noexcept : value_(::sus::move(value)) {}
+
+  /// Returns the value which could not be sent.
+  T into_inner() && noexcept { return ::sus::move(value_); }
+
+  std::string to_string() const noexcept {
+    return std::string("sending on a closed channel");
+  }
+
+ private:
+  T value_;
+
+  sus_class_trivially_relocatable_if_types(::sus::marker::unsafe_fn,
+                                           decltype(value_));
+};
+
+/// The error returned by `Sender::try_send()`. It holds the value which could
+/// not be sent.
+template <class T>
+class TrySendError final {
+ public:
+  /// The type of error which occured.
+  enum class Kind {
+    /// The channel is bounded and holds as many values as it can.
+    Full,
+    /// The receiving half of the channel is gone.
+    Disconnected,
+  };
+
+  /// Constructs a TrySendError with a `kind`, holding `value`.
+  TrySendError(Kind kind, T value) noexcept
+      : kind_(kind), value_(::sus::move(value)) {}
+
+  /// Returns the type of error which occured.
+  Kind kind() const noexcept { return kind_; }
+
+  /// Returns the value which could not be sent.
+  T into_inner() && noexcept { return ::sus::move(value_); }
+
+  std::string to_string() const noexcept {
+    switch (kind_) {
+      case Kind::Full: return std::string("sending on a full channel");
+      case Kind::Disconnected:
+        return std::string("sending on a closed channel");
+    }
+    ::sus::unreachable_unchecked(::sus::marker::unsafe_fn);
+  }
+
+ private:
+  Kind kind_;
+  T value_;
+
+  sus_class_trivially_relocatable_if_types(::sus::marker::unsafe_fn,
+                                           decltype(kind_),
+                                           decltype(value_));
+};
+
+/// The error returned by `Receiver::recv()` when the channel is empty and all
+/// of its senders are gone, so no more values can arrive.
+class RecvError final {
+ public:
+  std::string to_string() const noexcept {
+    return std::string("receiving on a closed channel");
+  }
+};
+
+/// The error returned by `Receiver::try_recv()`.
+class TryRecvError final {
+ public:
+  /// The type of error which occured.
+  enum class Kind {
+    /// The channel holds no values right now.
+    Empty,
+    /// The channel holds no values, and all of its senders are gone.
+    Disconnected,
+  };
+
+  /// Constructs a TryRecvError with a `kind`.
+  explicit TryRecvError(Kind kind) noexcept : kind_(kind) {}
+
+  /// Returns the type of error which occured.
+  Kind kind() const noexcept { return kind_; }
+
+  std::string to_string() const noexcept {
+    switch (kind_) {
+      case Kind::Empty: return std::string("receiving on an empty channel");
+      case Kind::Disconnected:
+        return std::string("receiving on a closed channel");
+    }
+    ::sus::unreachable_unchecked(::sus::marker::unsafe_fn);
+  }
+
+ private:
+  Kind kind_;
+};
+
+template <class T>
+class Sender;
+template <class T>
+class Receiver;
+
+template <class T>
+::sus::Tuple<Sender<T>, Receiver<T>> channel() noexcept;
+template <class T>
+::sus::Tuple<Sender<T>, Receiver<T>> sync_channel(usize bound) noexcept;
+
+namespace __private {
+
+using ::sus::sync::__private::ArrayChannel;
+using ::sus::sync::__private::ChannelCounter;
+using ::sus::sync::__private::ListChannel;
+
+/// Which kind of channel a `Sender` or `Receiver` is connected to.
+enum class Flavor : uint8_t {
+  /// The handle holding the pointer was moved from, and has no channel.
+  None,
+  Array,
+  List,
+};
+
+/// A pointer to the shared state of either kind of channel. The `flavor`
+/// says which member of the union is active, and is checked before each
+/// access to it.
+template <class T>
+struct ChannelPtr final {
+  /// Returns whether the pointer is to a channel.
+  bool is_some() const noexcept { return flavor != Flavor::None; }
+
+  /// Calls `f` with the channel, whichever kind it is. The pointer must be to
+  /// a channel.
+  template <class F>
+  decltype(auto) visit(F f) const noexcept {
+    switch (flavor) {
+      case Flavor::Array: return f(array);
+      case Flavor::List: return f(list);
+      case Flavor::None: break;
+    }
+    ::sus::unreachable_unchecked(::sus::marker::unsafe_fn);
+  }
+
+  Flavor flavor;
+  union {
+    ChannelCounter<ArrayChannel<T>>* array;
+    ChannelCounter<ListChannel<T>>* list;
+  };
+};
+
+}  // namespace __private
+
+/// The sending half of a channel.
+///
+/// A `Sender` can be cloned, and the clones sent to other threads, to send
+/// into the same channel from many threads at once. The channel is
+/// disconnected for the `Receiver` once every `Sender` is gone.
+template <class T>
+class [[sus_trivial_abi]] Sender final {
+  static_assert(!std::is_reference_v<T>, "Sender<T&> is not a valid type.");
+
+ public:
+  ~Sender() noexcept {
+    if (chan_.is_some())
+      chan_.visit([](auto* c) { ::sus::sync::__private::release_sender(c); });
+  }
+
+  Sender(Sender&& o) noexcept
+      : chan_(::sus::mem::replace(mref(o.chan_), moved_from_value())) {
+    check(chan_.is_some());
+  }
+  Sender& operator=(Sender&& o) noexcept {
+    check(o.chan_.is_some());
+    if (&o == this) return *this;
+    if (chan_.is_some())
+      chan_.visit([](auto* c) { ::sus::sync::__private::release_sender(c); });
+    chan_ = ::sus::mem::replace(mref(o.chan_), moved_from_value());
+    return *this;
+  }
+
+  /// Returns another `Sender` into the same channel.
+  ///
+  /// sus::mem::Clone trait.
+  Sender clone() const& noexcept {
+    check(chan_.is_some());
+    chan_.visit(
+        [](auto* c) { (void)::sus::sync::__private::acquire_sender(c); });
+    return Sender(chan_);
+  }
+
+  /// Sends `value` into the channel.
+  ///
+  /// If the channel is bounded and full, this blocks until there is room for
+  /// the value.
+  ///
+  /// Returns None once the value is sent, or an error holding the value if
+  /// the `Receiver` is gone. A value which is sent may never be received, if
+  /// the `Receiver` is dropped before receiving it.
+  ::sus::Option<SendError<T>> send(T value) const& noexcept {
+    check(chan_.is_some());
+    const auto status = chan_.visit([&value](auto* c) {
+      return ::sus::sync::__private::channel_send(c->chan, value, true);
+    });
+    if (status == ::sus::sync::__private::ChannelStatus::Ok)
+      return ::sus::Option<SendError<T>>::none();
+    return ::sus::Option<SendError<T>>::some(SendError<T>(::sus::move(value)));
+  }
+
+  /// Sends `value` into the channel if that can be done without blocking.
+  ///
+  /// Returns None once the value is sent, or an error holding the value if
+  /// the channel is bounded and full, or the `Receiver` is gone.
+  ::sus::Option<TrySendError<T>> try_send(T value) const& noexcept {
+    using ::sus::sync::__private::ChannelStatus;
+    check(chan_.is_some());
+    const auto status = chan_.visit([&value](auto* c) {
+      return ::sus::sync::__private::channel_send(c->chan, value, false);
+    });
+    using Kind = typename TrySendError<T>::Kind;
+    switch (status) {
+      case ChannelStatus::Ok: return ::sus::Option<TrySendError<T>>::none();
+      case ChannelStatus::Full:
+        return ::sus::Option<TrySendError<T>>::some(
+            TrySendError<T>(Kind::Full, ::sus::move(value)));
+      default:
+        return ::sus::Option<TrySendError<T>>::some(
+            TrySendError<T>(Kind::Disconnected, ::sus::move(value)));
+    }
+  }
+
+ private:
+  friend ::sus::Tuple<Sender<T>, Receiver<T>> channel<T>() noexcept;
+  friend ::sus::Tuple<Sender<T>, Receiver<T>> sync_channel<T>(usize) noexcept;
+
+  explicit Sender(__private::ChannelPtr<T> chan) noexcept : chan_(chan) {}
+
+  static __private::ChannelPtr<T> moved_from_value() noexcept {
+    return __private::ChannelPtr<T>{.flavor = __private::Flavor::None};
+  }
+
+  __private::ChannelPtr<T> chan_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(chan_));
+};
+
+/// The receiving half of a channel.
+///
+/// There is a single `Receiver` for each channel. It can be moved to another
+/// thread, but it must not be used from more than one thread at a time, which
+/// is why receiving requires a mutable reference.
+///
+/// Besides `recv()` and `try_recv()`, the values can be received through an
+/// `Iterator` from `iter()` or `into_iter()`, which ends once the channel is
+/// empty and disconnected, or from `try_iter()`, which ends once the channel
+/// is empty.
+template <class T>
+class [[sus_trivial_abi]] Receiver final {
+  static_assert(!std::is_reference_v<T>, "Receiver<T&> is not a valid type.");
+
+ public:
+  using Iter = ::sus::sync::__private::RecvIter<Receiver, T>;
+  using TryIter = ::sus::sync::__private::TryRecvIter<Receiver, T>;
+  using IntoIter = ::sus::sync::__private::RecvIntoIter<Receiver, T>;
+
+  ~Receiver() noexcept {
+    if (chan_.is_some()) {
+      chan_.visit(
+          [](auto* c) { ::sus::sync::__private::release_receiver(c); });
+    }
+  }
+
+  Receiver(Receiver&& o) noexcept
+      : chan_(::sus::mem::replace(mref(o.chan_), moved_from_value())) {
+    check(chan_.is_some());
+  }
+  Receiver& operator=(Receiver&& o) noexcept {
+    check(o.chan_.is_some());
+    if (&o == this) return *this;
+    if (chan_.is_some()) {
+      chan_.visit(
+          [](auto* c) { ::sus::sync::__private::release_receiver(c); });
+    }
+    chan_ = ::sus::mem::replace(mref(o.chan_), moved_from_value());
+    return *this;
+  }
+
+  /// Receives the next value from the channel, blocking until one is sent.
+  ///
+  /// Returns an error once the channel is empty and every `Sender` is gone.
+  /// Values sent before the last `Sender` was dropped are all received first.
+  ::sus::result::Result<T, RecvError> recv() & noexcept {
+    using R = ::sus::result::Result<T, RecvError>;
+    check(chan_.is_some());
+    auto status = ::sus::sync::__private::ChannelStatus::Ok;
+    auto out = chan_.visit([&status](auto* c) {
+      return ::sus::sync::__private::channel_recv(c->chan, status, true);
+    });
+    if (status == ::sus::sync::__private::ChannelStatus::Ok)
+      return R::with(::sus::move(out).unwrap());
+    return R::with_err(RecvError());
+  }
+
+  /// Receives the next value from the channel if there is one, without
+  /// blocking.
+  ::sus::result::Result<T, TryRecvError> try_recv() & noexcept {
+    using R = ::sus::result::Result<T, TryRecvError>;
+    using ::sus::sync::__private::ChannelStatus;
+    check(chan_.is_some());
+    auto status = ChannelStatus::Ok;
+    auto out = chan_.visit([&status](auto* c) {
+      return ::sus::sync::__private::channel_recv(c->chan, status, false);
+    });
+    switch (status) {
+      case ChannelStatus::Ok: return R::with(::sus::move(out).unwrap());
+      case ChannelStatus::Empty:
+        return R::with_err(TryRecvError(TryRecvError::Kind::Empty));
+      default:
+        return R::with_err(TryRecvError(TryRecvError::Kind::Disconnected));
+    }
+  }
+
+  /// Returns an iterator which receives values, blocking for each one, until
+  /// the channel is empty and every `Sender` is gone.
+  Iter iter() & noexcept {
+    check(chan_.is_some());
+    return Iter::with(*this);
+  }
+
+  /// Returns an iterator which receives the values already in the channel,
+  /// without blocking, and ends once it is empty.
+  TryIter try_iter() & noexcept {
+    check(chan_.is_some());
+    return TryIter::with(*this);
+  }
+
+  /// Consumes the `Receiver` into an iterator which receives values, blocking
+  /// for each one, until the channel is empty and every `Sender` is gone.
+  IntoIter into_iter() && noexcept {
+    check(chan_.is_some());
+    return IntoIter::with(::sus::move(*this));
+  }
+
+ private:
+  friend ::sus::Tuple<Sender<T>, Receiver<T>> channel<T>() noexcept;
+  friend ::sus::Tuple<Sender<T>, Receiver<T>> sync_channel<T>(usize) noexcept;
+
+  explicit Receiver(__private::ChannelPtr<T> chan) noexcept : chan_(chan) {}
+
+  static __private::ChannelPtr<T> moved_from_value() noexcept {
+    return __private::ChannelPtr<T>{.flavor = __private::Flavor::None};
+  }
+
+  __private::ChannelPtr<T> chan_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(chan_));
+};
+
+/// Creates an unbounded channel, returning its `Sender` and `Receiver`.
+///
+/// Sending never blocks. The values are held in a linked list of blocks, each
+/// of which holds many values, so that sending rarely allocates.
+template <class T>
+::sus::Tuple<Sender<T>, Receiver<T>> channel() noexcept {
+  using Counter = __private::ChannelCounter<__private::ListChannel<T>>;
+  auto p = __private::ChannelPtr<T>{.flavor = __private::Flavor::List};
+  p.list = new Counter();
+  return ::sus::Tuple<Sender<T>, Receiver<T>>::with(Sender<T>(p),
+                                                    Receiver<T>(p));
+}
+
+/// Creates a bounded channel, which holds up to `bound` values, returning its
+/// `Sender` and `Receiver`.
+///
+/// Sending blocks while the channel is full. The values are held in a ring
+/// buffer which is allocated up front, so sending and receiving never
+/// allocate.
+///
+/// # Panics
+/// Panics if `bound` is zero. Rendezvous channels are not supported.
+template <class T>
+::sus::Tuple<Sender<T>, Receiver<T>> sync_channel(usize bound) noexcept {
+  check(bound > 0u);
+  using Counter = __private::ChannelCounter<__private::ArrayChannel<T>>;
+  auto p = __private::ChannelPtr<T>{.flavor = __private::Flavor::Array};
+  p.array = new Counter(bound.primitive_value);
+  return ::sus::Tuple<Sender<T>, Receiver<T>>::with(Sender<T>(p),
+                                                    Receiver<T>(p));
+}
+
+}  // namespace sus::sync::mpsc
@@ -0,0 +1,195 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/sync/mpsc.h"
+
+#include <thread>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/boxed/box.h"
+#include "subspace/containers/vec.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::sync::mpsc::channel;
+using sus::sync::mpsc::sync_channel;
+using sus::sync::mpsc::TryRecvError;
+using sus::sync::mpsc::TrySendError;
+
+TEST(Mpsc, SendRecv) {
+  auto [tx, rx] = channel<i32>();
+  // Moving into itself does nothing.
+  auto& tx_self = tx;
+  tx = sus::move(tx_self);
+  auto& rx_self = rx;
+  rx = sus::move(rx_self);
+  EXPECT_TRUE(tx.send(1).is_none());
+  EXPECT_TRUE(tx.send(2).is_none());
+  EXPECT_EQ(rx.recv().unwrap(), 1_i32);
+  EXPECT_EQ(rx.recv().unwrap(), 2_i32);
+}
+
+TEST(Mpsc, ManyBlocks) {
+  // Crosses many of the unbounded channel's blocks.
+  auto [tx, rx] = channel<u32>();
+  for (u32 i = 0u; i < 1000u; i += 1u) EXPECT_TRUE(tx.send(i).is_none());
+  for (u32 i = 0u; i < 1000u; i += 1u) EXPECT_EQ(rx.recv().unwrap(), i);
+  EXPECT_EQ(rx.try_recv().unwrap_err().kind(), TryRecvError::Kind::Empty);
+}
+
+TEST(Mpsc, TryRecv) {
+  auto [tx, rx] = channel<i32>();
+  EXPECT_EQ(rx.try_recv().unwrap_err().kind(), TryRecvError::Kind::Empty);
+  EXPECT_TRUE(tx.send(3).is_none());
+  EXPECT_EQ(rx.try_recv().unwrap(), 3_i32);
+  EXPECT_TRUE(tx.send(4).is_none());
+  { auto drop = sus::move(tx); }
+  // Values sent before the disconnect are received first.
+  EXPECT_EQ(rx.try_recv().unwrap(), 4_i32);
+  EXPECT_EQ(rx.try_recv().unwrap_err().kind(),
+            TryRecvError::Kind::Disconnected);
+  EXPECT_TRUE(rx.recv().is_err());
+}
+
+TEST(Mpsc, SendToDroppedReceiver) {
+  auto [tx, rx] = channel<sus::Vec<i32>>();
+  { auto drop = sus::move(rx); }
+  auto v = sus::Vec<i32>();
+  v.push(7);
+  auto err = tx.send(sus::move(v));
+  ASSERT_TRUE(err.is_some());
+  sus::Vec<i32> back = sus::move(err).unwrap().into_inner();
+  EXPECT_EQ(back[0u], 7_i32);
+}
+
+TEST(Mpsc, MoveOnly) {
+  auto [tx, rx] = channel<sus::Vec<i32>>();
+  auto v = sus::Vec<i32>();
+  v.push(1);
+  v.push(2);
+  const i32* data = v.as_ptr();
+  EXPECT_TRUE(tx.send(sus::move(v)).is_none());
+  sus::Vec<i32> got = rx.recv().unwrap();
+  // The heap buffer was moved through the channel, not copied.
+  EXPECT_EQ(got.as_ptr(), data);
+  EXPECT_EQ(got.len(), 2u);
+
+  auto [btx, brx] = sync_channel<sus::Box<i32>>(2u);
+  EXPECT_TRUE(btx.send(sus::Box<i32>::with(5)).is_none());
+  sus::Box<i32> b = brx.recv().unwrap();
+  EXPECT_EQ(*b, 5_i32);
+}
+
+TEST(Mpsc, SyncChannel) {
+  auto [tx, rx] = sync_channel<i32>(2u);
+  EXPECT_TRUE(tx.try_send(1).is_none());
+  EXPECT_TRUE(tx.try_send(2).is_none());
+  auto full = tx.try_send(3);
+  ASSERT_TRUE(full.is_some());
+  EXPECT_EQ(full.as_ref().unwrap().kind(), TrySendError<i32>::Kind::Full);
+  EXPECT_EQ(sus::move(full).unwrap().into_inner(), 3_i32);
+
+  EXPECT_EQ(rx.recv().unwrap(), 1_i32);
+  EXPECT_TRUE(tx.try_send(3).is_none());
+  EXPECT_EQ(rx.recv().unwrap(), 2_i32);
+  EXPECT_EQ(rx.recv().unwrap(), 3_i32);
+
+  { auto drop = sus::move(rx); }
+  EXPECT_EQ(tx.try_send(4).unwrap().kind(),
+            TrySendError<i32>::Kind::Disconnected);
+}
+
+TEST(Mpsc, SyncChannelBlocks) {
+  auto [tx, rx] = sync_channel<u32>(1u);
+  auto t = std::thread([tx = sus::move(tx)]() {
+    for (u32 i = 0u; i < 1000u; i += 1u) EXPECT_TRUE(tx.send(i).is_none());
+  });
+  for (u32 i = 0u; i < 1000u; i += 1u) EXPECT_EQ(rx.recv().unwrap(), i);
+  t.join();
+  EXPECT_TRUE(rx.recv().is_err());
+}
+
+TEST(Mpsc, ManySenders) {
+  for (bool bounded : {false, true}) {
+    auto [tx, rx] = bounded ? sync_channel<u64>(16u) : channel<u64>();
+    constexpr int kThreads = 4;
+    constexpr u64 kEach = 5000u;
+    std::thread threads[kThreads];
+    for (int i = 0; i < kThreads; ++i) {
+      threads[i] = std::thread([tx = tx.clone(), kEach]() {
+        for (u64 j = 1u; j <= kEach; j += 1u) EXPECT_TRUE(tx.send(j).is_none());
+      });
+    }
+    { auto drop = sus::move(tx); }
+    u64 sum = 0u;
+    usize count = 0u;
+    for (u64 x : rx.iter()) {
+      sum += x;
+      count += 1u;
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(count, usize::from(kThreads) * usize::from(kEach));
+    EXPECT_EQ(sum, u64::from(kThreads) * kEach * (kEach + 1u) / 2u);
+  }
+}
+
+TEST(Mpsc, Iterators) {
+  auto [tx, rx] = channel<i32>();
+  for (i32 i = 0; i < 5; i += 1) EXPECT_TRUE(tx.send(i).is_none());
+  EXPECT_EQ(rx.try_iter().count(), 5u);
+  EXPECT_EQ(rx.try_iter().count(), 0u);
+
+  for (i32 i = 0; i < 5; i += 1) EXPECT_TRUE(tx.send(i).is_none());
+  { auto drop = sus::move(tx); }
+  auto v = sus::move(rx).into_iter().collect<sus::Vec<i32>>();
+  ASSERT_EQ(v.len(), 5u);
+  EXPECT_EQ(v[4u], 4_i32);
+}
+
+TEST(Mpsc, DropsUnreceived) {
+  static int destroyed;
+  struct S {
+    S() = default;
+    S(S&& o) : live(sus::mem::replace(mref(o.live), false)) {}
+    S& operator=(S&&) = delete;
+    ~S() {
+      if (live) destroyed += 1;
+    }
+    bool live = true;
+  };
+  destroyed = 0;
+  {
+    auto [tx, rx] = channel<S>();
+    for (int i = 0; i < 40; ++i) EXPECT_TRUE(tx.send(S()).is_none());
+    (void)rx.recv();
+  }
+  EXPECT_EQ(destroyed, 40);
+
+  destroyed = 0;
+  {
+    auto [tx, rx] = sync_channel<S>(8u);
+    for (int i = 0; i < 8; ++i) EXPECT_TRUE(tx.send(S()).is_none());
+    (void)rx.recv();
+  }
+  EXPECT_EQ(destroyed, 8);
+}
+
+TEST(MpscDeathTest, SyncChannelZero) {
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH((void)sync_channel<i32>(0u), "");
+#endif
+}
+
+}  // namespace
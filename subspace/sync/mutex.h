@@ -0,0 +1,164 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/option/option.h"
+#include "subspace/sync/__private/raw_mutex.h"
+
+namespace sus::sync {
+
+template <class T>
+class Mutex;
+
+/// Holds the lock of a `Mutex` and gives access to the value it protects. The
+/// lock is released when the guard is destroyed.
+///
+/// A guard is returned by `Mutex::lock()` or `Mutex::try_lock()`.
+template <class T>
+class [[nodiscard]] [[sus_trivial_abi]] MutexGuard final {
+ public:
+  MutexGuard(MutexGuard&& o) noexcept
+      : mutex_(::sus::mem::replace_ptr(mref(o.mutex_), nullptr)) {
+    check(mutex_ != nullptr);
+  }
+  MutexGuard& operator=(MutexGuard&& o) noexcept {
+    check(o.mutex_ != nullptr);
+    if (&o == this) return *this;
+    if (mutex_ != nullptr) mutex_->raw_.unlock();
+    mutex_ = ::sus::mem::replace_ptr(mref(o.mutex_), nullptr);
+    return *this;
+  }
+
+  ~MutexGuard() noexcept {
+    if (mutex_ != nullptr) mutex_->raw_.unlock();
+  }
+
+  /// Returns a const reference to the value protected by the mutex.
+  const T& as_ref() const& noexcept {
+    check(mutex_ != nullptr);
+    return mutex_->value_;
+  }
+  const T& as_ref() && = delete;
+  /// Returns a mutable reference to the value protected by the mutex.
+  T& as_mut() & noexcept {
+    check(mutex_ != nullptr);
+    return mutex_->value_;
+  }
+
+  // The operators can be used on a temporary guard, as in `*m.lock() += 1`,
+  // where the lock is held until the end of the full expression.
+  const T& operator*() const& noexcept { return as_ref(); }
+  T& operator*() & noexcept { return as_mut(); }
+  T& operator*() && noexcept { return as_mut(); }
+
+  const T* operator->() const& noexcept { return &as_ref(); }
+  T* operator->() & noexcept { return &as_mut(); }
+  T* operator->() && noexcept { return &as_mut(); }
+
+ private:
+  friend class Mutex<T>;
+
+  explicit MutexGuard(const Mutex<T>& mutex) noexcept : mutex_(&mutex) {}
+
+  const Mutex<T>* mutex_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn,
+                                  decltype(mutex_));
+};
+
+/// A mutual exclusion lock which owns the data it protects.
+///
+/// The data can only be reached through the `MutexGuard` returned by
+/// `lock()`, so it can't be accessed without holding the lock. The lock can be
+/// taken through a const reference, as the `Mutex` is shared between threads,
+/// such as through a `sus::sync::Arc`.
+///
+/// The lock is a single 32-bit futex word, so a `Mutex` is 4 bytes larger than
+/// `T`, before alignment, and it never allocates. Locking a contended mutex
+/// spins briefly before parking the thread in the kernel, and unlocking only
+/// makes a syscall if a thread is parked.
+///
+/// As panics terminate the program, there is no lock poisoning.
+template <class T>
+class Mutex final {
+ public:
+  /// Constructs a `Mutex` holding the default value of `T`.
+  ///
+  /// sus::construct::Default trait.
+  Mutex() noexcept
+    requires(std::is_default_constructible_v<T>)
+      : value_() {}
+
+  /// Constructs a `Mutex` holding `value`.
+  static Mutex with(T value) noexcept
+    requires(std::is_move_constructible_v<T>)
+  {
+    return Mutex(::sus::move(value));
+  }
+
+  Mutex(const Mutex&) = delete;
+  Mutex& operator=(const Mutex&) = delete;
+
+  /// Takes the lock, blocking the current thread until it is available, and
+  /// returns a guard which gives access to the value.
+  ///
+  /// Locking a mutex again from the thread which already holds the lock will
+  /// deadlock.
+  MutexGuard<T> lock() const& noexcept {
+    raw_.lock();
+    return MutexGuard<T>(*this);
+  }
+  MutexGuard<T> lock() && = delete;
+
+  /// Takes the lock if it is available without blocking, and returns a guard
+  /// which gives access to the value. Returns None if the lock is held.
+  ::sus::Option<MutexGuard<T>> try_lock() const& noexcept {
+    if (raw_.try_lock())
+      return ::sus::Option<MutexGuard<T>>::some(MutexGuard<T>(*this));
+    return ::sus::Option<MutexGuard<T>>::none();
+  }
+  ::sus::Option<MutexGuard<T>> try_lock() && = delete;
+
+  /// Returns a mutable reference to the value.
+  ///
+  /// As this requires a mutable reference to the `Mutex`, no other thread can
+  /// be using it, and no locking is needed.
+  T& get_mut() & noexcept { return value_; }
+
+  /// Consumes the `Mutex`, returning the value.
+  T into_inner() && noexcept
+    requires(std::is_move_constructible_v<T>)
+  {
+    return ::sus::move(value_);
+  }
+
+ private:
+  friend class MutexGuard<T>;
+
+  explicit Mutex(T&& value) noexcept : value_(::sus::move(value)) {}
+
+  __private::RawMutex raw_;
+  mutable T value_;
+};
+
+}  // namespace sus::sync
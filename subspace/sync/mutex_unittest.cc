@@ -0,0 +1,114 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/sync/mutex.h"
+
+#include <thread>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::sync::Mutex;
+using sus::sync::MutexGuard;
+
+static_assert(sizeof(Mutex<u32>) == 8u);
+static_assert(sizeof(Mutex<u8>) == 8u);
+static_assert(sizeof(MutexGuard<u32>) == sizeof(void*));
+
+TEST(Mutex, Lock) {
+  auto m = Mutex<i32>::with(3);
+  {
+    auto g = m.lock();
+    EXPECT_EQ(*g, 3_i32);
+    *g += 1;
+    EXPECT_EQ(g.as_ref(), 4_i32);
+  }
+  EXPECT_EQ(*m.lock(), 4_i32);
+
+  auto d = Mutex<i32>();
+  EXPECT_EQ(*d.lock(), 0_i32);
+}
+
+TEST(Mutex, TryLock) {
+  auto m = Mutex<i32>::with(3);
+  {
+    auto g = m.lock();
+    EXPECT_TRUE(m.try_lock().is_none());
+  }
+  auto o = m.try_lock();
+  ASSERT_TRUE(o.is_some());
+  EXPECT_EQ(o.as_ref().unwrap().as_ref(), 3_i32);
+  EXPECT_TRUE(m.try_lock().is_none());
+  o = sus::none();
+  EXPECT_TRUE(m.try_lock().is_some());
+}
+
+TEST(Mutex, MoveGuard) {
+  auto m = Mutex<i32>::with(3);
+  auto g = m.lock();
+  auto g2 = sus::move(g);
+  *g2 = 5;
+  // Moving into itself does nothing.
+  auto& self = g2;
+  g2 = sus::move(self);
+  EXPECT_TRUE(m.try_lock().is_none());
+  {
+    auto g3 = sus::move(g2);
+    EXPECT_EQ(*g3, 5_i32);
+  }
+  // Only the last guard unlocks.
+  EXPECT_TRUE(m.try_lock().is_some());
+}
+
+TEST(Mutex, Arrow) {
+  struct S {
+    i32 i;
+  };
+  auto m = Mutex<S>::with(S(2));
+  auto g = m.lock();
+  g->i += 1;
+  EXPECT_EQ(g->i, 3_i32);
+  const auto& cg = g;
+  EXPECT_EQ(cg->i, 3_i32);
+}
+
+TEST(Mutex, GetMutIntoInner) {
+  auto m = Mutex<sus::Vec<i32>>();
+  m.get_mut().push(1);
+  m.lock()->push(2);
+  sus::Vec<i32> v = sus::move(m).into_inner();
+  ASSERT_EQ(v.len(), 2u);
+  EXPECT_EQ(v[0u], 1_i32);
+  EXPECT_EQ(v[1u], 2_i32);
+}
+
+TEST(Mutex, Contended) {
+  auto m = Mutex<u64>::with(0u);
+  // Not atomic, so lost updates would show up if the lock failed to exclude.
+  constexpr int kThreads = 4;
+  constexpr int kIncrements = 20000;
+  std::thread threads[kThreads];
+  for (auto& t : threads) {
+    t = std::thread([&m]() {
+      for (int i = 0; i < kIncrements; ++i) *m.lock() += 1u;
+    });
+  }
+  for (auto& t : threads) t.join();
+  EXPECT_EQ(*m.lock(), u64::from(kThreads * kIncrements));
+}
+
+}  // namespace
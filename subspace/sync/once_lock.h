@@ -0,0 +1,140 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <new>
+#include <type_traits>
+
+#include "subspace/mem/move.h"
+#include "subspace/option/option.h"
+#include "subspace/sync/__private/raw_once.h"
+
+namespace sus::sync {
+
+/// A value which is written at most once, and can be read from many threads.
+///
+/// The value is set by `get_or_init()` or `set()`, and whichever thread gets
+/// there first initializes it, while other threads wait for it. Once it is
+/// set, reading it through `get()` or `get_or_init()` costs a single acquire
+/// load.
+///
+/// The constructor is constexpr, so a `OnceLock` at namespace scope is
+/// constant-initialized, and can be used from the constructors of other
+/// globals without concern for the order of static initialization.
+///
+/// The value is stored inline, and no allocation is made.
+template <class T>
+class OnceLock final {
+  static_assert(!std::is_reference_v<T>, "OnceLock<T&> is not a valid type.");
+
+ public:
+  /// Constructs an empty `OnceLock`.
+  ///
+  /// sus::construct::Default trait.
+  constexpr OnceLock() noexcept : no_value_() {}
+
+  ~OnceLock() noexcept {
+    if (once_.is_completed()) value_.~T();
+  }
+
+  OnceLock(const OnceLock&) = delete;
+  OnceLock& operator=(const OnceLock&) = delete;
+
+  /// Returns a reference to the value if it has been set, or None if it has
+  /// not, or if another thread is setting it right now.
+  ::sus::Option<const T&> get() const& noexcept {
+    if (once_.is_completed())
+      return ::sus::Option<const T&>::some(value_);
+    return ::sus::Option<const T&>::none();
+  }
+  ::sus::Option<const T&> get() && = delete;
+
+  /// Returns a mutable reference to the value if it has been set.
+  ///
+  /// As this requires a mutable reference to the `OnceLock`, no other thread
+  /// can be using it.
+  ::sus::Option<T&> get_mut() & noexcept {
+    if (once_.is_completed()) return ::sus::Option<T&>::some(value_);
+    return ::sus::Option<T&>::none();
+  }
+
+  /// Sets the value to `value` if it is not set yet, and returns None. If the
+  /// value was already set, `value` is returned back inside an Option.
+  ///
+  /// If another thread is setting the value, this blocks until it is done.
+  ::sus::Option<T> set(T value) const& noexcept {
+    bool was_set = false;
+    (void)get_or_init([&value, &was_set]() {
+      was_set = true;
+      return ::sus::move(value);
+    });
+    if (was_set) return ::sus::Option<T>::none();
+    return ::sus::Option<T>::some(::sus::move(value));
+  }
+
+  /// Returns a reference to the value, setting it to the result of `f` first
+  /// if it is not set yet.
+  ///
+  /// If many threads call this at once, only one of them calls its `f`, and
+  /// the others wait for it to finish. The `f` may be any callable, including
+  /// a `sus::fn::FnOnce<T()>`, and is called at most once.
+  ///
+  /// Calling `get_or_init()` on the same `OnceLock` from inside `f` will
+  /// deadlock.
+  template <class F>
+    requires(std::is_invocable_r_v<T, F &&>)
+  const T& get_or_init(F f) const& noexcept {
+    if (!once_.is_completed()) [[unlikely]]
+      initialize(f);
+    return value_;
+  }
+  template <class F>
+    requires(std::is_invocable_r_v<T, F &&>)
+  const T& get_or_init(F f) && = delete;
+
+  /// Takes the value out of the `OnceLock`, leaving it empty.
+  ///
+  /// As this requires a mutable reference to the `OnceLock`, no other thread
+  /// can be using it.
+  ::sus::Option<T> take() & noexcept {
+    if (!once_.is_completed()) return ::sus::Option<T>::none();
+    once_.reset();
+    auto o = ::sus::Option<T>::some(::sus::move(value_));
+    value_.~T();
+    return o;
+  }
+
+  /// Consumes the `OnceLock`, returning the value if it was set.
+  ::sus::Option<T> into_inner() && noexcept { return take(); }
+
+ private:
+  template <class F>
+  void initialize(F& f) const noexcept {
+    auto init = [this, &f]() { new (&value_) T(::sus::move(f)()); };
+    once_.call_once(init);
+  }
+
+  __private::RawOnce once_;
+  // The value is constructed by the thread which runs `once_`, and is only
+  // read once `once_` has completed. It is not held in an `Option`, as an
+  // `Option` can't be constant-initialized for every `T`, while a union with
+  // a trivial member active can.
+  union {
+    char no_value_;
+    mutable T value_;
+  };
+};
+
+}  // namespace sus::sync
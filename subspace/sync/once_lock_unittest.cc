@@ -0,0 +1,93 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/sync/once_lock.h"
+
+#include <atomic>
+#include <thread>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/fn/fn.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::sync::OnceLock;
+
+constinit OnceLock<sus::Vec<i32>> global_lock;
+
+TEST(OnceLock, GetOrInit) {
+  auto l = OnceLock<i32>();
+  EXPECT_TRUE(l.get().is_none());
+  EXPECT_EQ(l.get_or_init([]() { return 3_i32; }), 3_i32);
+  EXPECT_EQ(l.get_or_init([]() { return 4_i32; }), 3_i32);
+  EXPECT_EQ(l.get().unwrap(), 3_i32);
+}
+
+TEST(OnceLock, Global) {
+  const sus::Vec<i32>& v = global_lock.get_or_init([]() {
+    auto v = sus::Vec<i32>();
+    v.push(1);
+    return v;
+  });
+  EXPECT_EQ(v.len(), 1u);
+  EXPECT_EQ(&global_lock.get().unwrap(), &v);
+}
+
+TEST(OnceLock, FnOnce) {
+  auto l = OnceLock<i32>();
+  auto f = sus::fn::FnOnce<i32()>::from([]() { return 5_i32; });
+  EXPECT_EQ(l.get_or_init(sus::move(f)), 5_i32);
+}
+
+TEST(OnceLock, Set) {
+  auto l = OnceLock<i32>();
+  EXPECT_TRUE(l.set(1).is_none());
+  EXPECT_EQ(l.set(2).unwrap(), 2_i32);
+  EXPECT_EQ(l.get().unwrap(), 1_i32);
+}
+
+TEST(OnceLock, TakeIntoInner) {
+  auto l = OnceLock<i32>();
+  EXPECT_TRUE(l.take().is_none());
+  (void)l.get_or_init([]() { return 3_i32; });
+  l.get_mut().unwrap() += 1;
+  EXPECT_EQ(l.take().unwrap(), 4_i32);
+  EXPECT_TRUE(l.get().is_none());
+  EXPECT_EQ(l.get_or_init([]() { return 5_i32; }), 5_i32);
+  EXPECT_EQ(sus::move(l).into_inner().unwrap(), 5_i32);
+}
+
+TEST(OnceLock, Threads) {
+  auto l = OnceLock<u64>();
+  std::atomic<int> calls = 0;
+  constexpr int kThreads = 8;
+  std::thread threads[kThreads];
+  for (auto& t : threads) {
+    t = std::thread([&l, &calls]() {
+      const u64& v = l.get_or_init([&calls]() {
+        calls.fetch_add(1);
+        // Give other threads time to find the value being initialized.
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return 42_u64;
+      });
+      EXPECT_EQ(v, 42_u64);
+    });
+  }
+  for (auto& t : threads) t.join();
+  EXPECT_EQ(calls.load(), 1);
+}
+
+}  // namespace
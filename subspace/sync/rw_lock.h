@@ -0,0 +1,237 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/option/option.h"
+#include "subspace/sync/__private/raw_rw_lock.h"
+
+namespace sus::sync {
+
+template <class T>
+class RwLock;
+
+/// Holds a shared read lock of a `RwLock` and gives const access to the value
+/// it protects. The lock is released when the guard is destroyed.
+///
+/// A guard is returned by `RwLock::read()` or `RwLock::try_read()`.
+template <class T>
+class [[nodiscard]] [[sus_trivial_abi]] RwLockReadGuard final {
+ public:
+  RwLockReadGuard(RwLockReadGuard&& o) noexcept
+      : lock_(::sus::mem::replace_ptr(mref(o.lock_), nullptr)) {
+    check(lock_ != nullptr);
+  }
+  RwLockReadGuard& operator=(RwLockReadGuard&& o) noexcept {
+    check(o.lock_ != nullptr);
+    if (&o == this) return *this;
+    if (lock_ != nullptr) lock_->raw_.read_unlock();
+    lock_ = ::sus::mem::replace_ptr(mref(o.lock_), nullptr);
+    return *this;
+  }
+
+  ~RwLockReadGuard() noexcept {
+    if (lock_ != nullptr) lock_->raw_.read_unlock();
+  }
+
+  /// Returns a const reference to the value protected by the lock.
+  const T& as_ref() const& noexcept {
+    check(lock_ != nullptr);
+    return lock_->value_;
+  }
+  const T& as_ref() && = delete;
+
+  // The operators can be used on a temporary guard, as in `l.read()->len()`,
+  // where the lock is held until the end of the full expression.
+  const T& operator*() const noexcept { return as_ref(); }
+  const T* operator->() const noexcept { return &as_ref(); }
+
+ private:
+  friend class RwLock<T>;
+
+  explicit RwLockReadGuard(const RwLock<T>& lock) noexcept : lock_(&lock) {}
+
+  const RwLock<T>* lock_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(lock_));
+};
+
+/// Holds the exclusive write lock of a `RwLock` and gives mutable access to
+/// the value it protects. The lock is released when the guard is destroyed.
+///
+/// A guard is returned by `RwLock::write()` or `RwLock::try_write()`.
+template <class T>
+class [[nodiscard]] [[sus_trivial_abi]] RwLockWriteGuard final {
+ public:
+  RwLockWriteGuard(RwLockWriteGuard&& o) noexcept
+      : lock_(::sus::mem::replace_ptr(mref(o.lock_), nullptr)) {
+    check(lock_ != nullptr);
+  }
+  RwLockWriteGuard& operator=(RwLockWriteGuard&& o) noexcept {
+    check(o.lock_ != nullptr);
+    if (&o == this) return *this;
+    if (lock_ != nullptr) lock_->raw_.write_unlock();
+    lock_ = ::sus::mem::replace_ptr(mref(o.lock_), nullptr);
+    return *this;
+  }
+
+  ~RwLockWriteGuard() noexcept {
+    if (lock_ != nullptr) lock_->raw_.write_unlock();
+  }
+
+  /// Returns a const reference to the value protected by the lock.
+  const T& as_ref() const& noexcept {
+    check(lock_ != nullptr);
+    return lock_->value_;
+  }
+  const T& as_ref() && = delete;
+  /// Returns a mutable reference to the value protected by the lock.
+  T& as_mut() & noexcept {
+    check(lock_ != nullptr);
+    return lock_->value_;
+  }
+
+  // The operators can be used on a temporary guard, as in `*l.write() += 1`,
+  // where the lock is held until the end of the full expression.
+  const T& operator*() const& noexcept { return as_ref(); }
+  T& operator*() & noexcept { return as_mut(); }
+  T& operator*() && noexcept { return as_mut(); }
+
+  const T* operator->() const& noexcept { return &as_ref(); }
+  T* operator->() & noexcept { return &as_mut(); }
+  T* operator->() && noexcept { return &as_mut(); }
+
+ private:
+  friend class RwLock<T>;
+
+  explicit RwLockWriteGuard(const RwLock<T>& lock) noexcept : lock_(&lock) {}
+
+  const RwLock<T>* lock_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(lock_));
+};
+
+/// A reader-writer lock which owns the data it protects.
+///
+/// Any number of readers may hold the lock at once with `read()`, which gives
+/// const access to the value, or a single writer may hold it with `write()`,
+/// which gives mutable access. The lock can be taken through a const
+/// reference, as the `RwLock` is shared between threads.
+///
+/// Waiting writers are preferred over new readers, so that writers are not
+/// starved when there are many readers.
+///
+/// The lock is made of two 32-bit futex words, so a `RwLock` is 8 bytes larger
+/// than `T`, before alignment, and it never allocates. Contended locking spins
+/// briefly before parking the thread in the kernel.
+///
+/// As panics terminate the program, there is no lock poisoning.
+template <class T>
+class RwLock final {
+ public:
+  /// Constructs a `RwLock` holding the default value of `T`.
+  ///
+  /// sus::construct::Default trait.
+  RwLock() noexcept
+    requires(std::is_default_constructible_v<T>)
+      : value_() {}
+
+  /// Constructs a `RwLock` holding `value`.
+  static RwLock with(T value) noexcept
+    requires(std::is_move_constructible_v<T>)
+  {
+    return RwLock(::sus::move(value));
+  }
+
+  RwLock(const RwLock&) = delete;
+  RwLock& operator=(const RwLock&) = delete;
+
+  /// Takes a shared read lock, blocking the current thread until it is
+  /// available, and returns a guard which gives const access to the value.
+  ///
+  /// Taking a read lock from a thread which already holds one may deadlock,
+  /// if a writer is waiting in between.
+  ///
+  /// # Panics
+  /// Panics if the lock is held by too many readers (about 2^30).
+  RwLockReadGuard<T> read() const& noexcept {
+    raw_.read();
+    return RwLockReadGuard<T>(*this);
+  }
+  RwLockReadGuard<T> read() && = delete;
+
+  /// Takes a shared read lock if it is available without blocking, and
+  /// returns a guard which gives const access to the value. Returns None if a
+  /// writer holds or is waiting for the lock.
+  ::sus::Option<RwLockReadGuard<T>> try_read() const& noexcept {
+    if (raw_.try_read()) {
+      return ::sus::Option<RwLockReadGuard<T>>::some(
+          RwLockReadGuard<T>(*this));
+    }
+    return ::sus::Option<RwLockReadGuard<T>>::none();
+  }
+  ::sus::Option<RwLockReadGuard<T>> try_read() && = delete;
+
+  /// Takes the exclusive write lock, blocking the current thread until it is
+  /// available, and returns a guard which gives mutable access to the value.
+  RwLockWriteGuard<T> write() const& noexcept {
+    raw_.write();
+    return RwLockWriteGuard<T>(*this);
+  }
+  RwLockWriteGuard<T> write() && = delete;
+
+  /// Takes the exclusive write lock if it is available without blocking, and
+  /// returns a guard which gives mutable access to the value. Returns None if
+  /// the lock is held.
+  ::sus::Option<RwLockWriteGuard<T>> try_write() const& noexcept {
+    if (raw_.try_write()) {
+      return ::sus::Option<RwLockWriteGuard<T>>::some(
+          RwLockWriteGuard<T>(*this));
+    }
+    return ::sus::Option<RwLockWriteGuard<T>>::none();
+  }
+  ::sus::Option<RwLockWriteGuard<T>> try_write() && = delete;
+
+  /// Returns a mutable reference to the value.
+  ///
+  /// As this requires a mutable reference to the `RwLock`, no other thread
+  /// can be using it, and no locking is needed.
+  T& get_mut() & noexcept { return value_; }
+
+  /// Consumes the `RwLock`, returning the value.
+  T into_inner() && noexcept
+    requires(std::is_move_constructible_v<T>)
+  {
+    return ::sus::move(value_);
+  }
+
+ private:
+  friend class RwLockReadGuard<T>;
+  friend class RwLockWriteGuard<T>;
+
+  explicit RwLock(T&& value) noexcept : value_(::sus::move(value)) {}
+
+  __private::RawRwLock raw_;
+  mutable T value_;
+};
+
+}  // namespace sus::sync
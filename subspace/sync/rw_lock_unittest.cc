@@ -0,0 +1,135 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/sync/rw_lock.h"
+
+#include <atomic>
+#include <thread>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/prelude.h"
+
+namespace {
+
+using sus::sync::RwLock;
+
+static_assert(sizeof(RwLock<u32>) == 12u);
+static_assert(sizeof(RwLock<u64>) == 16u);
+
+TEST(RwLock, ReadWrite) {
+  auto l = RwLock<i32>::with(3);
+  {
+    auto r1 = l.read();
+    auto r2 = l.read();
+    EXPECT_EQ(*r1, 3_i32);
+    EXPECT_EQ(r2.as_ref(), 3_i32);
+  }
+  {
+    auto w = l.write();
+    *w += 1;
+    EXPECT_EQ(w.as_ref(), 4_i32);
+  }
+  EXPECT_EQ(*l.read(), 4_i32);
+
+  auto d = RwLock<i32>();
+  EXPECT_EQ(*d.read(), 0_i32);
+}
+
+TEST(RwLock, TryReadTryWrite) {
+  auto l = RwLock<i32>::with(3);
+  {
+    auto r = l.read();
+    EXPECT_TRUE(l.try_read().is_some());
+    EXPECT_TRUE(l.try_write().is_none());
+  }
+  {
+    auto w = l.write();
+    EXPECT_TRUE(l.try_read().is_none());
+    EXPECT_TRUE(l.try_write().is_none());
+  }
+  auto o = l.try_write();
+  ASSERT_TRUE(o.is_some());
+  o = sus::none();
+  EXPECT_TRUE(l.try_read().is_some());
+}
+
+TEST(RwLock, MoveGuards) {
+  auto l = RwLock<i32>::with(3);
+  {
+    auto r = l.read();
+    auto r2 = sus::move(r);
+    // Moving into itself does nothing.
+    auto& self = r2;
+    r2 = sus::move(self);
+    EXPECT_EQ(*r2, 3_i32);
+    EXPECT_TRUE(l.try_write().is_none());
+  }
+  {
+    auto w = l.write();
+    auto w2 = sus::move(w);
+    auto& self = w2;
+    w2 = sus::move(self);
+    *w2 = 5;
+    EXPECT_TRUE(l.try_read().is_none());
+  }
+  EXPECT_EQ(*l.try_write().unwrap(), 5_i32);
+}
+
+TEST(RwLock, GetMutIntoInner) {
+  auto l = RwLock<sus::Vec<i32>>();
+  l.get_mut().push(1);
+  l.write()->push(2);
+  EXPECT_EQ(l.read()->len(), 2u);
+  sus::Vec<i32> v = sus::move(l).into_inner();
+  ASSERT_EQ(v.len(), 2u);
+  EXPECT_EQ(v[1u], 2_i32);
+}
+
+TEST(RwLock, Contended) {
+  // Writers keep the two values equal, so a reader that sees them differ has
+  // raced with a writer.
+  struct Pair {
+    u64 a;
+    u64 b;
+  };
+  auto l = RwLock<Pair>::with(Pair(0u, 0u));
+  std::atomic<bool> torn = false;
+  constexpr int kWriters = 2;
+  constexpr int kReaders = 4;
+  constexpr int kIterations = 10000;
+  std::thread threads[kWriters + kReaders];
+  for (int i = 0; i < kWriters; ++i) {
+    threads[i] = std::thread([&l]() {
+      for (int j = 0; j < kIterations; ++j) {
+        auto w = l.write();
+        w->a += 1u;
+        w->b += 1u;
+      }
+    });
+  }
+  for (int i = kWriters; i < kWriters + kReaders; ++i) {
+    threads[i] = std::thread([&l, &torn]() {
+      for (int j = 0; j < kIterations; ++j) {
+        auto r = l.read();
+        if (r->a != r->b) torn.store(true);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  EXPECT_FALSE(torn.load());
+  EXPECT_EQ(l.read()->a, u64::from(kWriters * kIterations));
+}
+
+}  // namespace
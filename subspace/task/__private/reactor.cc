@@ -0,0 +1,171 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/task/__private/reactor.h"
+
+#include <errno.h>
+
+#include <algorithm>
+
+#include "subspace/assertions/check.h"
+#include "subspace/assertions/panic.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace sus::task::__private {
+
+Reactor::Reactor() noexcept {
+#if !defined(_WIN32)
+  int fds[2];
+  ::sus::check_with_message(::pipe(fds) == 0,
+                            *"unable to create the Reactor's pipe");
+  for (int fd : fds) {
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+  wake_read_ = fds[0];
+  wake_write_ = fds[1];
+#endif
+}
+
+Reactor::~Reactor() noexcept {
+#if !defined(_WIN32)
+  ::close(wake_read_);
+  ::close(wake_write_);
+#endif
+}
+
+void Reactor::add_timer(Clock::time_point deadline,
+                        std::coroutine_handle<> h) noexcept {
+  std::lock_guard lock(mutex_);
+  timers_.push(Timer{.deadline = deadline, .seq = next_seq_, .h = h});
+  next_seq_ += 1u;
+  Timer* const t = timers_.as_mut_ptr();
+  std::push_heap(t, t + timers_.len().primitive_value);
+}
+
+void Reactor::add_fd(int fd, bool write, std::coroutine_handle<> h) noexcept {
+#if defined(_WIN32)
+  (void)fd, (void)write, (void)h;
+  ::sus::panic_with_message(
+      *"waiting for a file descriptor is not supported on Windows");
+#else
+  std::lock_guard lock(mutex_);
+  fds_.push(FdWaiter{.fd = fd, .write = write, .h = h});
+#endif
+}
+
+void Reactor::wake() noexcept {
+#if defined(_WIN32)
+  std::lock_guard lock(mutex_);
+  woken_ = true;
+  wake_cv_.notify_all();
+#else
+  // If the pipe is full, the reader has not drained it yet, and will wake
+  // anyway.
+  const char c = 0;
+  (void)::write(wake_write_, &c, 1u);
+#endif
+}
+
+bool Reactor::expire_timers(Clock::time_point now,
+                            ::sus::Vec<std::coroutine_handle<>>& ready,
+                            Clock::time_point& next) noexcept {
+  while (!timers_.is_empty()) {
+    Timer* const t = timers_.as_mut_ptr();
+    if (t[0].deadline > now) {
+      next = t[0].deadline;
+      return true;
+    }
+    std::pop_heap(t, t + timers_.len().primitive_value);
+    ready.push(timers_.pop().unwrap().h);
+  }
+  return false;
+}
+
+void Reactor::poll(bool block,
+                   ::sus::Vec<std::coroutine_handle<>>& ready) noexcept {
+  const usize ready_before = ready.len();
+  std::unique_lock lock(mutex_);
+  Clock::time_point next;
+  const bool has_timer = expire_timers(Clock::now(), ready, next);
+  const bool wait = block && ready.len() == ready_before;
+
+#if defined(_WIN32)
+  if (wait) {
+    const auto woken = [this]() { return woken_; };
+    if (has_timer)
+      wake_cv_.wait_until(lock, next, woken);
+    else
+      wake_cv_.wait(lock, woken);
+  }
+  woken_ = false;
+#else
+  int timeout_ms = 0;
+  if (wait && has_timer) {
+    // Round up, so that the timer has expired when poll() returns.
+    const auto until = next - Clock::now();
+    const auto ms =
+        std::chrono::ceil<std::chrono::milliseconds>(until).count();
+    timeout_ms = ms < 0 ? 0 : ms > INT32_MAX ? INT32_MAX : int(ms);
+  } else if (wait) {
+    timeout_ms = -1;
+  }
+
+  // The file descriptors are polled without holding the lock, so that other
+  // threads can add to `fds_` meanwhile. Those are seen on the next call.
+  const size_t num_fds = fds_.len().primitive_value;
+  auto pfds = ::sus::Vec<pollfd>::with_capacity(num_fds + 1u);
+  pfds.push(pollfd{.fd = wake_read_, .events = POLLIN, .revents = 0});
+  for (const FdWaiter& w : fds_.iter()) {
+    pfds.push(pollfd{.fd = w.fd,
+                     .events = static_cast<short>(w.write ? POLLOUT : POLLIN),
+                     .revents = 0});
+  }
+  lock.unlock();
+
+  int n = ::poll(pfds.as_mut_ptr(), num_fds + 1u, timeout_ms);
+  if (n < 0) {
+    ::sus::check(errno == EINTR);
+    n = 0;
+  }
+
+  if (pfds[0u].revents != 0) {
+    char buf[64];
+    while (::read(wake_read_, buf, sizeof(buf)) > 0) {
+    }
+  }
+
+  lock.lock();
+  if (n > 0) {
+    // Waiters are only removed by this function, and only added to the end
+    // of `fds_`, so the first `num_fds` of them are the ones polled. They
+    // are removed from back to front so that the indices stay valid.
+    for (size_t i = num_fds; i > 0u; --i) {
+      if (pfds[i].revents == 0) continue;
+      ready.push(fds_[i - 1u].h);
+      const size_t last = fds_.len().primitive_value - 1u;
+      if (i - 1u != last) fds_[i - 1u] = fds_[last];
+      (void)fds_.pop();
+    }
+  }
+#endif
+  (void)expire_timers(Clock::now(), ready, next);
+}
+
+}  // namespace sus::task::__private
@@ -0,0 +1,107 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <chrono>
+#include <coroutine>
+#include <mutex>
+
+#if defined(_WIN32)
+#include <condition_variable>
+#endif
+
+#include "subspace/containers/vec.h"
+
+namespace sus::task::__private {
+
+/// Waits for timers to expire and for file descriptors to become ready, and
+/// hands back the coroutines which were waiting on them.
+///
+/// Timers and file descriptors may be added from any thread, while another
+/// thread is blocked in `poll()`. The thread which adds them must call
+/// `wake()` afterward in that case, so that `poll()` sees them.
+class Reactor final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  Reactor() noexcept;
+  ~Reactor() noexcept;
+
+  Reactor(const Reactor&) = delete;
+  Reactor& operator=(const Reactor&) = delete;
+
+  /// Resumes `h` from `poll()` once `deadline` has passed.
+  void add_timer(Clock::time_point deadline,
+                 std::coroutine_handle<> h) noexcept;
+
+  /// Resumes `h` from `poll()` once `fd` is readable, if `write` is false, or
+  /// writable, if `write` is true. It is also resumed if `fd` has an error or
+  /// is hung up.
+  void add_fd(int fd, bool write, std::coroutine_handle<> h) noexcept;
+
+  /// Makes a thread which is blocked in `poll()` return.
+  void wake() noexcept;
+
+  /// Appends the coroutines whose timers have expired or whose file
+  /// descriptors are ready to `ready`.
+  ///
+  /// If `block` is true and nothing is ready, waits until something is, or
+  /// until `wake()` is called.
+  void poll(bool block, ::sus::Vec<std::coroutine_handle<>>& ready) noexcept;
+
+ private:
+  struct Timer {
+    Clock::time_point deadline;
+    // Breaks ties between equal deadlines in the order they were added.
+    uint64_t seq;
+    std::coroutine_handle<> h;
+
+    // The heap is a max-heap, so later timers compare as less.
+    bool operator<(const Timer& o) const noexcept {
+      if (deadline != o.deadline) return deadline > o.deadline;
+      return seq > o.seq;
+    }
+  };
+  struct FdWaiter {
+    int fd;
+    bool write;
+    std::coroutine_handle<> h;
+  };
+
+  /// Moves expired timers to `ready`. If any timers are left, returns true and
+  /// sets `next` to the earliest deadline. The `mutex_` must be held.
+  bool expire_timers(Clock::time_point now,
+                     ::sus::Vec<std::coroutine_handle<>>& ready,
+                     Clock::time_point& next) noexcept;
+
+  std::mutex mutex_;
+  // A heap of timers, ordered by `Timer::operator<`.
+  ::sus::Vec<Timer> timers_;
+  uint64_t next_seq_ = 0u;
+  ::sus::Vec<FdWaiter> fds_;
+#if defined(_WIN32)
+  std::condition_variable wake_cv_;
+  bool woken_ = false;
+#else
+  // A pipe which `wake()` writes to, and `poll()` waits on along with the
+  // file descriptors of `fds_`.
+  int wake_read_ = -1;
+  int wake_write_ = -1;
+#endif
+};
+
+}  // namespace sus::task::__private
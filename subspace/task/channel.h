@@ -0,0 +1,252 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <coroutine>
+#include <mutex>
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/option/option.h"
+#include "subspace/result/result.h"
+#include "subspace/sync/__private/channel.h"
+#include "subspace/sync/__private/list_channel.h"
+#include "subspace/sync/mpsc.h"
+#include "subspace/task/executor.h"
+#include "subspace/tuple/tuple.h"
+
+namespace sus::task {
+
+template <class T>
+class Sender;
+template <class T>
+class Receiver;
+
+template <class T>
+::sus::Tuple<Sender<T>, Receiver<T>> channel() noexcept;
+
+namespace __private {
+
+/// The shared state of a channel between tasks: an unbounded queue, and the
+/// receiving task if it is waiting for the queue to be non-empty.
+template <class T>
+class TaskChannel final {
+ public:
+  TaskChannel() noexcept = default;
+
+  TaskChannel(const TaskChannel&) = delete;
+  TaskChannel& operator=(const TaskChannel&) = delete;
+
+  /// Moves from `value` into the queue, and wakes the receiver.
+  void push(T& value) noexcept {
+    (void)queue_.try_push(value);
+    wake();
+  }
+
+  ::sus::Option<T> pop() noexcept { return queue_.try_pop(); }
+
+  /// Registers `h` to be resumed on `ex` once there is a value in the queue
+  /// or the senders are gone. Returns false, without registering, if that is
+  /// already the case.
+  bool park(Executor& ex, std::coroutine_handle<> h) noexcept {
+    std::lock_guard lock(mutex_);
+    if (!queue_.is_empty() || queue_.senders_gone()) return false;
+    waiter_ = h;
+    waiter_executor_ = &ex;
+    return true;
+  }
+
+  bool senders_gone() const noexcept { return queue_.senders_gone(); }
+  bool receivers_gone() const noexcept { return queue_.receivers_gone(); }
+
+  void disconnect_senders() noexcept {
+    queue_.disconnect_senders();
+    wake();
+  }
+  void disconnect_receivers() noexcept { queue_.disconnect_receivers(); }
+
+ private:
+  void wake() noexcept {
+    std::coroutine_handle<> h;
+    Executor* ex;
+    {
+      // A `park()` which saw the queue empty has registered its waiter by
+      // the time the lock is acquired here.
+      std::lock_guard lock(mutex_);
+      h = ::sus::mem::replace(mref(waiter_), std::coroutine_handle<>());
+      ex = waiter_executor_;
+    }
+    if (h) ex->schedule(h);
+  }
+
+  ::sus::sync::__private::ListChannel<T> queue_;
+  std::mutex mutex_;
+  std::coroutine_handle<> waiter_;
+  Executor* waiter_executor_ = nullptr;
+};
+
+template <class T>
+using TaskChannelPtr = ::sus::sync::__private::ChannelCounter<TaskChannel<T>>*;
+
+}  // namespace __private
+
+/// The sending half of a channel between tasks, from `channel()`.
+///
+/// Sending never blocks, as the channel is unbounded, so a `Sender` can be
+/// used from a task or from any other thread. A `Sender` can be cloned to
+/// send from many places at once. The channel is disconnected for the
+/// `Receiver` once every `Sender` is gone.
+template <class T>
+class [[sus_trivial_abi]] Sender final {
+  static_assert(!std::is_reference_v<T>, "Sender<T&> is not a valid type.");
+
+ public:
+  ~Sender() noexcept {
+    if (chan_ != nullptr) ::sus::sync::__private::release_sender(chan_);
+  }
+
+  Sender(Sender&& o) noexcept
+      : chan_(::sus::mem::replace_ptr(mref(o.chan_), nullptr)) {
+    check(chan_ != nullptr);
+  }
+  Sender& operator=(Sender&& o) noexcept {
+    check(o.chan_ != nullptr);
+    if (&o == this) return *this;
+    if (chan_ != nullptr) ::sus::sync::__private::release_sender(chan_);
+    chan_ = ::sus::mem::replace_ptr(mref(o.chan_), nullptr);
+    return *this;
+  }
+
+  /// Returns another `Sender` into the same channel.
+  ///
+  /// sus::mem::Clone trait.
+  Sender clone() const& noexcept {
+    check(chan_ != nullptr);
+    return Sender(::sus::sync::__private::acquire_sender(chan_));
+  }
+
+  /// Sends `value` into the channel, and resumes the receiving task if it is
+  /// waiting for a value.
+  ///
+  /// Returns None once the value is sent, or an error holding the value if
+  /// the `Receiver` is gone.
+  ::sus::Option<::sus::sync::mpsc::SendError<T>> send(
+      T value) const& noexcept {
+    using Error = ::sus::sync::mpsc::SendError<T>;
+    check(chan_ != nullptr);
+    if (chan_->chan.receivers_gone())
+      return ::sus::Option<Error>::some(Error(::sus::move(value)));
+    chan_->chan.push(value);
+    return ::sus::Option<Error>::none();
+  }
+
+ private:
+  friend ::sus::Tuple<Sender<T>, Receiver<T>> channel<T>() noexcept;
+
+  explicit Sender(__private::TaskChannelPtr<T> chan) noexcept : chan_(chan) {}
+
+  __private::TaskChannelPtr<T> chan_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(chan_));
+};
+
+/// The receiving half of a channel between tasks, from `channel()`.
+///
+/// Values are received with `co_await receiver.recv()`, which suspends the
+/// task until a value is sent, letting other tasks run meanwhile. There is a
+/// single `Receiver` for each channel.
+template <class T>
+class [[sus_trivial_abi]] Receiver final {
+  static_assert(!std::is_reference_v<T>, "Receiver<T&> is not a valid type.");
+
+ public:
+  ~Receiver() noexcept {
+    if (chan_ != nullptr) ::sus::sync::__private::release_receiver(chan_);
+  }
+
+  Receiver(Receiver&& o) noexcept
+      : chan_(::sus::mem::replace_ptr(mref(o.chan_), nullptr)) {
+    check(chan_ != nullptr);
+  }
+  Receiver& operator=(Receiver&& o) noexcept {
+    check(o.chan_ != nullptr);
+    if (&o == this) return *this;
+    if (chan_ != nullptr) ::sus::sync::__private::release_receiver(chan_);
+    chan_ = ::sus::mem::replace_ptr(mref(o.chan_), nullptr);
+    return *this;
+  }
+
+  /// Returns an awaitable which receives the next value from the channel,
+  /// suspending the task until one is sent.
+  ///
+  /// The awaitable evaluates to an error once the channel is empty and every
+  /// `Sender` is gone. Values sent before the last `Sender` was dropped are
+  /// all received first.
+  auto recv() & noexcept {
+    check(chan_ != nullptr);
+    using R = ::sus::result::Result<T, ::sus::sync::mpsc::RecvError>;
+    struct RecvAwaiter {
+      __private::TaskChannel<T>& chan;
+      ::sus::Option<T> value;
+
+      bool await_ready() noexcept {
+        value = chan.pop();
+        return value.is_some() || chan.senders_gone();
+      }
+      bool await_suspend(std::coroutine_handle<> h) noexcept {
+        return chan.park(Executor::current().expect(
+                             "recv() must be awaited in a task"),
+                         h);
+      }
+      R await_resume() noexcept {
+        if (value.is_none()) value = chan.pop();
+        if (value.is_none()) return R::with_err(::sus::sync::mpsc::RecvError());
+        return R::with(::sus::move(value).unwrap());
+      }
+    };
+    return RecvAwaiter{.chan = chan_->chan, .value = ::sus::Option<T>()};
+  }
+
+ private:
+  friend ::sus::Tuple<Sender<T>, Receiver<T>> channel<T>() noexcept;
+
+  explicit Receiver(__private::TaskChannelPtr<T> chan) noexcept
+      : chan_(chan) {}
+
+  __private::TaskChannelPtr<T> chan_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn, decltype(chan_));
+};
+
+/// Creates an unbounded channel for sending values to a task, returning the
+/// sender and receiver halves.
+///
+/// This is the counterpart of `sus::sync::mpsc::channel()` for tasks: where
+/// its `Receiver::recv()` blocks the thread, the `Receiver::recv()` of this
+/// channel suspends only the receiving task.
+template <class T>
+::sus::Tuple<Sender<T>, Receiver<T>> channel() noexcept {
+  auto* c = new ::sus::sync::__private::ChannelCounter<
+      __private::TaskChannel<T>>();
+  return ::sus::Tuple<Sender<T>, Receiver<T>>::with(Sender<T>(c),
+                                                    Receiver<T>(c));
+}
+
+}  // namespace sus::task
@@ -0,0 +1,115 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/task/channel.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/prelude.h"
+#include "subspace/task/executor.h"
+#include "subspace/task/task.h"
+
+namespace {
+
+using sus::task::LocalExecutor;
+using sus::task::Receiver;
+using sus::task::Sender;
+using sus::task::Task;
+
+static_assert(sus::mem::relocate_by_memcpy<Sender<i32>>);
+static_assert(sus::mem::relocate_by_memcpy<Receiver<i32>>);
+
+Task<void> recv_all(Receiver<sus::Vec<i32>>& rx, sus::Vec<i32>& out) {
+  while (true) {
+    auto r = co_await rx.recv();
+    if (r.is_err()) break;
+    sus::Vec<i32> v = sus::move(r).unwrap();
+    for (i32 i : v.iter()) out.push(i);
+  }
+}
+
+TEST(TaskChannel, SendBeforeRecv) {
+  LocalExecutor ex;
+  auto [tx, rx] = sus::task::channel<sus::Vec<i32>>();
+  // Moving into itself does nothing.
+  auto& tx_self = tx;
+  tx = sus::move(tx_self);
+  auto& rx_self = rx;
+  rx = sus::move(rx_self);
+  EXPECT_TRUE(tx.send(sus::Vec<i32>(sus::vec(1_i32, 2_i32))).is_none());
+  EXPECT_TRUE(tx.send(sus::Vec<i32>(sus::vec(3_i32))).is_none());
+  {
+    // Values sent before the senders are gone are still received.
+    auto drop = sus::move(tx);
+  }
+  auto out = sus::Vec<i32>();
+  ex.block_on(recv_all(rx, out));
+  EXPECT_EQ(out, sus::Vec<i32>(sus::vec(1_i32, 2_i32, 3_i32)));
+}
+
+Task<void> send_each(Sender<sus::Vec<i32>> tx, i32 n) {
+  for (i32 i = 0; i < n; i += 1) {
+    EXPECT_TRUE(tx.send(sus::Vec<i32>(sus::vec(i))).is_none());
+    co_await sus::task::yield_now();
+  }
+}
+
+TEST(TaskChannel, RecvWaitsForSend) {
+  LocalExecutor ex;
+  auto [tx, rx] = sus::task::channel<sus::Vec<i32>>();
+  auto out = sus::Vec<i32>();
+  // The receiver runs first, and waits for each value.
+  ex.spawn(recv_all(rx, out));
+  ex.spawn(send_each(tx.clone(), 3_i32));
+  {
+    auto drop = sus::move(tx);
+  }
+  ex.run();
+  EXPECT_EQ(out, sus::Vec<i32>(sus::vec(0_i32, 1_i32, 2_i32)));
+}
+
+TEST(TaskChannel, ReceiverGone) {
+  auto [tx, rx] = sus::task::channel<sus::Vec<i32>>();
+  {
+    auto drop = sus::move(rx);
+  }
+  auto err = tx.send(sus::Vec<i32>(sus::vec(4_i32)));
+  ASSERT_TRUE(err.is_some());
+  EXPECT_EQ(sus::move(err).unwrap().into_inner(),
+            sus::Vec<i32>(sus::vec(4_i32)));
+}
+
+Task<bool> recv_is_err(Receiver<i32> rx) {
+  auto r = co_await rx.recv();
+  co_return r.is_err();
+}
+
+TEST(TaskChannel, SendersGoneWhileWaiting) {
+  LocalExecutor ex;
+  auto [tx, rx] = sus::task::channel<i32>();
+  bool is_err = false;
+  ex.spawn([](Receiver<i32> rx, bool& out) -> Task<void> {
+    out = co_await recv_is_err(sus::move(rx));
+  }(sus::move(rx), is_err));
+  ex.spawn([](Sender<i32> tx) -> Task<void> {
+    // Dropping the last Sender wakes the waiting receiver.
+    co_await sus::task::yield_now();
+    auto drop = sus::move(tx);
+  }(sus::move(tx)));
+  ex.run();
+  EXPECT_TRUE(is_err);
+}
+
+}  // namespace
@@ -0,0 +1,173 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/task/executor.h"
+
+#include "subspace/assertions/check.h"
+#include "subspace/fn/fn.h"
+#include "subspace/fn/fn_bind.h"
+#include "subspace/mem/replace.h"
+#include "subspace/mem/swap.h"
+
+namespace sus::task {
+
+namespace {
+
+// The executor of the task running on the current thread, if any.
+thread_local Executor* current_executor = nullptr;
+
+}  // namespace
+
+namespace __private {
+
+void task_finished(Executor& ex) noexcept {
+  std::lock_guard lock(ex.tasks_mutex_);
+  if (ex.tasks_.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+    ex.tasks_cv_.notify_all();
+}
+
+}  // namespace __private
+
+::sus::Option<Executor&> Executor::current() noexcept {
+  if (current_executor == nullptr) return ::sus::Option<Executor&>::none();
+  return ::sus::Option<Executor&>::some(*current_executor);
+}
+
+void Executor::spawn(Task<void> task) & noexcept {
+  check(static_cast<bool>(task.handle_));
+  auto h = ::sus::mem::replace(mref(task.handle_), Task<void>::Handle());
+  h.promise().spawned_on_ = this;
+  tasks_.fetch_add(1u, std::memory_order_acq_rel);
+  schedule(h);
+}
+
+void Executor::wait_for_tasks() noexcept {
+  std::unique_lock lock(tasks_mutex_);
+  tasks_cv_.wait(lock, [this]() { return num_tasks() == 0u; });
+}
+
+Executor::Enter::Enter(Executor& ex) noexcept : prev_(current_executor) {
+  current_executor = &ex;
+}
+
+Executor::Enter::~Enter() noexcept { current_executor = prev_; }
+
+LocalExecutor::~LocalExecutor() noexcept { run_until(nullptr); }
+
+void LocalExecutor::run() & noexcept { run_until(nullptr); }
+
+void LocalExecutor::wait(__private::BlockOnState& state) noexcept {
+  run_until(&state);
+}
+
+void LocalExecutor::run_until(
+    const __private::BlockOnState* state) noexcept {
+  Enter enter(*this);
+  auto batch = ::sus::Vec<std::coroutine_handle<>>();
+  while (state != nullptr ? !state->is_done() : num_tasks() > 0u) {
+    {
+      std::lock_guard lock(mutex_);
+      ::sus::mem::swap(batch, ready_);
+    }
+    // Timers and file descriptors are checked between each batch, so that a
+    // task which keeps yielding does not keep them waiting. The thread only
+    // blocks when there is nothing else to run.
+    reactor_.poll(batch.is_empty(), batch);
+    for (std::coroutine_handle<> h : batch.iter()) h.resume();
+    batch.clear();
+  }
+}
+
+void LocalExecutor::wake() noexcept {
+  if (current_executor != this) reactor_.wake();
+}
+
+void LocalExecutor::schedule(std::coroutine_handle<> h) noexcept {
+  {
+    std::lock_guard lock(mutex_);
+    ready_.push(h);
+  }
+  wake();
+}
+
+void LocalExecutor::schedule_at(Clock::time_point deadline,
+                                std::coroutine_handle<> h) noexcept {
+  reactor_.add_timer(deadline, h);
+  wake();
+}
+
+void LocalExecutor::schedule_on_fd(int fd, Interest interest,
+                                   std::coroutine_handle<> h) noexcept {
+  reactor_.add_fd(fd, interest == Interest::Writable, h);
+  wake();
+}
+
+PoolExecutor::PoolExecutor() noexcept
+    : PoolExecutor(::sus::thread::ThreadPool::global()) {}
+
+PoolExecutor::~PoolExecutor() noexcept {
+  wait_for_tasks();
+  if (reactor_thread_.joinable()) {
+    stop_.store(true, std::memory_order_release);
+    reactor_.wake();
+    reactor_thread_.join();
+  }
+}
+
+void PoolExecutor::wait(__private::BlockOnState& state) noexcept {
+  state.wait();
+}
+
+void PoolExecutor::schedule(std::coroutine_handle<> h) noexcept {
+  PoolExecutor* self = this;
+  void* frame = h.address();
+  // The job is allocated here, which may be the reactor thread, and freed on
+  // a worker. The SlabAllocator returns such frees to other threads in
+  // batches, so the reactor thread does not keep allocating new spans.
+  pool_->spawn(sus_bind_mut(
+      sus_store(sus_unsafe_pointer(self), sus_unsafe_pointer(frame)),
+      [self, frame]() mutable {
+        Enter enter(*self);
+        std::coroutine_handle<>::from_address(frame).resume();
+      }));
+}
+
+void PoolExecutor::schedule_at(Clock::time_point deadline,
+                               std::coroutine_handle<> h) noexcept {
+  start_reactor();
+  reactor_.add_timer(deadline, h);
+  reactor_.wake();
+}
+
+void PoolExecutor::schedule_on_fd(int fd, Interest interest,
+                                  std::coroutine_handle<> h) noexcept {
+  start_reactor();
+  reactor_.add_fd(fd, interest == Interest::Writable, h);
+  reactor_.wake();
+}
+
+void PoolExecutor::start_reactor() noexcept {
+  std::call_once(reactor_started_, [this]() {
+    reactor_thread_ = std::thread([this]() {
+      auto ready = ::sus::Vec<std::coroutine_handle<>>();
+      while (!stop_.load(std::memory_order_acquire)) {
+        reactor_.poll(true, ready);
+        for (std::coroutine_handle<> h : ready.iter()) schedule(h);
+        ready.clear();
+      }
+    });
+  });
+}
+
+}  // namespace sus::task
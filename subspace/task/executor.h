@@ -0,0 +1,304 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+#include "subspace/containers/vec.h"
+#include "subspace/mem/move.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/option/option.h"
+#include "subspace/task/__private/reactor.h"
+#include "subspace/task/task.h"
+#include "subspace/thread/thread_pool.h"
+
+namespace sus::task {
+
+/// Which readiness of a file descriptor to wait for, in
+/// `Executor::schedule_on_fd()`.
+enum class Interest {
+  /// The file descriptor can be read from without blocking.
+  Readable,
+  /// The file descriptor can be written to without blocking.
+  Writable,
+};
+
+namespace __private {
+
+/// Signals the thread in `Executor::block_on()` once its task is done.
+class BlockOnState final {
+ public:
+  bool is_done() const noexcept {
+    return done_.load(std::memory_order_acquire);
+  }
+
+  void set_done() noexcept {
+    // The state may be destroyed as soon as `wait()` sees `done_`, so it is
+    // set while holding the lock.
+    std::lock_guard lock(mutex_);
+    done_.store(true, std::memory_order_release);
+    cv_.notify_all();
+  }
+
+  void wait() noexcept {
+    std::unique_lock lock(mutex_);
+    cv_.wait(lock, [this]() { return is_done(); });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::atomic<bool> done_ = false;
+};
+
+template <class T>
+Task<void> drive(Task<T> task, ::sus::Option<T>& out, BlockOnState& state) {
+  T value = co_await ::sus::move(task);
+  out.insert(::sus::move(value));
+  state.set_done();
+}
+
+inline Task<void> drive(Task<void> task, BlockOnState& state) {
+  co_await ::sus::move(task);
+  state.set_done();
+}
+
+}  // namespace __private
+
+/// Runs `Task`s.
+///
+/// A task runs on an executor once it is given to `spawn()` or `block_on()`.
+/// When the task awaits something that is not ready, such as a timer or a
+/// file descriptor, it suspends, and the executor runs other tasks until the
+/// one it was waiting for is ready. Then the executor resumes the task with
+/// `schedule()`.
+///
+/// `Executor::current()` is the executor of the task running on the current
+/// thread. The awaitables in this module, such as `sleep_for()` and
+/// `Receiver::recv()`, resume their task on that executor.
+///
+/// Executors can not be moved, as tasks hold a pointer to the executor they
+/// run on.
+class Executor {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  virtual ~Executor() noexcept = default;
+
+  Executor(const Executor&) = delete;
+  Executor& operator=(const Executor&) = delete;
+
+  /// Returns the executor which is running a task on the current thread, or
+  /// None if the thread is not running a task.
+  static ::sus::Option<Executor&> current() noexcept;
+
+  /// Runs `task` in the background, without waiting for it. The frame of the
+  /// task is destroyed once it completes.
+  void spawn(Task<void> task) & noexcept;
+
+  /// Runs `task` and blocks the current thread until it is done, then
+  /// returns the value it returned.
+  ///
+  /// This must not be called from a task, as the task would block the thread
+  /// it runs on. Use `co_await` to wait for another task instead.
+  template <class T>
+  T block_on(Task<T> task) & noexcept {
+    __private::BlockOnState state;
+    if constexpr (std::is_void_v<T>) {
+      spawn(__private::drive(::sus::move(task), state));
+      wait(state);
+    } else {
+      ::sus::Option<T> out;
+      spawn(__private::drive(::sus::move(task), out, state));
+      wait(state);
+      return ::sus::move(out).unwrap();
+    }
+  }
+
+  /// Queues the suspended coroutine `h` to be resumed by the executor. This
+  /// may be called from any thread.
+  virtual void schedule(std::coroutine_handle<> h) noexcept = 0;
+
+  /// Resumes the suspended coroutine `h` on the executor once `deadline` has
+  /// passed. This may be called from any thread.
+  virtual void schedule_at(Clock::time_point deadline,
+                           std::coroutine_handle<> h) noexcept = 0;
+
+  /// Resumes the suspended coroutine `h` on the executor once `fd` is ready
+  /// for `interest`, or has an error. This may be called from any thread.
+  ///
+  /// The file descriptor must stay open until `h` is resumed.
+  virtual void schedule_on_fd(int fd, Interest interest,
+                              std::coroutine_handle<> h) noexcept = 0;
+
+ protected:
+  Executor() noexcept = default;
+
+  /// Sets `Executor::current()` for as long as it is alive.
+  class Enter final {
+   public:
+    explicit Enter(Executor& ex) noexcept;
+    ~Enter() noexcept;
+
+    Enter(const Enter&) = delete;
+    Enter& operator=(const Enter&) = delete;
+
+   private:
+    Executor* prev_;
+  };
+
+  /// Blocks until `state` is done, running tasks on the current thread if the
+  /// executor runs them there.
+  virtual void wait(__private::BlockOnState& state) noexcept = 0;
+
+  /// Returns the number of spawned tasks which have not completed.
+  usize num_tasks() const noexcept {
+    return tasks_.load(std::memory_order_acquire);
+  }
+
+  /// Blocks until every spawned task has completed.
+  void wait_for_tasks() noexcept;
+
+ private:
+  friend void __private::task_finished(Executor& ex) noexcept;
+
+  // Counts the spawned tasks which have not completed. It is decremented
+  // while holding `tasks_mutex_`, so that the executor is not destroyed by
+  // `wait_for_tasks()` before the last task is done notifying it.
+  std::atomic<size_t> tasks_ = 0u;
+  std::mutex tasks_mutex_;
+  std::condition_variable tasks_cv_;
+};
+
+/// An executor which runs all of its tasks on a single thread.
+///
+/// Tasks run on the thread which calls `run()` or `block_on()`, so they do
+/// not need to synchronize with each other. Timers and file descriptors are
+/// waited for on the same thread, with `poll()`, whenever there are no tasks
+/// ready to run.
+///
+/// Coroutines may be scheduled onto the executor from other threads, such as
+/// by sending into a `Sender` from a thread which is not running a task, and
+/// they are run on the executor's thread.
+class LocalExecutor final : public Executor {
+ public:
+  /// Constructs an executor with no tasks.
+  ///
+  /// sus::construct::Default trait.
+  LocalExecutor() noexcept = default;
+
+  /// Runs the executor until every spawned task has completed.
+  ~LocalExecutor() noexcept override;
+
+  /// Runs tasks on the current thread until every spawned task has
+  /// completed.
+  void run() & noexcept;
+
+  void schedule(std::coroutine_handle<> h) noexcept override;
+  void schedule_at(Clock::time_point deadline,
+                   std::coroutine_handle<> h) noexcept override;
+  void schedule_on_fd(int fd, Interest interest,
+                      std::coroutine_handle<> h) noexcept override;
+
+ protected:
+  void wait(__private::BlockOnState& state) noexcept override;
+
+ private:
+  /// Runs tasks until `state` is done, or if it is null, until every spawned
+  /// task has completed.
+  void run_until(const __private::BlockOnState* state) noexcept;
+
+  /// Wakes the thread running the executor, if it is not this thread.
+  void wake() noexcept;
+
+  std::mutex mutex_;
+  ::sus::Vec<std::coroutine_handle<>> ready_;
+  __private::Reactor reactor_;
+};
+
+/// An executor which runs its tasks on the threads of a `ThreadPool`.
+///
+/// Each time a task is resumed it is queued as a job on the pool, so a task
+/// may run on a different thread after each `co_await`. Tasks which are
+/// ready run in parallel.
+///
+/// Timers and file descriptors are waited for by a thread of the executor's
+/// own, which is started the first time it is needed.
+///
+/// Destroying the executor waits for every spawned task to complete.
+class PoolExecutor final : public Executor {
+ public:
+  /// Constructs an executor which runs tasks on `ThreadPool::global()`.
+  ///
+  /// sus::construct::Default trait.
+  PoolExecutor() noexcept;
+
+  /// Constructs an executor which runs tasks on `pool`. The `pool` must
+  /// outlive the executor.
+  static PoolExecutor with_thread_pool(
+      ::sus::thread::ThreadPool& pool) noexcept {
+    return PoolExecutor(pool);
+  }
+
+  ~PoolExecutor() noexcept override;
+
+  void schedule(std::coroutine_handle<> h) noexcept override;
+  void schedule_at(Clock::time_point deadline,
+                   std::coroutine_handle<> h) noexcept override;
+  void schedule_on_fd(int fd, Interest interest,
+                      std::coroutine_handle<> h) noexcept override;
+
+ protected:
+  void wait(__private::BlockOnState& state) noexcept override;
+
+ private:
+  explicit PoolExecutor(::sus::thread::ThreadPool& pool) noexcept
+      : pool_(&pool) {}
+
+  /// Starts the thread which runs the `reactor_`, if it is not running yet.
+  void start_reactor() noexcept;
+
+  ::sus::thread::ThreadPool* pool_;
+  __private::Reactor reactor_;
+  std::once_flag reactor_started_;
+  std::thread reactor_thread_;
+  std::atomic<bool> stop_ = false;
+};
+
+/// Returns an awaitable which suspends the current task and queues it to be
+/// resumed by its executor, so that other tasks which are ready can run
+/// first.
+inline auto yield_now() noexcept {
+  struct YieldAwaiter {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) const noexcept {
+      Executor::current()
+          .expect("yield_now() must be awaited in a task")
+          .schedule(h);
+    }
+    void await_resume() const noexcept {}
+  };
+  return YieldAwaiter();
+}
+
+}  // namespace sus::task
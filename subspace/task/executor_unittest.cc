@@ -0,0 +1,269 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/task/executor.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/io/file_desc.h"
+#include "subspace/prelude.h"
+#include "subspace/task/channel.h"
+#include "subspace/task/fd.h"
+#include "subspace/task/sleep.h"
+#include "subspace/task/task.h"
+#include "subspace/thread/thread_pool.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using namespace std::chrono_literals;
+using sus::task::Executor;
+using sus::task::LocalExecutor;
+using sus::task::PoolExecutor;
+using sus::task::Task;
+
+Task<void> increment(i32& n) {
+  n += 1;
+  co_return;
+}
+
+TEST(LocalExecutor, SpawnRun) {
+  LocalExecutor ex;
+  i32 n = 0;
+  for (i32 i = 0; i < 100; i += 1) ex.spawn(increment(n));
+  EXPECT_EQ(n, 0_i32);
+  ex.run();
+  EXPECT_EQ(n, 100_i32);
+}
+
+TEST(LocalExecutor, DestroyRunsTasks) {
+  i32 n = 0;
+  {
+    LocalExecutor ex;
+    ex.spawn(increment(n));
+  }
+  EXPECT_EQ(n, 1_i32);
+}
+
+Task<void> is_current(Executor& ex, bool& out) {
+  out = &Executor::current().unwrap() == &ex;
+  co_return;
+}
+
+TEST(LocalExecutor, Current) {
+  LocalExecutor ex;
+  EXPECT_TRUE(Executor::current().is_none());
+  bool current = false;
+  ex.block_on(is_current(ex, current));
+  EXPECT_TRUE(current);
+  EXPECT_TRUE(Executor::current().is_none());
+}
+
+Task<void> yield_and_record(sus::Vec<i32>& order, i32 id) {
+  for (i32 i = 0; i < 3; i += 1) {
+    order.push(id);
+    co_await sus::task::yield_now();
+  }
+}
+
+TEST(LocalExecutor, YieldNow) {
+  LocalExecutor ex;
+  auto order = sus::Vec<i32>();
+  ex.spawn(yield_and_record(order, 1_i32));
+  ex.spawn(yield_and_record(order, 2_i32));
+  ex.run();
+  ASSERT_EQ(order.len(), 6u);
+  for (usize i = 0u; i < 6u; i += 1u) {
+    EXPECT_EQ(order[i], i % 2u == 0u ? 1_i32 : 2_i32);
+  }
+}
+
+Task<void> sleep_and_record(sus::Vec<i32>& order, i32 id,
+                            std::chrono::milliseconds d) {
+  co_await sus::task::sleep_for(d);
+  order.push(id);
+}
+
+TEST(LocalExecutor, Sleep) {
+  LocalExecutor ex;
+  auto order = sus::Vec<i32>();
+  const auto start = std::chrono::steady_clock::now();
+  ex.spawn(sleep_and_record(order, 3_i32, 30ms));
+  ex.spawn(sleep_and_record(order, 1_i32, 10ms));
+  ex.spawn(sleep_and_record(order, 2_i32, 20ms));
+  ex.spawn(sleep_and_record(order, 0_i32, 0ms));
+  ex.run();
+  EXPECT_GE(std::chrono::steady_clock::now() - start, 30ms);
+  ASSERT_EQ(order.len(), 4u);
+  EXPECT_EQ(order[0u], 0_i32);
+  EXPECT_EQ(order[1u], 1_i32);
+  EXPECT_EQ(order[2u], 2_i32);
+  EXPECT_EQ(order[3u], 3_i32);
+}
+
+Task<void> recv_sum(sus::task::Receiver<i32> rx, i32& sum) {
+  while (true) {
+    auto r = co_await rx.recv();
+    if (r.is_err()) break;
+    sum += sus::move(r).unwrap();
+  }
+}
+
+TEST(LocalExecutor, WakeFromOtherThread) {
+  LocalExecutor ex;
+  auto [tx, rx] = sus::task::channel<i32>();
+  i32 sum = 0;
+  ex.spawn(recv_sum(sus::move(rx), sum));
+  // The executor blocks waiting for the other thread to send.
+  auto t = std::thread([tx = sus::move(tx)]() {
+    for (i32 i = 1; i <= 10; i += 1) {
+      std::this_thread::sleep_for(1ms);
+      EXPECT_TRUE(tx.send(i).is_none());
+    }
+  });
+  ex.run();
+  t.join();
+  EXPECT_EQ(sum, 55_i32);
+}
+
+#if !defined(_WIN32)
+
+Task<void> read_when_ready(const sus::io::FileDesc& reader, char& out) {
+  co_await sus::task::readable(reader);
+  EXPECT_EQ(::read(reader.as_raw_fd(), &out, 1u), 1);
+}
+
+Task<void> write_later(const sus::io::FileDesc& writer) {
+  co_await sus::task::sleep_for(5ms);
+  co_await sus::task::writable(writer);
+  EXPECT_EQ(::write(writer.as_raw_fd(), "x", 1u), 1);
+}
+
+TEST(LocalExecutor, Fd) {
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  auto reader = sus::io::FileDesc::from_raw_fd(unsafe_fn, fds[0]);
+  auto writer = sus::io::FileDesc::from_raw_fd(unsafe_fn, fds[1]);
+  ASSERT_EQ(fcntl(fds[0], F_SETFL, O_NONBLOCK), 0);
+
+  LocalExecutor ex;
+  char c = 0;
+  ex.spawn(read_when_ready(reader, c));
+  ex.spawn(write_later(writer));
+  ex.run();
+  EXPECT_EQ(c, 'x');
+}
+
+#endif
+
+
+Task<i32> sleep_then_add(i32 a, i32 b) {
+  co_await sus::task::sleep_for(1ms);
+  co_return a + b;
+}
+
+TEST(PoolExecutor, BlockOn) {
+  auto pool = sus::thread::ThreadPool::with_num_threads(2u);
+  auto ex = PoolExecutor::with_thread_pool(pool);
+  EXPECT_EQ(ex.block_on(sleep_then_add(2_i32, 3_i32)), 5_i32);
+}
+
+Task<void> on_pool(Executor& ex, std::atomic<bool>& out) {
+  out.store(&Executor::current().unwrap() == &ex);
+  co_return;
+}
+
+TEST(PoolExecutor, Global) {
+  PoolExecutor ex;
+  std::atomic<bool> current = false;
+  ex.block_on(on_pool(ex, current));
+  EXPECT_TRUE(current.load());
+}
+
+Task<void> add_after_yield(std::atomic<int32_t>& n, i32 i) {
+  co_await sus::task::yield_now();
+  n.fetch_add(i.primitive_value);
+}
+
+TEST(PoolExecutor, SpawnMany) {
+  auto pool = sus::thread::ThreadPool::with_num_threads(4u);
+  std::atomic<int32_t> n = 0;
+  {
+    auto ex = PoolExecutor::with_thread_pool(pool);
+    for (i32 i = 1; i <= 1000; i += 1) ex.spawn(add_after_yield(n, i));
+    // Destroying the executor waits for the tasks.
+  }
+  EXPECT_EQ(n.load(), 500500);
+}
+
+Task<void> produce(sus::task::Sender<i32> tx, i32 from, i32 to) {
+  for (i32 i = from; i < to; i += 1) {
+    if (i % 16 == 0) co_await sus::task::yield_now();
+    EXPECT_TRUE(tx.send(i).is_none());
+  }
+}
+
+Task<i32> consume(sus::task::Receiver<i32> rx) {
+  i32 sum = 0;
+  while (true) {
+    auto r = co_await rx.recv();
+    if (r.is_err()) break;
+    sum += sus::move(r).unwrap();
+  }
+  co_return sum;
+}
+
+TEST(PoolExecutor, Channel) {
+  auto pool = sus::thread::ThreadPool::with_num_threads(4u);
+  auto ex = PoolExecutor::with_thread_pool(pool);
+  auto [tx, rx] = sus::task::channel<i32>();
+  for (i32 i = 0; i < 8; i += 1)
+    ex.spawn(produce(tx.clone(), i * 100, (i + 1) * 100));
+  {
+    // The channel disconnects once the producers are done.
+    auto drop = sus::move(tx);
+  }
+  EXPECT_EQ(ex.block_on(consume(sus::move(rx))), 319600_i32);
+}
+
+#if !defined(_WIN32)
+
+TEST(PoolExecutor, Fd) {
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  auto reader = sus::io::FileDesc::from_raw_fd(unsafe_fn, fds[0]);
+  auto writer = sus::io::FileDesc::from_raw_fd(unsafe_fn, fds[1]);
+  ASSERT_EQ(fcntl(fds[0], F_SETFL, O_NONBLOCK), 0);
+
+  auto pool = sus::thread::ThreadPool::with_num_threads(2u);
+  char c = 0;
+  {
+    auto ex = PoolExecutor::with_thread_pool(pool);
+    ex.spawn(read_when_ready(reader, c));
+    ex.spawn(write_later(writer));
+  }
+  EXPECT_EQ(c, 'x');
+}
+
+#endif
+
+}  // namespace
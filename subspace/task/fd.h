@@ -0,0 +1,61 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <coroutine>
+
+#include "subspace/io/file_desc.h"
+#include "subspace/task/executor.h"
+
+namespace sus::task {
+
+namespace __private {
+
+struct FdAwaiter {
+  int fd;
+  Interest interest;
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> h) const noexcept {
+    Executor::current()
+        .expect("a file descriptor must be awaited in a task")
+        .schedule_on_fd(fd, interest, h);
+  }
+  void await_resume() const noexcept {}
+};
+
+}  // namespace __private
+
+/// Returns an awaitable which suspends the current task until `file` can be
+/// read from without blocking, or has an error or is hung up.
+///
+/// The file is usually a pipe or socket in non-blocking mode, which is then
+/// read until it returns `Error::Kind::WouldBlock`, before awaiting it again.
+/// It must stay open until the task resumes.
+inline __private::FdAwaiter readable(const ::sus::io::FileDesc& file) noexcept {
+  return __private::FdAwaiter{.fd = file.as_raw_fd(),
+                              .interest = Interest::Readable};
+}
+
+/// Returns an awaitable which suspends the current task until `file` can be
+/// written to without blocking, or has an error or is hung up.
+///
+/// It must stay open until the task resumes.
+inline __private::FdAwaiter writable(const ::sus::io::FileDesc& file) noexcept {
+  return __private::FdAwaiter{.fd = file.as_raw_fd(),
+                              .interest = Interest::Writable};
+}
+
+}  // namespace sus::task
@@ -0,0 +1,58 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+
+#include "subspace/task/executor.h"
+
+namespace sus::task {
+
+namespace __private {
+
+struct SleepAwaiter {
+  Executor::Clock::time_point deadline;
+
+  bool await_ready() const noexcept {
+    return deadline <= Executor::Clock::now();
+  }
+  void await_suspend(std::coroutine_handle<> h) const noexcept {
+    Executor::current()
+        .expect("a sleep must be awaited in a task")
+        .schedule_at(deadline, h);
+  }
+  void await_resume() const noexcept {}
+};
+
+}  // namespace __private
+
+/// Returns an awaitable which suspends the current task until `deadline` has
+/// passed. Other tasks run on the executor meanwhile.
+inline __private::SleepAwaiter sleep_until(
+    Executor::Clock::time_point deadline) noexcept {
+  return __private::SleepAwaiter{.deadline = deadline};
+}
+
+/// Returns an awaitable which suspends the current task for at least
+/// `duration`. Other tasks run on the executor meanwhile.
+template <class Rep, class Period>
+__private::SleepAwaiter sleep_for(
+    std::chrono::duration<Rep, Period> duration) noexcept {
+  return sleep_until(Executor::Clock::now() +
+                     std::chrono::ceil<Executor::Clock::duration>(duration));
+}
+
+}  // namespace sus::task
@@ -0,0 +1,285 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+#include <coroutine>
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/assertions/panic.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/replace.h"
+#include "subspace/mem/slab_allocator.h"
+#include "subspace/option/option.h"
+#include "subspace/result/__private/is_result_type.h"
+#include "subspace/result/result.h"
+
+namespace sus::task {
+
+class Executor;
+template <class T>
+class Task;
+
+namespace __private {
+
+/// Called when a task which was spawned onto `ex` finishes, after its frame
+/// is destroyed.
+void task_finished(Executor& ex) noexcept;
+
+/// The state shared by the promises of all tasks.
+class PromiseBase {
+ public:
+  /// Coroutine frames are allocated from the `SlabAllocator`, so that
+  /// spawning a short-lived task does not go to the global allocator. A frame
+  /// is often freed on a different thread than it was allocated on, which
+  /// the `SlabAllocator` hands back to other threads in batches.
+  static void* operator new(size_t size) {
+    void* const p = ::sus::mem::SlabAllocator::allocate(
+        size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    ::sus::check_with_message(p != nullptr,
+                              *"unable to allocate a Task frame");
+    return p;
+  }
+  static void operator delete(void* p) noexcept {
+    ::sus::mem::SlabAllocator::deallocate(p, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+  }
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+
+  void unhandled_exception() noexcept {
+    ::sus::panic_with_message(*"an exception escaped from a Task");
+  }
+
+  /// Hands control to whatever is waiting for the task, once it has
+  /// produced its value. Returns the coroutine to resume next.
+  ///
+  /// A task which was spawned onto an `Executor` has nothing waiting for it,
+  /// so its frame is destroyed here instead.
+  template <class P>
+  static std::coroutine_handle<> complete(
+      std::coroutine_handle<P> h) noexcept {
+    PromiseBase& p = h.promise();
+    if (p.continuation_) {
+      // If the awaiting task is still in `await_suspend()`, it continues from
+      // there once this returns. Otherwise it suspended, and is resumed here.
+      if (p.arrived_.exchange(true, std::memory_order_acq_rel))
+        return p.continuation_;
+      return std::noop_coroutine();
+    }
+    if (Executor* const ex = p.spawned_on_) {
+      h.destroy();
+      task_finished(*ex);
+    }
+    return std::noop_coroutine();
+  }
+
+  struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    template <class P>
+    std::coroutine_handle<> await_suspend(
+        std::coroutine_handle<P> h) noexcept {
+      return complete(h);
+    }
+    void await_resume() const noexcept {}
+  };
+  FinalAwaiter final_suspend() noexcept { return {}; }
+
+  /// Any awaitable other than a `Result` is awaited as is.
+  template <class A>
+    requires(!::sus::result::__private::IsResultType<
+             std::remove_cvref_t<A>>::value)
+  A&& await_transform(A&& a) noexcept {
+    return static_cast<A&&>(a);
+  }
+
+ private:
+  friend class ::sus::task::Executor;
+  template <class U>
+  friend class ::sus::task::Task;
+
+  // The coroutine awaiting this task, if any.
+  std::coroutine_handle<> continuation_;
+  // Set by whichever comes second of the task completing and the awaiting
+  // task returning from `await_suspend()`, which then resumes the awaiting
+  // task.
+  std::atomic<bool> arrived_ = false;
+  // The executor which the task was spawned onto, if any.
+  Executor* spawned_on_ = nullptr;
+};
+
+template <class T>
+class Promise;
+
+/// Awaits a `Result` inside a task which returns a `Result` with the same
+/// error type. An `Ok` value is unwrapped, and an `Err` ends the task,
+/// returning the error from it.
+template <class T, class V, class E>
+struct TryAwaiter {
+  ::sus::result::Result<V, E> result;
+  Promise<T>& promise;
+
+  bool await_ready() const noexcept { return result.is_ok(); }
+  std::coroutine_handle<> await_suspend(
+      std::coroutine_handle<Promise<T>> h) noexcept {
+    promise.value_.insert(T::with_err(::sus::move(result).unwrap_err()));
+    return PromiseBase::complete(h);
+  }
+  V await_resume() noexcept { return ::sus::move(result).unwrap(); }
+};
+
+template <class T>
+class Promise final : public PromiseBase {
+ public:
+  Task<T> get_return_object() noexcept;
+
+  template <class U>
+    requires(std::is_convertible_v<U &&, T>)
+  void return_value(U&& value) noexcept {
+    value_.insert(static_cast<U&&>(value));
+  }
+
+  using PromiseBase::await_transform;
+
+  /// Inside a task returning `Result<U, E>`, `co_await` on a `Result<V, E>`
+  /// evaluates to the `V` value, or returns its error from the task.
+  template <class V, class R = T>
+    requires(::sus::result::__private::IsResultType<R>::value)
+  TryAwaiter<T, V, typename R::ErrType> await_transform(
+      ::sus::result::Result<V, typename R::ErrType> result) noexcept {
+    return {::sus::move(result), *this};
+  }
+
+ private:
+  template <class U>
+  friend class ::sus::task::Task;
+  template <class U, class V, class E>
+  friend struct TryAwaiter;
+
+  ::sus::Option<T> value_;
+};
+
+template <>
+class Promise<void> final : public PromiseBase {
+ public:
+  Task<void> get_return_object() noexcept;
+
+  void return_void() noexcept {}
+};
+
+}  // namespace __private
+
+/// A coroutine which produces a `T`, or nothing if `T` is `void`.
+///
+/// A function returning a `Task` may use `co_await` and `co_return`. The body
+/// of the task does not run until the `Task` is awaited with `co_await` from
+/// another task, or is handed to an `Executor` with `Executor::spawn()` or
+/// `Executor::block_on()`. Awaiting a task runs it on the current thread until
+/// it completes or suspends. If it suspends, the awaiting task is resumed
+/// directly when it completes, without going through the executor.
+///
+/// # Results
+/// Inside a task which returns a `Result<U, E>`, awaiting any `Result<V, E>`
+/// with the same error type unwraps it, like the `?` operator in Rust. If
+/// the awaited `Result` holds an error, the task ends there and returns the
+/// error.
+/// ```
+/// sus::task::Task<sus::io::Result<usize>> read_header(Conn& c) {
+///   usize n = co_await c.read_len();
+///   co_return sus::io::Result<usize>::with(n + 4u);
+/// }
+/// ```
+///
+/// # Allocation
+/// The frame of each task, which holds its local variables, is allocated
+/// from `sus::mem::SlabAllocator`. A task spawned onto a `PoolExecutor` is
+/// created on the spawning thread and destroyed on whichever worker thread it
+/// completes on.
+///
+/// # Panics
+/// An exception which escapes from the body of a task will panic.
+template <class T>
+class [[nodiscard]] Task final {
+ public:
+  using promise_type = __private::Promise<T>;
+
+  Task(Task&& o) noexcept
+      : handle_(::sus::mem::replace(mref(o.handle_), Handle())) {}
+  Task& operator=(Task&& o) noexcept {
+    if (&o == this) return *this;
+    if (handle_) handle_.destroy();
+    handle_ = ::sus::mem::replace(mref(o.handle_), Handle());
+    return *this;
+  }
+
+  /// Destroys the task's frame, whether it has completed or not.
+  ~Task() noexcept {
+    if (handle_) handle_.destroy();
+  }
+
+  /// Awaits the task, which evaluates to the value it returns.
+  auto operator co_await() && noexcept {
+    check(static_cast<bool>(handle_));
+    struct Awaiter {
+      Handle h;
+
+      bool await_ready() const noexcept { return false; }
+      bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        // The task runs inside of `await_suspend()`, rather than by returning
+        // its handle, as returning a handle is only a tail call when the
+        // compiler optimizes it. If it completes without suspending, the
+        // awaiting task continues without being suspended, and the stack
+        // does not grow with each task that is awaited in a loop.
+        __private::PromiseBase& p = h.promise();
+        p.continuation_ = awaiting;
+        h.resume();
+        return !p.arrived_.exchange(true, std::memory_order_acq_rel);
+      }
+      T await_resume() noexcept {
+        if constexpr (!std::is_void_v<T>)
+          return ::sus::move(h.promise().value_).unwrap();
+      }
+    };
+    return Awaiter{handle_};
+  }
+
+ private:
+  using Handle = std::coroutine_handle<promise_type>;
+
+  friend promise_type;
+  friend class Executor;
+
+  explicit Task(Handle h) noexcept : handle_(h) {}
+
+  Handle handle_;
+};
+
+namespace __private {
+
+template <class T>
+Task<T> Promise<T>::get_return_object() noexcept {
+  return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() noexcept {
+  return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+}  // namespace __private
+
+}  // namespace sus::task
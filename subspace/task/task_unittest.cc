@@ -0,0 +1,154 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/task/task.h"
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/prelude.h"
+#include "subspace/result/result.h"
+#include "subspace/task/executor.h"
+
+namespace {
+
+using sus::task::LocalExecutor;
+using sus::task::Task;
+
+enum class Error { Bad, Worse };
+using Result = sus::result::Result<i32, Error>;
+
+Task<i32> value(i32 i) { co_return i; }
+
+Task<i32> add(i32 a, i32 b) {
+  const i32 x = co_await value(a);
+  const i32 y = co_await value(b);
+  co_return x + y;
+}
+
+TEST(Task, ReturnsValue) {
+  LocalExecutor ex;
+  EXPECT_EQ(ex.block_on(value(3_i32)), 3_i32);
+  EXPECT_EQ(ex.block_on(add(3_i32, 4_i32)), 7_i32);
+}
+
+Task<void> set(i32& out, i32 i) {
+  out = co_await value(i);
+}
+
+TEST(Task, Void) {
+  LocalExecutor ex;
+  i32 out = 0;
+  ex.block_on(set(out, 5_i32));
+  EXPECT_EQ(out, 5_i32);
+}
+
+Task<sus::Vec<i32>> make_vec(i32 n) {
+  auto v = sus::Vec<i32>();
+  for (i32 i = 0; i < n; i += 1) v.push(i);
+  co_return sus::move(v);
+}
+
+TEST(Task, MoveOnlyValue) {
+  LocalExecutor ex;
+  sus::Vec<i32> v = ex.block_on(make_vec(3_i32));
+  EXPECT_EQ(v.len(), 3u);
+  EXPECT_EQ(v[2u], 2_i32);
+}
+
+Task<void> count(i32& runs) {
+  runs += 1;
+  co_return;
+}
+
+TEST(Task, Lazy) {
+  LocalExecutor ex;
+  i32 runs = 0;
+  {
+    Task<void> t = count(runs);
+    EXPECT_EQ(runs, 0_i32);
+    // Destroying the task destroys the frame without running it.
+  }
+  EXPECT_EQ(runs, 0_i32);
+
+  Task<void> t = count(runs);
+  // Moving into itself does nothing.
+  auto& self = t;
+  t = sus::move(self);
+  ex.block_on(sus::move(t));
+  EXPECT_EQ(runs, 1_i32);
+}
+
+Task<Result> checked(i32 i) {
+  if (i < 0) co_return Result::with_err(Error::Bad);
+  co_return Result::with(i);
+}
+
+Task<Result> sum_checked(i32 a, i32 b, i32& reached) {
+  // Each co_await on a Result unwraps it, or returns its error.
+  const i32 x = co_await co_await checked(a);
+  reached += 1;
+  const i32 y = co_await co_await checked(b);
+  reached += 1;
+  co_return Result::with(x + y);
+}
+
+TEST(Task, ResultOk) {
+  LocalExecutor ex;
+  i32 reached = 0;
+  Result r = ex.block_on(sum_checked(1_i32, 2_i32, reached));
+  EXPECT_EQ(sus::move(r).unwrap(), 3_i32);
+  EXPECT_EQ(reached, 2_i32);
+}
+
+TEST(Task, ResultErr) {
+  LocalExecutor ex;
+  i32 reached = 0;
+  Result r = ex.block_on(sum_checked(1_i32, -2_i32, reached));
+  EXPECT_EQ(sus::move(r).unwrap_err(), Error::Bad);
+  EXPECT_EQ(reached, 1_i32);
+
+  reached = 0;
+  r = ex.block_on(sum_checked(-1_i32, 2_i32, reached));
+  EXPECT_EQ(sus::move(r).unwrap_err(), Error::Bad);
+  EXPECT_EQ(reached, 0_i32);
+}
+
+Task<sus::result::Result<u8, Error>> narrow(i32 i) {
+  // The Ok type of the awaited Result may differ from the task's.
+  const i32 x = co_await Result::with(i);
+  if (x > 255) co_return sus::result::Result<u8, Error>::with_err(Error::Worse);
+  co_return sus::result::Result<u8, Error>::with(
+      u8(static_cast<uint8_t>(x.primitive_value)));
+}
+
+TEST(Task, ResultDifferentOk) {
+  LocalExecutor ex;
+  EXPECT_EQ(ex.block_on(narrow(7_i32)).unwrap(), 7_u8);
+  EXPECT_EQ(ex.block_on(narrow(300_i32)).unwrap_err(), Error::Worse);
+}
+
+Task<i32> deep(i32 n) {
+  i32 total = 0;
+  // Awaiting a task which completes immediately resumes the awaiting task
+  // without growing the stack, so this does not overflow.
+  for (i32 i = 0; i < n; i += 1) total += co_await value(1_i32);
+  co_return total;
+}
+
+TEST(Task, ManyAwaits) {
+  LocalExecutor ex;
+  EXPECT_EQ(ex.block_on(deep(1000000_i32)), 1000000_i32);
+}
+
+}  // namespace
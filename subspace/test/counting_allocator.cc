@@ -0,0 +1,213 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "subspace/test/counting_allocator.h"
+
+#include <string.h>
+
+#include "subspace/assertions/check.h"
+#include "subspace/mem/alloc.h"
+
+namespace sus::test {
+
+namespace {
+
+// The innermost AllocationScope on this thread.
+thread_local AllocationScope* innermost_scope = nullptr;
+
+}  // namespace
+
+struct AllocationRecorder final {
+  static void record(size_t bytes,
+                     const std::source_location& location) noexcept {
+    for (auto* s = innermost_scope; s; s = s->outer_)
+      s->record(bytes, location);
+  }
+  static void record_free(size_t bytes,
+                          const std::source_location& location) noexcept {
+    for (auto* s = innermost_scope; s; s = s->outer_)
+      s->record_free(bytes, location);
+  }
+};
+
+AllocationScope::AllocationScope() noexcept
+    : outer_(innermost_scope),
+      count_(0u),
+      bytes_(0u),
+      peak_bytes_(0u),
+      live_bytes_(0),
+      num_sites_(0u),
+      sites_() {
+  innermost_scope = this;
+}
+
+AllocationScope::~AllocationScope() noexcept {
+  check(innermost_scope == this);
+  innermost_scope = outer_;
+}
+
+const AllocationSite& AllocationScope::site(usize i) const noexcept {
+  check(i < num_sites_);
+  return sites_[i.primitive_value];
+}
+
+void AllocationScope::record(size_t bytes,
+                             const std::source_location& location) noexcept {
+  count_ += 1u;
+  bytes_ += bytes;
+  live_bytes_ += static_cast<ptrdiff_t>(bytes);
+  if (live_bytes_ > 0 && static_cast<size_t>(live_bytes_) > peak_bytes_)
+    peak_bytes_ = static_cast<size_t>(live_bytes_);
+
+  AllocationSite* site = find_site(location);
+  if (site == nullptr) {
+    // Sites beyond the limit are still counted in the totals.
+    if (num_sites_ == kMaxSites) return;
+    site = &sites_[num_sites_.primitive_value];
+    *site = AllocationSite{
+        .file_name = location.file_name(),
+        .line = location.line(),
+        .count = 0u,
+        .bytes = 0u,
+        .peak_bytes = 0u,
+        .live_bytes = 0,
+    };
+    num_sites_ += 1u;
+  }
+  site->count += 1u;
+  site->bytes += bytes;
+  site->live_bytes += static_cast<ptrdiff_t>(bytes);
+  if (site->live_bytes > 0 &&
+      static_cast<size_t>(site->live_bytes) > site->peak_bytes)
+    site->peak_bytes = static_cast<size_t>(site->live_bytes);
+}
+
+void AllocationScope::record_free(
+    size_t bytes, const std::source_location& location) noexcept {
+  live_bytes_ -= static_cast<ptrdiff_t>(bytes);
+  if (AllocationSite* site = find_site(location); site != nullptr)
+    site->live_bytes -= static_cast<ptrdiff_t>(bytes);
+}
+
+AllocationSite* AllocationScope::find_site(
+    const std::source_location& location) noexcept {
+  for (size_t i = 0u; i < num_sites_.primitive_value; ++i) {
+    AllocationSite& site = sites_[i];
+    if (site.line == location.line() &&
+        strcmp(site.file_name, location.file_name()) == 0) {
+      return &site;
+    }
+  }
+  return nullptr;
+}
+
+namespace __private {
+
+bool NoAllocationsScope::run_once() noexcept {
+  if (!ran_) {
+    ran_ = true;
+    return true;
+  }
+  if (scope_.count() > 0u) {
+    auto failure = ::testing::Message();
+    failure << "Expected no allocations, but found "
+            << scope_.count().primitive_value << " allocating "
+            << scope_.bytes().primitive_value << " bytes:";
+    for (usize i = 0u; i < scope_.num_sites(); i += 1u) {
+      const AllocationSite& site = scope_.site(i);
+      failure << "\n  " << site.file_name << ":" << site.line.primitive_value
+              << " allocated " << site.count.primitive_value << " times";
+    }
+    ADD_FAILURE_AT(file_, line_) << failure;
+  }
+  return false;
+}
+
+}  // namespace __private
+
+}  // namespace sus::test
+
+#if defined(SUS_PROVIDE_ALLOCATOR)
+
+namespace sus::test {
+namespace {
+
+// Each allocation is given a header in front of it which holds its size and
+// where it was allocated, so that it can be counted against that place when
+// it's freed. The header keeps the allocation's alignment.
+struct Header final {
+  std::source_location location;
+  size_t size;
+};
+
+size_t header_size(size_t align) noexcept {
+  constexpr size_t min_size = (sizeof(Header) + alignof(max_align_t) - 1u) /
+                              alignof(max_align_t) * alignof(max_align_t);
+  return align > min_size ? align : min_size;
+}
+
+char* add_header(void* p, size_t size, size_t align,
+                 const std::source_location& location) noexcept {
+  if (p == nullptr) return nullptr;
+  char* user = static_cast<char*>(p) + header_size(align);
+  const auto header = Header{.location = location, .size = size};
+  memcpy(user - sizeof(Header), &header, sizeof(Header));
+  return user;
+}
+
+Header read_header(const void* user) noexcept {
+  Header header;
+  memcpy(&header, static_cast<const char*>(user) - sizeof(Header),
+         sizeof(Header));
+  return header;
+}
+
+}  // namespace
+}  // namespace sus::test
+
+namespace sus::mem {
+
+void* provided_allocate(size_t size, size_t align,
+                        const std::source_location& location) noexcept {
+  ::sus::test::AllocationRecorder::record(size, location);
+  const size_t header = ::sus::test::header_size(align);
+  return ::sus::test::add_header(
+      __private::default_allocate(header + size, align), size, align, location);
+}
+
+void* provided_reallocate(void* ptr, size_t old_size, size_t new_size,
+                          size_t align,
+                          const std::source_location& location) noexcept {
+  const ::sus::test::Header old = ::sus::test::read_header(ptr);
+  check(old.size == old_size);
+  ::sus::test::AllocationRecorder::record_free(old_size, old.location);
+  ::sus::test::AllocationRecorder::record(new_size, location);
+  const size_t header = ::sus::test::header_size(align);
+  return ::sus::test::add_header(
+      __private::default_reallocate(static_cast<char*>(ptr) - header,
+                                    header + old_size, header + new_size,
+                                    align),
+      new_size, align, location);
+}
+
+void provided_deallocate(void* ptr, size_t align) noexcept {
+  if (ptr == nullptr) return;
+  const ::sus::test::Header header = ::sus::test::read_header(ptr);
+  ::sus::test::AllocationRecorder::record_free(header.size, header.location);
+  __private::default_deallocate(
+      static_cast<char*>(ptr) - ::sus::test::header_size(align), align);
+}
+
+}  // namespace sus::mem
+
+#endif
@@ -0,0 +1,133 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <stddef.h>
+
+#include <source_location>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/num/unsigned_integer.h"
+
+namespace sus::test {
+
+/// Counts for the allocations made at one place in the code.
+///
+/// The place is the caller of the library function which allocated, such as
+/// `Vec::push()` or `Box::with()`, as those functions take the
+/// `std::source_location` of their caller.
+struct AllocationSite final {
+  const char* file_name;
+  u32 line;
+  /// The number of allocations, including reallocations.
+  usize count;
+  /// The total bytes requested by those allocations.
+  usize bytes;
+  /// The largest number of bytes that was live at once from those
+  /// allocations.
+  usize peak_bytes;
+  /// The bytes from those allocations which are still live. It can go
+  /// negative if memory allocated here before the scope is freed in it.
+  ptrdiff_t live_bytes;
+};
+
+/// Records the heap allocations made through `sus::mem::allocate()` and
+/// `sus::mem::reallocate()` on the current thread while it is alive.
+///
+/// This requires the test binary, and the library it links, to be built with
+/// `SUS_PROVIDE_ALLOCATOR`, which makes the library allocate through the
+/// counting allocator in counting_allocator.cc. The subspace unittests are
+/// built that way, against `subspace::test_lib`.
+///
+/// Scopes may be nested, and each one records every allocation made while it
+/// is alive.
+class AllocationScope final {
+ public:
+  AllocationScope() noexcept;
+  ~AllocationScope() noexcept;
+
+  AllocationScope(const AllocationScope&) = delete;
+  AllocationScope& operator=(const AllocationScope&) = delete;
+
+  /// The number of allocations and reallocations made in the scope.
+  usize count() const noexcept { return count_; }
+  /// The total bytes requested by the allocations and reallocations made in
+  /// the scope.
+  usize bytes() const noexcept { return bytes_; }
+  /// The largest number of bytes that was live at once from the allocations
+  /// made in the scope.
+  usize peak_bytes() const noexcept { return peak_bytes_; }
+  /// The number of distinct places in the library that allocated in the
+  /// scope.
+  usize num_sites() const noexcept { return num_sites_; }
+  /// The counts for each place in the library that allocated in the scope.
+  ///
+  /// # Panics
+  /// Panics if `i` is not less than `num_sites()`.
+  const AllocationSite& site(usize i) const noexcept;
+
+ private:
+  friend struct AllocationRecorder;
+
+  void record(size_t bytes, const std::source_location& location) noexcept;
+  void record_free(size_t bytes,
+                   const std::source_location& location) noexcept;
+  AllocationSite* find_site(const std::source_location& location) noexcept;
+
+  static constexpr size_t kMaxSites = 32u;
+
+  AllocationScope* outer_;
+  usize count_;
+  usize bytes_;
+  usize peak_bytes_;
+  // The bytes allocated in the scope which are still live. It can go negative
+  // if memory from before the scope is freed in it.
+  ptrdiff_t live_bytes_;
+  usize num_sites_;
+  AllocationSite sites_[kMaxSites];
+};
+
+namespace __private {
+
+// Runs the body of `EXPECT_NO_ALLOCATIONS` once, and then reports a test
+// failure if it allocated.
+class NoAllocationsScope final {
+ public:
+  NoAllocationsScope(const char* file, int line) noexcept
+      : file_(file), line_(line) {}
+
+  bool run_once() noexcept;
+
+ private:
+  AllocationScope scope_;
+  const char* file_;
+  int line_;
+  bool ran_ = false;
+};
+
+}  // namespace __private
+
+}  // namespace sus::test
+
+/// Runs the following statement or block, and adds a test failure if it
+/// allocated through the library's allocator, listing where the allocations
+/// were made.
+///
+/// ```
+/// EXPECT_NO_ALLOCATIONS { v.push(1); }
+/// ```
+#define EXPECT_NO_ALLOCATIONS                                           \
+  for (::sus::test::__private::NoAllocationsScope _sus_no_allocations( \
+           __FILE__, __LINE__);                                          \
+       _sus_no_allocations.run_once();)
@@ -0,0 +1,182 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/slab_allocator.h"
+#include "subspace/option/option.h"
+
+namespace sus::thread::__private {
+
+class Registry;
+
+/// A unit of work which is run by a thread of a `ThreadPool`.
+///
+/// Jobs are intrusive: the `Job` is the header of an object which also holds
+/// the closure to run, and the pool only passes around pointers to it. A job
+/// for a fork-join task lives on the stack of the thread which waits for it,
+/// so queueing it does not allocate.
+struct Job {
+  /// Runs the job. The job may be destroyed by the time this returns.
+  void (*execute)(Job& job) noexcept;
+  /// The next job in the pool's queue of jobs from outside the pool.
+  Job* next = nullptr;
+};
+
+/// A counter which is set once it reaches zero. Threads of the pool which are
+/// waiting for it run other jobs until it is set.
+class CountLatch final {
+ public:
+  CountLatch(Registry& registry, size_t count) noexcept
+      : count_(count), registry_(registry) {}
+
+  CountLatch(const CountLatch&) = delete;
+  CountLatch& operator=(const CountLatch&) = delete;
+
+  /// Adds one to the count. The count must not already be zero.
+  void increment() noexcept {
+    count_.fetch_add(1u, std::memory_order_relaxed);
+  }
+
+  /// Subtracts one from the count, waking any waiting threads if it reaches
+  /// zero. The latch may be destroyed by a waiting thread as soon as it is
+  /// set, so the latch must not be used again by the caller.
+  void count_down() noexcept;
+
+  /// Returns whether the count has reached zero.
+  bool probe() const noexcept {
+    return count_.load(std::memory_order_acquire) == 0u;
+  }
+
+ private:
+  std::atomic<size_t> count_;
+  Registry& registry_;
+};
+
+/// A latch which blocks a thread outside of the pool until it is set.
+class LockLatch final {
+ public:
+  LockLatch() noexcept = default;
+
+  LockLatch(const LockLatch&) = delete;
+  LockLatch& operator=(const LockLatch&) = delete;
+
+  void count_down() noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    set_ = true;
+    // Notify while holding the lock, as the waiting thread destroys the latch
+    // as soon as it sees it is set.
+    cv_.notify_all();
+  }
+
+  void wait() noexcept {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return set_; });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool set_ = false;
+};
+
+/// Holds the return value of a job, if it has one.
+template <class R>
+struct JobResult final {
+  template <class F>
+  void run(F& f) noexcept {
+    value = Option<R>::some(::sus::move(f)());
+  }
+  R take() && noexcept { return ::sus::move(value).unwrap(); }
+
+  Option<R> value = Option<R>::none();
+};
+
+template <>
+struct JobResult<void> final {
+  template <class F>
+  void run(F& f) noexcept {
+    ::sus::move(f)();
+  }
+  void take() && noexcept {}
+};
+
+/// A job which lives on the stack of the thread which waits for it. The
+/// closure is run in place, and its result is kept in the job for the waiting
+/// thread to take.
+template <class F, class Latch>
+struct StackJob final : public Job {
+  using R = std::invoke_result_t<F&&>;
+
+  StackJob(F& f, Latch& latch) noexcept
+      : Job{.execute = &StackJob::run}, f(f), latch(latch) {}
+
+  static void run(Job& job) noexcept {
+    auto& self = static_cast<StackJob&>(job);
+    self.result.run(self.f);
+    self.latch.count_down();
+  }
+
+  F& f;
+  Latch& latch;
+  JobResult<R> result;
+};
+
+/// A job which owns its closure, for tasks which are not waited for by the
+/// thread which queues them. The job frees itself once it has run, then counts
+/// down `latch`.
+///
+/// The job is allocated from the `SlabAllocator`. It is usually freed on a
+/// different thread than allocated it, which the `SlabAllocator` hands back in
+/// batches, so a thread which keeps queueing jobs for others to run reuses
+/// the same memory.
+template <class F>
+struct HeapJob final : public Job {
+  static HeapJob& with(F f, CountLatch& latch) noexcept {
+    void* p = ::sus::mem::SlabAllocator::allocate(sizeof(HeapJob),
+                                                  alignof(HeapJob));
+    check(p != nullptr);
+    return *new (p) HeapJob(::sus::move(f), latch);
+  }
+
+  static void run(Job& job) noexcept {
+    auto& self = static_cast<HeapJob&>(job);
+    CountLatch& latch = self.latch;
+    ::sus::move(self.f)();
+    // The closure is destroyed before the latch is set, as it may refer to
+    // data that the waiting thread destroys once it is.
+    self.~HeapJob();
+    ::sus::mem::SlabAllocator::deallocate(&self, alignof(HeapJob));
+    latch.count_down();
+  }
+
+ private:
+  HeapJob(F&& f, CountLatch& latch) noexcept
+      : Job{.execute = &HeapJob::run}, f(::sus::move(f)), latch(latch) {}
+
+  F f;
+  CountLatch& latch;
+};
+
+}  // namespace sus::thread::__private
@@ -0,0 +1,210 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "subspace/mem/forward.h"
+#include "subspace/mem/move.h"
+#include "subspace/num/integer_concepts.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/thread/thread_pool.h"
+
+namespace sus::thread::__private {
+
+/// The source of items for a parallel iterator over a slice. It can be split
+/// at any index, and feeds its items to a sink in order.
+template <class T>
+class SliceProducer final {
+ public:
+  SliceProducer(T* data, usize len) noexcept : data_(data), len_(len) {}
+
+  usize len() const noexcept { return len_; }
+
+  /// Shortens the producer to `[0, mid)` and returns a producer of the items
+  /// in `[mid, len)`.
+  SliceProducer split_off(usize mid) noexcept {
+    auto back = SliceProducer(data_ + mid.primitive_value, len_ - mid);
+    len_ = mid;
+    return back;
+  }
+
+  /// Passes each item to `sink` until it returns false.
+  template <class Sink>
+  void feed(Sink& sink) noexcept {
+    for (size_t i = 0u; i < len_.primitive_value; ++i) {
+      if (!sink(data_[i])) return;
+    }
+  }
+
+ private:
+  T* data_;
+  usize len_;
+};
+
+/// The source of items for a parallel iterator over the integers in
+/// `[start, end)`.
+template <::sus::num::Integer T>
+class RangeProducer final {
+  using Primitive = decltype(T::primitive_value);
+  using Unsigned = std::make_unsigned_t<Primitive>;
+
+ public:
+  RangeProducer(T start, T end) noexcept : start_(start), end_(end) {}
+
+  usize len() const noexcept {
+    if (end_ <= start_) return 0u;
+    // Computed in unsigned arithmetic, as the distance between two signed
+    // integers may not fit in the signed type.
+    return usize::from(static_cast<Unsigned>(
+        static_cast<Unsigned>(end_.primitive_value) -
+        static_cast<Unsigned>(start_.primitive_value)));
+  }
+
+  RangeProducer split_off(usize mid) noexcept {
+    const T at = T(static_cast<Primitive>(
+        static_cast<Unsigned>(start_.primitive_value) +
+        static_cast<Unsigned>(mid.primitive_value)));
+    auto back = RangeProducer(at, end_);
+    end_ = at;
+    return back;
+  }
+
+  template <class Sink>
+  void feed(Sink& sink) noexcept {
+    for (Primitive i = start_.primitive_value; i < end_.primitive_value; ++i) {
+      if (!sink(T(i))) return;
+    }
+  }
+
+ private:
+  T start_;
+  T end_;
+};
+
+/// The first stage of a parallel iterator, which passes items through as is.
+struct Identity final {
+  template <class Down>
+  Down wrap(Down down) const noexcept {
+    return down;
+  }
+};
+
+template <class F, class Down>
+struct MapSink final {
+  template <class X>
+  bool operator()(X&& x) noexcept {
+    return down((*f)(::sus::forward<X>(x)));
+  }
+
+  const F* f;
+  Down down;
+};
+
+/// A stage of a parallel iterator which maps each item with `f`.
+template <class Prev, class F>
+struct MapStage final {
+  template <class Down>
+  auto wrap(Down down) const noexcept {
+    return prev.wrap(MapSink<F, Down>{.f = &f, .down = ::sus::move(down)});
+  }
+
+  Prev prev;
+  F f;
+};
+
+template <class P, class Down>
+struct FilterSink final {
+  template <class X>
+  bool operator()(X&& x) noexcept {
+    if (!(*pred)(std::as_const(x))) return true;
+    return down(::sus::forward<X>(x));
+  }
+
+  const P* pred;
+  Down down;
+};
+
+/// A stage of a parallel iterator which drops items that do not match `pred`.
+template <class Prev, class P>
+struct FilterStage final {
+  template <class Down>
+  auto wrap(Down down) const noexcept {
+    return prev.wrap(
+        FilterSink<P, Down>{.pred = &pred, .down = ::sus::move(down)});
+  }
+
+  Prev prev;
+  P pred;
+};
+
+/// Decides when to split the work of a parallel iterator, in the manner of
+/// Rayon's adaptive splitter.
+///
+/// Work is split into about as many pieces as there are threads. When a piece
+/// is stolen, the thief is evidently idle, so the piece is split again into as
+/// many pieces as there are threads, to keep all of them busy.
+struct Splitter final {
+  bool try_split(usize len, bool stolen) noexcept {
+    if (len < 2u) return false;
+    if (stolen) {
+      splits = splits / 2u > threads ? splits / 2u : threads;
+      return true;
+    }
+    if (splits > 0u) {
+      splits /= 2u;
+      return true;
+    }
+    return false;
+  }
+
+  usize splits;
+  usize threads;
+};
+
+/// Runs `leaf(producer, offset)` on pieces of `producer` across the threads of
+/// `pool`, where `offset` is the index of the piece's first item, and combines
+/// the results of the pieces with `reduce`.
+template <class Producer, class Leaf, class Reduce>
+auto bridge(ThreadPool& pool, Producer producer, usize offset,
+            Splitter splitter, bool stolen, const Leaf& leaf,
+            const Reduce& reduce) noexcept {
+  using R = std::invoke_result_t<const Leaf&, Producer&, usize>;
+  const usize len = producer.len();
+  if (!splitter.try_split(len, stolen)) return leaf(producer, offset);
+
+  const usize mid = len / 2u;
+  Producer back = producer.split_off(mid);
+  const std::thread::id forked_on = std::this_thread::get_id();
+  auto front_fn = [&]() {
+    return bridge(pool, ::sus::move(producer), offset, splitter, false, leaf,
+                  reduce);
+  };
+  auto back_fn = [&]() {
+    const bool back_stolen = std::this_thread::get_id() != forked_on;
+    return bridge(pool, ::sus::move(back), offset + mid, splitter,
+                  back_stolen, leaf, reduce);
+  };
+  if constexpr (std::is_void_v<R>) {
+    pool.join(front_fn, back_fn);
+  } else {
+    auto [a, b] = pool.join(front_fn, back_fn);
+    return reduce(::sus::move(a), ::sus::move(b));
+  }
+}
+
+}  // namespace sus::thread::__private
@@ -0,0 +1,115 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "subspace/containers/vec.h"
+#include "subspace/thread/__private/job.h"
+#include "subspace/thread/__private/work_deque.h"
+
+namespace sus::thread::__private {
+
+/// The state of one thread of a `ThreadPool`.
+struct Worker final {
+  /// The jobs queued by this thread, which other threads may steal.
+  WorkDeque deque;
+  Registry* registry = nullptr;
+  size_t index = 0u;
+  /// The state of a xorshift generator, used to pick threads to steal from.
+  uint64_t rng = 0u;
+};
+
+/// The shared state of a `ThreadPool` and its threads.
+class Registry final {
+ public:
+  /// Starts `num_threads` threads, which run until the `Registry` is
+  /// destroyed.
+  explicit Registry(size_t num_threads) noexcept;
+  /// Waits for all detached jobs to finish, then stops and joins the threads.
+  ~Registry() noexcept;
+
+  Registry(const Registry&) = delete;
+  Registry& operator=(const Registry&) = delete;
+
+  size_t num_threads() const noexcept { return num_threads_; }
+
+  /// Returns the `Worker` of the current thread, if it is a thread of this
+  /// pool, or null.
+  Worker* current_worker() noexcept;
+
+  /// Queues a job to run on the pool. The job is pushed onto the current
+  /// thread's deque if it is a thread of this pool, and otherwise onto the
+  /// queue of jobs from outside the pool.
+  void push(Job& job) noexcept;
+
+  /// Runs jobs until `latch` is set, sleeping if there are none to run.
+  void wait_until(Worker& worker, const CountLatch& latch) noexcept;
+
+  /// Waits for a job pushed by `worker` to finish, which sets `latch`. If the
+  /// job has not been stolen, it is popped and run on this thread.
+  void wait_for_local_job(Worker& worker, const CountLatch& latch) noexcept;
+
+  /// Queues `f` to run as a job on the pool, as with `push()`, without
+  /// waiting for it. The pool is not destroyed until it has run.
+  template <class F>
+  void spawn_detached(F f) noexcept {
+    detached_.increment();
+    push(HeapJob<F>::with(::sus::move(f), detached_));
+  }
+
+  /// Wakes sleeping threads so that they look for jobs to run, or for their
+  /// latch to be set.
+  void notify(bool all) noexcept;
+
+ private:
+  friend class CountLatch;
+
+  void main_loop(Worker& worker) noexcept;
+  Job* find_work(Worker& worker) noexcept;
+  Job* pop_injected() noexcept;
+  void sleep(uint64_t epoch, const CountLatch* latch) noexcept;
+  bool should_exit() const noexcept;
+
+  size_t num_threads_;
+  Worker* workers_;
+  ::sus::Vec<std::thread> threads_;
+
+  // Jobs pushed from outside the pool, in FIFO order.
+  std::mutex injected_mutex_;
+  Job* injected_head_ = nullptr;
+  Job* injected_tail_ = nullptr;
+  std::atomic<size_t> injected_len_ = 0u;
+
+  // Threads with nothing to run sleep on `sleep_cv_` until `epoch_` changes,
+  // which happens whenever a job is queued or a latch is set.
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  std::atomic<uint64_t> epoch_ = 0u;
+  std::atomic<size_t> sleepers_ = 0u;
+
+  // Counts the jobs from `spawn_detached()` which have not finished, plus one
+  // which is released when the pool is destroyed. The threads exit once this
+  // reaches zero.
+  CountLatch detached_;
+};
+
+}  // namespace sus::thread::__private
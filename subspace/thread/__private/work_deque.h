@@ -0,0 +1,178 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <new>
+
+#include "subspace/mem/alloc.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/replace.h"
+
+namespace sus::thread::__private {
+
+struct Job;
+
+/// The result of `WorkDeque::steal()`.
+enum class Steal {
+  /// The deque was empty.
+  Empty,
+  /// Another thread took the job at the top of the deque first. The deque may
+  /// still hold other jobs.
+  Retry,
+  /// A job was stolen.
+  Success,
+};
+
+/// A Chase-Lev work-stealing deque of pointers to jobs.
+///
+/// The thread which owns the deque pushes and pops jobs at the bottom, in LIFO
+/// order, without taking a lock. Other threads steal jobs from the top, in
+/// FIFO order, with a single compare-and-swap. The ring buffer grows as
+/// needed. Buffers which are replaced are kept until the deque is destroyed,
+/// as a thief may still be reading from them.
+///
+/// The memory orderings follow "Correct and Efficient Work-Stealing for Weak
+/// Memory Models" (Lê, Pop, Cohen, Zappa Nardelli, PPoPP 2013).
+class WorkDeque final {
+ public:
+  WorkDeque() noexcept : top_(0), bottom_(0), buffer_(make_buffer(kMinCap)) {}
+  ~WorkDeque() noexcept {
+    Buffer* b = buffer_.load(std::memory_order_relaxed);
+    while (b != nullptr)
+      free_buffer(::sus::mem::replace_ptr(mref(b), b->prev));
+  }
+
+  WorkDeque(const WorkDeque&) = delete;
+  WorkDeque& operator=(const WorkDeque&) = delete;
+
+  /// Pushes a job onto the bottom of the deque. Must only be called by the
+  /// thread which owns the deque.
+  void push(Job* job) noexcept {
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_acquire);
+    Buffer* a = buffer_.load(std::memory_order_relaxed);
+    if (b - t > static_cast<int64_t>(a->mask)) [[unlikely]]
+      a = grow(a, t, b);
+    a->at(b).store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /// Pops the most recently pushed job from the bottom of the deque, or
+  /// returns null if it is empty. Must only be called by the thread which
+  /// owns the deque.
+  Job* pop() noexcept {
+    const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Buffer* a = buffer_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+    if (t > b) {
+      // Empty.
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    Job* job = a->at(b).load(std::memory_order_relaxed);
+    if (t == b) {
+      // The last job, which a thief may be stealing at the same time.
+      if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        job = nullptr;
+      }
+      bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+  }
+
+  /// Tries to steal the least recently pushed job from the top of the deque.
+  /// May be called from any thread.
+  Steal steal(Job*& out) noexcept {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) return Steal::Empty;
+    Buffer* a = buffer_.load(std::memory_order_acquire);
+    Job* job = a->at(t).load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return Steal::Retry;
+    }
+    out = job;
+    return Steal::Success;
+  }
+
+  /// Returns whether the deque looked empty. Another thread may change this
+  /// at any time.
+  bool is_empty() const noexcept {
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_relaxed);
+    return t >= b;
+  }
+
+ private:
+  // A ring buffer with a power-of-two capacity, followed in the same
+  // allocation by its slots.
+  struct Buffer {
+    size_t mask;
+    // The buffer this one replaced, which is freed with the deque.
+    Buffer* prev;
+
+    std::atomic<Job*>& at(int64_t i) noexcept {
+      auto* slots = reinterpret_cast<std::atomic<Job*>*>(this + 1);
+      return slots[static_cast<size_t>(i) & mask];
+    }
+  };
+  static_assert(alignof(Buffer) >= alignof(std::atomic<Job*>));
+
+  static constexpr size_t kMinCap = 64u;
+
+  static Buffer* make_buffer(size_t cap) noexcept {
+    void* p = ::sus::mem::allocate(
+        sizeof(Buffer) + cap * sizeof(std::atomic<Job*>), alignof(Buffer));
+    auto* buffer = new (p) Buffer{.mask = cap - 1u, .prev = nullptr};
+    auto* slots = reinterpret_cast<std::atomic<Job*>*>(buffer + 1);
+    for (size_t i = 0u; i < cap; ++i) new (slots + i) std::atomic<Job*>();
+    return buffer;
+  }
+  static void free_buffer(Buffer* buffer) noexcept {
+    ::sus::mem::deallocate(buffer, alignof(Buffer));
+  }
+
+  // Replaces the full buffer `a`, which holds the jobs in `[t, b)`, with one
+  // of twice the capacity.
+  Buffer* grow(Buffer* a, int64_t t, int64_t b) noexcept {
+    Buffer* bigger = make_buffer((a->mask + 1u) * 2u);
+    for (int64_t i = t; i < b; ++i) {
+      bigger->at(i).store(a->at(i).load(std::memory_order_relaxed),
+                          std::memory_order_relaxed);
+    }
+    bigger->prev = a;
+    buffer_.store(bigger, std::memory_order_release);
+    return bigger;
+  }
+
+  // Thieves take from the top, and the owner pushes and pops at the bottom.
+  // They are kept on separate cache lines, as they are written by different
+  // threads.
+  alignas(64) std::atomic<int64_t> top_;
+  alignas(64) std::atomic<int64_t> bottom_;
+  std::atomic<Buffer*> buffer_;
+};
+
+}  // namespace sus::thread::__private
@@ -0,0 +1,282 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <type_traits>
+
+#include "subspace/containers/vec.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/forward.h"
+#include "subspace/mem/move.h"
+#include "subspace/num/integer_concepts.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/thread/__private/par_bridge.h"
+#include "subspace/thread/thread_pool.h"
+
+namespace sus::thread {
+
+/// An iterator whose items are processed in parallel on a `ThreadPool`.
+///
+/// A parallel iterator is created by `par_iter()` or `par_iter_mut()` on a
+/// `Slice` or `Vec`, or by `par_range()`. It is transformed by adaptors like
+/// `map()` and `filter()`, which mirror those of `sus::iter::Iterator`, and is
+/// then consumed by a method like `sum()`, `for_each()` or `collect_vec()`,
+/// which runs the work on the pool and returns once it is done.
+///
+/// The items are split into pieces which are run with `ThreadPool::join()`.
+/// The splitting is adaptive: the items are first split into about as many
+/// pieces as there are threads, and a piece is split further whenever it is
+/// stolen by an idle thread.
+///
+/// The closures given to the adaptors and consumers are called concurrently
+/// from many threads through a const reference, so they must be safe to call
+/// that way.
+///
+/// The work runs on `ThreadPool::global()` unless another pool is given with
+/// `with_pool()`.
+template <class Producer, class Stage, class Item, bool Indexed>
+class [[nodiscard]] ParIter final {
+ public:
+  /// Constructs a parallel iterator over the items of `producer`. Use
+  /// `par_iter()`, `par_iter_mut()` or `par_range()` instead of calling this
+  /// directly.
+  explicit ParIter(Producer producer) noexcept
+    requires(std::is_same_v<Stage, __private::Identity>)
+      : producer_(::sus::move(producer)),
+        stage_(),
+        pool_(&ThreadPool::global()) {}
+
+  /// Runs the iterator on `pool` instead of on `ThreadPool::global()`.
+  ParIter with_pool(ThreadPool& pool) && noexcept {
+    pool_ = &pool;
+    return ::sus::move(*this);
+  }
+
+  /// Creates a parallel iterator which maps each item with `fn`.
+  ///
+  /// The returned iterator's item type is whatever is returned by `fn`.
+  template <class MapFn, int&...,
+            class R = std::invoke_result_t<const MapFn&, Item&&>>
+    requires(!std::is_void_v<R>)
+  auto map(MapFn fn) && noexcept {
+    using S = __private::MapStage<Stage, MapFn>;
+    return ParIter<Producer, S, R, Indexed>(
+        ::sus::move(producer_),
+        S{.prev = ::sus::move(stage_), .f = ::sus::move(fn)}, *pool_);
+  }
+
+  /// Creates a parallel iterator which yields only the items for which `pred`
+  /// returns true.
+  template <class Pred>
+    requires(std::is_invocable_r_v<bool, const Pred&,
+                                   const std::remove_reference_t<Item>&>)
+  auto filter(Pred pred) && noexcept {
+    using S = __private::FilterStage<Stage, Pred>;
+    return ParIter<Producer, S, Item, false>(
+        ::sus::move(producer_),
+        S{.prev = ::sus::move(stage_), .pred = ::sus::move(pred)}, *pool_);
+  }
+
+  /// Calls `fn` on each item, in no particular order.
+  template <class F>
+    requires(std::is_invocable_v<const F&, Item &&>)
+  void for_each(F fn) && noexcept {
+    run([&fn, this](Producer& p, usize) {
+      auto sink = stage_.wrap([&fn](Item&& x) {
+        fn(::sus::forward<Item>(x));
+        return true;
+      });
+      p.feed(sink);
+    });
+  }
+
+  /// Consumes the iterator, and returns the number of items that were in it.
+  usize count() && noexcept {
+    return run(
+        [this](Producer& p, usize) {
+          usize n = 0u;
+          auto sink = stage_.wrap([&n](Item&&) {
+            n += 1u;
+            return true;
+          });
+          p.feed(sink);
+          return n;
+        },
+        [](usize a, usize b) { return a + b; });
+  }
+
+  /// Sums the items of the iterator.
+  ///
+  /// An empty iterator returns the default value of the item type, which is
+  /// zero for numeric types. The order in which items are added is not
+  /// specified, so the sum of floating point items may differ between runs.
+  ///
+  /// # Panics
+  /// For integer items, panics if the sum overflows.
+  template <int&..., class S = std::remove_cvref_t<Item>>
+    requires(std::is_default_constructible_v<S> &&
+             requires(S& s, Item&& x) { s += ::sus::forward<Item>(x); })
+  S sum() && noexcept {
+    return run(
+        [this](Producer& p, usize) {
+          S acc = S();
+          auto sink = stage_.wrap([&acc](Item&& x) {
+            acc += ::sus::forward<Item>(x);
+            return true;
+          });
+          p.feed(sink);
+          return acc;
+        },
+        [](S a, S b) {
+          a += ::sus::move(b);
+          return a;
+        });
+  }
+
+  /// Reduces the items to a single value with `op`, which must be
+  /// associative. The `identity` is returned if the iterator is empty, and
+  /// may be combined with items any number of times, so it must not change
+  /// the result, like `0` for addition.
+  template <class Op, int&..., class S = std::remove_cvref_t<Item>>
+    requires(std::is_invocable_r_v<S, const Op&, S, S>)
+  S reduce(std::type_identity_t<S> identity, Op op) && noexcept {
+    return run(
+        [this, &identity, &op](Producer& p, usize) {
+          S acc = identity;
+          auto sink = stage_.wrap([&acc, &op](Item&& x) {
+            acc = op(::sus::move(acc), S(::sus::forward<Item>(x)));
+            return true;
+          });
+          p.feed(sink);
+          return acc;
+        },
+        [&op](S a, S b) { return op(::sus::move(a), ::sus::move(b)); });
+  }
+
+  /// Tests whether all items match `pred`.
+  ///
+  /// Once an item that does not match is found, the remaining work stops
+  /// early. Returns `true` if the iterator is empty.
+  template <class Pred>
+    requires(std::is_invocable_r_v<bool, const Pred&, Item &&>)
+  bool all(Pred pred) && noexcept {
+    std::atomic<bool> failed = false;
+    run([this, &pred, &failed](Producer& p, usize) {
+      auto sink = stage_.wrap([&pred, &failed](Item&& x) {
+        if (failed.load(std::memory_order_relaxed)) return false;
+        if (pred(::sus::forward<Item>(x))) return true;
+        failed.store(true, std::memory_order_relaxed);
+        return false;
+      });
+      p.feed(sink);
+    });
+    return !failed.load(std::memory_order_relaxed);
+  }
+
+  /// Tests whether any item matches `pred`.
+  ///
+  /// Once a matching item is found, the remaining work stops early. Returns
+  /// `false` if the iterator is empty.
+  template <class Pred>
+    requires(std::is_invocable_r_v<bool, const Pred&, Item &&>)
+  bool any(Pred pred) && noexcept {
+    return !::sus::move(*this).all(
+        [&pred](Item&& x) { return !pred(::sus::forward<Item>(x)); });
+  }
+
+  /// Collects the items into a `Vec`, in the same order as they were in the
+  /// source.
+  ///
+  /// If the iterator is not filtered, the number of items is known up front,
+  /// and each thread writes its items directly into their place in the
+  /// output. Otherwise each thread collects its items into a `Vec` of its
+  /// own, which are then concatenated in order.
+  template <int&..., class Vec = ::sus::containers::Vec<Item>>
+    requires(!std::is_reference_v<Item>)
+  Vec collect_vec() && noexcept {
+    if constexpr (Indexed) {
+      const usize len = producer_.len();
+      auto v = Vec::with_capacity(len);
+      if (len == 0u) return v;
+      Item* const out = v.as_mut_ptr();
+      run([this, out](Producer& p, usize offset) {
+        Item* at = out + offset.primitive_value;
+        auto sink = stage_.wrap([&at](Item&& x) {
+          new (at) Item(::sus::move(x));
+          at += 1;
+          return true;
+        });
+        p.feed(sink);
+      });
+      // SAFETY: Every item in `[0, len)` was written above, as the map stages
+      // produce exactly one item for each item of the producer.
+      v.set_len(::sus::marker::unsafe_fn, len);
+      return v;
+    } else {
+      return run(
+          [this](Producer& p, usize) {
+            auto v = Vec();
+            auto sink = stage_.wrap([&v](Item&& x) {
+              v.push(::sus::move(x));
+              return true;
+            });
+            p.feed(sink);
+            return v;
+          },
+          [](Vec a, Vec b) {
+            a.reserve(b.len());
+            for (Item& x : b.iter_mut()) a.push(::sus::move(x));
+            return a;
+          });
+    }
+  }
+
+ private:
+  template <class P, class S, class I, bool X>
+  friend class ParIter;
+
+  ParIter(Producer producer, Stage stage, ThreadPool& pool) noexcept
+      : producer_(::sus::move(producer)),
+        stage_(::sus::move(stage)),
+        pool_(&pool) {}
+
+  template <class Leaf>
+  void run(const Leaf& leaf) noexcept {
+    run(leaf, [](auto&&...) {});
+  }
+  template <class Leaf, class Reduce>
+  auto run(const Leaf& leaf, const Reduce& reduce) noexcept {
+    const usize threads = pool_->num_threads();
+    return __private::bridge(
+        *pool_, ::sus::move(producer_), 0u,
+        __private::Splitter{.splits = threads, .threads = threads}, false,
+        leaf, reduce);
+  }
+
+  Producer producer_;
+  Stage stage_;
+  ThreadPool* pool_;
+};
+
+/// Returns a parallel iterator over the integers in `[start, end)`.
+template <::sus::num::Integer T>
+auto par_range(T start, T end) noexcept {
+  using P = __private::RangeProducer<T>;
+  return ParIter<P, __private::Identity, T, true>(P(start, end));
+}
+
+}  // namespace sus::thread
@@ -0,0 +1,157 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/thread/par_iter.h"
+
+#include <atomic>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/slice.h"
+#include "subspace/containers/vec.h"
+#include "subspace/prelude.h"
+#include "subspace/thread/thread_pool.h"
+
+namespace {
+
+using sus::thread::par_range;
+using sus::thread::ThreadPool;
+
+sus::Vec<u64> iota(u64 n) {
+  auto v = sus::Vec<u64>::with_capacity(usize::from(n));
+  for (u64 i = 0u; i < n; i += 1u) v.push(i);
+  return v;
+}
+
+TEST(ParIter, Sum) {
+  const auto v = iota(10000u);
+  EXPECT_EQ(v.par_iter().sum(), 9999u * 10000u / 2u);
+  EXPECT_EQ(v.as_ref().par_iter().sum(), 9999u * 10000u / 2u);
+
+  const auto empty = sus::Vec<u64>();
+  EXPECT_EQ(empty.par_iter().sum(), 0u);
+}
+
+TEST(ParIter, MapFilterSum) {
+  const auto v = iota(1000u);
+  u64 expected = 0u;
+  for (u64 i = 0u; i < 1000u; i += 1u) {
+    if (i % 3u == 0u) expected += i * 2u;
+  }
+  u64 sum = v.par_iter()
+                .filter([](const u64& x) { return x % 3u == 0u; })
+                .map([](const u64& x) { return x * 2u; })
+                .sum();
+  EXPECT_EQ(sum, expected);
+}
+
+TEST(ParIter, Count) {
+  const auto v = iota(1001u);
+  EXPECT_EQ(v.par_iter().count(), 1001u);
+  EXPECT_EQ(
+      v.par_iter().filter([](const u64& x) { return x % 2u == 0u; }).count(),
+      501u);
+}
+
+TEST(ParIter, ForEachMut) {
+  auto v = iota(5000u);
+  v.par_iter_mut().for_each([](u64& x) { x *= 2u; });
+  for (usize i = 0u; i < v.len(); i += 1u) EXPECT_EQ(v[i], u64::from(i) * 2u);
+
+  std::atomic<int> calls = 0;
+  v.par_iter().for_each([&](const u64&) { calls.fetch_add(1); });
+  EXPECT_EQ(calls.load(), 5000);
+}
+
+TEST(ParIter, Reduce) {
+  const auto v = iota(1000u);
+  u64 max = v.par_iter().reduce(
+      0u, [](u64 a, u64 b) { return a > b ? a : b; });
+  EXPECT_EQ(max, 999u);
+
+  const auto empty = sus::Vec<u64>();
+  EXPECT_EQ(empty.par_iter().reduce(7u, [](u64 a, u64 b) { return a + b; }),
+            7u);
+}
+
+TEST(ParIter, AllAny) {
+  const auto v = iota(10000u);
+  EXPECT_TRUE(v.par_iter().all([](const u64& x) { return x < 10000u; }));
+  EXPECT_FALSE(v.par_iter().all([](const u64& x) { return x != 5000u; }));
+  EXPECT_TRUE(v.par_iter().any([](const u64& x) { return x == 9999u; }));
+  EXPECT_FALSE(v.par_iter().any([](const u64& x) { return x > 10000u; }));
+
+  const auto empty = sus::Vec<u64>();
+  EXPECT_TRUE(empty.par_iter().all([](const u64&) { return false; }));
+  EXPECT_FALSE(empty.par_iter().any([](const u64&) { return true; }));
+}
+
+TEST(ParIter, CollectVecIndexed) {
+  const auto v = iota(3000u);
+  sus::Vec<u64> out = v.par_iter().map([](const u64& x) { return x + 1u; })
+                          .collect_vec();
+  ASSERT_EQ(out.len(), 3000u);
+  for (usize i = 0u; i < out.len(); i += 1u)
+    EXPECT_EQ(out[i], u64::from(i) + 1u);
+
+  const auto empty = sus::Vec<u64>();
+  EXPECT_EQ(empty.par_iter().map([](const u64& x) { return x; })
+                .collect_vec()
+                .len(),
+            0u);
+}
+
+TEST(ParIter, CollectVecFiltered) {
+  const auto v = iota(3000u);
+  sus::Vec<u64> out = v.par_iter()
+                          .filter([](const u64& x) { return x % 7u == 0u; })
+                          .map([](const u64& x) { return x; })
+                          .collect_vec();
+  ASSERT_EQ(out.len(), 429u);
+  // The order of the source is kept.
+  for (usize i = 0u; i < out.len(); i += 1u)
+    EXPECT_EQ(out[i], u64::from(i) * 7u);
+}
+
+TEST(ParIter, Range) {
+  EXPECT_EQ(par_range(0_u32, 1000_u32).sum(), 999u * 1000u / 2u);
+  EXPECT_EQ(par_range(-500_i32, 500_i32).sum(), -500_i32);
+  EXPECT_EQ(par_range(10_i32, 5_i32).count(), 0u);
+
+  sus::Vec<i32> squares =
+      par_range(0_i32, 100_i32).map([](i32 x) { return x * x; }).collect_vec();
+  ASSERT_EQ(squares.len(), 100u);
+  EXPECT_EQ(squares[9u], 81_i32);
+}
+
+TEST(ParIter, WithPool) {
+  auto pool = ThreadPool::with_num_threads(3u);
+  const auto v = iota(2000u);
+  EXPECT_EQ(v.par_iter().with_pool(pool).sum(), 1999u * 2000u / 2u);
+}
+
+TEST(ParIter, Nested) {
+  const auto v = iota(100u);
+  u64 sum = v.par_iter()
+                .map([](const u64& x) {
+                  return par_range(0_u64, x).map([](u64 y) { return y; }).sum();
+                })
+                .sum();
+  u64 expected = 0u;
+  for (u64 x = 0u; x < 100u; x += 1u) {
+    for (u64 y = 0u; y < x; y += 1u) expected += y;
+  }
+  EXPECT_EQ(sum, expected);
+}
+
+}  // namespace
@@ -0,0 +1,235 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/thread/thread_pool.h"
+
+#include <thread>
+
+#include "subspace/assertions/check.h"
+
+namespace sus::thread {
+
+namespace __private {
+
+namespace {
+
+// The worker of the pool which owns the current thread, if any.
+thread_local Worker* current = nullptr;
+
+// Returns the next value of a xorshift64 generator.
+uint64_t next_random(Worker& worker) noexcept {
+  uint64_t x = worker.rng;
+  x ^= x << 13u;
+  x ^= x >> 7u;
+  x ^= x << 17u;
+  worker.rng = x;
+  return x;
+}
+
+}  // namespace
+
+void CountLatch::count_down() noexcept {
+  // The latch may be destroyed as soon as the count reaches zero.
+  Registry& registry = registry_;
+  if (count_.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+    registry.notify(true);
+}
+
+Registry::Registry(size_t num_threads) noexcept
+    : num_threads_(num_threads),
+      workers_(new Worker[num_threads]),
+      threads_(::sus::Vec<std::thread>::with_capacity(num_threads)),
+      detached_(*this, 1u) {
+  for (size_t i = 0u; i < num_threads; ++i) {
+    workers_[i].registry = this;
+    workers_[i].index = i;
+    // Any non-zero seed works for xorshift.
+    workers_[i].rng = (i + 1u) * 0x9e3779b97f4a7c15u;
+  }
+  for (size_t i = 0u; i < num_threads; ++i)
+    threads_.push(std::thread([this, i]() { main_loop(workers_[i]); }));
+}
+
+Registry::~Registry() noexcept {
+  // Release the count held by the pool. The threads exit once every detached
+  // job has run.
+  detached_.count_down();
+  for (std::thread& t : threads_.iter_mut()) t.join();
+  delete[] workers_;
+}
+
+Worker* Registry::current_worker() noexcept {
+  Worker* worker = current;
+  return worker != nullptr && worker->registry == this ? worker : nullptr;
+}
+
+void Registry::push(Job& job) noexcept {
+  if (Worker* worker = current_worker()) {
+    worker->deque.push(&job);
+  } else {
+    std::lock_guard<std::mutex> lock(injected_mutex_);
+    job.next = nullptr;
+    if (injected_tail_ != nullptr)
+      injected_tail_->next = &job;
+    else
+      injected_head_ = &job;
+    injected_tail_ = &job;
+    injected_len_.fetch_add(1u, std::memory_order_relaxed);
+  }
+  notify(false);
+}
+
+void Registry::notify(bool all) noexcept {
+  // A sleeping thread registers itself in `sleepers_` before checking the
+  // epoch, and this changes the epoch before checking `sleepers_`, so either
+  // the sleeping thread sees the new epoch, or this sees the sleeping thread.
+  epoch_.fetch_add(1u, std::memory_order_seq_cst);
+  if (sleepers_.load(std::memory_order_seq_cst) == 0u) return;
+  std::lock_guard<std::mutex> lock(sleep_mutex_);
+  if (all)
+    sleep_cv_.notify_all();
+  else
+    sleep_cv_.notify_one();
+}
+
+void Registry::wait_until(Worker& worker, const CountLatch& latch) noexcept {
+  while (!latch.probe()) {
+    // The epoch is read before looking for jobs, so that a job queued after
+    // the search prevents sleeping.
+    const uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+    if (Job* job = find_work(worker)) {
+      job->execute(*job);
+      continue;
+    }
+    sleep(epoch, &latch);
+  }
+}
+
+void Registry::wait_for_local_job(Worker& worker,
+                                  const CountLatch& latch) noexcept {
+  while (!latch.probe()) {
+    // Jobs pushed after the awaited one have all finished, so the job at the
+    // bottom of the deque is the awaited one, unless it was stolen, in which
+    // case it's a job pushed earlier which is run while waiting.
+    Job* job = worker.deque.pop();
+    if (job == nullptr) {
+      wait_until(worker, latch);
+      return;
+    }
+    job->execute(*job);
+  }
+}
+
+void Registry::main_loop(Worker& worker) noexcept {
+  current = &worker;
+  while (true) {
+    const uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+    if (Job* job = find_work(worker)) {
+      job->execute(*job);
+      continue;
+    }
+    if (should_exit()) break;
+    sleep(epoch, nullptr);
+  }
+  current = nullptr;
+}
+
+Job* Registry::find_work(Worker& worker) noexcept {
+  if (Job* job = worker.deque.pop()) return job;
+  if (num_threads_ > 1u) {
+    bool retry = true;
+    while (retry) {
+      retry = false;
+      // Start from a random thread, so that thieves spread out.
+      const size_t start = next_random(worker) % num_threads_;
+      for (size_t i = 0u; i < num_threads_; ++i) {
+        Worker& victim = workers_[(start + i) % num_threads_];
+        if (&victim == &worker) continue;
+        Job* job;
+        switch (victim.deque.steal(job)) {
+          case Steal::Success: return job;
+          case Steal::Retry: retry = true; break;
+          case Steal::Empty: break;
+        }
+      }
+    }
+  }
+  return pop_injected();
+}
+
+Job* Registry::pop_injected() noexcept {
+  if (injected_len_.load(std::memory_order_relaxed) == 0u) return nullptr;
+  std::lock_guard<std::mutex> lock(injected_mutex_);
+  Job* job = injected_head_;
+  if (job == nullptr) return nullptr;
+  injected_head_ = job->next;
+  if (injected_head_ == nullptr) injected_tail_ = nullptr;
+  injected_len_.fetch_sub(1u, std::memory_order_relaxed);
+  return job;
+}
+
+void Registry::sleep(uint64_t epoch, const CountLatch* latch) noexcept {
+  std::unique_lock<std::mutex> lock(sleep_mutex_);
+  sleepers_.fetch_add(1u, std::memory_order_seq_cst);
+  while (epoch_.load(std::memory_order_seq_cst) == epoch) {
+    if (latch != nullptr ? latch->probe() : should_exit()) break;
+    sleep_cv_.wait(lock);
+  }
+  sleepers_.fetch_sub(1u, std::memory_order_relaxed);
+}
+
+bool Registry::should_exit() const noexcept { return detached_.probe(); }
+
+}  // namespace __private
+
+namespace {
+
+size_t available_parallelism() noexcept {
+  const unsigned n = std::thread::hardware_concurrency();
+  return n > 0u ? n : 1u;
+}
+
+}  // namespace
+
+ThreadPool::ThreadPool() noexcept : ThreadPool(available_parallelism()) {}
+
+ThreadPool::ThreadPool(size_t num_threads) noexcept
+    : registry_(new __private::Registry(num_threads)) {}
+
+ThreadPool ThreadPool::with_num_threads(usize num_threads) noexcept {
+  check(num_threads > 0u);
+  return ThreadPool(num_threads.primitive_value);
+}
+
+ThreadPool& ThreadPool::global() noexcept {
+  static ThreadPool* const pool = new ThreadPool();
+  return *pool;
+}
+
+ThreadPool::~ThreadPool() noexcept { delete registry_; }
+
+ThreadPool& ThreadPool::operator=(ThreadPool&& o) noexcept {
+  check(o.registry_ != nullptr);
+  if (&o == this) return *this;
+  delete registry_;
+  registry_ = ::sus::mem::replace_ptr(mref(o.registry_), nullptr);
+  return *this;
+}
+
+void ThreadPool::spawn(::sus::fn::FnOnce<void()> f) & noexcept {
+  check(registry_ != nullptr);
+  registry_->spawn_detached(::sus::move(f));
+}
+
+}  // namespace sus::thread
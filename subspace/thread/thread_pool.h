@@ -0,0 +1,235 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stddef.h>
+
+#include <type_traits>
+
+#include "subspace/assertions/check.h"
+#include "subspace/fn/fn_defn.h"
+#include "subspace/marker/unsafe.h"
+#include "subspace/mem/move.h"
+#include "subspace/mem/mref.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/mem/replace.h"
+#include "subspace/num/unsigned_integer.h"
+#include "subspace/thread/__private/job.h"
+#include "subspace/thread/__private/registry.h"
+#include "subspace/tuple/tuple.h"
+
+namespace sus::thread {
+
+class ThreadPool;
+
+/// A scope in which tasks can be spawned onto a `ThreadPool`, which is
+/// created by `ThreadPool::scope()`.
+///
+/// Every task spawned in the scope finishes before `ThreadPool::scope()`
+/// returns, so the tasks may refer to data on the stack of the caller of
+/// `scope()`.
+class Scope final {
+ public:
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+  /// Spawns a task to run on the pool, which finishes before the scope ends.
+  ///
+  /// The task is a callable object which receives no arguments, or which
+  /// receives a reference to the `Scope` so that it may spawn more tasks. A
+  /// `sus::fn::FnOnce<void()>` may be given as the task.
+  ///
+  /// The task is stored with the pool's queued job, which is allocated from
+  /// the `sus::mem::SlabAllocator` instead of from the global allocator.
+  template <class F>
+    requires(std::is_invocable_r_v<void, F&&> ||
+             std::is_invocable_r_v<void, F&&, Scope&>)
+  void spawn(F f) & noexcept {
+    latch_.increment();
+    if constexpr (std::is_invocable_r_v<void, F&&, Scope&>) {
+      auto task = [f = ::sus::move(f), this]() mutable {
+        ::sus::move(f)(*this);
+      };
+      registry_.push(
+          __private::HeapJob<decltype(task)>::with(::sus::move(task), latch_));
+    } else {
+      registry_.push(__private::HeapJob<F>::with(::sus::move(f), latch_));
+    }
+  }
+
+ private:
+  friend class ThreadPool;
+
+  explicit Scope(__private::Registry& registry) noexcept
+      : registry_(registry), latch_(registry, 1u) {}
+
+  // Waits for all of the spawned tasks to finish, running other jobs while
+  // waiting.
+  void finish(__private::Worker& worker) noexcept {
+    latch_.count_down();
+    registry_.wait_until(worker, latch_);
+  }
+
+  __private::Registry& registry_;
+  // Counts the spawned tasks which have not finished, plus one for the body
+  // of the scope.
+  __private::CountLatch latch_;
+};
+
+/// A pool of threads which run tasks, with work stealing.
+///
+/// Each thread of the pool has its own deque of tasks. A thread pushes the
+/// tasks it spawns onto its own deque and runs them in LIFO order, which keeps
+/// recently used data in its cache. A thread that runs out of tasks steals the
+/// oldest task from another thread's deque, which tends to be the largest
+/// piece of remaining work. Threads sleep when there is nothing to run.
+///
+/// Tasks can be run on the pool in three ways:
+/// * `join()` runs two closures, potentially in parallel, and returns both of
+///   their results. This is the basic building block for divide-and-conquer
+///   algorithms, and does not allocate.
+/// * `scope()` runs a closure which can spawn any number of tasks that may
+///   refer to the caller's stack, and waits for all of them to finish.
+/// * `spawn()` queues a `sus::fn::FnOnce` to run in the background, and does
+///   not wait for it.
+///
+/// Threads of the pool that wait for tasks in `join()` or `scope()` run other
+/// tasks while they wait, so the pool does not deadlock when these are
+/// nested. When called from a thread outside of the pool, `join()` and
+/// `scope()` run on a thread of the pool and block the calling thread until
+/// they are done.
+///
+/// Destroying the pool waits for all of the tasks queued by `spawn()` to run,
+/// then stops its threads.
+class [[sus_trivial_abi]] ThreadPool final {
+ public:
+  /// Constructs a pool with a thread for each of the CPU cores available to
+  /// the process.
+  ///
+  /// sus::construct::Default trait.
+  ThreadPool() noexcept;
+
+  /// Constructs a pool with `num_threads` threads.
+  ///
+  /// # Panics
+  /// Panics if `num_threads` is zero.
+  static ThreadPool with_num_threads(usize num_threads) noexcept;
+
+  /// Returns the pool shared by the whole process, which parallel iterators
+  /// run on by default.
+  ///
+  /// The pool has a thread for each of the CPU cores available to the process.
+  /// It is created the first time it is used, and is never destroyed, so that
+  /// it may be used during static destruction.
+  static ThreadPool& global() noexcept;
+
+  ~ThreadPool() noexcept;
+
+  ThreadPool(ThreadPool&& o) noexcept
+      : registry_(::sus::mem::replace_ptr(mref(o.registry_), nullptr)) {
+    check(registry_ != nullptr);
+  }
+  ThreadPool& operator=(ThreadPool&& o) noexcept;
+
+  /// Returns the number of threads in the pool.
+  usize num_threads() const& noexcept {
+    check(registry_ != nullptr);
+    return registry_->num_threads();
+  }
+
+  /// Queues `f` to run on a thread of the pool, without waiting for it.
+  ///
+  /// The `FnOnce` is stored with the pool's queued job, which is allocated
+  /// from the `sus::mem::SlabAllocator` instead of from the global
+  /// allocator. Note that an `FnOnce` which holds captures has its own
+  /// allocation, made when it was constructed.
+  void spawn(::sus::fn::FnOnce<void()> f) & noexcept;
+
+  /// Runs `f` with a `Scope` in which tasks can be spawned, and returns the
+  /// result of `f` once every spawned task has finished.
+  template <class F, int&..., class R = std::invoke_result_t<F&&, Scope&>>
+  R scope(F f) & noexcept {
+    auto op = [this, &f](__private::Worker& worker) -> R {
+      Scope s(*registry_);
+      if constexpr (std::is_void_v<R>) {
+        ::sus::move(f)(s);
+        s.finish(worker);
+      } else {
+        R r = ::sus::move(f)(s);
+        s.finish(worker);
+        return r;
+      }
+    };
+    return in_worker(op);
+  }
+
+  /// Runs `a` and `b`, potentially in parallel, and returns once both have
+  /// finished.
+  ///
+  /// The closure `b` is made available for another thread to steal while `a`
+  /// runs on the current thread. If no thread has stolen `b` by the time `a`
+  /// finishes, it is run on the current thread.
+  ///
+  /// If both closures return a value, they are returned together in a
+  /// `Tuple`. If neither returns a value, nothing is returned.
+  template <class A, class B, int&..., class RA = std::invoke_result_t<A&&>,
+            class RB = std::invoke_result_t<B&&>>
+    requires(std::is_void_v<RA> == std::is_void_v<RB>)
+  auto join(A a, B b) & noexcept {
+    auto op = [this, &a, &b](__private::Worker& worker) {
+      __private::CountLatch latch(*registry_, 1u);
+      __private::StackJob<B, __private::CountLatch> job_b(b, latch);
+      registry_->push(job_b);
+      if constexpr (std::is_void_v<RA>) {
+        ::sus::move(a)();
+        registry_->wait_for_local_job(worker, latch);
+      } else {
+        RA ra = ::sus::move(a)();
+        registry_->wait_for_local_job(worker, latch);
+        return ::sus::Tuple<RA, RB>::with(::sus::move(ra),
+                                          ::sus::move(job_b.result).take());
+      }
+    };
+    return in_worker(op);
+  }
+
+ private:
+  explicit ThreadPool(size_t num_threads) noexcept;
+
+  // Runs `op` on a thread of the pool. If the current thread is not a thread
+  // of the pool, it blocks until `op` has run on one that is.
+  template <class Op, int&...,
+            class R = std::invoke_result_t<Op&, __private::Worker&>>
+  R in_worker(Op& op) noexcept {
+    check(registry_ != nullptr);
+    if (__private::Worker* worker = registry_->current_worker())
+      return op(*worker);
+    auto body = [this, &op]() -> R {
+      return op(*registry_->current_worker());
+    };
+    __private::LockLatch latch;
+    __private::StackJob<decltype(body), __private::LockLatch> job(body, latch);
+    registry_->push(job);
+    latch.wait();
+    return ::sus::move(job.result).take();
+  }
+
+  __private::Registry* registry_;
+
+  sus_class_trivially_relocatable(::sus::marker::unsafe_fn,
+                                  decltype(registry_));
+};
+
+}  // namespace sus::thread
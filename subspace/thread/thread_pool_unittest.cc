@@ -0,0 +1,262 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "subspace/thread/thread_pool.h"
+
+#include <atomic>
+#include <thread>
+
+#include "googletest/include/gtest/gtest.h"
+#include "subspace/containers/vec.h"
+#include "subspace/mem/relocate.h"
+#include "subspace/prelude.h"
+#include "subspace/thread/__private/work_deque.h"
+
+namespace {
+
+using sus::thread::Scope;
+using sus::thread::ThreadPool;
+
+static_assert(sus::mem::relocate_by_memcpy<ThreadPool>);
+
+std::atomic<int> spawn_count;
+
+TEST(ThreadPool, NumThreads) {
+  auto pool = ThreadPool::with_num_threads(3u);
+  EXPECT_EQ(pool.num_threads(), 3u);
+
+  auto def = ThreadPool();
+  EXPECT_GE(def.num_threads(), 1u);
+
+#if GTEST_HAS_DEATH_TEST
+  EXPECT_DEATH(ThreadPool::with_num_threads(0u), "");
+#endif
+}
+
+TEST(ThreadPool, Move) {
+  auto pool = ThreadPool::with_num_threads(2u);
+  auto moved = sus::move(pool);
+  EXPECT_EQ(moved.num_threads(), 2u);
+  pool = ThreadPool::with_num_threads(1u);
+  EXPECT_EQ(pool.num_threads(), 1u);
+  // Moving into itself does nothing.
+  auto& self = pool;
+  pool = sus::move(self);
+  EXPECT_EQ(pool.num_threads(), 1u);
+}
+
+TEST(ThreadPool, Spawn) {
+  spawn_count.store(0);
+  {
+    auto pool = ThreadPool::with_num_threads(4u);
+    for (int i = 0; i < 100; ++i)
+      pool.spawn([]() { spawn_count.fetch_add(1); });
+  }
+  // Destroying the pool waits for the spawned tasks.
+  EXPECT_EQ(spawn_count.load(), 100);
+}
+
+TEST(ThreadPool, SpawnBind) {
+  std::atomic<int> count = 0;
+  {
+    auto pool = ThreadPool::with_num_threads(2u);
+    std::atomic<int>* c = &count;
+    pool.spawn(sus_bind_mut(sus_store(sus_unsafe_pointer(c)),
+                            [c]() mutable { c->fetch_add(2); }));
+    pool.spawn(sus_bind_mut(sus_store(sus_unsafe_pointer(c)),
+                            [c]() mutable { c->fetch_add(3); }));
+  }
+  EXPECT_EQ(count.load(), 5);
+}
+
+TEST(ThreadPool, ScopeBorrowsStack) {
+  auto pool = ThreadPool::with_num_threads(4u);
+  sus::Vec<i32> v;
+  for (i32 i = 0; i < 64; i += 1) v.push(i);
+
+  std::atomic<int32_t> sum = 0;
+  pool.scope([&](Scope& s) {
+    for (usize i = 0u; i < v.len(); i += 8u) {
+      s.spawn([&, i]() {
+        i32 part = 0;
+        for (usize j = i; j < i + 8u; j += 1u) part += v[j];
+        sum.fetch_add(part.primitive_value);
+      });
+    }
+  });
+  // The scope waits for every spawned task.
+  EXPECT_EQ(sum.load(), 63 * 64 / 2);
+}
+
+TEST(ThreadPool, ScopeReturnsValue) {
+  auto pool = ThreadPool::with_num_threads(2u);
+  i32 a = 0, b = 0;
+  i32 r = pool.scope([&](Scope& s) {
+    s.spawn([&]() { a = 1; });
+    s.spawn([&]() { b = 2; });
+    return 3_i32;
+  });
+  EXPECT_EQ(r, 3_i32);
+  EXPECT_EQ(a, 1_i32);
+  EXPECT_EQ(b, 2_i32);
+}
+
+TEST(ThreadPool, ScopeNestedSpawn) {
+  auto pool = ThreadPool::with_num_threads(3u);
+  std::atomic<int> count = 0;
+  pool.scope([&](Scope& s) {
+    for (int i = 0; i < 10; ++i) {
+      s.spawn([&](Scope& inner) {
+        count.fetch_add(1);
+        for (int j = 0; j < 10; ++j)
+          inner.spawn([&]() { count.fetch_add(1); });
+      });
+    }
+  });
+  EXPECT_EQ(count.load(), 110);
+}
+
+TEST(ThreadPool, ScopeFnOnce) {
+  auto pool = ThreadPool::with_num_threads(2u);
+  std::atomic<int> count = 0;
+  std::atomic<int>* c = &count;
+  pool.scope([&](Scope& s) {
+    s.spawn(sus::fn::FnOnce<void()>(sus_bind_mut(
+        sus_store(sus_unsafe_pointer(c)), [c]() mutable { c->fetch_add(1); })));
+  });
+  EXPECT_EQ(count.load(), 1);
+}
+
+TEST(ThreadPool, Join) {
+  auto pool = ThreadPool::with_num_threads(2u);
+  auto [a, b] = pool.join([]() { return 1_i32; }, []() { return 2_u32; });
+  EXPECT_EQ(a, 1_i32);
+  EXPECT_EQ(b, 2_u32);
+
+  i32 x = 0, y = 0;
+  pool.join([&]() { x = 3; }, [&]() { y = 4; });
+  EXPECT_EQ(x, 3_i32);
+  EXPECT_EQ(y, 4_i32);
+}
+
+u64 parallel_sum(ThreadPool& pool, const u64* data, usize len) {
+  if (len <= 16u) {
+    u64 sum = 0u;
+    for (usize i = 0u; i < len; i += 1u) sum += data[i.primitive_value];
+    return sum;
+  }
+  const usize mid = len / 2u;
+  auto [l, r] = pool.join(
+      [&]() { return parallel_sum(pool, data, mid); },
+      [&]() {
+        return parallel_sum(pool, data + mid.primitive_value, len - mid);
+      });
+  return l + r;
+}
+
+TEST(ThreadPool, JoinRecursive) {
+  auto pool = ThreadPool::with_num_threads(4u);
+  sus::Vec<u64> v;
+  for (u64 i = 0u; i < 10000u; i += 1u) v.push(i);
+  EXPECT_EQ(parallel_sum(pool, v.as_ptr(), v.len()), 9999u * 10000u / 2u);
+}
+
+TEST(ThreadPool, JoinInsideScope) {
+  auto pool = ThreadPool::with_num_threads(4u);
+  std::atomic<int> count = 0;
+  pool.scope([&](Scope& s) {
+    for (int i = 0; i < 8; ++i) {
+      s.spawn([&]() {
+        pool.join([&]() { count.fetch_add(1); },
+                  [&]() { count.fetch_add(1); });
+      });
+    }
+  });
+  EXPECT_EQ(count.load(), 16);
+}
+
+TEST(ThreadPool, JoinFromManyThreads) {
+  auto pool = ThreadPool::with_num_threads(2u);
+  std::atomic<int> count = 0;
+  sus::Vec<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.push(std::thread([&]() {
+      for (int j = 0; j < 50; ++j) {
+        pool.join([&]() { count.fetch_add(1); },
+                  [&]() { count.fetch_add(1); });
+      }
+    }));
+  }
+  for (std::thread& t : threads.iter_mut()) t.join();
+  EXPECT_EQ(count.load(), 400);
+}
+
+TEST(WorkDeque, PushPopSteal) {
+  using sus::thread::__private::Job;
+  using sus::thread::__private::Steal;
+  using sus::thread::__private::WorkDeque;
+
+  Job jobs[200];
+  WorkDeque d;
+  EXPECT_TRUE(d.is_empty());
+  EXPECT_EQ(d.pop(), nullptr);
+
+  // Pushing more than the initial capacity grows the deque.
+  for (int i = 0; i < 200; ++i) d.push(&jobs[i]);
+  EXPECT_FALSE(d.is_empty());
+
+  // The owner pops in LIFO order.
+  EXPECT_EQ(d.pop(), &jobs[199]);
+  // Thieves steal in FIFO order.
+  Job* stolen = nullptr;
+  EXPECT_EQ(d.steal(stolen), Steal::Success);
+  EXPECT_EQ(stolen, &jobs[0]);
+
+  for (int i = 198; i >= 1; --i) EXPECT_EQ(d.pop(), &jobs[i]);
+  EXPECT_TRUE(d.is_empty());
+  EXPECT_EQ(d.steal(stolen), Steal::Empty);
+}
+
+TEST(WorkDeque, ConcurrentSteal) {
+  using sus::thread::__private::Job;
+  using sus::thread::__private::Steal;
+  using sus::thread::__private::WorkDeque;
+
+  constexpr int kJobs = 10000;
+  static Job jobs[kJobs];
+  WorkDeque d;
+  std::atomic<int> taken = 0;
+  std::atomic<bool> done = false;
+
+  sus::Vec<std::thread> thieves;
+  for (int i = 0; i < 3; ++i) {
+    thieves.push(std::thread([&]() {
+      while (!done.load()) {
+        Job* job;
+        if (d.steal(job) == Steal::Success) taken.fetch_add(1);
+      }
+    }));
+  }
+  for (int i = 0; i < kJobs; ++i) {
+    d.push(&jobs[i]);
+    if (i % 3 == 0 && d.pop() != nullptr) taken.fetch_add(1);
+  }
+  while (d.pop() != nullptr) taken.fetch_add(1);
+  done.store(true);
+  for (std::thread& t : thieves.iter_mut()) t.join();
+  // Every job was taken exactly once.
+  EXPECT_EQ(taken.load(), kJobs);
+}
+
+}  // namespace
@@ -138,33 +138,116 @@ static constexpr S& find_tuple_storage_mut(S& storage,
   return storage;
 }
 
-template <size_t I, class S1, class S2>
-constexpr inline auto storage_eq_impl(const S1& l, const S2& r) noexcept {
-  return find_tuple_storage<I>(l).at() == find_tuple_storage<I>(r).at();
+template <size_t I, class T1, class T2>
+constexpr inline auto tuple_eq_impl(const T1& l, const T2& r) noexcept {
+  return l.template at<I>() == r.template at<I>();
 };
 
-template <class S1, class S2, size_t... N>
-constexpr inline auto storage_eq(const S1& l, const S2& r,
-                                 std::index_sequence<N...>) noexcept {
-  return (... && (storage_eq_impl<N>(l, r)));
+template <class T1, class T2, size_t... N>
+constexpr inline auto tuple_eq(const T1& l, const T2& r,
+                               std::index_sequence<N...>) noexcept {
+  return (... && (tuple_eq_impl<N>(l, r)));
 };
 
-template <size_t I, class O, class S1, class S2>
-constexpr inline bool storage_cmp_impl(O& val, const S1& l,
-                                       const S2& r) noexcept {
-  auto cmp = find_tuple_storage<I>(l).at() <=> find_tuple_storage<I>(r).at();
+template <size_t I, class O, class T1, class T2>
+constexpr inline bool tuple_cmp_impl(O& val, const T1& l,
+                                     const T2& r) noexcept {
+  auto cmp = l.template at<I>() <=> r.template at<I>();
   // Allow downgrading from equal to equivalent, but not the inverse.
   if (cmp != 0) val = cmp;
   // Short circuit by returning true when we find a difference.
   return val == 0;
 };
 
-template <class S1, class S2, size_t... N>
-constexpr inline auto storage_cmp(auto equal, const S1& l, const S2& r,
-                                  std::index_sequence<N...>) noexcept {
+template <class T1, class T2, size_t... N>
+constexpr inline auto tuple_cmp(auto equal, const T1& l, const T2& r,
+                                std::index_sequence<N...>) noexcept {
   auto val = equal;
-  (... && (storage_cmp_impl<N>(val, l, r)));
+  (... && (tuple_cmp_impl<N>(val, l, r)));
   return val;
 };
 
+template <size_t I, class T, class... Ts>
+struct NthTypeHelper {
+  using type = NthTypeHelper<I - 1u, Ts...>::type;
+};
+
+template <class T, class... Ts>
+struct NthTypeHelper<0u, T, Ts...> {
+  using type = T;
+};
+
+template <size_t I, class... Ts>
+using NthType = NthTypeHelper<I, Ts...>::type;
+
+/// Returns the `I`th argument, forwarded.
+template <size_t I, class A, class... As>
+constexpr inline decltype(auto) nth_arg(A&& a, As&&... as) noexcept {
+  if constexpr (I == 0u)
+    return ::sus::forward<A>(a);
+  else
+    return nth_arg<I - 1u>(::sus::forward<As>(as)...);
+}
+
+/// The alignment used to order an element of type `T` in the storage.
+/// References are stored as pointers.
+template <class T>
+constexpr size_t storage_align =
+    alignof(std::conditional_t<std::is_reference_v<T>,
+                               std::remove_reference_t<T>*, T>);
+
+/// The order of the elements of a Tuple in its TupleStorage.
+template <size_t N>
+struct TupleOrder {
+  /// The index of the Tuple element held at each position in the storage.
+  size_t element_at[N];
+  /// The position in the storage of each element of the Tuple.
+  size_t storage_index[N];
+};
+
+template <size_t N>
+consteval TupleOrder<N> tuple_order(const size_t (&aligns)[N]) noexcept {
+  TupleOrder<N> order;
+  for (size_t i = 0u; i < N; ++i) order.element_at[i] = i;
+  // A stable insertion sort, so that elements of the same alignment keep
+  // their order.
+  for (size_t i = 1u; i < N; ++i) {
+    for (size_t j = i; j > 0u; --j) {
+      if (aligns[order.element_at[j - 1u]] <= aligns[order.element_at[j]])
+        break;
+      const size_t tmp = order.element_at[j];
+      order.element_at[j] = order.element_at[j - 1u];
+      order.element_at[j - 1u] = tmp;
+    }
+  }
+  for (size_t p = 0u; p < N; ++p) order.storage_index[order.element_at[p]] = p;
+  return order;
+}
+
+/// The layout of a `Tuple<Ts...>`.
+///
+/// The TupleStorage places its last element first in memory, so sorting the
+/// elements by increasing alignment places them in memory from the largest
+/// alignment to the smallest. Then no padding is needed between elements, and
+/// any padding is left at the tail, where it can be reused.
+template <class... Ts>
+constexpr TupleOrder<sizeof...(Ts)> kTupleOrder =
+    tuple_order<sizeof...(Ts)>({storage_align<Ts>...});
+
+template <class Seq, class... Ts>
+struct OrderedTupleStorageHelper;
+
+template <size_t... Ps, class... Ts>
+struct OrderedTupleStorageHelper<std::index_sequence<Ps...>, Ts...> {
+  using type =
+      TupleStorage<NthType<kTupleOrder<Ts...>.element_at[Ps], Ts...>...>;
+};
+
+/// The TupleStorage for a `Tuple<Ts...>`, which holds the elements in the
+/// order given by `kTupleOrder`.
+template <class... Ts>
+using OrderedTupleStorage =
+    OrderedTupleStorageHelper<std::make_index_sequence<sizeof...(Ts)>,
+                              Ts...>::type;
+
 }  // namespace sus::tuple_type::__private
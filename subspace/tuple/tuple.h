@@ -60,13 +60,17 @@ namespace sus::tuple_type {
 /// Additionally types within the tuple may be placed inside the tail padding of
 /// other types in the tuple, should such padding exist.
 ///
-/// Generally, but not always, use of tail padding in Tuple is optimized by
-/// ordering types (left-to-right in the template variables) from smallest-to-
-/// largest for simple types such as integers (which have no tail padding
-/// themselves), or in least-to-most tail-padding for more complex types.
-/// Elements in a Tuple are stored internally in reverse of the order they are
-/// specified, which is why the size of the *first* element matters for the
-/// Tuple's externally usable tail padding.
+/// # Layout
+/// The elements of a Tuple are not stored in the order they are specified.
+/// They are laid out in memory from the largest alignment to the smallest, so
+/// that no padding is needed between them, and any padding is left at the tail
+/// of the Tuple where it can be reused. For example `Tuple<u8, u64, u8>` is 16
+/// bytes, where storing the elements in order would take 24. Elements of the
+/// same alignment are laid out in reverse of the order they are specified.
+///
+/// The layout is not visible through the Tuple's methods, which all use the
+/// order the elements are specified in. It is available at compile time from
+/// `sus::tuple_type::__private::kTupleOrder<Ts...>`.
 template <class T, class... Ts>
 class Tuple final {
  public:
@@ -103,8 +107,9 @@ class Tuple final {
              !(::sus::mem::CopyOrRef<T> && ... && ::sus::mem::CopyOrRef<Ts>))
   {
     auto f = [this]<size_t... Is>(std::index_sequence<Is...>) {
-      return Tuple::with(::sus::mem::clone_or_forward<T>(
-          __private::find_tuple_storage<Is>(storage_).at())...);
+      return Tuple::with(
+          ::sus::mem::clone_or_forward<__private::NthType<Is, T, Ts...>>(
+              at<Is>())...);
     };
     return f(std::make_index_sequence<1u + sizeof...(Ts)>());
   }
@@ -113,7 +118,7 @@ class Tuple final {
   template <size_t I>
     requires(I <= sizeof...(Ts))
   constexpr inline const auto& at() const& noexcept {
-    return __private::find_tuple_storage<I>(storage_).at();
+    return __private::find_tuple_storage<storage_index<I>>(storage_).at();
   }
   // Disallows getting a reference to temporary Tuple.
   template <size_t I>
@@ -123,7 +128,8 @@ class Tuple final {
   template <size_t I>
     requires(I <= sizeof...(Ts))
   constexpr inline auto& at_mut() & noexcept {
-    return __private::find_tuple_storage_mut<I>(storage_).at_mut();
+    return __private::find_tuple_storage_mut<storage_index<I>>(storage_)
+        .at_mut();
   }
 
   /// Removes the `I`th element from the tuple, leaving the Tuple in a
@@ -131,7 +137,8 @@ class Tuple final {
   template <size_t I>
     requires(I <= sizeof...(Ts))
   constexpr inline decltype(auto) into_inner() && noexcept {
-    return ::sus::move(__private::find_tuple_storage_mut<I>(storage_))
+    return ::sus::move(
+               __private::find_tuple_storage_mut<storage_index<I>>(storage_))
         .into_inner();
   }
 
@@ -140,8 +147,8 @@ class Tuple final {
     requires(sizeof...(Us) == sizeof...(Ts) &&
              (::sus::ops::Eq<T, U> && ... && ::sus::ops::Eq<Ts, Us>))
   constexpr bool operator==(const Tuple<U, Us...>& r) const& noexcept {
-    return __private::storage_eq(
-        storage_, r.storage_, std::make_index_sequence<1u + sizeof...(Ts)>());
+    return __private::tuple_eq(*this, r,
+                               std::make_index_sequence<1u + sizeof...(Ts)>());
   }
 
   /// Compares two Tuples.
@@ -156,8 +163,8 @@ class Tuple final {
              (::sus::ops::ExclusiveOrd<T, U> && ... &&
               ::sus::ops::ExclusiveOrd<Ts, Us>))
   constexpr auto operator<=>(const Tuple<U, Us...>& r) const& noexcept {
-    return __private::storage_cmp(
-        std::strong_ordering::equal, storage_, r.storage_,
+    return __private::tuple_cmp(
+        std::strong_ordering::equal, *this, r,
         std::make_index_sequence<1u + sizeof...(Ts)>());
   }
 
@@ -167,8 +174,8 @@ class Tuple final {
              (::sus::ops::ExclusiveWeakOrd<T, U> && ... &&
               ::sus::ops::ExclusiveWeakOrd<Ts, Us>))
   constexpr auto operator<=>(const Tuple<U, Us...>& r) const& noexcept {
-    return __private::storage_cmp(
-        std::weak_ordering::equivalent, storage_, r.storage_,
+    return __private::tuple_cmp(
+        std::weak_ordering::equivalent, *this, r,
         std::make_index_sequence<1u + sizeof...(Ts)>());
   }
 
@@ -178,8 +185,8 @@ class Tuple final {
              (::sus::ops::ExclusivePartialOrd<T, U> && ... &&
               ::sus::ops::ExclusivePartialOrd<Ts, Us>))
   constexpr auto operator<=>(const Tuple<U, Us...>& r) const& noexcept {
-    return __private::storage_cmp(
-        std::partial_ordering::equivalent, storage_, r.storage_,
+    return __private::tuple_cmp(
+        std::partial_ordering::equivalent, *this, r,
         std::make_index_sequence<1u + sizeof...(Ts)>());
   }
 
@@ -187,12 +194,26 @@ class Tuple final {
   template <class U, class... Us>
   friend class Tuple;
 
-  /// Storage for the tuple elements.
-  using Storage = __private::TupleStorage<T, Ts...>;
+  /// Storage for the tuple elements, ordered by alignment.
+  using Storage = __private::OrderedTupleStorage<T, Ts...>;
+
+  /// The position of the `I`th element of the Tuple in the `storage_`.
+  template <size_t I>
+  static constexpr size_t storage_index =
+      __private::kTupleOrder<T, Ts...>.storage_index[I];
 
   template <std::convertible_to<T> U, std::convertible_to<Ts>... Us>
   constexpr inline Tuple(U&& first, Us&&... more) noexcept
-      : storage_(::sus::forward<U>(first), ::sus::forward<Us>(more)...) {}
+      : Tuple(std::make_index_sequence<1u + sizeof...(Ts)>(),
+              ::sus::forward<U>(first), ::sus::forward<Us>(more)...) {}
+
+  // Constructs the `storage_` from the elements, given in Tuple order, by
+  // passing each one to the position in the storage where it is held.
+  template <size_t... Ps, class... Us>
+  constexpr inline Tuple(std::index_sequence<Ps...>, Us&&... values) noexcept
+      : storage_(__private::nth_arg<
+                 __private::kTupleOrder<T, Ts...>.element_at[Ps]>(
+            ::sus::forward<Us>(values)...)...) {}
 
   // The use of `[[no_unique_address]]` allows the tail padding of of the
   // `storage_` to be used in structs that request to do so by putting
@@ -119,6 +119,47 @@ TEST(Tuple, TailPadding) {
   static_assert(sizeof(ExampleFromDocs) == (16 + sus_if_msvc_else(8, 0)));
 }
 
+// Elements are laid out by alignment, largest first, regardless of the order
+// they are specified in.
+static_assert(sizeof(Tuple<u8, u64, u8>) == 16u);
+static_assert(sizeof(Tuple<u8, u64, u8>) == sizeof(Tuple<u64, u8, u8>));
+static_assert(sizeof(Tuple<u8, u32, u16, u64>) == 16u);
+static_assert(sizeof(Tuple<u16, u64, u16, u64, u16>) == 24u);
+static_assert(sizeof(Tuple<u8, i32&, u8>) == 2u * sizeof(void*));
+// The elements with the largest alignment go last in the storage, which places
+// them first in memory.
+static_assert(sus::tuple_type::__private::kTupleOrder<u8, u64, u8>
+                  .storage_index[0u] == 0u);
+static_assert(sus::tuple_type::__private::kTupleOrder<u8, u64, u8>
+                  .storage_index[1u] == 2u);
+static_assert(sus::tuple_type::__private::kTupleOrder<u8, u64, u8>
+                  .storage_index[2u] == 1u);
+static_assert(sus::tuple_type::__private::kTupleOrder<u8, u64, u8>
+                  .element_at[2u] == 1u);
+
+TEST(Tuple, Reordered) {
+  auto t = Tuple<u8, u64, u16, u32>::with(1_u8, 2_u64, 3_u16, 4_u32);
+  EXPECT_EQ(t.at<0>(), 1_u8);
+  EXPECT_EQ(t.at<1>(), 2_u64);
+  EXPECT_EQ(t.at<2>(), 3_u16);
+  EXPECT_EQ(t.at<3>(), 4_u32);
+  t.at_mut<2>() = 5_u16;
+  EXPECT_EQ(t.at<2>(), 5_u16);
+
+  auto [a, b, c, d] = t;
+  EXPECT_EQ(a, 1_u8);
+  EXPECT_EQ(b, 2_u64);
+  EXPECT_EQ(c, 5_u16);
+  EXPECT_EQ(d, 4_u32);
+
+  // Comparisons are in the order the elements are specified, not the order
+  // they are stored in.
+  EXPECT_LT((Tuple<u8, u64>::with(1_u8, 9_u64)),
+            (Tuple<u8, u64>::with(2_u8, 0_u64)));
+  EXPECT_EQ((Tuple<u8, u64>::with(1_u8, 9_u64)),
+            (Tuple<u8, u64>::with(1_u8, 9_u64)));
+}
+
 TEST(Tuple, With) {
   auto t1 = Tuple<i32>::with(2);
   auto t2 = Tuple<i32, f32>::with(2, 3.f);
@@ -264,6 +305,12 @@ TEST(Tuple, Clone) {
   auto t1 = Tuple<Cloneable>::with(2_i32);
   auto t2 = ::sus::clone(t1);
   EXPECT_EQ(t1.at<0>().i + 1_i32, t2.at<0>().i);
+
+  // Each element is cloned as its own type.
+  auto t3 = Tuple<i32, Cloneable>::with(4_i32, 5_i32);
+  auto t4 = ::sus::clone(t3);
+  EXPECT_EQ(t4.at<0>(), 4_i32);
+  EXPECT_EQ(t4.at<1>().i, 6_i32);
 }
 
 TEST(Tuple, GetRef) {